@@ -0,0 +1,53 @@
+#include <catch.hpp>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <string>
+#include <vector>
+import lune;
+
+using namespace lune;
+
+namespace
+{
+	constexpr size_t LARGE_FILE_SIZE{64 * 1024 * 1024};
+
+	std::string createLargeFile()
+	{
+		const auto path{(std::filesystem::temp_directory_path() / "lune_bench_large.bin").string()};
+
+		std::vector<char> data(LARGE_FILE_SIZE);
+		std::iota(data.begin(), data.end(), 0);
+
+		std::ofstream stream(path, std::ios::binary);
+		stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+		return path;
+	}
+} // namespace
+
+TEST_CASE("File benchmarks", "[benchmark][File]")
+{
+	const std::string path{createLargeFile()};
+
+	BENCHMARK("File::read 64 MiB")
+	{
+		return File::read(path)->size();
+	};
+
+	BENCHMARK("File::readBinary 64 MiB")
+	{
+		return File::readBinary(path)->size();
+	};
+
+	BENCHMARK("MappedFile::open 64 MiB and touch every page")
+	{
+		const auto file{MappedFile::open(path)};
+		size_t sum{};
+		for (size_t i = 0; i < file->size(); i += 4096)
+			sum += static_cast<size_t>(file->data()[i]);
+		return sum;
+	};
+
+	std::filesystem::remove(path);
+}
@@ -0,0 +1,85 @@
+#include <catch.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+import lune;
+
+using namespace lune;
+
+namespace
+{
+	constexpr size_t ELEMENT_COUNT{1 << 22};
+
+	template <typename T> std::vector<T> randomKeys(const size_t count)
+	{
+		std::mt19937_64 random{7};
+		std::vector<T> keys(count);
+		for (T& key : keys)
+			key = static_cast<T>(random());
+		return keys;
+	}
+} // namespace
+
+// The GPU kernels need a device; these measure the CPU path, which backends without kernels use
+TEST_CASE("CpuPrimitives benchmarks", "[benchmark][CpuPrimitives]")
+{
+	JobSystem& jobs{JobSystem::instance()};
+	const std::vector<uint32_t> input{randomKeys<uint32_t>(ELEMENT_COUNT)};
+	std::vector<uint32_t> output(ELEMENT_COUNT);
+
+	BENCHMARK("std::exclusive_scan 4M")
+	{
+		std::exclusive_scan(input.begin(), input.end(), output.begin(), 0u);
+		return output.back();
+	};
+
+	BENCHMARK("CpuPrimitives::exclusiveScan 4M")
+	{
+		gfx::CpuPrimitives::exclusiveScan(input, output, &jobs);
+		return output.back();
+	};
+
+	BENCHMARK("CpuPrimitives::reduce 4M")
+	{
+		return gfx::CpuPrimitives::reduce(input, &jobs);
+	};
+
+	std::vector<uint32_t> flags(ELEMENT_COUNT);
+	std::transform(input.begin(), input.end(), flags.begin(),
+				   [](const uint32_t value) { return value & 1; });
+	BENCHMARK("CpuPrimitives::compact 4M, half kept")
+	{
+		return gfx::CpuPrimitives::compact(input, flags, output, &jobs);
+	};
+
+	std::vector<uint32_t> bins(256);
+	BENCHMARK("CpuPrimitives::histogram 4M into 256 bins")
+	{
+		gfx::CpuPrimitives::histogram(input, bins, 24, &jobs);
+		return bins[0];
+	};
+
+	std::vector<uint32_t> values(ELEMENT_COUNT);
+	BENCHMARK_ADVANCED("std::sort 4M 32-bit keys")(Catch::Benchmark::Chronometer meter)
+	{
+		std::vector<uint32_t> keys{input};
+		meter.measure([&] { std::sort(keys.begin(), keys.end()); });
+	};
+
+	BENCHMARK_ADVANCED("CpuPrimitives::sortPairs 4M 32-bit keys")
+	(Catch::Benchmark::Chronometer meter)
+	{
+		std::vector<uint32_t> keys{input};
+		meter.measure([&] { gfx::CpuPrimitives::sortPairs(keys, values, &jobs); });
+	};
+
+	const std::vector<uint64_t> wideInput{randomKeys<uint64_t>(ELEMENT_COUNT)};
+	BENCHMARK_ADVANCED("CpuPrimitives::sortPairs 4M 64-bit keys")
+	(Catch::Benchmark::Chronometer meter)
+	{
+		std::vector<uint64_t> keys{wideInput};
+		meter.measure([&] { gfx::CpuPrimitives::sortPairs(keys, values, &jobs); });
+	};
+}
@@ -0,0 +1,47 @@
+#include <catch.hpp>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+import lune;
+
+using namespace lune;
+
+namespace
+{
+	constexpr size_t ELEMENT_COUNT{1 << 22};
+
+	void saxpy(const float a, const float* x, float* y, const size_t begin, const size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+			y[i] = a * x[i] + std::sqrt(y[i]);
+	}
+} // namespace
+
+// There is no CPU gfx backend; the job system is the engine's CPU path for data-parallel work
+TEST_CASE("JobSystem benchmarks", "[benchmark][JobSystem]")
+{
+	std::vector<float> x(ELEMENT_COUNT, 2.0f);
+	std::vector<float> y(ELEMENT_COUNT, 4.0f);
+	JobSystem& jobs{JobSystem::instance()};
+
+	BENCHMARK("saxpy 4M single-threaded")
+	{
+		saxpy(0.5f, x.data(), y.data(), 0, ELEMENT_COUNT);
+		return y[0];
+	};
+
+	BENCHMARK("saxpy 4M JobSystem::parallelFor")
+	{
+		jobs.parallelFor(ELEMENT_COUNT, 64 * 1024, [&](const size_t begin, const size_t end)
+						 { saxpy(0.5f, x.data(), y.data(), begin, end); });
+		return y[0];
+	};
+
+	BENCHMARK("JobSystem::submit/wait 1024 empty jobs")
+	{
+		JobCounter counter;
+		for (int i = 0; i < 1024; ++i)
+			jobs.submit([] {}, &counter);
+		jobs.wait(counter);
+	};
+}
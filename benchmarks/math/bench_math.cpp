@@ -0,0 +1,83 @@
+#include <catch.hpp>
+#include <vector>
+import lune;
+
+using namespace lune;
+
+namespace
+{
+	std::vector<Mat4> makeMatrices(const size_t count)
+	{
+		std::vector<Mat4> matrices;
+		matrices.reserve(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const auto f{static_cast<float>(i)};
+			matrices.push_back(Mat4::transform({f, -f, 0.5f * f}, {0.01f * f, 0.02f * f, 0.0f},
+											   {1.0f, 1.0f, 1.0f}));
+		}
+		return matrices;
+	}
+} // namespace
+
+TEST_CASE("Mat4 benchmarks", "[benchmark][Mat4]")
+{
+	const std::vector<Mat4> matrices{makeMatrices(1024)};
+
+	BENCHMARK("Mat4::operator* x1024")
+	{
+		Mat4 result{matrices[0]};
+		for (const Mat4& matrix : matrices)
+			result = result * matrix;
+		return result;
+	};
+
+	BENCHMARK("Mat4::transform x1024")
+	{
+		Mat4 result{};
+		for (size_t i = 0; i < 1024; ++i)
+		{
+			const auto f{static_cast<float>(i)};
+			result = result + Mat4::transform({f, f, f}, {0.1f, 0.2f, 0.3f}, {1.0f, 2.0f, 1.0f});
+		}
+		return result;
+	};
+}
+
+TEST_CASE("Vector benchmarks", "[benchmark][Vector]")
+{
+	std::vector<Vec2> vec2s(4096);
+	std::vector<Vec3> vec3s(4096);
+	std::vector<Vec4> vec4s(4096);
+	for (size_t i = 0; i < vec3s.size(); ++i)
+	{
+		const auto f{static_cast<float>(i) + 1.0f};
+		vec2s[i] = {f, -f};
+		vec3s[i] = {f, 2.0f * f, -f};
+		vec4s[i] = {f, 2.0f * f, -f, 0.5f * f};
+	}
+
+	BENCHMARK("Vec2::normalize x4096")
+	{
+		Vec2 sum{};
+		for (const Vec2& v : vec2s)
+			sum = sum + v.normalize();
+		return sum;
+	};
+
+	BENCHMARK("Vec3::normalize x4096")
+	{
+		Vec3 sum{};
+		for (const Vec3& v : vec3s)
+			sum = sum + v.normalize();
+		return sum;
+	};
+
+	BENCHMARK("Vec4::normalize x4096")
+	{
+		Vec4 sum{};
+		for (const Vec4& v : vec4s)
+			sum = sum + v.normalize();
+		return sum;
+	};
+}
@@ -0,0 +1,55 @@
+#include <GLFW/glfw3.h>
+#include <catch.hpp>
+import lune;
+
+using namespace lune;
+
+namespace
+{
+	/**
+	 * @brief Queues a burst of key and mouse events as GLFW would deliver them during one
+	 * `glfwPollEvents()` call.
+	 */
+	void queueStorm(const int eventCount)
+	{
+		for (int i = 0; i < eventCount; ++i)
+		{
+			const int key{GLFW_KEY_A + i % 26};
+			switch (i % 4)
+			{
+				case 0:
+					InputManager::_processInputCallback(nullptr, key, 0, GLFW_PRESS, 0);
+					break;
+				case 1:
+					InputManager::_processMouseCallback(nullptr, i, -i);
+					break;
+				case 2:
+					InputManager::_processInputCallback(nullptr, key, 0, GLFW_REPEAT, 0);
+					break;
+				default:
+					InputManager::_processInputCallback(nullptr, key, 0, GLFW_RELEASE, 0);
+					break;
+			}
+		}
+	}
+} // namespace
+
+TEST_CASE("InputManager benchmarks", "[benchmark][InputManager]")
+{
+	BENCHMARK("InputManager::_process idle frame")
+	{
+		InputManager::_process();
+	};
+
+	BENCHMARK("InputManager::_process 64 events")
+	{
+		queueStorm(64);
+		InputManager::_process();
+	};
+
+	BENCHMARK("InputManager::_process 4000 events")
+	{
+		queueStorm(4000);
+		InputManager::_process();
+	};
+}
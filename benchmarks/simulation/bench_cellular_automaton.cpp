@@ -0,0 +1,81 @@
+#include <catch.hpp>
+#include <cstdint>
+#include <utility>
+#include <vector>
+import lune;
+
+using namespace lune;
+
+namespace
+{
+	constexpr uint32_t GRID_SIZE{2048};
+
+	/// One byte per cell, as the compute sandbox used to store it.
+	void stepBytes(const std::vector<uint8_t>& cells, std::vector<uint8_t>& next)
+	{
+		for (uint32_t y = 0; y < GRID_SIZE; ++y)
+		{
+			const uint32_t up{(y + GRID_SIZE - 1) % GRID_SIZE * GRID_SIZE};
+			const uint32_t row{y * GRID_SIZE};
+			const uint32_t down{(y + 1) % GRID_SIZE * GRID_SIZE};
+			for (uint32_t x = 0; x < GRID_SIZE; ++x)
+			{
+				const uint32_t left{(x + GRID_SIZE - 1) % GRID_SIZE};
+				const uint32_t right{(x + 1) % GRID_SIZE};
+				const uint32_t neighbours{
+						static_cast<uint32_t>(cells[up + left] + cells[up + x] + cells[up + right] +
+											  cells[row + left] + cells[row + right] +
+											  cells[down + left] + cells[down + x] +
+											  cells[down + right])};
+				next[row + x] = neighbours == 3 || (neighbours == 2 && cells[row + x]);
+			}
+		}
+	}
+} // namespace
+
+TEST_CASE("CellularAutomaton benchmarks", "[benchmark][CellularAutomaton]")
+{
+	CellularAutomaton life{GRID_SIZE, GRID_SIZE};
+	life.randomize(0.5f);
+
+	std::vector<uint8_t> cells(GRID_SIZE * GRID_SIZE);
+	std::vector<uint8_t> next(cells.size());
+	for (uint32_t y = 0; y < GRID_SIZE; ++y)
+	{
+		for (uint32_t x = 0; x < GRID_SIZE; ++x)
+			cells[y * GRID_SIZE + x] = life.get(x, y);
+	}
+
+	BENCHMARK("Life 2048x2048 byte per cell")
+	{
+		stepBytes(cells, next);
+		std::swap(cells, next);
+		return cells[0];
+	};
+
+	BENCHMARK("CellularAutomaton::step 2048x2048")
+	{
+		life.step();
+		return life.generation();
+	};
+
+	BENCHMARK("CellularAutomaton::step 2048x2048 JobSystem")
+	{
+		life.step(1, &JobSystem::instance());
+		return life.generation();
+	};
+
+	life.setRule(*CellularRule::parse("B36/S23"));
+	BENCHMARK("CellularAutomaton::step 2048x2048 B36/S23")
+	{
+		life.step();
+		return life.generation();
+	};
+
+	std::vector<uint32_t> pixels(GRID_SIZE * GRID_SIZE);
+	BENCHMARK("CellularAutomaton::toPixels 2048x2048")
+	{
+		life.toPixels(pixels, {255, 0, 0, 255}, {25, 25, 25, 255});
+		return pixels[0];
+	};
+}
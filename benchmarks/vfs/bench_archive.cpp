@@ -0,0 +1,95 @@
+#include <catch.hpp>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <vector>
+import lune;
+
+using namespace lune;
+
+namespace
+{
+	constexpr size_t SMALL_FILE_COUNT{2000};
+	constexpr size_t SMALL_FILE_SIZE{4096};
+	constexpr size_t LARGE_FILE_SIZE{64 * 1024 * 1024};
+
+	std::vector<std::byte> makeContent(const size_t size)
+	{
+		// Compressible like most cooked assets: repeated structure with varying values
+		std::vector<std::byte> content(size);
+		for (size_t i = 0; i < size; ++i)
+			content[i] = static_cast<std::byte>(i % 251 < 128 ? i / 4096 : i % 13);
+		return content;
+	}
+
+	std::string smallFileName(const size_t index)
+	{
+		return "assets/file_" + std::to_string(index) + ".bin";
+	}
+} // namespace
+
+TEST_CASE("Archive benchmarks", "[benchmark][Vfs]")
+{
+	const std::filesystem::path root{std::filesystem::temp_directory_path() / "lune_bench_vfs"};
+	std::filesystem::remove_all(root);
+	std::filesystem::create_directories(root / "assets");
+
+	const std::vector<std::byte> small{makeContent(SMALL_FILE_SIZE)};
+	const std::vector<std::byte> large{makeContent(LARGE_FILE_SIZE)};
+
+	ArchiveWriter storedWriter{ARCHIVE_STORED};
+	ArchiveWriter lz4Writer{ARCHIVE_LZ4};
+	ArchiveWriter zstdWriter{ARCHIVE_ZSTD};
+	for (size_t i = 0; i < SMALL_FILE_COUNT; ++i)
+	{
+		File::writeBinary((root / smallFileName(i)).string(), small);
+		storedWriter.add(smallFileName(i), small);
+	}
+	lz4Writer.add("large.bin", large);
+	zstdWriter.add("large.bin", large);
+
+	const std::string storedPath{(root / "small.lpak").string()};
+	const std::string lz4Path{(root / "lz4.lpak").string()};
+	const std::string zstdPath{(root / "zstd.lpak").string()};
+	JobSystem& jobs{JobSystem::instance()};
+	storedWriter.write(storedPath, &jobs);
+	lz4Writer.write(lz4Path, &jobs);
+	zstdWriter.write(zstdPath, &jobs);
+
+	const auto stored{Archive::open(storedPath)};
+	const auto lz4{Archive::open(lz4Path)};
+	const auto zstd{Archive::open(zstdPath)};
+
+	BENCHMARK("2000 loose 4 KiB files")
+	{
+		size_t size{};
+		for (size_t i = 0; i < SMALL_FILE_COUNT; ++i)
+			size += File::readBinary((root / smallFileName(i)).string())->size();
+		return size;
+	};
+
+	BENCHMARK("2000 archived 4 KiB files, Archive::view")
+	{
+		size_t size{};
+		for (size_t i = 0; i < SMALL_FILE_COUNT; ++i)
+			size += stored->view(smallFileName(i))->size();
+		return size;
+	};
+
+	BENCHMARK("Archive::read 64 MiB LZ4")
+	{
+		return lz4->read("large.bin")->size();
+	};
+
+	BENCHMARK("Archive::read 64 MiB LZ4 JobSystem")
+	{
+		return lz4->read("large.bin", &jobs)->size();
+	};
+
+	BENCHMARK("Archive::read 64 MiB Zstandard JobSystem")
+	{
+		return zstd->read("large.bin", &jobs)->size();
+	};
+
+	std::filesystem::remove_all(root);
+}
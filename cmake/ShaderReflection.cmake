@@ -0,0 +1,132 @@
+# Converts the reflection JSON written by `slangc -reflection-json` into the sidecar read by
+# gfx::ShaderReflection. Run by lune_compile_shaders:
+#
+#   cmake -DINPUT=<shader>.slang.json -DOUTPUT=<shader>.reflect -P ShaderReflection.cmake
+#
+# Every entry point lists the global parameters followed by its own uniform parameters.
+
+cmake_minimum_required(VERSION 3.20)
+
+if (NOT INPUT OR NOT OUTPUT)
+    message(FATAL_ERROR "Usage: cmake -DINPUT=<reflection.json> -DOUTPUT=<file.reflect> -P ${CMAKE_CURRENT_LIST_FILE}")
+endif ()
+
+file(READ "${INPUT}" json)
+
+# Gets the binding type of a parameter ("buffer", "texture", "sampler"), or "" if it isn't bound
+# to a slot of its own (e.g. varying inputs and loose uniforms)
+function(_parameter_type parameter result)
+    set(${result} "" PARENT_SCOPE)
+
+    string(JSON type_kind ERROR_VARIABLE error GET "${parameter}" type kind)
+    if (error)
+        return()
+    endif ()
+
+    # Arrays are bound like their elements
+    if (type_kind STREQUAL "array")
+        string(JSON type_kind ERROR_VARIABLE error GET "${parameter}" type elementType kind)
+        string(JSON shape ERROR_VARIABLE shape_error GET "${parameter}" type elementType baseShape)
+    else ()
+        string(JSON shape ERROR_VARIABLE shape_error GET "${parameter}" type baseShape)
+    endif ()
+
+    if (type_kind STREQUAL "resource")
+        if (NOT shape_error AND shape MATCHES "^texture")
+            set(${result} texture PARENT_SCOPE)
+        else ()
+            set(${result} buffer PARENT_SCOPE)
+        endif ()
+    elseif (type_kind STREQUAL "samplerState")
+        set(${result} sampler PARENT_SCOPE)
+    elseif (type_kind MATCHES "^(constantBuffer|parameterBlock|shaderStorageBuffer)$")
+        set(${result} buffer PARENT_SCOPE)
+    endif ()
+endfunction()
+
+# Gets the slot index of a parameter, or "" if it has none
+function(_parameter_index parameter result)
+    set(${result} "" PARENT_SCOPE)
+
+    string(JSON binding ERROR_VARIABLE error GET "${parameter}" binding)
+    if (error)
+        # Parameters spanning several resource kinds list one binding per kind
+        string(JSON binding ERROR_VARIABLE error GET "${parameter}" bindings 0)
+        if (error)
+            return()
+        endif ()
+    endif ()
+
+    string(JSON kind ERROR_VARIABLE error GET "${binding}" kind)
+    if (error OR kind MATCHES "^(uniform|varyingInput|varyingOutput|specializationConstant)$")
+        return()
+    endif ()
+
+    string(JSON index ERROR_VARIABLE error GET "${binding}" index)
+    if (NOT error)
+        set(${result} ${index} PARENT_SCOPE)
+    endif ()
+endfunction()
+
+# Appends the binding lines of a parameter array
+function(_append_bindings parameters output_variable)
+    set(lines "${${output_variable}}")
+
+    string(JSON count ERROR_VARIABLE error LENGTH "${parameters}")
+    if (error OR count EQUAL 0)
+        return()
+    endif ()
+
+    math(EXPR last "${count} - 1")
+    foreach (i RANGE ${last})
+        string(JSON parameter GET "${parameters}" ${i})
+        string(JSON name GET "${parameter}" name)
+        _parameter_type("${parameter}" type)
+        _parameter_index("${parameter}" index)
+
+        if (type AND NOT index STREQUAL "")
+            string(APPEND lines "${type} ${index} ${name}\n")
+        endif ()
+    endforeach ()
+
+    set(${output_variable} "${lines}" PARENT_SCOPE)
+endfunction()
+
+set(global_bindings "")
+string(JSON parameters ERROR_VARIABLE error GET "${json}" parameters)
+if (NOT error)
+    _append_bindings("${parameters}" global_bindings)
+endif ()
+
+set(contents "lune-reflection 1\n# Generated from ${INPUT}\n")
+
+string(JSON entry_count ERROR_VARIABLE error LENGTH "${json}" entryPoints)
+if (error OR entry_count EQUAL 0)
+    message(FATAL_ERROR "No entry points in ${INPUT}")
+endif ()
+
+math(EXPR last_entry "${entry_count} - 1")
+foreach (i RANGE ${last_entry})
+    string(JSON entry GET "${json}" entryPoints ${i})
+    string(JSON name GET "${entry}" name)
+    string(JSON stage GET "${entry}" stage)
+
+    string(APPEND contents "entry ${name} ${stage}")
+    string(JSON group_size ERROR_VARIABLE error GET "${entry}" threadGroupSize)
+    if (NOT error)
+        foreach (axis 0 1 2)
+            string(JSON size GET "${group_size}" ${axis})
+            string(APPEND contents " ${size}")
+        endforeach ()
+    endif ()
+    string(APPEND contents "\n${global_bindings}")
+
+    set(entry_bindings "")
+    string(JSON entry_parameters ERROR_VARIABLE error GET "${entry}" parameters)
+    if (NOT error)
+        _append_bindings("${entry_parameters}" entry_bindings)
+    endif ()
+    string(APPEND contents "${entry_bindings}")
+endforeach ()
+
+file(WRITE "${OUTPUT}" "${contents}")
@@ -0,0 +1,89 @@
+# Offline shader compilation.
+#
+# lune_compile_shaders(<target> SOURCES <files...> [OUTPUT_DIR <dir>])
+#
+# Compiles shaders at build time so the application never invokes a shader compiler at startup:
+#   - .slang sources are compiled with slangc to MSL and then a .metallib (USE_METAL), or to SPIR-V,
+#     and their bindings are written to a .reflect sidecar read by gfx::ShaderReflection.
+#   - .metal sources are compiled to a .metallib (USE_METAL only); bindings are reflected at load.
+#
+# Outputs are named after the source, e.g. shaders/life.slang -> <dir>/life.metallib + life.reflect.
+# OUTPUT_DIR defaults to <binary dir>/shaders.
+
+set(LUNE_SHADER_REFLECTION_SCRIPT "${CMAKE_CURRENT_LIST_DIR}/ShaderReflection.cmake")
+
+function(lune_compile_shaders target_name)
+    cmake_parse_arguments(PARSE_ARGV 1 SHADER "" "OUTPUT_DIR" "SOURCES")
+
+    if (NOT SHADER_OUTPUT_DIR)
+        set(SHADER_OUTPUT_DIR "${CMAKE_CURRENT_BINARY_DIR}/shaders")
+    endif ()
+    file(MAKE_DIRECTORY "${SHADER_OUTPUT_DIR}")
+
+    set(outputs)
+    foreach (source ${SHADER_SOURCES})
+        get_filename_component(source "${source}" ABSOLUTE)
+        get_filename_component(name "${source}" NAME_WE)
+        get_filename_component(extension "${source}" LAST_EXT)
+        set(output_base "${SHADER_OUTPUT_DIR}/${name}")
+
+        if (extension STREQUAL ".slang")
+            find_program(SLANGC_EXECUTABLE slangc REQUIRED)
+
+            if (USE_METAL)
+                set(slang_target metal)
+                set(slang_output "${output_base}.metal")
+                set(slang_flags)
+            else ()
+                set(slang_target spirv)
+                set(slang_output "${output_base}.spv")
+                # Keep entry point names instead of "main" so kernels can be looked up by name
+                set(slang_flags -fvk-use-entrypoint-name)
+            endif ()
+
+            add_custom_command(
+                    OUTPUT "${slang_output}" "${output_base}.reflect"
+                    COMMAND ${SLANGC_EXECUTABLE} "${source}" -target ${slang_target} ${slang_flags}
+                    -o "${slang_output}" -reflection-json "${output_base}.slang.json"
+                    COMMAND ${CMAKE_COMMAND} "-DINPUT=${output_base}.slang.json"
+                    "-DOUTPUT=${output_base}.reflect" -P "${LUNE_SHADER_REFLECTION_SCRIPT}"
+                    DEPENDS "${source}" "${LUNE_SHADER_REFLECTION_SCRIPT}"
+                    COMMENT "Compiling shader ${name}.slang (${slang_target})"
+                    VERBATIM
+            )
+            list(APPEND outputs "${output_base}.reflect")
+
+            if (USE_METAL)
+                _lune_compile_metallib("${slang_output}" "${output_base}" metallib)
+                list(APPEND outputs "${metallib}")
+            else ()
+                list(APPEND outputs "${slang_output}")
+            endif ()
+        elseif (extension STREQUAL ".metal" AND USE_METAL)
+            _lune_compile_metallib("${source}" "${output_base}" metallib)
+            list(APPEND outputs "${metallib}")
+        else ()
+            message(FATAL_ERROR "lune_compile_shaders: unsupported shader ${source}")
+        endif ()
+    endforeach ()
+
+    add_custom_target(${target_name}_shaders DEPENDS ${outputs})
+    add_dependencies(${target_name} ${target_name}_shaders)
+endfunction()
+
+# Compiles MSL to a .metallib through an intermediate .air file
+function(_lune_compile_metallib source output_base result_variable)
+    find_program(XCRUN_EXECUTABLE xcrun REQUIRED)
+
+    add_custom_command(
+            OUTPUT "${output_base}.metallib"
+            COMMAND ${XCRUN_EXECUTABLE} -sdk macosx metal -c "${source}" -o "${output_base}.air"
+            COMMAND ${XCRUN_EXECUTABLE} -sdk macosx metallib "${output_base}.air"
+            -o "${output_base}.metallib"
+            DEPENDS "${source}"
+            COMMENT "Compiling Metal library ${output_base}.metallib"
+            VERBATIM
+    )
+
+    set(${result_variable} "${output_base}.metallib" PARENT_SCOPE)
+endfunction()
@@ -0,0 +1,134 @@
+module;
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <utility>
+module lune;
+
+namespace lune
+{
+	namespace
+	{
+		bool isValidSection(const MeshSection& section, const size_t fileSize)
+		{
+			if (section.size == 0)
+				return true;
+
+			return section.offset % MESH_SECTION_ALIGNMENT == 0 && section.offset <= fileSize &&
+				   section.size <= fileSize - section.offset;
+		}
+
+		bool holds(const MeshSection& section, const uint64_t count, const uint64_t elementSize)
+		{
+			return section.size / elementSize >= count;
+		}
+
+		/**
+		 * @brief Checks the counts of the header and the ranges of the LOD and meshlet tables
+		 * against the sections they index, so no accessor reads past a section.
+		 */
+		bool hasValidRanges(const MeshHeader& header, const std::byte* file)
+		{
+			const uint64_t vertexCount{header.vertexCount};
+			if (header.layout == MESH_INTERLEAVED)
+			{
+				if (!holds(header.vertices, vertexCount, sizeof(MeshVertex)))
+					return false;
+			}
+			else if (!holds(header.positions, vertexCount, 3 * sizeof(float)) ||
+					 !holds(header.normals, vertexCount, 3 * sizeof(float)) ||
+					 !holds(header.uvs, vertexCount, 2 * sizeof(float)))
+			{
+				return false;
+			}
+
+			if (!holds(header.indices, header.indexCount, header.indexSize) ||
+				!holds(header.lods, header.lodCount, sizeof(MeshLod)) ||
+				!holds(header.meshlets, header.meshletCount, sizeof(Meshlet)))
+				return false;
+
+			const auto* lods{reinterpret_cast<const MeshLod*>(file + header.lods.offset)};
+			for (uint32_t i = 0; i < header.lodCount; ++i)
+			{
+				if (uint64_t{lods[i].indexOffset} + lods[i].indexCount > header.indexCount)
+					return false;
+			}
+
+			const uint64_t tableVertices{header.meshletVertices.size / sizeof(uint32_t)};
+			const auto* meshlets{reinterpret_cast<const Meshlet*>(file + header.meshlets.offset)};
+			for (uint32_t i = 0; i < header.meshletCount; ++i)
+			{
+				const Meshlet& meshlet{meshlets[i]};
+				if (uint64_t{meshlet.vertexOffset} + meshlet.vertexCount > tableVertices ||
+					uint64_t{meshlet.triangleOffset} + uint64_t{meshlet.triangleCount} * 3 >
+							header.meshletTriangles.size)
+					return false;
+			}
+
+			return true;
+		}
+	} // namespace
+
+	std::optional<MeshFile> MeshFile::open(const std::string& path)
+	{
+		// Meshes are mapped in place, which needs a file on disk rather than an archived copy
+		const auto diskPath{Vfs::resolve(path)};
+		if (!diskPath)
+		{
+			std::cerr << "Mesh files can't be mapped from an archive: " << path << "\n";
+			return std::nullopt;
+		}
+
+		auto file{MappedFile::open(*diskPath)};
+		if (!file)
+			return std::nullopt;
+
+		if (file->size() < sizeof(MeshHeader))
+		{
+			std::cerr << "Mesh file is too small: " << path << "\n";
+			return std::nullopt;
+		}
+
+		const auto& header{*reinterpret_cast<const MeshHeader*>(file->data())};
+		if (header.magic != MESH_MAGIC || header.version != MESH_VERSION)
+		{
+			std::cerr << "Unsupported mesh file (bad magic or version): " << path << "\n";
+			return std::nullopt;
+		}
+
+		if (header.indexSize != 2 && header.indexSize != 4)
+		{
+			std::cerr << "Mesh file has an invalid index size: " << path << "\n";
+			return std::nullopt;
+		}
+
+		if (header.layout != MESH_INTERLEAVED && header.layout != MESH_SEPARATE_STREAMS)
+		{
+			std::cerr << "Mesh file has an invalid layout: " << path << "\n";
+			return std::nullopt;
+		}
+
+		for (const MeshSection& section :
+			 {header.vertices, header.positions, header.normals, header.uvs, header.indices,
+			  header.lods, header.meshlets, header.meshletVertices, header.meshletTriangles})
+		{
+			if (!isValidSection(section, file->size()))
+			{
+				std::cerr << "Mesh file has a section out of bounds: " << path << "\n";
+				return std::nullopt;
+			}
+		}
+
+		if (!hasValidRanges(header, file->data()))
+		{
+			std::cerr << "Mesh file has counts or ranges past the end of their sections: " << path
+					  << "\n";
+			return std::nullopt;
+		}
+
+		return MeshFile{std::move(*file)};
+	}
+} // namespace lune
@@ -0,0 +1,260 @@
+module;
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+export module lune:mesh;
+
+import :bounds;
+import lune.vfs;
+
+namespace lune
+{
+	export inline constexpr uint32_t MESH_MAGIC{0x48534D4C}; ///< "LMSH" in little-endian.
+	export inline constexpr uint32_t MESH_VERSION{1};
+	export inline constexpr size_t MESH_SECTION_ALIGNMENT{16};
+
+	/**
+	 * @brief How vertex attributes are laid out in a cooked mesh.
+	 */
+	export enum MeshLayout : uint32_t
+	{
+		MESH_INTERLEAVED,	  ///< A single stream of `MeshVertex`.
+		MESH_SEPARATE_STREAMS ///< One tightly packed stream per attribute (SoA).
+	};
+
+
+	/**
+	 * @brief Interleaved vertex as stored in `MESH_INTERLEAVED` files.
+	 */
+	export struct MeshVertex
+	{
+		float position[3]{};
+		float normal[3]{};
+		float uv[2]{};
+	};
+
+
+	/**
+	 * @brief Byte range of a section, relative to the start of the file.
+	 */
+	export struct MeshSection
+	{
+		uint64_t offset{};
+		uint64_t size{};
+	};
+
+
+	/**
+	 * @brief A single level of detail. All levels share the vertex streams and index into one
+	 * index buffer, so switching LOD is only a change of the draw range.
+	 */
+	export struct MeshLod
+	{
+		uint32_t indexOffset{}; ///< First index of this level.
+		uint32_t indexCount{};	///< Number of indices of this level.
+		float error{};			///< Simplification error relative to the mesh extent.
+		uint32_t _pad{};
+	};
+
+
+	/**
+	 * @brief A small cluster of LOD 0 triangles, suitable for cluster culling and mesh shaders.
+	 */
+	export struct Meshlet
+	{
+		uint32_t vertexOffset{};   ///< First entry in the meshlet vertex table.
+		uint32_t triangleOffset{}; ///< First byte in the meshlet triangle table.
+		uint32_t vertexCount{};
+		uint32_t triangleCount{};
+		float center[3]{}; ///< Bounding sphere center.
+		float radius{};	   ///< Bounding sphere radius.
+	};
+
+
+	/**
+	 * @brief Fixed-size header at the start of every cooked mesh file.
+	 *
+	 * Every section starts on a `MESH_SECTION_ALIGNMENT` boundary so the mapped data can be handed
+	 * to the GPU or reinterpreted in place.
+	 */
+	export struct MeshHeader
+	{
+		uint32_t magic{MESH_MAGIC};
+		uint32_t version{MESH_VERSION};
+		uint32_t layout{MESH_INTERLEAVED}; ///< `MeshLayout`.
+		uint32_t indexSize{};			   ///< Size of an index in bytes (2 or 4).
+		uint32_t vertexCount{};
+		uint32_t indexCount{}; ///< Number of indices across all LODs.
+		uint32_t lodCount{};
+		uint32_t meshletCount{};
+
+		float aabbMin[3]{};
+		float sphereRadius{};
+		float aabbMax[3]{};
+		float _pad{};
+		float sphereCenter[3]{};
+		float _pad2{};
+
+		MeshSection vertices{};	 ///< `MeshVertex[]`, interleaved layout only.
+		MeshSection positions{}; ///< `float[3][]`, separate layout only.
+		MeshSection normals{};	 ///< `float[3][]`, separate layout only.
+		MeshSection uvs{};		 ///< `float[2][]`, separate layout only.
+		MeshSection indices{};
+		MeshSection lods{};
+		MeshSection meshlets{};
+		MeshSection meshletVertices{};	///< `uint32_t[]` indices into the vertex streams.
+		MeshSection meshletTriangles{}; ///< `uint8_t[3][]` indices into the meshlet vertices.
+	};
+
+	static_assert(std::is_trivially_copyable_v<MeshHeader>);
+	static_assert(sizeof(MeshVertex) == 32);
+	static_assert(sizeof(MeshHeader) % MESH_SECTION_ALIGNMENT == 0);
+
+
+	/**
+	 * @brief Loads a cooked `.lmesh` file by memory mapping it.
+	 *
+	 * Loading validates the header and the ranges of the LOD and meshlet tables; the section
+	 * accessors return views straight into the mapping, so data is paged in on first use and can
+	 * be uploaded to GPU buffers without copies. Index values are not checked against the vertex
+	 * count.
+	 */
+	export class MeshFile
+	{
+		MappedFile m_file;
+
+	public:
+		MeshFile() = default;
+
+		/**
+		 * @brief Maps and validates a cooked mesh file.
+		 *
+		 * @param path Path to the `.lmesh` file, resolved through the directory mounts of `Vfs`.
+		 *
+		 * @return The loaded mesh; std::nullopt if the file is missing or malformed.
+		 */
+		static std::optional<MeshFile> open(const std::string& path);
+
+		[[nodiscard]] const MeshHeader& header() const noexcept
+		{
+			return *reinterpret_cast<const MeshHeader*>(m_file.data());
+		}
+
+		[[nodiscard]] MeshLayout layout() const noexcept
+		{
+			return static_cast<MeshLayout>(header().layout);
+		}
+
+		[[nodiscard]] uint32_t vertexCount() const noexcept
+		{
+			return header().vertexCount;
+		}
+
+		[[nodiscard]] uint32_t indexSize() const noexcept
+		{
+			return header().indexSize;
+		}
+
+		/**
+		 * @brief Object space bounding box, e.g. for registering the mesh in a `Bvh`.
+		 */
+		[[nodiscard]] Aabb bounds() const noexcept
+		{
+			const MeshHeader& h = header();
+			return {{h.aabbMin[0], h.aabbMin[1], h.aabbMin[2]},
+					{h.aabbMax[0], h.aabbMax[1], h.aabbMax[2]}};
+		}
+
+		[[nodiscard]] Sphere boundingSphere() const noexcept
+		{
+			const MeshHeader& h = header();
+			return {{h.sphereCenter[0], h.sphereCenter[1], h.sphereCenter[2]}, h.sphereRadius};
+		}
+
+		/**
+		 * @brief Raw bytes of a section, e.g. for uploading to a `gfx::Buffer`.
+		 */
+		[[nodiscard]] std::span<const std::byte> section(const MeshSection& section) const noexcept
+		{
+			return m_file.bytes().subspan(section.offset, section.size);
+		}
+
+		[[nodiscard]] std::span<const MeshVertex> vertices() const noexcept
+		{
+			return view<MeshVertex>(header().vertices);
+		}
+
+		[[nodiscard]] std::span<const float> positions() const noexcept
+		{
+			return view<float>(header().positions);
+		}
+
+		[[nodiscard]] std::span<const float> normals() const noexcept
+		{
+			return view<float>(header().normals);
+		}
+
+		[[nodiscard]] std::span<const float> uvs() const noexcept
+		{
+			return view<float>(header().uvs);
+		}
+
+		/**
+		 * @return The index buffer if the file uses 16-bit indices; an empty span otherwise.
+		 */
+		[[nodiscard]] std::span<const uint16_t> indices16() const noexcept
+		{
+			return indexSize() == 2 ? view<uint16_t>(header().indices) : std::span<const uint16_t>{};
+		}
+
+		/**
+		 * @return The index buffer if the file uses 32-bit indices; an empty span otherwise.
+		 */
+		[[nodiscard]] std::span<const uint32_t> indices32() const noexcept
+		{
+			return indexSize() == 4 ? view<uint32_t>(header().indices) : std::span<const uint32_t>{};
+		}
+
+		/**
+		 * @brief Reads a single index regardless of the stored index size.
+		 */
+		[[nodiscard]] uint32_t index(const size_t i) const noexcept
+		{
+			return indexSize() == 2 ? indices16()[i] : indices32()[i];
+		}
+
+		[[nodiscard]] std::span<const MeshLod> lods() const noexcept
+		{
+			return view<MeshLod>(header().lods);
+		}
+
+		[[nodiscard]] std::span<const Meshlet> meshlets() const noexcept
+		{
+			return view<Meshlet>(header().meshlets);
+		}
+
+		[[nodiscard]] std::span<const uint32_t> meshletVertices() const noexcept
+		{
+			return view<uint32_t>(header().meshletVertices);
+		}
+
+		[[nodiscard]] std::span<const uint8_t> meshletTriangles() const noexcept
+		{
+			return view<uint8_t>(header().meshletTriangles);
+		}
+
+	private:
+		explicit MeshFile(MappedFile&& file) noexcept : m_file(std::move(file))
+		{
+		}
+
+		template <typename T> [[nodiscard]] std::span<const T> view(const MeshSection& s) const
+		{
+			return {reinterpret_cast<const T*>(m_file.data() + s.offset), s.size / sizeof(T)};
+		}
+	};
+} // namespace lune
@@ -0,0 +1,848 @@
+module;
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <queue>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+module lune;
+
+namespace lune
+{
+	namespace
+	{
+		/**
+		 * @brief Symmetric 4x4 error quadric, stored as its upper triangle.
+		 */
+		struct Quadric
+		{
+			double a00{}, a01{}, a02{}, a03{};
+			double a11{}, a12{}, a13{};
+			double a22{}, a23{};
+			double a33{};
+
+			static Quadric fromPlane(const double a, const double b, const double c, const double d,
+									 const double weight)
+			{
+				return {
+						a * a * weight, a * b * weight, a * c * weight, a * d * weight,
+						b * b * weight, b * c * weight, b * d * weight, c * c * weight,
+						c * d * weight, d * d * weight,
+				};
+			}
+
+			Quadric& operator+=(const Quadric& o)
+			{
+				a00 += o.a00;
+				a01 += o.a01;
+				a02 += o.a02;
+				a03 += o.a03;
+				a11 += o.a11;
+				a12 += o.a12;
+				a13 += o.a13;
+				a22 += o.a22;
+				a23 += o.a23;
+				a33 += o.a33;
+				return *this;
+			}
+
+			[[nodiscard]] double evaluate(const double x, const double y, const double z) const
+			{
+				const double error{a00 * x * x + 2 * a01 * x * y + 2 * a02 * x * z + 2 * a03 * x +
+								   a11 * y * y + 2 * a12 * y * z + 2 * a13 * y + a22 * z * z +
+								   2 * a23 * z + a33};
+				return std::abs(error);
+			}
+		};
+
+
+		struct Collapse
+		{
+			double error;
+			uint32_t from;
+			uint32_t to;
+
+			bool operator>(const Collapse& o) const
+			{
+				return error > o.error;
+			}
+		};
+
+
+		struct ObjCorner
+		{
+			int position;
+			int uv;
+			int normal;
+
+			bool operator==(const ObjCorner&) const = default;
+		};
+
+
+		struct ObjCornerHash
+		{
+			size_t operator()(const ObjCorner& c) const noexcept
+			{
+				size_t h{std::hash<int>{}(c.position)};
+				h = h * 31 + std::hash<int>{}(c.uv);
+				return h * 31 + std::hash<int>{}(c.normal);
+			}
+		};
+
+
+		struct PositionKey
+		{
+			uint32_t x, y, z;
+
+			bool operator==(const PositionKey&) const = default;
+		};
+
+
+		struct PositionKeyHash
+		{
+			size_t operator()(const PositionKey& k) const noexcept
+			{
+				return (static_cast<size_t>(k.x) * 73856093) ^ (static_cast<size_t>(k.y) * 19349663) ^
+					   (static_cast<size_t>(k.z) * 83492791);
+			}
+		};
+
+
+		/**
+		 * @brief Accumulates sections of a mesh file, keeping each one aligned.
+		 */
+		class SectionWriter
+		{
+			std::vector<std::byte> m_bytes;
+
+		public:
+			explicit SectionWriter(const size_t reserved) : m_bytes(reserved)
+			{
+			}
+
+			template <typename T> MeshSection append(const std::vector<T>& data)
+			{
+				if (data.empty())
+					return {};
+
+				const size_t offset{(m_bytes.size() + MESH_SECTION_ALIGNMENT - 1) /
+									MESH_SECTION_ALIGNMENT * MESH_SECTION_ALIGNMENT};
+				const size_t size{data.size() * sizeof(T)};
+				m_bytes.resize(offset + size);
+				std::memcpy(m_bytes.data() + offset, data.data(), size);
+
+				return {offset, size};
+			}
+
+			std::vector<std::byte> finish(const MeshHeader& header)
+			{
+				std::memcpy(m_bytes.data(), &header, sizeof(MeshHeader));
+				return std::move(m_bytes);
+			}
+		};
+
+
+		const char* skipSpaces(const char* p, const char* end)
+		{
+			while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+				++p;
+			return p;
+		}
+
+
+		/**
+		 * @brief Parses up to `count` floats from the rest of the line.
+		 */
+		int parseFloats(const char* p, const char* end, float* out, const int count)
+		{
+			int parsed{};
+			while (parsed < count)
+			{
+				p = skipSpaces(p, end);
+				if (p >= end)
+					break;
+
+				char* next{};
+				out[parsed] = std::strtof(p, &next);
+				if (next == p)
+					break;
+
+				p = next;
+				++parsed;
+			}
+			return parsed;
+		}
+
+
+		/**
+		 * @brief Resolves a 1-based (or negative, relative) OBJ index to a 0-based one.
+		 */
+		int resolveObjIndex(const long index, const size_t count)
+		{
+			if (index > 0)
+				return static_cast<int>(index - 1);
+			if (index < 0)
+				return static_cast<int>(static_cast<long>(count) + index);
+			return -1;
+		}
+
+
+		void computeBounds(const std::span<const MeshVertex> vertices, const uint32_t* indices,
+						   const size_t count, float center[3], float& radius)
+		{
+			float mn[3]{std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+						std::numeric_limits<float>::max()};
+			float mx[3]{std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(),
+						std::numeric_limits<float>::lowest()};
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				const float* p{vertices[indices[i]].position};
+				for (int k = 0; k < 3; ++k)
+				{
+					mn[k] = std::min(mn[k], p[k]);
+					mx[k] = std::max(mx[k], p[k]);
+				}
+			}
+
+			float radiusSq{};
+			for (int k = 0; k < 3; ++k)
+				center[k] = count ? (mn[k] + mx[k]) * 0.5f : 0.0f;
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				const float* p{vertices[indices[i]].position};
+				const float dx{p[0] - center[0]}, dy{p[1] - center[1]}, dz{p[2] - center[2]};
+				radiusSq = std::max(radiusSq, dx * dx + dy * dy + dz * dz);
+			}
+
+			radius = std::sqrt(radiusSq);
+		}
+	} // namespace
+
+	std::optional<MeshSource> MeshCooker::loadObj(const std::string& path)
+	{
+		const auto text{File::read(path)};
+		if (!text.has_value())
+			return std::nullopt;
+
+		std::vector<float> positions;
+		std::vector<float> uvs;
+		std::vector<float> normals;
+
+		MeshSource mesh;
+		std::vector<bool> needsNormal;
+		std::unordered_map<ObjCorner, uint32_t, ObjCornerHash> cornerToVertex;
+		std::vector<uint32_t> polygon;
+
+		const char* cursor{text->data()};
+		const char* const end{cursor + text->size()};
+
+		while (cursor < end)
+		{
+			const auto* newline{static_cast<const char*>(std::memchr(cursor, '\n', end - cursor))};
+			const char* lineEnd{newline ? newline : end};
+			const char* p{skipSpaces(cursor, lineEnd)};
+			cursor = lineEnd + 1;
+
+			if (p + 1 >= lineEnd)
+				continue;
+
+			if (p[0] == 'v' && p[1] == ' ')
+			{
+				float v[3]{};
+				parseFloats(p + 2, lineEnd, v, 3);
+				positions.insert(positions.end(), v, v + 3);
+			}
+			else if (p[0] == 'v' && p[1] == 't')
+			{
+				float v[2]{};
+				parseFloats(p + 2, lineEnd, v, 2);
+				uvs.insert(uvs.end(), v, v + 2);
+			}
+			else if (p[0] == 'v' && p[1] == 'n')
+			{
+				float v[3]{};
+				parseFloats(p + 2, lineEnd, v, 3);
+				normals.insert(normals.end(), v, v + 3);
+			}
+			else if (p[0] == 'f' && p[1] == ' ')
+			{
+				polygon.clear();
+				p += 2;
+
+				while (true)
+				{
+					p = skipSpaces(p, lineEnd);
+					if (p >= lineEnd)
+						break;
+
+					char* next{};
+					ObjCorner corner{-1, -1, -1};
+					corner.position = resolveObjIndex(std::strtol(p, &next, 10), positions.size() / 3);
+					if (next == p)
+						break;
+					p = next;
+
+					if (p < lineEnd && *p == '/')
+					{
+						++p;
+						if (p < lineEnd && *p != '/')
+						{
+							corner.uv = resolveObjIndex(std::strtol(p, &next, 10), uvs.size() / 2);
+							p = next;
+						}
+						if (p < lineEnd && *p == '/')
+						{
+							++p;
+							corner.normal =
+									resolveObjIndex(std::strtol(p, &next, 10), normals.size() / 3);
+							p = next;
+						}
+					}
+
+					if (corner.position < 0 ||
+						static_cast<size_t>(corner.position) >= positions.size() / 3)
+					{
+						std::cerr << "Invalid face index in " << path << "\n";
+						return std::nullopt;
+					}
+
+					auto [it, inserted]{cornerToVertex.try_emplace(
+							corner, static_cast<uint32_t>(mesh.vertices.size()))};
+					if (inserted)
+					{
+						MeshVertex vertex{};
+						std::memcpy(vertex.position, &positions[corner.position * 3],
+									sizeof(vertex.position));
+						if (corner.uv >= 0 && static_cast<size_t>(corner.uv) < uvs.size() / 2)
+							std::memcpy(vertex.uv, &uvs[corner.uv * 2], sizeof(vertex.uv));
+
+						const bool hasNormal{corner.normal >= 0 &&
+											 static_cast<size_t>(corner.normal) <
+													 normals.size() / 3};
+						if (hasNormal)
+							std::memcpy(vertex.normal, &normals[corner.normal * 3],
+										sizeof(vertex.normal));
+
+						mesh.vertices.push_back(vertex);
+						needsNormal.push_back(!hasNormal);
+					}
+
+					polygon.push_back(it->second);
+				}
+
+				// Triangulate the polygon as a fan
+				for (size_t i = 2; i < polygon.size(); ++i)
+				{
+					mesh.indices.push_back(polygon[0]);
+					mesh.indices.push_back(polygon[i - 1]);
+					mesh.indices.push_back(polygon[i]);
+				}
+			}
+		}
+
+		if (mesh.indices.empty())
+		{
+			std::cerr << "OBJ file contains no faces: " << path << "\n";
+			return std::nullopt;
+		}
+
+		// Generate smooth normals for vertices that didn't specify one
+		if (std::ranges::find(needsNormal, true) != needsNormal.end())
+		{
+			for (size_t i = 0; i < mesh.indices.size(); i += 3)
+			{
+				MeshVertex* v[3]{&mesh.vertices[mesh.indices[i]], &mesh.vertices[mesh.indices[i + 1]],
+								 &mesh.vertices[mesh.indices[i + 2]]};
+				const Vec3 a{v[0]->position[0], v[0]->position[1], v[0]->position[2]};
+				const Vec3 b{v[1]->position[0], v[1]->position[1], v[1]->position[2]};
+				const Vec3 c{v[2]->position[0], v[2]->position[1], v[2]->position[2]};
+				const Vec3 n{(b - a).cross(c - a)}; // Area weighted
+
+				for (int k = 0; k < 3; ++k)
+				{
+					if (!needsNormal[mesh.indices[i + k]])
+						continue;
+					v[k]->normal[0] += n.x;
+					v[k]->normal[1] += n.y;
+					v[k]->normal[2] += n.z;
+				}
+			}
+
+			for (size_t i = 0; i < mesh.vertices.size(); ++i)
+			{
+				if (!needsNormal[i])
+					continue;
+
+				float* n{mesh.vertices[i].normal};
+				const Vec3 normal{Vec3{n[0], n[1], n[2]}.normalize()};
+				n[0] = normal.x;
+				n[1] = normal.y;
+				n[2] = normal.z;
+			}
+		}
+
+		return mesh;
+	}
+
+	std::vector<std::byte> MeshCooker::cook(const MeshSource& source, const MeshCookInfo& info)
+	{
+		const auto vertexCount{static_cast<uint32_t>(source.vertices.size())};
+
+		// Build the LOD chain. Each level is simplified from the previous one and appended to a
+		// single shared index buffer.
+		std::vector<uint32_t> indices{source.indices};
+		std::vector<MeshLod> lods{{0, static_cast<uint32_t>(indices.size()), 0.0f}};
+		std::vector<uint32_t> current{source.indices};
+
+		for (uint32_t lod = 1; lod < info.maxLodCount; ++lod)
+		{
+			const size_t target{static_cast<size_t>(static_cast<float>(current.size() / 3) *
+													info.lodReduction) *
+								3};
+			float error{};
+			std::vector simplified{
+					simplify(source.vertices, current, target, info.maxLodError, &error)};
+
+			// Stop once simplification stalls, further levels would only duplicate this one
+			if (simplified.empty() || simplified.size() * 20 > current.size() * 19)
+				break;
+
+			lods.push_back({
+					.indexOffset = static_cast<uint32_t>(indices.size()),
+					.indexCount = static_cast<uint32_t>(simplified.size()),
+					.error = std::max(error, lods.back().error),
+			});
+			indices.insert(indices.end(), simplified.begin(), simplified.end());
+			current = std::move(simplified);
+		}
+
+		std::vector<Meshlet> meshlets;
+		std::vector<uint32_t> meshletVertices;
+		std::vector<uint8_t> meshletTriangles;
+		if (info.buildMeshlets)
+		{
+			meshlets = buildMeshlets(source.vertices,
+									 std::span{source.indices.data(), source.indices.size()},
+									 info.maxMeshletVertices, info.maxMeshletTriangles,
+									 meshletVertices, meshletTriangles);
+		}
+
+		MeshHeader header{};
+		header.layout = info.layout;
+		header.indexSize = vertexCount <= std::numeric_limits<uint16_t>::max() + 1u ? 2 : 4;
+		header.vertexCount = vertexCount;
+		header.indexCount = static_cast<uint32_t>(indices.size());
+		header.lodCount = static_cast<uint32_t>(lods.size());
+		header.meshletCount = static_cast<uint32_t>(meshlets.size());
+
+		// Bounding volumes
+		for (int k = 0; k < 3; ++k)
+		{
+			header.aabbMin[k] = vertexCount ? std::numeric_limits<float>::max() : 0.0f;
+			header.aabbMax[k] = vertexCount ? std::numeric_limits<float>::lowest() : 0.0f;
+		}
+		for (const MeshVertex& v : source.vertices)
+		{
+			for (int k = 0; k < 3; ++k)
+			{
+				header.aabbMin[k] = std::min(header.aabbMin[k], v.position[k]);
+				header.aabbMax[k] = std::max(header.aabbMax[k], v.position[k]);
+			}
+		}
+		std::vector<uint32_t> allVertices(vertexCount);
+		std::iota(allVertices.begin(), allVertices.end(), 0u);
+		computeBounds(source.vertices, allVertices.data(), allVertices.size(), header.sphereCenter,
+					  header.sphereRadius);
+
+		SectionWriter writer{sizeof(MeshHeader)};
+
+		if (info.layout == MESH_INTERLEAVED)
+		{
+			header.vertices = writer.append(source.vertices);
+		}
+		else
+		{
+			std::vector<float> positions, normals, uvs;
+			positions.reserve(vertexCount * 3);
+			normals.reserve(vertexCount * 3);
+			uvs.reserve(vertexCount * 2);
+
+			for (const MeshVertex& v : source.vertices)
+			{
+				positions.insert(positions.end(), v.position, v.position + 3);
+				normals.insert(normals.end(), v.normal, v.normal + 3);
+				uvs.insert(uvs.end(), v.uv, v.uv + 2);
+			}
+
+			header.positions = writer.append(positions);
+			header.normals = writer.append(normals);
+			header.uvs = writer.append(uvs);
+		}
+
+		if (header.indexSize == 2)
+		{
+			const std::vector<uint16_t> narrow(indices.begin(), indices.end());
+			header.indices = writer.append(narrow);
+		}
+		else
+		{
+			header.indices = writer.append(indices);
+		}
+
+		header.lods = writer.append(lods);
+		header.meshlets = writer.append(meshlets);
+		header.meshletVertices = writer.append(meshletVertices);
+		header.meshletTriangles = writer.append(meshletTriangles);
+
+		return writer.finish(header);
+	}
+
+	bool MeshCooker::cookToFile(const MeshSource& source, const std::string& path,
+								const MeshCookInfo& info)
+	{
+		const std::vector bytes{cook(source, info)};
+		return File::writeBinary(path, bytes);
+	}
+
+	std::vector<uint32_t> MeshCooker::simplify(const std::span<const MeshVertex> vertices,
+											   const std::span<const uint32_t> indices,
+											   const size_t targetIndexCount,
+											   const float targetError, float* resultError)
+	{
+		if (resultError)
+			*resultError = 0.0f;
+
+		if (indices.size() <= targetIndexCount)
+			return {indices.begin(), indices.end()};
+
+		const size_t vertexCount{vertices.size()};
+		const size_t triangleCount{indices.size() / 3};
+
+		// Weld vertices sharing a position so that attribute seams don't look like borders
+		std::vector<uint32_t> positionOf(vertexCount);
+		std::unordered_map<PositionKey, uint32_t, PositionKeyHash> positionIds;
+		for (size_t i = 0; i < vertexCount; ++i)
+		{
+			const float* p{vertices[i].position};
+			const PositionKey key{std::bit_cast<uint32_t>(p[0]), std::bit_cast<uint32_t>(p[1]),
+								  std::bit_cast<uint32_t>(p[2])};
+			positionOf[i] = positionIds.try_emplace(key, static_cast<uint32_t>(positionIds.size()))
+									.first->second;
+		}
+		const size_t positionCount{positionIds.size()};
+
+		// Lock seams (several vertices at one position) and open borders (edges with one face)
+		std::vector<bool> locked(positionCount);
+		std::vector<uint32_t> vertexAtPosition(positionCount, std::numeric_limits<uint32_t>::max());
+		std::unordered_map<uint64_t, uint32_t> edgeUse;
+
+		for (size_t t = 0; t < triangleCount; ++t)
+		{
+			for (int k = 0; k < 3; ++k)
+			{
+				const uint32_t v{indices[t * 3 + k]};
+				uint32_t& owner{vertexAtPosition[positionOf[v]]};
+				if (owner == std::numeric_limits<uint32_t>::max())
+					owner = v;
+				else if (owner != v)
+					locked[positionOf[v]] = true;
+
+				const uint64_t a{positionOf[v]};
+				const uint64_t b{positionOf[indices[t * 3 + (k + 1) % 3]]};
+				++edgeUse[std::min(a, b) << 32 | std::max(a, b)];
+			}
+		}
+
+		for (const auto& [edge, count] : edgeUse)
+		{
+			if (count == 1)
+			{
+				locked[edge >> 32] = true;
+				locked[edge & 0xFFFFFFFF] = true;
+			}
+		}
+
+		// Accumulate area weighted plane quadrics and the mesh extent
+		std::vector<Quadric> quadrics(positionCount);
+		double mn[3]{std::numeric_limits<double>::max(), std::numeric_limits<double>::max(),
+					 std::numeric_limits<double>::max()};
+		double mx[3]{std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest(),
+					 std::numeric_limits<double>::lowest()};
+
+		for (size_t t = 0; t < triangleCount; ++t)
+		{
+			const float* p0{vertices[indices[t * 3 + 0]].position};
+			const float* p1{vertices[indices[t * 3 + 1]].position};
+			const float* p2{vertices[indices[t * 3 + 2]].position};
+
+			for (const float* p : {p0, p1, p2})
+			{
+				for (int k = 0; k < 3; ++k)
+				{
+					mn[k] = std::min(mn[k], static_cast<double>(p[k]));
+					mx[k] = std::max(mx[k], static_cast<double>(p[k]));
+				}
+			}
+
+			const double e1[3]{p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+			const double e2[3]{p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+			double n[3]{e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2],
+						e1[0] * e2[1] - e1[1] * e2[0]};
+			const double length{std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2])};
+			if (length == 0.0)
+				continue;
+
+			n[0] /= length;
+			n[1] /= length;
+			n[2] /= length;
+			const double d{-(n[0] * p0[0] + n[1] * p0[1] + n[2] * p0[2])};
+			const Quadric q{Quadric::fromPlane(n[0], n[1], n[2], d, length * 0.5)};
+
+			for (int k = 0; k < 3; ++k)
+				quadrics[positionOf[indices[t * 3 + k]]] += q;
+		}
+
+		const double extent{std::max({mx[0] - mn[0], mx[1] - mn[1], mx[2] - mn[2]})};
+		if (extent <= 0.0)
+			return {indices.begin(), indices.end()};
+
+		const double maxError{static_cast<double>(targetError) * extent *
+							  static_cast<double>(targetError) * extent};
+
+		std::vector<std::vector<uint32_t>> vertexTriangles(vertexCount);
+		for (size_t t = 0; t < triangleCount; ++t)
+			for (int k = 0; k < 3; ++k)
+				vertexTriangles[indices[t * 3 + k]].push_back(static_cast<uint32_t>(t));
+
+		std::vector<uint32_t> remap(vertexCount);
+		std::iota(remap.begin(), remap.end(), 0u);
+
+		const auto find{[&remap](uint32_t v)
+						{
+							while (remap[v] != v)
+							{
+								remap[v] = remap[remap[v]];
+								v = remap[v];
+							}
+							return v;
+						}};
+
+		const auto collapseError{[&](const uint32_t from, const uint32_t to)
+								 {
+									 Quadric q{quadrics[positionOf[from]]};
+									 q += quadrics[positionOf[to]];
+									 const float* p{vertices[to].position};
+									 return q.evaluate(p[0], p[1], p[2]);
+								 }};
+
+		// Moving `from` onto `to` must not flip any triangle that survives the collapse
+		const auto flips{[&](const uint32_t from, const uint32_t to)
+						 {
+							 for (const uint32_t t : vertexTriangles[from])
+							 {
+								 uint32_t tri[3]{find(indices[t * 3]), find(indices[t * 3 + 1]),
+												 find(indices[t * 3 + 2])};
+								 if (tri[0] == tri[1] || tri[1] == tri[2] || tri[0] == tri[2])
+									 continue;
+								 if (tri[0] == to || tri[1] == to || tri[2] == to)
+									 continue;
+
+								 const auto normal{[&](const uint32_t (&v)[3])
+												   {
+													   const float* a{vertices[v[0]].position};
+													   const float* b{vertices[v[1]].position};
+													   const float* c{vertices[v[2]].position};
+													   const Vec3 ab{b[0] - a[0], b[1] - a[1],
+																	 b[2] - a[2]};
+													   const Vec3 ac{c[0] - a[0], c[1] - a[1],
+																	 c[2] - a[2]};
+													   return ab.cross(ac);
+												   }};
+
+								 const Vec3 before{normal(tri)};
+								 for (uint32_t& v : tri)
+									 if (v == from)
+										 v = to;
+								 const Vec3 after{normal(tri)};
+
+								 if (before.dot(after) <= 0.0f)
+									 return true;
+							 }
+							 return false;
+						 }};
+
+		std::priority_queue<Collapse, std::vector<Collapse>, std::greater<>> heap;
+		const auto pushCandidates{[&](const uint32_t v)
+								  {
+									  if (locked[positionOf[v]])
+										  return;
+
+									  for (const uint32_t t : vertexTriangles[v])
+									  {
+										  for (int k = 0; k < 3; ++k)
+										  {
+											  const uint32_t other{find(indices[t * 3 + k])};
+											  if (other != v && positionOf[other] != positionOf[v])
+												  heap.push({collapseError(v, other), v, other});
+										  }
+									  }
+								  }};
+
+		for (uint32_t v = 0; v < vertexCount; ++v)
+			pushCandidates(v);
+
+		size_t liveIndices{indices.size()};
+		double worstError{};
+
+		while (liveIndices > targetIndexCount && !heap.empty())
+		{
+			const Collapse candidate{heap.top()};
+			heap.pop();
+
+			if (candidate.error > maxError)
+				break;
+
+			const uint32_t from{candidate.from};
+			if (remap[from] != from)
+				continue; // Already collapsed
+
+			const uint32_t to{find(candidate.to)};
+			if (to == from)
+				continue;
+
+			// Quadrics grow as collapses accumulate; re-queue stale candidates at their new cost
+			const double error{collapseError(from, to)};
+			if (error > candidate.error * (1.0 + 1e-6) + 1e-12)
+			{
+				heap.push({error, from, to});
+				continue;
+			}
+
+			if (flips(from, to))
+				continue;
+
+			size_t removedTriangles{};
+			for (const uint32_t t : vertexTriangles[from])
+			{
+				const uint32_t a{find(indices[t * 3])}, b{find(indices[t * 3 + 1])},
+						c{find(indices[t * 3 + 2])};
+				if (a == b || b == c || a == c)
+					continue;
+				if (a == to || b == to || c == to)
+					++removedTriangles;
+			}
+
+			remap[from] = to;
+			quadrics[positionOf[to]] += quadrics[positionOf[from]];
+			vertexTriangles[to].insert(vertexTriangles[to].end(), vertexTriangles[from].begin(),
+									   vertexTriangles[from].end());
+			vertexTriangles[from].clear();
+			liveIndices -= removedTriangles * 3;
+			worstError = std::max(worstError, error);
+
+			pushCandidates(to);
+		}
+
+		std::vector<uint32_t> result;
+		result.reserve(liveIndices);
+		for (size_t t = 0; t < triangleCount; ++t)
+		{
+			const uint32_t a{find(indices[t * 3])}, b{find(indices[t * 3 + 1])},
+					c{find(indices[t * 3 + 2])};
+			if (a == b || b == c || a == c)
+				continue;
+
+			result.push_back(a);
+			result.push_back(b);
+			result.push_back(c);
+		}
+
+		if (resultError)
+			*resultError = static_cast<float>(std::sqrt(worstError) / extent);
+
+		return result;
+	}
+
+	std::vector<Meshlet> MeshCooker::buildMeshlets(const std::span<const MeshVertex> vertices,
+												   const std::span<const uint32_t> indices,
+												   uint32_t maxVertices, uint32_t maxTriangles,
+												   std::vector<uint32_t>& meshletVertices,
+												   std::vector<uint8_t>& meshletTriangles)
+	{
+		// Local indices are stored as bytes
+		maxVertices = std::clamp(maxVertices, 3u, 256u);
+		maxTriangles = std::max(maxTriangles, 1u);
+
+		std::vector<Meshlet> meshlets;
+		std::vector<int> localIndex(vertices.size(), -1);
+
+		const auto begin{[&]
+						 {
+							 return Meshlet{
+									 .vertexOffset = static_cast<uint32_t>(meshletVertices.size()),
+									 .triangleOffset = static_cast<uint32_t>(meshletTriangles.size()),
+							 };
+						 }};
+		Meshlet current{begin()};
+
+		const auto flush{[&]
+						 {
+							 if (current.triangleCount == 0)
+								 return;
+
+							 const uint32_t* used{meshletVertices.data() + current.vertexOffset};
+							 computeBounds(vertices, used, current.vertexCount, current.center,
+										   current.radius);
+
+							 for (uint32_t i = 0; i < current.vertexCount; ++i)
+								 localIndex[used[i]] = -1;
+
+							 // Keep every meshlet's triangle block 4-byte aligned
+							 while (meshletTriangles.size() % 4 != 0)
+								 meshletTriangles.push_back(0);
+
+							 meshlets.push_back(current);
+							 current = begin();
+						 }};
+
+		for (size_t i = 0; i + 2 < indices.size(); i += 3)
+		{
+			const uint32_t tri[3]{indices[i], indices[i + 1], indices[i + 2]};
+			const uint32_t newVertices{(localIndex[tri[0]] < 0 ? 1u : 0u) +
+									   (localIndex[tri[1]] < 0 ? 1u : 0u) +
+									   (localIndex[tri[2]] < 0 ? 1u : 0u)};
+
+			if (current.vertexCount + newVertices > maxVertices ||
+				current.triangleCount + 1 > maxTriangles)
+			{
+				flush();
+			}
+
+			for (const uint32_t v : tri)
+			{
+				if (localIndex[v] < 0)
+				{
+					localIndex[v] = static_cast<int>(current.vertexCount++);
+					meshletVertices.push_back(v);
+				}
+				meshletTriangles.push_back(static_cast<uint8_t>(localIndex[v]));
+			}
+			++current.triangleCount;
+		}
+
+		flush();
+		return meshlets;
+	}
+} // namespace lune
@@ -0,0 +1,112 @@
+module;
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+export module lune:mesh_cooker;
+
+import :mesh;
+
+namespace lune
+{
+	/**
+	 * @brief Uncooked triangle mesh, as produced by a source format importer.
+	 */
+	export struct MeshSource
+	{
+		std::vector<MeshVertex> vertices;
+		std::vector<uint32_t> indices; ///< Triangle list.
+	};
+
+
+	/**
+	 * @brief Options controlling how a mesh is cooked.
+	 */
+	export struct MeshCookInfo
+	{
+		MeshLayout layout{MESH_INTERLEAVED}; ///< Vertex stream layout.
+		uint32_t maxLodCount{4};			 ///< Maximum number of LODs, including LOD 0.
+		float lodReduction{0.5f};	///< Target ratio of triangles between consecutive LODs.
+		float maxLodError{0.05f};	///< Max simplification error relative to the mesh extent.
+		bool buildMeshlets{true};	///< Whether to split LOD 0 into meshlets.
+		uint32_t maxMeshletVertices{64};
+		uint32_t maxMeshletTriangles{124};
+	};
+
+
+	/**
+	 * @brief Offline conversion of source meshes into the binary `.lmesh` format read by
+	 * `MeshFile`.
+	 */
+	export class MeshCooker
+	{
+	public:
+		/**
+		 * @brief Imports a Wavefront OBJ file. Polygons are triangulated and identical
+		 * position/uv/normal combinations are merged into a single vertex.
+		 *
+		 * @param path Path to the `.obj` file.
+		 *
+		 * @return The imported mesh; std::nullopt if the file could not be read or has no faces.
+		 */
+		static std::optional<MeshSource> loadObj(const std::string& path);
+
+		/**
+		 * @brief Cooks a mesh into the in-memory representation of a `.lmesh` file.
+		 *
+		 * @param source Mesh to cook.
+		 * @param info Cooking options.
+		 *
+		 * @return The file contents, ready to be written to disk.
+		 */
+		static std::vector<std::byte> cook(const MeshSource& source, const MeshCookInfo& info = {});
+
+		/**
+		 * @brief Cooks a mesh and writes it to disk.
+		 *
+		 * @return true if the file was written successfully.
+		 */
+		static bool cookToFile(const MeshSource& source, const std::string& path,
+							   const MeshCookInfo& info = {});
+
+		/**
+		 * @brief Reduces the triangle count of a mesh using quadric error metric edge collapses.
+		 *
+		 * Vertices on open borders and attribute seams are locked, and vertices are only collapsed
+		 * onto existing vertices, so the result indexes the original vertex buffer.
+		 *
+		 * @param vertices Vertex buffer.
+		 * @param indices Triangle list to simplify.
+		 * @param targetIndexCount Index count to stop at.
+		 * @param targetError Maximum error relative to the mesh extent.
+		 * @param resultError Optional output for the error of the returned triangle list.
+		 *
+		 * @return Simplified triangle list.
+		 */
+		static std::vector<uint32_t> simplify(std::span<const MeshVertex> vertices,
+											  std::span<const uint32_t> indices,
+											  size_t targetIndexCount, float targetError,
+											  float* resultError = nullptr);
+
+		/**
+		 * @brief Greedily splits a triangle list into meshlets.
+		 *
+		 * @param vertices Vertex buffer.
+		 * @param indices Triangle list to split.
+		 * @param maxVertices Maximum unique vertices per meshlet (at most 256).
+		 * @param maxTriangles Maximum triangles per meshlet.
+		 * @param meshletVertices Output table of vertex indices referenced by meshlets.
+		 * @param meshletTriangles Output table of local triangle indices, padded to 4 bytes
+		 * per meshlet.
+		 *
+		 * @return The meshlets.
+		 */
+		static std::vector<Meshlet> buildMeshlets(std::span<const MeshVertex> vertices,
+												  std::span<const uint32_t> indices,
+												  uint32_t maxVertices, uint32_t maxTriangles,
+												  std::vector<uint32_t>& meshletVertices,
+												  std::vector<uint8_t>& meshletTriangles);
+	};
+} // namespace lune
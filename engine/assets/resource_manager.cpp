@@ -0,0 +1,405 @@
+module;
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+module lune;
+
+namespace lune
+{
+	namespace
+	{
+		/// Spelling-independent path, so "./textures/a.png" and "textures/a.png" share a resource.
+		std::string normalizePath(const std::string& path)
+		{
+			return std::filesystem::path(path).lexically_normal().generic_string();
+		}
+
+		[[nodiscard]] bool fits(const ResourceMemory& usage, const ResourceMemory& budget) noexcept
+		{
+			return usage.cpuBytes <= budget.cpuBytes && usage.gpuBytes <= budget.gpuBytes;
+		}
+
+		void addMemory(ResourceMemory& usage, const ResourceMemory& memory) noexcept
+		{
+			usage.cpuBytes += memory.cpuBytes;
+			usage.gpuBytes += memory.gpuBytes;
+		}
+
+		void subtractMemory(ResourceMemory& usage, const ResourceMemory& memory) noexcept
+		{
+			usage.cpuBytes -= memory.cpuBytes;
+			usage.gpuBytes -= memory.gpuBytes;
+		}
+	} // namespace
+
+	ResourceManager::ResourceManager(JobSystem* jobs, const ResourceMemory budget) :
+		m_jobs(jobs), m_budget(budget)
+	{
+	}
+
+	ResourceManager::~ResourceManager()
+	{
+		waitIdle();
+	}
+
+	void ResourceManager::update()
+	{
+		// Evicted resources are destroyed after the lock is released
+		std::vector<std::shared_ptr<void>> evicted;
+		const std::lock_guard lock{m_mutex};
+
+		// Resources used during the frame that just ended stay loaded
+		const uint64_t lastFrame{m_frame++};
+		if (fits(m_usage, m_budget))
+			return;
+
+		std::vector<uint32_t> candidates;
+		for (uint32_t index = 0; index < m_slots.size(); ++index)
+		{
+			const Slot& slot{m_slots[index]};
+			if (slot.state == RESOURCE_READY && !slot.pinned && slot.lastUsed < lastFrame)
+				candidates.push_back(index);
+		}
+
+		std::sort(candidates.begin(), candidates.end(), [&](const uint32_t a, const uint32_t b)
+				  { return m_slots[a].lastUsed < m_slots[b].lastUsed; });
+
+		for (const uint32_t index : candidates)
+		{
+			if (fits(m_usage, m_budget))
+				break;
+
+			Slot& slot{m_slots[index]};
+			evicted.push_back(std::move(slot.resource));
+			subtractMemory(m_usage, slot.memory);
+			slot.memory = {};
+			slot.state = RESOURCE_EVICTED;
+			++m_evictionCount;
+		}
+	}
+
+	void ResourceManager::waitIdle()
+	{
+		if (m_jobs)
+			m_jobs->wait(m_loads);
+	}
+
+	void ResourceManager::setBudget(const ResourceMemory& budget)
+	{
+		const std::lock_guard lock{m_mutex};
+		m_budget = budget;
+	}
+
+	ResourceMemory ResourceManager::budget() const
+	{
+		const std::lock_guard lock{m_mutex};
+		return m_budget;
+	}
+
+	ResourceMemory ResourceManager::usage() const
+	{
+		const std::lock_guard lock{m_mutex};
+		return m_usage;
+	}
+
+	size_t ResourceManager::resourceCount() const
+	{
+		const std::lock_guard lock{m_mutex};
+		return m_slots.size() - m_freeSlots.size();
+	}
+
+	size_t ResourceManager::evictionCount() const
+	{
+		const std::lock_guard lock{m_mutex};
+		return m_evictionCount;
+	}
+
+	ResourceLoader<gfx::Texture> ResourceManager::textureLoader(const gfx::Context& context)
+	{
+		return [&context](const std::string& path) -> std::optional<LoadedResource<gfx::Texture>>
+		{
+			// Texture::load reports failures but leaves the texture empty, so check beforehand
+			if (!Vfs::exists(path))
+			{
+				std::cerr << "Texture not found: " << path << "\n";
+				return std::nullopt;
+			}
+
+			auto texture{std::make_unique<gfx::Texture>(
+					context.createTexture({.pixelFormat = gfx::RGBA8_UNorm}))};
+			texture->load(path);
+
+			const size_t pixels{static_cast<size_t>(texture->width()) *
+								static_cast<size_t>(texture->height())};
+			const size_t levels{texture->mipmapped() ? 4 * pixels / 3 : pixels};
+			return LoadedResource<gfx::Texture>{std::move(texture), {0, levels * 4}};
+		};
+	}
+
+	ResourceLoader<gfx::Shader> ResourceManager::shaderLoader(const gfx::Context& context)
+	{
+		return [&context](const std::string& path) -> std::optional<LoadedResource<gfx::Shader>>
+		{
+			if (!Vfs::exists(path))
+			{
+				std::cerr << "Shader not found: " << path << "\n";
+				return std::nullopt;
+			}
+
+			return LoadedResource<gfx::Shader>{
+					std::make_unique<gfx::Shader>(context.createShader({.path = path})), {}};
+		};
+	}
+
+	void ResourceManager::setType(const uint32_t type, ErasedLoader loader,
+								  std::shared_ptr<void> placeholder)
+	{
+		std::shared_ptr<void> previous;
+		const std::lock_guard lock{m_mutex};
+
+		if (m_types.size() <= type)
+			m_types.resize(type + 1);
+
+		m_types[type].loader = std::move(loader);
+		previous = std::exchange(m_types[type].placeholder, std::move(placeholder));
+	}
+
+	std::pair<uint32_t, uint32_t> ResourceManager::acquire(const uint32_t type,
+														   const std::string& path)
+	{
+		std::optional<PendingLoad> pending;
+		std::pair<uint32_t, uint32_t> handle;
+		{
+			const std::lock_guard lock{m_mutex};
+
+			std::string key{normalizePath(path)};
+			if (const auto it{m_lookup.find({type, key})}; it != m_lookup.end())
+			{
+				Slot& slot{m_slots[it->second]};
+				++slot.references;
+				return {it->second, slot.generation};
+			}
+
+			const uint32_t index{allocateSlot()};
+			Slot& slot{m_slots[index]};
+			slot.path = std::move(key);
+			slot.type = type;
+			slot.references = 1;
+			slot.lastUsed = m_frame;
+			m_lookup.emplace(std::pair{type, slot.path}, index);
+
+			handle = {index, slot.generation};
+			pending = beginLoad(index);
+		}
+
+		if (pending)
+			dispatch(std::move(*pending));
+		return handle;
+	}
+
+	std::pair<uint32_t, uint32_t> ResourceManager::insert(const uint32_t type,
+														  ErasedResource resource,
+														  const std::string& name)
+	{
+		const std::lock_guard lock{m_mutex};
+
+		if (!name.empty())
+		{
+			if (const auto it{m_lookup.find({type, name})}; it != m_lookup.end())
+			{
+				Slot& slot{m_slots[it->second]};
+				++slot.references;
+				return {it->second, slot.generation};
+			}
+		}
+
+		const uint32_t index{allocateSlot()};
+		Slot& slot{m_slots[index]};
+		slot.path = name;
+		slot.type = type;
+		slot.references = 1;
+		slot.state = RESOURCE_READY;
+		slot.pinned = true;
+		slot.resource = std::move(resource.resource);
+		slot.memory = resource.memory;
+		slot.lastUsed = m_frame;
+		addMemory(m_usage, slot.memory);
+
+		if (!name.empty())
+			m_lookup.emplace(std::pair{type, name}, index);
+
+		return {index, slot.generation};
+	}
+
+	const void* ResourceManager::use(const uint32_t type, const uint32_t index,
+									 const uint32_t generation)
+	{
+		std::optional<PendingLoad> pending;
+		const void* placeholder{};
+		{
+			const std::lock_guard lock{m_mutex};
+
+			Slot* slot{find(type, index, generation)};
+			if (!slot)
+				return nullptr;
+
+			slot->lastUsed = m_frame;
+			if (slot->state == RESOURCE_READY)
+				return slot->resource.get();
+
+			placeholder = type < m_types.size() ? m_types[type].placeholder.get() : nullptr;
+			if (slot->state == RESOURCE_EVICTED)
+				pending = beginLoad(index);
+		}
+
+		if (!pending)
+			return placeholder;
+
+		dispatch(std::move(*pending));
+		if (m_jobs)
+			return placeholder;
+
+		// Without a job system the resource was reloaded right away
+		const std::lock_guard lock{m_mutex};
+		const Slot* slot{find(type, index, generation)};
+		return slot && slot->state == RESOURCE_READY ? slot->resource.get() : placeholder;
+	}
+
+	ResourceState ResourceManager::stateOf(const uint32_t type, const uint32_t index,
+										   const uint32_t generation) const
+	{
+		const std::lock_guard lock{m_mutex};
+		const Slot* slot{find(type, index, generation)};
+		return slot ? slot->state : RESOURCE_INVALID;
+	}
+
+	void ResourceManager::addReference(const uint32_t type, const uint32_t index,
+									   const uint32_t generation)
+	{
+		const std::lock_guard lock{m_mutex};
+		if (Slot* slot{find(type, index, generation)})
+			++slot->references;
+	}
+
+	void ResourceManager::removeReference(const uint32_t type, const uint32_t index,
+										  const uint32_t generation)
+	{
+		// The resource is destroyed after the lock is released
+		std::shared_ptr<void> released;
+		const std::lock_guard lock{m_mutex};
+
+		Slot* slot{find(type, index, generation)};
+		if (!slot || --slot->references > 0)
+			return;
+
+		// A load still in flight finds the generation changed and drops its result
+		if (slot->state == RESOURCE_READY)
+			subtractMemory(m_usage, slot->memory);
+		if (!slot->path.empty())
+			m_lookup.erase({type, slot->path});
+
+		released = std::move(slot->resource);
+		*slot = Slot{.generation = slot->generation + 1};
+		m_freeSlots.push_back(index);
+	}
+
+	ResourceManager::Slot* ResourceManager::find(const uint32_t type, const uint32_t index,
+												 const uint32_t generation)
+	{
+		if (index >= m_slots.size())
+			return nullptr;
+
+		Slot& slot{m_slots[index]};
+		const bool live{slot.state != RESOURCE_INVALID && slot.generation == generation};
+		return live && slot.type == type ? &slot : nullptr;
+	}
+
+	const ResourceManager::Slot* ResourceManager::find(const uint32_t type, const uint32_t index,
+													   const uint32_t generation) const
+	{
+		return const_cast<ResourceManager*>(this)->find(type, index, generation);
+	}
+
+	uint32_t ResourceManager::allocateSlot()
+	{
+		if (!m_freeSlots.empty())
+		{
+			const uint32_t index{m_freeSlots.back()};
+			m_freeSlots.pop_back();
+			return index;
+		}
+
+		m_slots.emplace_back();
+		return static_cast<uint32_t>(m_slots.size() - 1);
+	}
+
+	std::optional<ResourceManager::PendingLoad> ResourceManager::beginLoad(const uint32_t index)
+	{
+		Slot& slot{m_slots[index]};
+		if (slot.type >= m_types.size() || !m_types[slot.type].loader)
+		{
+			std::cerr << "No loader registered for resource: " << slot.path << "\n";
+			slot.state = RESOURCE_FAILED;
+			return std::nullopt;
+		}
+
+		slot.state = RESOURCE_LOADING;
+		return PendingLoad{m_types[slot.type].loader, slot.path, index, slot.generation};
+	}
+
+	void ResourceManager::dispatch(PendingLoad load)
+	{
+		auto run{[this, load = std::move(load)]
+				 {
+					 // A throwing loader fails the load instead of the next waitIdle()
+					 std::optional<ErasedResource> result;
+					 try
+					 {
+						 result = load.loader(load.path);
+					 }
+					 catch (const std::exception& e)
+					 {
+						 std::cerr << "Loader of " << load.path << " threw: " << e.what() << "\n";
+					 }
+					 complete(load.index, load.generation, std::move(result));
+				 }};
+
+		if (m_jobs)
+			m_jobs->submit(std::move(run), &m_loads);
+		else
+			run();
+	}
+
+	void ResourceManager::complete(const uint32_t index, const uint32_t generation,
+								   std::optional<ErasedResource> result)
+	{
+		const std::lock_guard lock{m_mutex};
+
+		// Released while loading: the result is dropped, after the lock is released
+		if (index >= m_slots.size() || m_slots[index].generation != generation ||
+			m_slots[index].state != RESOURCE_LOADING)
+			return;
+
+		Slot& slot{m_slots[index]};
+		if (!result)
+		{
+			std::cerr << "Failed to load resource: " << slot.path << "\n";
+			slot.state = RESOURCE_FAILED;
+			return;
+		}
+
+		slot.resource = std::move(result->resource);
+		slot.memory = result->memory;
+		slot.state = RESOURCE_READY;
+		addMemory(m_usage, slot.memory);
+	}
+} // namespace lune
@@ -0,0 +1,337 @@
+module;
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+export module lune:resource_manager;
+
+import lune.gfx;
+import lune.jobs;
+
+namespace lune
+{
+	/**
+	 * @brief Handle of a resource of a `ResourceManager`. The generation tells a released resource
+	 * apart from a later one reusing its slot.
+	 */
+	export template <typename T> struct ResourceHandle
+	{
+		static constexpr uint32_t NULL_INDEX{std::numeric_limits<uint32_t>::max()};
+
+		uint32_t index{NULL_INDEX};
+		uint32_t generation{};
+
+		[[nodiscard]] constexpr bool isNull() const noexcept
+		{
+			return index == NULL_INDEX;
+		}
+
+		constexpr bool operator==(const ResourceHandle&) const noexcept = default;
+	};
+
+
+	export enum ResourceState
+	{
+		RESOURCE_LOADING, ///< Queued or loading; the placeholder stands in.
+		RESOURCE_READY,
+		RESOURCE_EVICTED, ///< Unloaded to stay within the budget; reloaded on the next `get()`.
+		RESOURCE_FAILED,  ///< The loader failed; the placeholder stands in for good.
+		RESOURCE_INVALID  ///< The handle is null or was released.
+	};
+
+
+	/**
+	 * @brief Memory held by resources, split by where it lives.
+	 */
+	export struct ResourceMemory
+	{
+		size_t cpuBytes{};
+		size_t gpuBytes{};
+
+		constexpr bool operator==(const ResourceMemory&) const noexcept = default;
+	};
+
+	export inline constexpr ResourceMemory UNLIMITED_RESOURCE_BUDGET{
+			std::numeric_limits<size_t>::max(), std::numeric_limits<size_t>::max()};
+
+
+	/**
+	 * @brief A resource produced by a loader, with the memory it holds.
+	 */
+	export template <typename T> struct LoadedResource
+	{
+		std::unique_ptr<T> resource;
+		ResourceMemory memory;
+	};
+
+	/// Loads a resource from a path on a job system thread; std::nullopt on failure.
+	export template <typename T>
+	using ResourceLoader = std::function<std::optional<LoadedResource<T>>(const std::string& path)>;
+
+
+	/**
+	 * @brief Owns shared resources (textures, shaders, ...) and streams them within a memory
+	 * budget.
+	 *
+	 * Resources are requested by path and referred to by handles. Requesting a path that is
+	 * already loaded, or loading, shares the resource instead of loading it again. Loads run on
+	 * the job system; until a resource is ready, `get()` returns the placeholder registered for
+	 * its type, so rendering never waits on the disk.
+	 *
+	 * Once per frame, `update()` keeps the loaded resources within the CPU and GPU budgets by
+	 * evicting the least recently used ones. Evicted resources keep their handles and are loaded
+	 * again the next time they are used, so a large world streams within fixed memory.
+	 * Resources used during the last frame, and resources added from memory, are never evicted.
+	 *
+	 * @code
+	 * ResourceManager resources{&JobSystem::instance(),
+	 *                           {.cpuBytes = 256 << 20, .gpuBytes = 1 << 30}};
+	 * resources.registerLoader(ResourceManager::textureLoader(ctx), std::move(checkerboard));
+	 *
+	 * const ResourceHandle<gfx::Texture> albedo{resources.load<gfx::Texture>("textures/rock.png")};
+	 * ...
+	 * material.setUniform("albedo", *resources.get(albedo)); // The checkerboard until it's loaded
+	 * resources.update();
+	 * ...
+	 * resources.release(albedo);
+	 * @endcode
+	 *
+	 * Every `load()` or `add()` must be paired with a `release()`; the resource is destroyed when
+	 * its last reference is released. All members are thread-safe.
+	 */
+	export class ResourceManager
+	{
+		struct ErasedResource
+		{
+			std::shared_ptr<void> resource;
+			ResourceMemory memory;
+		};
+
+		using ErasedLoader = std::function<std::optional<ErasedResource>(const std::string& path)>;
+
+		struct TypeInfo
+		{
+			ErasedLoader loader;
+			std::shared_ptr<void> placeholder;
+		};
+
+		struct Slot
+		{
+			std::string path; ///< Normalized path the resource is shared by; empty if unnamed.
+			uint32_t type{};
+			uint32_t generation{};
+			uint32_t references{};
+			ResourceState state{RESOURCE_INVALID};
+			bool pinned{}; ///< Added from memory, so it can't be reloaded after an eviction.
+			std::shared_ptr<void> resource;
+			ResourceMemory memory;
+			uint64_t lastUsed{}; ///< Frame of the last `get()`.
+		};
+
+		/// A load to hand to the job system once the lock is released.
+		struct PendingLoad
+		{
+			ErasedLoader loader;
+			std::string path;
+			uint32_t index{};
+			uint32_t generation{};
+		};
+
+		static inline std::atomic<uint32_t> m_typeCount{0};
+
+		JobSystem* m_jobs;
+		JobCounter m_loads;
+
+		mutable std::mutex m_mutex;
+		std::vector<Slot> m_slots;
+		std::vector<uint32_t> m_freeSlots;
+		std::map<std::pair<uint32_t, std::string>, uint32_t> m_lookup;
+		std::vector<TypeInfo> m_types; ///< Indexed by type id.
+
+		ResourceMemory m_budget;
+		ResourceMemory m_usage;
+		uint64_t m_frame{1};
+		size_t m_evictionCount{};
+
+	public:
+		/**
+		 * @param jobs Job system to load on; nullptr to load on the thread requesting a resource.
+		 * @param budget Memory the loaded resources may hold before the least recently used are
+		 * evicted.
+		 */
+		explicit ResourceManager(JobSystem* jobs = &JobSystem::instance(),
+								 ResourceMemory budget = UNLIMITED_RESOURCE_BUDGET);
+
+		/**
+		 * @brief Waits for the loads in flight, then destroys every resource.
+		 */
+		~ResourceManager();
+
+		ResourceManager(const ResourceManager&) = delete;
+		ResourceManager& operator=(const ResourceManager&) = delete;
+
+		/**
+		 * @brief Sets how resources of a type are loaded from a path.
+		 *
+		 * @param placeholder Returned by `get()` while a resource of the type isn't ready;
+		 * nullptr for none.
+		 */
+		template <typename T>
+		void registerLoader(ResourceLoader<T> loader, std::unique_ptr<T> placeholder = nullptr)
+		{
+			setType(typeId<T>(),
+					[loader = std::move(loader)](const std::string& path)
+							-> std::optional<ErasedResource>
+					{
+						auto loaded{loader(path)};
+						if (!loaded || !loaded->resource)
+							return std::nullopt;
+						return ErasedResource{std::move(loaded->resource), loaded->memory};
+					},
+					std::move(placeholder));
+		}
+
+		/**
+		 * @brief Gets a handle to the resource at a path, loading it in the background if it
+		 * isn't already loaded or loading.
+		 *
+		 * @param path Path handed to the loader of the type, usually a `Vfs` path.
+		 */
+		template <typename T> [[nodiscard]] ResourceHandle<T> load(const std::string& path)
+		{
+			const auto [index, generation]{acquire(typeId<T>(), path)};
+			return {index, generation};
+		}
+
+		/**
+		 * @brief Adds a resource created in memory (e.g. a generated buffer).
+		 *
+		 * It can't be reloaded, so it is never evicted, but it counts towards the budget.
+		 *
+		 * @param name Name to share the resource by, e.g. a hash of its contents; if a resource
+		 * of this type and name exists, it is shared and `resource` is dropped. Empty for none.
+		 */
+		template <typename T>
+		[[nodiscard]] ResourceHandle<T> add(std::unique_ptr<T> resource,
+											const ResourceMemory& memory = {},
+											const std::string& name = {})
+		{
+			const auto [index, generation]{
+					insert(typeId<T>(), ErasedResource{std::move(resource), memory}, name)};
+			return {index, generation};
+		}
+
+		/**
+		 * @brief Gets a resource and marks it as used this frame.
+		 *
+		 * @return The resource if it is ready, otherwise the placeholder of its type (or
+		 * nullptr). Valid until the next `update()` or `release()` of the handle.
+		 */
+		template <typename T> [[nodiscard]] const T* get(const ResourceHandle<T> handle)
+		{
+			return static_cast<const T*>(use(typeId<T>(), handle.index, handle.generation));
+		}
+
+		template <typename T>
+		[[nodiscard]] ResourceState state(const ResourceHandle<T> handle) const
+		{
+			return stateOf(typeId<T>(), handle.index, handle.generation);
+		}
+
+		/**
+		 * @brief Adds a reference to a resource, to be paired with a `release()`.
+		 */
+		template <typename T> void retain(const ResourceHandle<T> handle)
+		{
+			addReference(typeId<T>(), handle.index, handle.generation);
+		}
+
+		/**
+		 * @brief Drops a reference to a resource, destroying it with the last one. Does nothing
+		 * for null or already released handles.
+		 */
+		template <typename T> void release(const ResourceHandle<T> handle)
+		{
+			removeReference(typeId<T>(), handle.index, handle.generation);
+		}
+
+		/**
+		 * @brief Ends a frame and evicts the least recently used resources until the loaded ones
+		 * fit the budget. Call once per frame.
+		 */
+		void update();
+
+		/**
+		 * @brief Waits for every load in flight, e.g. behind a loading screen.
+		 */
+		void waitIdle();
+
+		void setBudget(const ResourceMemory& budget);
+
+		[[nodiscard]] ResourceMemory budget() const;
+
+		/**
+		 * @brief Gets the memory held by the loaded resources.
+		 */
+		[[nodiscard]] ResourceMemory usage() const;
+
+		/**
+		 * @brief Counts the resources with live handles, loaded or not.
+		 */
+		[[nodiscard]] size_t resourceCount() const;
+
+		[[nodiscard]] size_t evictionCount() const;
+
+		/**
+		 * @brief Loads RGBA8 textures with `gfx::Texture::load`.
+		 *
+		 * @param context Context to create the textures with; must outlive the manager.
+		 */
+		[[nodiscard]] static ResourceLoader<gfx::Texture>
+		textureLoader(const gfx::Context& context);
+
+		/**
+		 * @brief Loads shaders with the default entry points of `gfx::ShaderDesc`.
+		 *
+		 * @param context Context to create the shaders with; must outlive the manager.
+		 */
+		[[nodiscard]] static ResourceLoader<gfx::Shader> shaderLoader(const gfx::Context& context);
+
+	private:
+		template <typename T> static uint32_t typeId()
+		{
+			static const uint32_t id{m_typeCount.fetch_add(1, std::memory_order_relaxed)};
+			return id;
+		}
+
+		void setType(uint32_t type, ErasedLoader loader, std::shared_ptr<void> placeholder);
+
+		std::pair<uint32_t, uint32_t> acquire(uint32_t type, const std::string& path);
+		std::pair<uint32_t, uint32_t> insert(uint32_t type, ErasedResource resource,
+											 const std::string& name);
+		const void* use(uint32_t type, uint32_t index, uint32_t generation);
+		[[nodiscard]] ResourceState stateOf(uint32_t type, uint32_t index,
+											uint32_t generation) const;
+		void addReference(uint32_t type, uint32_t index, uint32_t generation);
+		void removeReference(uint32_t type, uint32_t index, uint32_t generation);
+
+		[[nodiscard]] Slot* find(uint32_t type, uint32_t index, uint32_t generation);
+		[[nodiscard]] const Slot* find(uint32_t type, uint32_t index, uint32_t generation) const;
+		[[nodiscard]] uint32_t allocateSlot();
+		[[nodiscard]] std::optional<PendingLoad> beginLoad(uint32_t index);
+
+		/**
+		 * @brief Runs a load on the job system, or right away without one.
+		 */
+		void dispatch(PendingLoad load);
+		void complete(uint32_t index, uint32_t generation, std::optional<ErasedResource> result);
+	};
+} // namespace lune
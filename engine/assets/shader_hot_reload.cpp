@@ -0,0 +1,26 @@
+module;
+#include <memory>
+#include <string>
+module lune;
+
+import lune.gfx;
+
+namespace lune
+{
+	void ShaderHotReload::start()
+	{
+		if (m_watcher)
+			return;
+
+		m_watcher = std::make_unique<FileWatcher>([](const std::string& path)
+												  { gfx::HotReload::reload(path); });
+		gfx::HotReload::setWatchCallback([](const std::string& path) { m_watcher->watch(path); });
+	}
+
+	void ShaderHotReload::stop()
+	{
+		// Unhook first so no shader created meanwhile reaches the watcher being destroyed
+		gfx::HotReload::setWatchCallback({});
+		m_watcher.reset();
+	}
+} // namespace lune
@@ -0,0 +1,34 @@
+module;
+#include <memory>
+export module lune:shader_hot_reload;
+
+import lune.gfx;
+import :file_watcher;
+
+namespace lune
+{
+	/**
+	 * @brief Recompiles shaders when their source files change.
+	 *
+	 * While running, every shader source registered with `gfx::HotReload` is watched. Changed
+	 * shaders and the pipelines and kernels built from them are recompiled on the watcher
+	 * thread, and `Window::pollEvents` swaps them in before the next frame, so the frame loop
+	 * never waits on the compiler. A shader that fails to compile keeps its previous version.
+	 *
+	 * Started automatically by `Window::create` if `LUNE_SHADER_HOT_RELOAD` is set, and then
+	 * stopped when the process exits.
+	 */
+	export class ShaderHotReload
+	{
+		static inline std::unique_ptr<FileWatcher> m_watcher;
+
+	public:
+		static void start();
+		static void stop();
+
+		[[nodiscard]] static bool isRunning() noexcept
+		{
+			return m_watcher != nullptr;
+		}
+	};
+} // namespace lune
@@ -6,4 +6,10 @@ export import :types;
 export import :texture;
 export import :render_surface;
 export import :graphics;
-export import :compute;
\ No newline at end of file
+export import :compute;
+export import :timing;
+export import :hot_reload;
+export import :shader_reflection;
+export import :warmup;
+export import :render_queue;
+export import :staging;
\ No newline at end of file
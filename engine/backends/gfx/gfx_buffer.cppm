@@ -1,5 +1,7 @@
 module;
+#include <functional>
 #include <memory>
+#include <span>
 export module lune.gfx:buffer;
 
 import :types;
@@ -33,6 +35,9 @@ namespace lune::gfx
 
 		~Buffer() = default;
 
+		Buffer(Buffer&&) noexcept = default;
+		Buffer& operator=(Buffer&&) noexcept = default;
+
 		/**
 		 * @brief Gets the platform-specific implementation of a buffer.
 		 *
@@ -55,9 +60,50 @@ namespace lune::gfx
 			return m_impl->size();
 		}
 
+		/**
+		 * @brief Gets the CPU mapping of the buffer.
+		 *
+		 * @return nullptr for buffers the CPU can't access (`Private`, `Memoryless`); these are
+		 * filled and read through a `StagingManager`.
+		 */
 		[[nodiscard]] void* data() const noexcept
 		{
 			return m_impl->data();
 		}
 	};
+
+
+	/**
+	 * @brief A GPU-side copy between two buffers.
+	 */
+	export struct BufferCopy
+	{
+		const Buffer* source;
+		size_t sourceOffset;
+		const Buffer* destination;
+		size_t destinationOffset;
+		size_t size;
+	};
+
+
+	/**
+	 * @brief Backend queue running buffer copies in order with rendering and compute work: copies
+	 * see what was submitted before them and are seen by what is submitted after.
+	 *
+	 * @note Backends that can't copy on the GPU use the default from
+	 * `IContextImpl::createTransferQueue`, which copies on the CPU through `Buffer::data()`.
+	 */
+	export class ITransferQueueImpl
+	{
+	public:
+		virtual ~ITransferQueueImpl() = default;
+
+		/**
+		 * @brief Runs the copies in order without waiting for them.
+		 *
+		 * @param onComplete Called once every copy has finished, possibly from a backend thread.
+		 */
+		virtual void submit(std::span<const BufferCopy> copies,
+							std::function<void()> onComplete) = 0;
+	};
 } // namespace lune::gfx
@@ -0,0 +1,314 @@
+module;
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <lune/profiler.hpp>
+#include <span>
+#include <utility>
+#include <vector>
+module lune.gfx;
+
+import lune.jobs;
+import lune.profiler;
+
+namespace lune::gfx
+{
+	namespace
+	{
+		/// Elements per chunk; chunks are the unit of parallel work and of partial results.
+		constexpr size_t CHUNK_SIZE{64 * 1024};
+
+		constexpr size_t RADIX_BITS{8};
+		constexpr size_t RADIX{1 << RADIX_BITS};
+
+		size_t chunkCount(const size_t count) noexcept
+		{
+			return (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+		}
+
+		/**
+		 * @brief Calls `function(chunk, begin, end)` for every chunk of `[0, count)`, across the
+		 * job system if there is one and more than a single chunk.
+		 */
+		template <typename Function>
+		void forEachChunk(JobSystem* jobs, const size_t count, Function&& function)
+		{
+			const size_t chunks{chunkCount(count)};
+			const auto run{[&](const size_t first, const size_t last)
+						   {
+							   for (size_t chunk = first; chunk < last; ++chunk)
+							   {
+								   const size_t begin{chunk * CHUNK_SIZE};
+								   function(chunk, begin, std::min(begin + CHUNK_SIZE, count));
+							   }
+						   }};
+
+			if (jobs && chunks > 1)
+				jobs->parallelFor(chunks, 1, run);
+			else
+				run(0, chunks);
+		}
+
+		uint32_t sum(const uint32_t* values, const size_t count) noexcept
+		{
+			uint32_t total{};
+			for (size_t i = 0; i < count; ++i)
+				total += values[i];
+			return total;
+		}
+
+		void scan(const std::span<const uint32_t> input, const std::span<uint32_t> output,
+				  const bool inclusive, JobSystem* jobs)
+		{
+			if (output.size() < input.size())
+			{
+				std::cerr << "Scan output holds " << output.size() << " elements, "
+						  << input.size() << " needed\n";
+				return;
+			}
+
+			// Sum every chunk, then offset each chunk by the sums of the ones before it
+			std::vector<uint32_t> offsets(chunkCount(input.size()));
+			if (offsets.size() > 1)
+			{
+				forEachChunk(jobs, input.size(),
+							 [&](const size_t chunk, const size_t begin, const size_t end)
+							 { offsets[chunk] = sum(input.data() + begin, end - begin); });
+			}
+
+			uint32_t running{};
+			for (uint32_t& offset : offsets)
+				running += std::exchange(offset, running);
+
+			forEachChunk(jobs, input.size(),
+						 [&](const size_t chunk, const size_t begin, const size_t end)
+						 {
+							 uint32_t total{offsets[chunk]};
+							 for (size_t i = begin; i < end; ++i)
+							 {
+								 const uint32_t value{input[i]};
+								 output[i] = inclusive ? total + value : total;
+								 total += value;
+							 }
+						 });
+		}
+
+		template <typename Key>
+		void radixSort(const std::span<Key> keys, const std::span<uint32_t> values, JobSystem* jobs)
+		{
+			const bool hasValues{!values.empty()};
+			if (hasValues && values.size() != keys.size())
+			{
+				std::cerr << "Sort has " << keys.size() << " keys but " << values.size()
+						  << " values\n";
+				return;
+			}
+
+			const size_t count{keys.size()};
+			if (count < 2)
+				return;
+
+			std::vector<Key> keyScratch(count);
+			std::vector<uint32_t> valueScratch(hasValues ? count : 0);
+			Key* sourceKeys{keys.data()};
+			Key* destinationKeys{keyScratch.data()};
+			uint32_t* sourceValues{values.data()};
+			uint32_t* destinationValues{valueScratch.data()};
+
+			// Digit counts of every chunk, turned into the chunk's scatter offsets
+			std::vector<std::array<uint32_t, RADIX>> counts(chunkCount(count));
+
+			for (size_t shift = 0; shift < sizeof(Key) * 8; shift += RADIX_BITS)
+			{
+				const auto digit{[shift](const Key key)
+								 { return static_cast<size_t>(key >> shift) & (RADIX - 1); }};
+
+				forEachChunk(jobs, count,
+							 [&](const size_t chunk, const size_t begin, const size_t end)
+							 {
+								 std::array<uint32_t, RADIX>& chunkCounts{counts[chunk]};
+								 chunkCounts.fill(0);
+								 for (size_t i = begin; i < end; ++i)
+									 ++chunkCounts[digit(sourceKeys[i])];
+							 });
+
+				// Keys sharing this digit are already in order; skip the pass
+				bool uniform{false};
+				for (size_t d = 0; d < RADIX && !uniform; ++d)
+				{
+					size_t total{};
+					for (const auto& chunkCounts : counts)
+						total += chunkCounts[d];
+					uniform = total == count;
+				}
+				if (uniform)
+					continue;
+
+				// Digit-major offsets keep equal digits in chunk order, which keeps the sort stable
+				uint32_t running{};
+				for (size_t d = 0; d < RADIX; ++d)
+				{
+					for (auto& chunkCounts : counts)
+						running += std::exchange(chunkCounts[d], running);
+				}
+
+				forEachChunk(jobs, count,
+							 [&](const size_t chunk, const size_t begin, const size_t end)
+							 {
+								 std::array<uint32_t, RADIX>& offsets{counts[chunk]};
+								 for (size_t i = begin; i < end; ++i)
+								 {
+									 const uint32_t destination{offsets[digit(sourceKeys[i])]++};
+									 destinationKeys[destination] = sourceKeys[i];
+									 if (hasValues)
+										 destinationValues[destination] = sourceValues[i];
+								 }
+							 });
+
+				std::swap(sourceKeys, destinationKeys);
+				std::swap(sourceValues, destinationValues);
+			}
+
+			if (sourceKeys == keys.data())
+				return;
+
+			forEachChunk(jobs, count,
+						 [&](size_t, const size_t begin, const size_t end)
+						 {
+							 std::copy(sourceKeys + begin, sourceKeys + end, keys.data() + begin);
+							 if (hasValues)
+							 {
+								 std::copy(sourceValues + begin, sourceValues + end,
+										   values.data() + begin);
+							 }
+						 });
+		}
+	} // namespace
+
+	void CpuPrimitives::exclusiveScan(const std::span<const uint32_t> input,
+									  const std::span<uint32_t> output, JobSystem* jobs)
+	{
+		LUNE_ZONE("CpuPrimitives::exclusiveScan");
+		scan(input, output, false, jobs);
+	}
+
+	void CpuPrimitives::inclusiveScan(const std::span<const uint32_t> input,
+									  const std::span<uint32_t> output, JobSystem* jobs)
+	{
+		LUNE_ZONE("CpuPrimitives::inclusiveScan");
+		scan(input, output, true, jobs);
+	}
+
+	uint32_t CpuPrimitives::reduce(const std::span<const uint32_t> input, JobSystem* jobs)
+	{
+		LUNE_ZONE("CpuPrimitives::reduce");
+
+		std::vector<uint32_t> partials(chunkCount(input.size()));
+		forEachChunk(jobs, input.size(),
+					 [&](const size_t chunk, const size_t begin, const size_t end)
+					 { partials[chunk] = sum(input.data() + begin, end - begin); });
+
+		return sum(partials.data(), partials.size());
+	}
+
+	size_t CpuPrimitives::compact(const std::span<const uint32_t> input,
+								  const std::span<const uint32_t> flags,
+								  const std::span<uint32_t> output, JobSystem* jobs)
+	{
+		LUNE_ZONE("CpuPrimitives::compact");
+
+		if (flags.size() < input.size())
+		{
+			std::cerr << "Compaction has " << input.size() << " elements but " << flags.size()
+					  << " flags\n";
+			return 0;
+		}
+
+		std::vector<size_t> offsets(chunkCount(input.size()));
+		forEachChunk(jobs, input.size(),
+					 [&](const size_t chunk, const size_t begin, const size_t end)
+					 {
+						 size_t kept{};
+						 for (size_t i = begin; i < end; ++i)
+							 kept += flags[i] != 0;
+						 offsets[chunk] = kept;
+					 });
+
+		size_t total{};
+		for (size_t& offset : offsets)
+			total += std::exchange(offset, total);
+
+		if (output.size() < total)
+		{
+			std::cerr << "Compaction output holds " << output.size() << " elements, " << total
+					  << " needed\n";
+			return 0;
+		}
+
+		forEachChunk(jobs, input.size(),
+					 [&](const size_t chunk, const size_t begin, const size_t end)
+					 {
+						 size_t destination{offsets[chunk]};
+						 for (size_t i = begin; i < end; ++i)
+						 {
+							 if (flags[i] != 0)
+								 output[destination++] = input[i];
+						 }
+					 });
+
+		return total;
+	}
+
+	void CpuPrimitives::histogram(const std::span<const uint32_t> input,
+								  const std::span<uint32_t> bins, const uint32_t shift,
+								  JobSystem* jobs)
+	{
+		LUNE_ZONE("CpuPrimitives::histogram");
+
+		const size_t binCount{bins.size()};
+		if (binCount == 0)
+			return;
+
+		// Every chunk counts into bins of its own, merged at the end, so no atomics are needed
+		std::vector<uint32_t> chunkBins(chunkCount(input.size()) * binCount);
+		const bool powerOfTwo{(binCount & (binCount - 1)) == 0};
+		forEachChunk(jobs, input.size(),
+					 [&](const size_t chunk, const size_t begin, const size_t end)
+					 {
+						 uint32_t* local{chunkBins.data() + chunk * binCount};
+						 if (powerOfTwo)
+						 {
+							 for (size_t i = begin; i < end; ++i)
+								 ++local[(input[i] >> shift) & (binCount - 1)];
+						 }
+						 else
+						 {
+							 for (size_t i = begin; i < end; ++i)
+								 ++local[(input[i] >> shift) % binCount];
+						 }
+					 });
+
+		std::fill(bins.begin(), bins.end(), 0);
+		for (size_t offset = 0; offset < chunkBins.size(); offset += binCount)
+		{
+			for (size_t bin = 0; bin < binCount; ++bin)
+				bins[bin] += chunkBins[offset + bin];
+		}
+	}
+
+	void CpuPrimitives::sortPairs(const std::span<uint32_t> keys, const std::span<uint32_t> values,
+								  JobSystem* jobs)
+	{
+		LUNE_ZONE("CpuPrimitives::sortPairs");
+		radixSort(keys, values, jobs);
+	}
+
+	void CpuPrimitives::sortPairs(const std::span<uint64_t> keys, const std::span<uint32_t> values,
+								  JobSystem* jobs)
+	{
+		LUNE_ZONE("CpuPrimitives::sortPairs");
+		radixSort(keys, values, jobs);
+	}
+} // namespace lune::gfx
@@ -1,12 +1,16 @@
 module;
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
+#include <span>
 #include <string>
 export module lune.gfx:compute;
 
 import :buffer;
 import :texture;
+import lune.jobs;
 
 namespace lune::gfx
 {
@@ -132,6 +136,15 @@ namespace lune::gfx
 		{
 			return m_kernels.contains(name);
 		}
+
+		/**
+		 * @brief Tells whether the backend built the object. Backends may report build errors
+		 * instead of throwing, leaving an object that can't be used.
+		 */
+		[[nodiscard]] virtual bool isValid() const noexcept
+		{
+			return true;
+		}
 	};
 
 
@@ -146,6 +159,9 @@ namespace lune::gfx
 
 		~ComputeShader() = default;
 
+		ComputeShader(ComputeShader&&) noexcept = default;
+		ComputeShader& operator=(ComputeShader&&) noexcept = default;
+
 		[[nodiscard]] IComputeShaderImpl* getImpl() const
 		{
 			return m_impl.get();
@@ -166,5 +182,218 @@ namespace lune::gfx
 		{
 			return m_impl->hasKernel(name);
 		}
+
+		/**
+		 * @brief Tells whether the shader and every kernel in it compiled.
+		 */
+		[[nodiscard]] bool isValid() const noexcept
+		{
+			return m_impl && m_impl->isValid();
+		}
+	};
+
+
+	export enum SortKeySize
+	{
+		SortKey32,
+		SortKey64,
+	};
+
+
+	/**
+	 * @brief Data-parallel primitives on the CPU, over 32-bit unsigned integers.
+	 *
+	 * Work is split into fixed-size chunks, so results don't depend on the number of threads,
+	 * and the chunks run on the job system when one is given. Inner loops are kept simple
+	 * enough for the compiler to vectorize. Sums wrap around on overflow, like on the GPU.
+	 */
+	export class CpuPrimitives
+	{
+	public:
+		/**
+		 * @brief Writes the sum of all preceding elements to each element of the output. The
+		 * output may alias the input.
+		 */
+		static void exclusiveScan(std::span<const uint32_t> input, std::span<uint32_t> output,
+								  JobSystem* jobs = nullptr);
+
+		/**
+		 * @brief Writes the sum of all elements up to and including each one to the output. The
+		 * output may alias the input.
+		 */
+		static void inclusiveScan(std::span<const uint32_t> input, std::span<uint32_t> output,
+								  JobSystem* jobs = nullptr);
+
+		[[nodiscard]] static uint32_t reduce(std::span<const uint32_t> input,
+											 JobSystem* jobs = nullptr);
+
+		/**
+		 * @brief Copies the elements whose flag is non-zero to the output, keeping their order.
+		 *
+		 * @return The number of elements kept.
+		 */
+		static size_t compact(std::span<const uint32_t> input, std::span<const uint32_t> flags,
+							  std::span<uint32_t> output, JobSystem* jobs = nullptr);
+
+		/**
+		 * @brief Counts the elements falling in each bin, `bin = (value >> shift) % bins.size()`.
+		 * The bins are overwritten, not accumulated into.
+		 *
+		 * @param shift Bits dropped from every value before binning, below 32.
+		 */
+		static void histogram(std::span<const uint32_t> input, std::span<uint32_t> bins,
+							  uint32_t shift = 0, JobSystem* jobs = nullptr);
+
+		/**
+		 * @brief Sorts keys in ascending order with a stable radix sort, moving the values along.
+		 *
+		 * @param values Values of the keys, or empty to sort the keys alone.
+		 */
+		static void sortPairs(std::span<uint32_t> keys, std::span<uint32_t> values,
+							  JobSystem* jobs = nullptr);
+		static void sortPairs(std::span<uint64_t> keys, std::span<uint32_t> values,
+							  JobSystem* jobs = nullptr);
+	};
+
+
+	/**
+	 * @brief Backend implementation of `ComputePrimitives`. Buffers hold 32-bit unsigned integers,
+	 * apart from 64-bit sort keys, and operations may complete asynchronously.
+	 */
+	export class IComputePrimitivesImpl
+	{
+	public:
+		virtual ~IComputePrimitivesImpl() = default;
+
+		virtual void exclusiveScan(const Buffer& input, const Buffer& output, size_t count) = 0;
+		virtual void inclusiveScan(const Buffer& input, const Buffer& output, size_t count) = 0;
+		virtual void reduce(const Buffer& input, const Buffer& result, size_t count) = 0;
+		virtual void compact(const Buffer& input, const Buffer& flags, const Buffer& output,
+							 const Buffer& outputCount, size_t count) = 0;
+		virtual void histogram(const Buffer& input, const Buffer& bins, size_t count,
+							   uint32_t binCount, uint32_t shift) = 0;
+
+		/**
+		 * @param values Values of the keys; nullptr to sort the keys alone.
+		 */
+		virtual void sortPairs(const Buffer& keys, const Buffer* values, size_t count,
+							   SortKeySize keySize) = 0;
+
+		virtual void waitUntilComplete() = 0;
+	};
+
+
+	/**
+	 * @brief Scans, reductions, stream compaction, histograms and radix sorts over GPU buffers,
+	 * so compute code doesn't have to write its own.
+	 *
+	 * Operations are queued behind the compute work submitted before them and run
+	 * asynchronously; results are written to buffers rather than returned, so they can feed
+	 * further GPU work without a round trip to the CPU:
+	 *
+	 * @code
+	 * gfx::ComputePrimitives primitives{ctx.createComputePrimitives()};
+	 * primitives.sortPairs(cellKeys, particleIndices, particleCount)
+	 *           .exclusiveScan(cellCounts, cellStarts, cellCount)
+	 *           .waitUntilComplete();
+	 * @endcode
+	 *
+	 * Backends without kernels of their own run `CpuPrimitives` on CPU-accessible buffers.
+	 */
+	export class ComputePrimitives
+	{
+		std::unique_ptr<IComputePrimitivesImpl> m_impl;
+
+	public:
+		explicit ComputePrimitives(std::unique_ptr<IComputePrimitivesImpl> impl) :
+			m_impl(std::move(impl))
+		{
+		}
+
+		~ComputePrimitives() = default;
+
+		ComputePrimitives(ComputePrimitives&&) noexcept = default;
+		ComputePrimitives& operator=(ComputePrimitives&&) noexcept = default;
+
+		[[nodiscard]] IComputePrimitivesImpl* getImpl() const
+		{
+			return m_impl.get();
+		}
+
+		/**
+		 * @brief Writes the sum of all preceding elements of `input` to each element of `output`.
+		 * The buffers may be the same.
+		 */
+		ComputePrimitives& exclusiveScan(const Buffer& input, const Buffer& output,
+										 const size_t count)
+		{
+			m_impl->exclusiveScan(input, output, count);
+			return *this;
+		}
+
+		ComputePrimitives& inclusiveScan(const Buffer& input, const Buffer& output,
+										 const size_t count)
+		{
+			m_impl->inclusiveScan(input, output, count);
+			return *this;
+		}
+
+		/**
+		 * @brief Writes the sum of the elements to the first element of `result`.
+		 */
+		ComputePrimitives& reduce(const Buffer& input, const Buffer& result, const size_t count)
+		{
+			m_impl->reduce(input, result, count);
+			return *this;
+		}
+
+		/**
+		 * @brief Copies the elements whose flag is 1 to `output`, keeping their order, and writes
+		 * their number to the first element of `outputCount`. Flags must be 0 or 1.
+		 */
+		ComputePrimitives& compact(const Buffer& input, const Buffer& flags, const Buffer& output,
+								   const Buffer& outputCount, const size_t count)
+		{
+			m_impl->compact(input, flags, output, outputCount, count);
+			return *this;
+		}
+
+		/**
+		 * @brief Counts the elements falling in each of `binCount` bins,
+		 * `bin = (value >> shift) % binCount`, overwriting `bins`. `shift` must be below 32.
+		 */
+		ComputePrimitives& histogram(const Buffer& input, const Buffer& bins, const size_t count,
+									 const uint32_t binCount, const uint32_t shift = 0)
+		{
+			m_impl->histogram(input, bins, count, binCount, shift);
+			return *this;
+		}
+
+		/**
+		 * @brief Sorts keys in ascending order, in place.
+		 */
+		ComputePrimitives& sort(const Buffer& keys, const size_t count,
+								const SortKeySize keySize = SortKey32)
+		{
+			m_impl->sortPairs(keys, nullptr, count, keySize);
+			return *this;
+		}
+
+		/**
+		 * @brief Sorts keys in ascending order, in place, moving their 32-bit values along. The
+		 * sort is stable.
+		 */
+		ComputePrimitives& sortPairs(const Buffer& keys, const Buffer& values, const size_t count,
+									 const SortKeySize keySize = SortKey32)
+		{
+			m_impl->sortPairs(keys, &values, count, keySize);
+			return *this;
+		}
+
+		ComputePrimitives& waitUntilComplete()
+		{
+			m_impl->waitUntilComplete();
+			return *this;
+		}
 	};
 } // namespace lune::gfx
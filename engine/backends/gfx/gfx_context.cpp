@@ -1,13 +1,193 @@
 module;
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iostream>
 #include <memory>
+#include <span>
+#include <string>
+#include <utility>
 module lune.gfx;
 
+import lune.jobs;
+
 #ifdef USE_METAL
 import lune.metal;
 #endif
 
 namespace lune::gfx
 {
+	namespace
+	{
+		/**
+		 * @brief Runs a factory on the job system and hands its result over through a future.
+		 */
+		template <typename T, typename Factory>
+		std::future<std::unique_ptr<T>> runAsync(Factory factory)
+		{
+			auto promise{std::make_shared<std::promise<std::unique_ptr<T>>>()};
+			std::future<std::unique_ptr<T>> future{promise->get_future()};
+
+			JobSystem::instance().submit(
+					[promise, factory = std::move(factory)]
+					{
+						try
+						{
+							promise->set_value(std::make_unique<T>(factory()));
+						}
+						catch (...)
+						{
+							promise->set_exception(std::current_exception());
+						}
+					});
+
+			return future;
+		}
+
+		/**
+		 * @brief Copies between CPU-mapped buffers on the calling thread.
+		 */
+		class HostTransferQueueImpl final : public ITransferQueueImpl
+		{
+		public:
+			void submit(const std::span<const BufferCopy> copies,
+						const std::function<void()> onComplete) override
+			{
+				for (const BufferCopy& copy : copies)
+				{
+					const auto* source{static_cast<const std::byte*>(copy.source->data())};
+					auto* destination{static_cast<std::byte*>(copy.destination->data())};
+					if (!source || !destination)
+					{
+						std::cerr << "Buffer copy skipped: the backend has no transfer queue and "
+									 "a buffer isn't CPU accessible\n";
+						continue;
+					}
+
+					std::memcpy(destination + copy.destinationOffset, source + copy.sourceOffset,
+								copy.size);
+				}
+
+				onComplete();
+			}
+		};
+
+
+		/**
+		 * @brief Runs `CpuPrimitives` on the job system, directly on the buffers' mapped memory.
+		 */
+		class HostComputePrimitivesImpl final : public IComputePrimitivesImpl
+		{
+		public:
+			void exclusiveScan(const Buffer& input, const Buffer& output,
+							   const size_t count) override
+			{
+				const auto source{view<uint32_t>(input, count)};
+				const auto destination{view<uint32_t>(output, count)};
+				if (source.size() == count && destination.size() == count)
+					CpuPrimitives::exclusiveScan(source, destination, &JobSystem::instance());
+			}
+
+			void inclusiveScan(const Buffer& input, const Buffer& output,
+							   const size_t count) override
+			{
+				const auto source{view<uint32_t>(input, count)};
+				const auto destination{view<uint32_t>(output, count)};
+				if (source.size() == count && destination.size() == count)
+					CpuPrimitives::inclusiveScan(source, destination, &JobSystem::instance());
+			}
+
+			void reduce(const Buffer& input, const Buffer& result, const size_t count) override
+			{
+				const auto source{view<uint32_t>(input, count)};
+				const auto destination{view<uint32_t>(result, 1)};
+				if (source.size() == count && !destination.empty())
+					destination[0] = CpuPrimitives::reduce(source, &JobSystem::instance());
+			}
+
+			void compact(const Buffer& input, const Buffer& flags, const Buffer& output,
+						 const Buffer& outputCount, const size_t count) override
+			{
+				const auto source{view<uint32_t>(input, count)};
+				const auto keep{view<uint32_t>(flags, count)};
+				const auto destination{view<uint32_t>(output, count)};
+				const auto kept{view<uint32_t>(outputCount, 1)};
+				if (source.size() != count || keep.size() != count ||
+					destination.size() != count || kept.empty())
+					return;
+
+				kept[0] = static_cast<uint32_t>(
+						CpuPrimitives::compact(source, keep, destination, &JobSystem::instance()));
+			}
+
+			void histogram(const Buffer& input, const Buffer& bins, const size_t count,
+						   const uint32_t binCount, const uint32_t shift) override
+			{
+				const auto source{view<uint32_t>(input, count)};
+				const auto destination{view<uint32_t>(bins, binCount)};
+				if (source.size() == count && destination.size() == binCount)
+					CpuPrimitives::histogram(source, destination, shift, &JobSystem::instance());
+			}
+
+			void sortPairs(const Buffer& keys, const Buffer* values, const size_t count,
+						   const SortKeySize keySize) override
+			{
+				std::span<uint32_t> sortedValues;
+				if (values)
+				{
+					sortedValues = view<uint32_t>(*values, count);
+					if (sortedValues.size() != count)
+						return;
+				}
+
+				if (keySize == SortKey64)
+				{
+					const auto sortedKeys{view<uint64_t>(keys, count)};
+					if (sortedKeys.size() == count)
+						CpuPrimitives::sortPairs(sortedKeys, sortedValues, &JobSystem::instance());
+					return;
+				}
+
+				const auto sortedKeys{view<uint32_t>(keys, count)};
+				if (sortedKeys.size() == count)
+					CpuPrimitives::sortPairs(sortedKeys, sortedValues, &JobSystem::instance());
+			}
+
+			void waitUntilComplete() override
+			{
+				// Every operation has completed by the time it returns
+			}
+
+		private:
+			/**
+			 * @return The first `count` elements of the buffer's memory, or an empty span if the
+			 * buffer isn't CPU accessible or is too small.
+			 */
+			template <typename T>
+			static std::span<T> view(const Buffer& buffer, const size_t count)
+			{
+				auto* data{static_cast<T*>(buffer.data())};
+				if (!data)
+				{
+					std::cerr << "Compute primitive skipped: the backend has no kernels for it and "
+								 "a buffer isn't CPU accessible\n";
+					return {};
+				}
+				if (buffer.size() < count * sizeof(T))
+				{
+					std::cerr << "Compute primitive skipped: a buffer of " << buffer.size()
+							  << " bytes can't hold " << count << " elements\n";
+					return {};
+				}
+
+				return {data, count};
+			}
+		};
+	} // namespace
+
 	Context::Context()
 	{
 
@@ -16,4 +196,33 @@ namespace lune::gfx
 #elif defined(USE_VULKAN)
 #endif
 	}
+
+	std::unique_ptr<ITransferQueueImpl> IContextImpl::createTransferQueue() const
+	{
+		return std::make_unique<HostTransferQueueImpl>();
+	}
+
+	std::unique_ptr<IComputePrimitivesImpl> IContextImpl::createComputePrimitives() const
+	{
+		return std::make_unique<HostComputePrimitivesImpl>();
+	}
+
+	std::future<std::unique_ptr<Shader>> Context::createShaderAsync(const ShaderDesc& desc) const
+	{
+		return runAsync<Shader>([impl = m_impl.get(), desc] { return impl->createShader(desc); });
+	}
+
+	std::future<std::unique_ptr<Pipeline>>
+	Context::createPipelineAsync(const Shader& shader, const PipelineDesc& desc) const
+	{
+		return runAsync<Pipeline>([impl = m_impl.get(), &shader, desc]
+								  { return impl->createPipeline(shader, desc); });
+	}
+
+	std::future<std::unique_ptr<ComputeShader>>
+	Context::createComputeShaderAsync(const std::string& path) const
+	{
+		return runAsync<ComputeShader>([impl = m_impl.get(), path]
+									   { return impl->createComputeShader(path); });
+	}
 } // namespace lune::gfx
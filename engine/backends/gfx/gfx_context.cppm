@@ -1,9 +1,11 @@
 module;
+#include <future>
 #include <memory>
 #include <string>
 export module lune.gfx:context;
 
 import :buffer;
+import :types;
 import :texture;
 import :render_surface;
 import :graphics;
@@ -17,7 +19,7 @@ namespace lune::gfx
 		IContextImpl() = default;
 		virtual ~IContextImpl() = default;
 
-		[[nodiscard]] virtual Buffer createBuffer(size_t size) const = 0;
+		[[nodiscard]] virtual Buffer createBuffer(size_t size, BufferUsage usage) const = 0;
 		[[nodiscard]] virtual Texture
 		createTexture(const TextureContextCreateInfo& createInfo) const = 0;
 
@@ -28,6 +30,19 @@ namespace lune::gfx
 		[[nodiscard]] virtual RenderPass createRenderPass(const RenderSurface& surface) const = 0;
 
 		[[nodiscard]] virtual ComputeShader createComputeShader(const std::string& path) const = 0;
+
+		/**
+		 * @brief Creates the queue `StagingManager` submits its copies to. Defaults to copying on
+		 * the CPU, which only works between buffers the CPU can access.
+		 */
+		[[nodiscard]] virtual std::unique_ptr<ITransferQueueImpl> createTransferQueue() const;
+
+		/**
+		 * @brief Creates the backend's data-parallel primitives. Defaults to `CpuPrimitives` on
+		 * the job system, which only works on buffers the CPU can access.
+		 */
+		[[nodiscard]] virtual std::unique_ptr<IComputePrimitivesImpl>
+		createComputePrimitives() const;
 	};
 
 	export class Context
@@ -51,9 +66,13 @@ namespace lune::gfx
 			return m_impl.get();
 		}
 
-		[[nodiscard]] Buffer createBuffer(size_t size) const
+		/**
+		 * @param usage Where the buffer lives. `Shared` buffers are mapped on the CPU; `Private`
+		 * ones are only accessible to the GPU and are filled through a `StagingManager`.
+		 */
+		[[nodiscard]] Buffer createBuffer(const size_t size, const BufferUsage usage = Shared) const
 		{
-			return m_impl->createBuffer(size);
+			return m_impl->createBuffer(size, usage);
 		}
 
 		[[nodiscard]] Texture createTexture(const TextureContextCreateInfo& createInfo) const
@@ -85,5 +104,36 @@ namespace lune::gfx
 		{
 			return m_impl->createComputeShader(path);
 		}
+
+		[[nodiscard]] ComputePrimitives createComputePrimitives() const
+		{
+			return ComputePrimitives{m_impl->createComputePrimitives()};
+		}
+
+		/**
+		 * @brief Compiles a shader on the job system.
+		 *
+		 * @return Future of the shader; rethrows errors of the compilation on `get()`.
+		 */
+		[[nodiscard]] std::future<std::unique_ptr<Shader>>
+		createShaderAsync(const ShaderDesc& desc) const;
+
+		/**
+		 * @brief Builds a pipeline on the job system.
+		 *
+		 * @param shader Shader of the pipeline; must outlive the pipeline.
+		 *
+		 * @return Future of the pipeline; rethrows errors of the build on `get()`.
+		 */
+		[[nodiscard]] std::future<std::unique_ptr<Pipeline>>
+		createPipelineAsync(const Shader& shader, const PipelineDesc& desc) const;
+
+		/**
+		 * @brief Compiles a compute shader and builds all of its kernels on the job system.
+		 *
+		 * @return Future of the shader; rethrows errors of the compilation on `get()`.
+		 */
+		[[nodiscard]] std::future<std::unique_ptr<ComputeShader>>
+		createComputeShaderAsync(const std::string& path) const;
 	};
 } // namespace lune::gfx
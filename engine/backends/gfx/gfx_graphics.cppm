@@ -14,6 +14,8 @@ namespace lune::gfx
 {
 	export struct ShaderDesc
 	{
+		/// Source compiled at load time (e.g. `.metal`), or a shader precompiled by
+		/// `lune_compile_shaders` (e.g. `.metallib`) whose bindings are read from its sidecar.
 		std::string path;
 		std::string vsMain{"vertexMain"};
 		std::string fsMain{"fragmentMain"};
@@ -37,6 +39,15 @@ namespace lune::gfx
 		virtual ~IShaderImpl() = default;
 
 		virtual void create() = 0;
+
+		/**
+		 * @brief Tells whether the backend built the object. Backends may report build errors
+		 * instead of throwing, leaving an object that can't be used.
+		 */
+		[[nodiscard]] virtual bool isValid() const noexcept
+		{
+			return true;
+		}
 	};
 
 	export class IPipelineImpl
@@ -57,6 +68,14 @@ namespace lune::gfx
 			return m_desc.winding;
 		}
 
+		/**
+		 * @brief Tells whether the backend built the object. Backends may report build errors
+		 * instead of throwing, leaving an object that can't be used.
+		 */
+		[[nodiscard]] virtual bool isValid() const noexcept
+		{
+			return true;
+		}
 
 	protected:
 		virtual void createPipeline() = 0;
@@ -76,9 +95,25 @@ namespace lune::gfx
 
 	export class IRenderPassImpl
 	{
+	protected:
+		std::string m_label{"RenderPass"};
+
 	public:
 		virtual ~IRenderPassImpl() = default;
 
+		/**
+		 * @brief Name the pass is reported under in `GpuTimings`.
+		 */
+		[[nodiscard]] const std::string& label() const noexcept
+		{
+			return m_label;
+		}
+
+		void setLabel(const std::string& label)
+		{
+			m_label = label;
+		}
+
 		virtual void bind(const IMaterialImpl& material) = 0;
 
 		virtual void begin() = 0;
@@ -108,6 +143,14 @@ namespace lune::gfx
 		{
 			return m_impl.get();
 		}
+
+		/**
+		 * @brief Tells whether the shader compiled; a shader that didn't can't build pipelines.
+		 */
+		[[nodiscard]] bool isValid() const noexcept
+		{
+			return m_impl && m_impl->isValid();
+		}
 	};
 
 	export class Pipeline
@@ -121,6 +164,9 @@ namespace lune::gfx
 
 		virtual ~Pipeline() = default;
 
+		Pipeline(Pipeline&&) noexcept = default;
+		Pipeline& operator=(Pipeline&&) noexcept = default;
+
 		[[nodiscard]] IPipelineImpl* getImpl() const
 		{
 			return m_impl.get();
@@ -135,6 +181,14 @@ namespace lune::gfx
 		{
 			return m_impl->winding();
 		}
+
+		/**
+		 * @brief Tells whether the pipeline state was created; an invalid pipeline draws nothing.
+		 */
+		[[nodiscard]] bool isValid() const noexcept
+		{
+			return m_impl && m_impl->isValid();
+		}
 	};
 
 	export class Material
@@ -201,6 +255,15 @@ namespace lune::gfx
 			return *this;
 		}
 
+		/**
+		 * @brief Sets the name the pass is reported under in `GpuTimings`.
+		 */
+		RenderPass& setLabel(const std::string& label)
+		{
+			m_impl->setLabel(label);
+			return *this;
+		}
+
 		RenderPass& begin()
 		{
 			m_impl->begin();
@@ -0,0 +1,211 @@
+module;
+#include <algorithm>
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+module lune.gfx;
+
+namespace lune::gfx
+{
+	namespace
+	{
+		/**
+		 * @brief Gets the form paths are compared in, so relative and absolute spellings of a
+		 * file match.
+		 */
+		std::string normalize(const std::string& path)
+		{
+			std::error_code error;
+			const std::filesystem::path canonical{std::filesystem::weakly_canonical(path, error)};
+			return error ? std::filesystem::path(path).lexically_normal().string()
+						 : canonical.string();
+		}
+	} // namespace
+
+	void HotReload::add(const std::string& path, IHotReloadable& object)
+	{
+		std::string normalized{normalize(path)};
+
+		std::lock_guard lock(m_mutex);
+
+		const bool known{std::ranges::any_of(m_entries, [&](const Entry& entry)
+											 { return entry.path == normalized; })};
+		if (!known && m_watchCallback)
+			m_watchCallback(normalized);
+
+		m_entries.push_back({std::move(normalized), &object});
+	}
+
+	void HotReload::remove(const IHotReloadable& object)
+	{
+		std::unique_lock lock(m_mutex);
+
+		// The object can't be destroyed while it is being rebuilt
+		m_prepared.wait(lock, [&] { return m_preparing != &object; });
+		std::erase_if(m_entries, [&](const Entry& entry) { return entry.object == &object; });
+
+		// A new object may later be allocated at the same address, without a version to apply
+		for (Ready& ready : m_ready)
+			std::erase(ready.objects, &object);
+	}
+
+	bool HotReload::reload(const std::string& path)
+	{
+		const std::string normalized{normalize(path)};
+
+		// Serializes reloads and keeps applyPending from swapping in half-prepared state
+		const std::lock_guard reloadLock(m_reloadMutex);
+
+		std::vector<IHotReloadable*> objects;
+		{
+			const std::lock_guard lock(m_mutex);
+			for (const Entry& entry : m_entries)
+			{
+				if (entry.path == normalized)
+					objects.push_back(entry.object);
+			}
+		}
+
+		if (objects.empty())
+			return false;
+
+		// The registry isn't locked while compiling: backends wait on the job system, whose
+		// queued jobs may be creating shaders that register themselves
+		bool succeeded{true};
+		std::vector<IHotReloadable*> prepared;
+		for (IHotReloadable* object : objects)
+		{
+			{
+				const std::lock_guard lock(m_mutex);
+				const bool registered{std::ranges::any_of(m_entries, [&](const Entry& entry)
+														  { return entry.object == object; })};
+				if (!registered)
+					continue;
+
+				m_preparing = object;
+			}
+
+			const bool built{object->prepareReload()};
+
+			{
+				const std::lock_guard lock(m_mutex);
+				m_preparing = nullptr;
+			}
+			m_prepared.notify_all();
+
+			if (!built)
+			{
+				succeeded = false;
+				break;
+			}
+			prepared.push_back(object);
+		}
+
+		const std::lock_guard lock(m_mutex);
+		std::erase_if(m_ready, [&](const Ready& ready) { return ready.path == normalized; });
+		if (!succeeded)
+		{
+			std::cerr << "Failed to reload " << normalized << "; keeping the previous version\n";
+			return false;
+		}
+
+		// Objects removed since they were rebuilt had nothing in m_ready for remove() to erase
+		std::erase_if(prepared,
+					  [&](const IHotReloadable* object)
+					  {
+						  return std::ranges::none_of(m_entries, [&](const Entry& entry)
+													  { return entry.object == object; });
+					  });
+		m_ready.push_back({normalized, std::move(prepared)});
+		m_hasReady.store(true, std::memory_order_release);
+		return true;
+	}
+
+	size_t HotReload::applyPending()
+	{
+		if (!m_hasReady.load(std::memory_order_acquire))
+			return 0;
+
+		// A reload being prepared holds the reload lock for the whole compilation
+		const std::unique_lock reloadLock(m_reloadMutex, std::try_to_lock);
+		if (!reloadLock)
+			return 0;
+
+		std::vector<Barrier> barriers;
+		{
+			const std::lock_guard lock(m_mutex);
+			barriers = m_barriers;
+		}
+
+		// Waited on without the registry lock, as the frames in flight may destroy objects
+		for (const Barrier& barrier : barriers)
+			barrier.wait();
+
+		const std::lock_guard lock(m_mutex);
+
+		const std::vector<Ready> ready{std::exchange(m_ready, {})};
+		m_hasReady.store(false, std::memory_order_relaxed);
+
+		// In registration order, so shaders are applied before what was built from them; objects
+		// registered after the reload took its snapshot never prepared and are left alone
+		for (const Ready& pending : ready)
+		{
+			for (const Entry& entry : m_entries)
+			{
+				if (entry.path == pending.path &&
+					std::ranges::find(pending.objects, entry.object) != pending.objects.end())
+					entry.object->applyReload();
+			}
+		}
+
+		return ready.size();
+	}
+
+	void HotReload::addFrameBarrier(const void* owner, std::function<void()> wait)
+	{
+		std::lock_guard lock(m_mutex);
+		m_barriers.push_back({owner, std::move(wait)});
+	}
+
+	void HotReload::removeFrameBarrier(const void* owner)
+	{
+		std::lock_guard lock(m_mutex);
+		std::erase_if(m_barriers, [&](const Barrier& barrier) { return barrier.owner == owner; });
+	}
+
+	std::vector<std::string> HotReload::paths()
+	{
+		std::lock_guard lock(m_mutex);
+
+		std::vector<std::string> result;
+		for (const Entry& entry : m_entries)
+		{
+			if (std::ranges::find(result, entry.path) == result.end())
+				result.push_back(entry.path);
+		}
+
+		return result;
+	}
+
+	void HotReload::setWatchCallback(std::function<void(const std::string&)> callback)
+	{
+		std::lock_guard lock(m_mutex);
+		m_watchCallback = std::move(callback);
+
+		if (!m_watchCallback)
+			return;
+
+		for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+		{
+			const bool seen{std::any_of(m_entries.begin(), it, [&](const Entry& entry)
+										{ return entry.path == it->path; })};
+			if (!seen)
+				m_watchCallback(it->path);
+		}
+	}
+} // namespace lune::gfx
@@ -0,0 +1,140 @@
+module;
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+export module lune.gfx:hot_reload;
+
+namespace lune::gfx
+{
+	/**
+	 * @brief A backend object that can be rebuilt from its shader source while in use.
+	 *
+	 * Reloading happens in two steps so the frame loop never waits on the compiler:
+	 * `prepareReload` compiles the new version off the render thread into state that rendering
+	 * doesn't touch, and `applyReload` swaps it in between frames.
+	 */
+	export class IHotReloadable
+	{
+	public:
+		virtual ~IHotReloadable() = default;
+
+		/**
+		 * @brief Builds the new version from source. Called on the reload thread.
+		 *
+		 * @return true if the new version is ready to be applied; on failure the object must keep
+		 * working with its current version.
+		 */
+		virtual bool prepareReload() = 0;
+
+		/**
+		 * @brief Swaps in the version built by the last successful `prepareReload`. Called between
+		 * frames. Does nothing if no version is waiting.
+		 */
+		virtual void applyReload() = 0;
+	};
+
+
+	/**
+	 * @brief Registry of the objects built from each shader source, and the reloads waiting to be
+	 * applied.
+	 *
+	 * Backends register shaders and everything built from them (pipelines, kernels) under the
+	 * shader's source path, shaders first. `reload` rebuilds every object of a path on the calling
+	 * thread, without holding the registry lock, so objects may be created and destroyed
+	 * meanwhile; the result is only applied if all of them succeed, so a broken edit never leaves a
+	 * pipeline built from a shader it doesn't match. `applyPending` then swaps the results in,
+	 * and is called between frames by `Window::pollEvents`.
+	 *
+	 * Changes are detected by `ShaderHotReload`, which watches every registered path.
+	 */
+	export class HotReload
+	{
+		struct Entry
+		{
+			std::string path;
+			IHotReloadable* object;
+		};
+
+		/// A rebuilt shader source, and the objects that were rebuilt for it.
+		struct Ready
+		{
+			std::string path;
+			std::vector<IHotReloadable*> objects;
+		};
+
+		struct Barrier
+		{
+			const void* owner;
+			std::function<void()> wait;
+		};
+
+		static inline std::mutex m_reloadMutex; ///< Held while a reload is being prepared.
+		static inline std::mutex m_mutex;
+		static inline std::condition_variable m_prepared;
+		static inline const IHotReloadable* m_preparing{}; ///< Object being rebuilt, if any.
+		static inline std::vector<Entry> m_entries; ///< In registration order.
+		static inline std::vector<Ready> m_ready;
+		static inline std::vector<Barrier> m_barriers;
+		static inline std::atomic<bool> m_hasReady{};
+		static inline std::function<void(const std::string&)> m_watchCallback;
+
+	public:
+		/**
+		 * @brief Registers an object built from a shader source.
+		 *
+		 * @param path Path of the shader source.
+		 * @param object Object to rebuild when the source changes; must be removed before it is
+		 * destroyed.
+		 */
+		static void add(const std::string& path, IHotReloadable& object);
+
+		/**
+		 * @brief Unregisters an object. Blocks while the object is being rebuilt by `reload`.
+		 */
+		static void remove(const IHotReloadable& object);
+
+		/**
+		 * @brief Rebuilds every object of a shader source and queues the result to be applied.
+		 * Blocks for the duration of the compilation; call it off the render thread.
+		 *
+		 * @param path Path of the shader source; paths that aren't registered are ignored.
+		 *
+		 * @return true if every object of the path was rebuilt.
+		 */
+		static bool reload(const std::string& path);
+
+		/**
+		 * @brief Swaps in the reloads prepared since the last call. Never waits on a reload being
+		 * prepared; it is picked up by a later call instead. Waits on the frame barriers before
+		 * swapping anything in. Only objects rebuilt by the reload are swapped, so those
+		 * registered since keep their version.
+		 *
+		 * @return The number of shader sources applied.
+		 */
+		static size_t applyPending();
+
+		/**
+		 * @brief Registers a function `applyPending` calls before swapping reloads in, e.g. to wait
+		 * for a render thread to finish the frames still using the current versions.
+		 *
+		 * @param owner Key to remove the barrier by.
+		 */
+		static void addFrameBarrier(const void* owner, std::function<void()> wait);
+
+		static void removeFrameBarrier(const void* owner);
+
+		/**
+		 * @brief Gets the registered shader sources.
+		 */
+		[[nodiscard]] static std::vector<std::string> paths();
+
+		/**
+		 * @brief Sets a function called with every registered path, now and whenever a new one is
+		 * added; used to start watching it. Pass an empty function to stop.
+		 */
+		static void setWatchCallback(std::function<void(const std::string&)> callback);
+	};
+} // namespace lune::gfx
@@ -0,0 +1,272 @@
+module;
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <lune/profiler.hpp>
+#include <string>
+#include <thread>
+#include <utility>
+module lune.gfx;
+
+import lune.profiler;
+
+namespace lune::gfx
+{
+	RenderCommandList::PassRecorder& RenderCommandList::PassRecorder::begin()
+	{
+		m_list.push({.type = BeginPass, .target = &m_pass});
+		return *this;
+	}
+
+	RenderCommandList::PassRecorder& RenderCommandList::PassRecorder::end()
+	{
+		m_list.push({.type = EndPass, .target = &m_pass});
+		return *this;
+	}
+
+	RenderCommandList::PassRecorder&
+	RenderCommandList::PassRecorder::bind(const Material& material)
+	{
+		m_list.push({.type = BindMaterial, .target = &m_pass, .object = &material});
+		return *this;
+	}
+
+	RenderCommandList::PassRecorder&
+	RenderCommandList::PassRecorder::draw(const PrimitiveType type, const uint32_t start,
+										  const uint32_t count)
+	{
+		m_list.push({.type = Draw, .primitive = type, .target = &m_pass, .args = {start, count}});
+		return *this;
+	}
+
+	RenderCommandList::PassRecorder& RenderCommandList::PassRecorder::drawIndexed(
+			const PrimitiveType type, const uint32_t indexCount, const Buffer& indexBuffer,
+			const uint32_t indexOffset)
+	{
+		m_list.push({.type = DrawIndexed,
+					 .primitive = type,
+					 .target = &m_pass,
+					 .object = &indexBuffer,
+					 .args = {indexCount, indexOffset}});
+		return *this;
+	}
+
+	RenderCommandList::PassRecorder&
+	RenderCommandList::PassRecorder::setViewport(const float x, const float y, const float w,
+												 const float h, const float zmin,
+												 const float zmax)
+	{
+		m_list.push({.type = SetViewport, .target = &m_pass, .viewport = {x, y, w, h, zmin, zmax}});
+		return *this;
+	}
+
+	RenderCommandList::PassRecorder&
+	RenderCommandList::PassRecorder::setScissor(const uint32_t x, const uint32_t y,
+												const uint32_t w, const uint32_t h)
+	{
+		m_list.push({.type = SetScissor, .target = &m_pass, .args = {x, y, w, h}});
+		return *this;
+	}
+
+	RenderCommandList::PassRecorder&
+	RenderCommandList::PassRecorder::setFillMode(const FillMode fillMode)
+	{
+		m_list.push({.type = SetFillMode, .fillMode = fillMode, .target = &m_pass});
+		return *this;
+	}
+
+	RenderCommandList& RenderCommandList::setUniform(Material& material, const std::string& name,
+													 const Texture& texture)
+	{
+		pushUniform({.type = UniformTexture, .target = &material, .object = &texture}, name);
+		return *this;
+	}
+
+	RenderCommandList& RenderCommandList::setUniform(Material& material, const std::string& name,
+													 const Buffer& buffer)
+	{
+		pushUniform({.type = UniformBuffer, .target = &material, .object = &buffer}, name);
+		return *this;
+	}
+
+	RenderCommandList& RenderCommandList::setUniform(Material& material, const std::string& name,
+													 const void* data, const size_t size)
+	{
+		pushUniform({.type = UniformData, .target = &material}, name, data, size);
+		return *this;
+	}
+
+	RenderCommandList& RenderCommandList::execute(std::function<void()> callback)
+	{
+		push({.type = Callback, .args = {static_cast<uint32_t>(m_callbacks.size())}});
+		m_callbacks.push_back(std::move(callback));
+		return *this;
+	}
+
+	void RenderCommandList::execute() const
+	{
+		LUNE_ZONE("RenderCommandList::execute");
+
+		for (const Command& command : m_commands)
+		{
+			auto* pass{static_cast<RenderPass*>(command.target)};
+			auto* material{static_cast<Material*>(command.target)};
+			const auto& [a, b, c, d]{command.args};
+			const auto name{[&]
+							{
+								const auto* chars{m_data.data() + command.name};
+								return std::string{reinterpret_cast<const char*>(chars),
+												   command.nameSize};
+							}};
+
+			switch (command.type)
+			{
+				case BeginPass:
+					pass->begin();
+					break;
+				case EndPass:
+					pass->end();
+					break;
+				case BindMaterial:
+					pass->bind(*static_cast<const Material*>(command.object));
+					break;
+				case Draw:
+					pass->draw(command.primitive, a, b);
+					break;
+				case DrawIndexed:
+					pass->drawIndexed(command.primitive, a,
+									  *static_cast<const Buffer*>(command.object), b);
+					break;
+				case SetViewport:
+				{
+					const auto& [x, y, w, h, zmin, zmax]{command.viewport};
+					pass->setViewport(x, y, w, h, zmin, zmax);
+					break;
+				}
+				case SetScissor:
+					pass->setScissor(a, b, c, d);
+					break;
+				case SetFillMode:
+					pass->setFillMode(command.fillMode);
+					break;
+				case UniformData:
+					material->setUniform(name(), m_data.data() + command.data, command.dataSize);
+					break;
+				case UniformTexture:
+					material->setUniform(name(), *static_cast<const Texture*>(command.object));
+					break;
+				case UniformBuffer:
+					material->setUniform(name(), *static_cast<const Buffer*>(command.object));
+					break;
+				case Callback:
+					m_callbacks[a]();
+					break;
+			}
+		}
+	}
+
+	void RenderCommandList::clear() noexcept
+	{
+		m_commands.clear();
+		m_data.clear();
+		m_callbacks.clear();
+	}
+
+	void RenderCommandList::pushUniform(Command command, const std::string& name,
+										const void* data, const size_t size)
+	{
+		command.name = static_cast<uint32_t>(m_data.size());
+		command.nameSize = static_cast<uint32_t>(name.size());
+		command.data = command.name + command.nameSize;
+		command.dataSize = static_cast<uint32_t>(size);
+
+		m_data.resize(m_data.size() + name.size() + size);
+		std::memcpy(m_data.data() + command.name, name.data(), name.size());
+		if (size > 0)
+			std::memcpy(m_data.data() + command.data, data, size);
+
+		push(command);
+	}
+
+	RenderQueue::RenderQueue(const bool threaded)
+	{
+		if (threaded)
+		{
+			m_thread = std::thread(
+					[this]
+					{
+						Profiler::setThreadName("Render");
+						renderLoop();
+					});
+
+			// Reloaded shaders are swapped in by the game thread, once the frames using the
+			// current versions have been replayed
+			HotReload::addFrameBarrier(this, [this] { waitIdle(); });
+		}
+	}
+
+	RenderQueue::~RenderQueue()
+	{
+		if (!isThreaded())
+			return;
+
+		HotReload::removeFrameBarrier(this);
+		waitIdle();
+		m_running.store(false, std::memory_order_relaxed);
+
+		// Wake the render thread with an empty frame so it sees the stop request
+		m_pending.store(true, std::memory_order_release);
+		m_pending.notify_one();
+		m_thread.join();
+	}
+
+	void RenderQueue::submit()
+	{
+		LUNE_ZONE("RenderQueue::submit");
+
+		if (!isThreaded())
+		{
+			m_lists[m_write].execute();
+			m_lists[m_write].clear();
+			return;
+		}
+
+		// The render thread owns m_read until it clears the flag
+		waitIdle();
+		m_read = m_write;
+		m_write ^= 1;
+		m_pending.store(true, std::memory_order_release);
+		m_pending.notify_one();
+	}
+
+	void RenderQueue::waitIdle() const
+	{
+		m_pending.wait(true, std::memory_order_acquire);
+	}
+
+	void RenderQueue::renderLoop()
+	{
+		while (true)
+		{
+			m_pending.wait(false, std::memory_order_acquire);
+			if (!m_running.load(std::memory_order_relaxed))
+				return;
+
+			RenderCommandList& list{m_lists[m_read]};
+			try
+			{
+				list.execute();
+			}
+			catch (const std::exception& e)
+			{
+				std::cerr << "Render thread failed to replay a frame: " << e.what() << "\n";
+			}
+			list.clear();
+
+			m_pending.store(false, std::memory_order_release);
+			m_pending.notify_all();
+		}
+	}
+} // namespace lune::gfx
@@ -0,0 +1,222 @@
+module;
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+export module lune.gfx:render_queue;
+
+import :buffer;
+import :graphics;
+import :texture;
+import :types;
+
+namespace lune::gfx
+{
+	/**
+	 * @brief Render commands recorded for a frame and replayed later, possibly on another thread.
+	 *
+	 * Recording only copies arguments into flat arrays; nothing reaches the backend until
+	 * `execute()`. Uniform data is copied when recorded. Passes, materials, buffers and textures
+	 * are referenced, so they must outlive every frame that uses them.
+	 */
+	export class RenderCommandList
+	{
+		enum CommandType : uint8_t
+		{
+			BeginPass,
+			EndPass,
+			BindMaterial,
+			Draw,
+			DrawIndexed,
+			SetViewport,
+			SetScissor,
+			SetFillMode,
+			UniformData,
+			UniformTexture,
+			UniformBuffer,
+			Callback,
+		};
+
+		struct Command
+		{
+			CommandType type;
+			PrimitiveType primitive{Triangle};
+			FillMode fillMode{Fill};
+			void* target{}; ///< RenderPass or Material.
+			const void* object{}; ///< Bound Material, Buffer or Texture.
+			std::array<uint32_t, 4> args{};
+			std::array<float, 6> viewport{};
+			uint32_t name{}; ///< Offset of the uniform name in `m_data`.
+			uint32_t nameSize{};
+			uint32_t data{}; ///< Offset of the uniform data in `m_data`.
+			uint32_t dataSize{};
+		};
+
+		std::vector<Command> m_commands;
+		std::vector<std::byte> m_data; ///< Uniform names and values.
+		std::vector<std::function<void()>> m_callbacks;
+
+	public:
+		/**
+		 * @brief Records commands for one render pass with the same chaining as `RenderPass`.
+		 */
+		class PassRecorder
+		{
+			RenderCommandList& m_list;
+			RenderPass& m_pass;
+
+		public:
+			PassRecorder(RenderCommandList& list, RenderPass& pass) : m_list(list), m_pass(pass)
+			{
+			}
+
+			PassRecorder& begin();
+			PassRecorder& end();
+			PassRecorder& bind(const Material& material);
+			PassRecorder& draw(PrimitiveType type, uint32_t start, uint32_t count);
+			PassRecorder& drawIndexed(PrimitiveType type, uint32_t indexCount,
+									  const Buffer& indexBuffer, uint32_t indexOffset);
+			PassRecorder& setViewport(float x, float y, float w, float h, float zmin = 0.0f,
+									  float zmax = 1.0f);
+			PassRecorder& setScissor(uint32_t x, uint32_t y, uint32_t w, uint32_t h);
+			PassRecorder& setFillMode(FillMode fillMode);
+		};
+
+		[[nodiscard]] PassRecorder pass(RenderPass& pass)
+		{
+			return {*this, pass};
+		}
+
+		RenderCommandList& setUniform(Material& material, const std::string& name,
+									  const Texture& texture);
+		RenderCommandList& setUniform(Material& material, const std::string& name,
+									  const Buffer& buffer);
+
+		/**
+		 * @brief Records a uniform update. The data is copied, so it may change after the call.
+		 */
+		RenderCommandList& setUniform(Material& material, const std::string& name,
+									  const void* data, size_t size);
+
+		template <typename T>
+		RenderCommandList& setUniform(Material& material, const std::string& name, const T& value)
+		{
+			return setUniform(material, name, &value, sizeof(T));
+		}
+
+		/**
+		 * @brief Records a function called in order with the other commands, e.g. to touch the
+		 * backend in ways the command list doesn't cover.
+		 */
+		RenderCommandList& execute(std::function<void()> callback);
+
+		/**
+		 * @brief Replays the recorded commands against the backend, in order.
+		 */
+		void execute() const;
+
+		/**
+		 * @brief Removes every command, keeping the allocated storage for the next frame.
+		 */
+		void clear() noexcept;
+
+		[[nodiscard]] size_t size() const noexcept
+		{
+			return m_commands.size();
+		}
+
+		[[nodiscard]] bool empty() const noexcept
+		{
+			return m_commands.empty();
+		}
+
+	private:
+		void push(const Command& command)
+		{
+			m_commands.push_back(command);
+		}
+
+		void pushUniform(Command command, const std::string& name, const void* data = nullptr,
+						 size_t size = 0);
+	};
+
+
+	/**
+	 * @brief Hands frames of render commands from the game thread to a dedicated render thread.
+	 *
+	 * The game thread records frame N+1 into one command list while the render thread replays
+	 * frame N from the other, so simulation and command encoding overlap. The lists are swapped
+	 * by `submit()`, which only blocks while the render thread is still busy with the previous
+	 * frame; the hand-off itself is a single atomic flag, with no lock on either side. Window
+	 * events are still polled on the game thread.
+	 *
+	 * @code
+	 * gfx::RenderQueue queue;
+	 * while (!window.shouldClose())
+	 * {
+	 *     gfx::RenderCommandList& frame{queue.commands()};
+	 *     frame.setUniform(material, "time", time);
+	 *     frame.pass(pass).begin().bind(material).draw(gfx::Triangle, 0, 3).end();
+	 *     queue.submit();
+	 *
+	 *     Window::pollEvents();
+	 * }
+	 * @endcode
+	 *
+	 * Resources referenced by submitted commands must stay alive until the render thread is done
+	 * with them; call `waitIdle()` before destroying them. Hot-reloaded shaders and pipelines are
+	 * safe: `Window::pollEvents` waits for the render thread to go idle before swapping them in.
+	 */
+	export class RenderQueue
+	{
+		std::array<RenderCommandList, 2> m_lists;
+		size_t m_write{}; ///< List recorded by the game thread.
+		size_t m_read{}; ///< List replayed by the render thread; set while no frame is pending.
+
+		std::atomic<bool> m_pending{false}; ///< A submitted frame is waiting for or in replay.
+		std::atomic<bool> m_running{true};
+		std::thread m_thread;
+
+	public:
+		/**
+		 * @param threaded Replays frames on a render thread; when false, `submit()` replays
+		 * them on the calling thread, e.g. to debug a frame or on single-core machines.
+		 */
+		explicit RenderQueue(bool threaded = true);
+		~RenderQueue();
+
+		RenderQueue(const RenderQueue&) = delete;
+		RenderQueue& operator=(const RenderQueue&) = delete;
+
+		/**
+		 * @brief Gets the list recording the next frame.
+		 */
+		[[nodiscard]] RenderCommandList& commands() noexcept
+		{
+			return m_lists[m_write];
+		}
+
+		/**
+		 * @brief Hands the recorded frame to the render thread and starts recording the next
+		 * one. Waits first if the previous frame is still being replayed.
+		 */
+		void submit();
+
+		/**
+		 * @brief Waits until every submitted frame has been replayed.
+		 */
+		void waitIdle() const;
+
+		[[nodiscard]] bool isThreaded() const noexcept
+		{
+			return m_thread.joinable();
+		}
+
+	private:
+		void renderLoop();
+	};
+} // namespace lune::gfx
@@ -1,4 +1,7 @@
 module;
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <memory>
 export module lune.gfx:render_surface;
 
@@ -15,14 +18,35 @@ namespace lune::gfx
 
 	/**
 	 * @brief Backend interface for a rendering surface.
+	 *
+	 * Resizes are requested from window callbacks and applied by the render pass before it
+	 * acquires its next drawable, once the size has stopped changing for `RESIZE_DEBOUNCE`. A live
+	 * resize therefore recreates the size-dependent resources once it settles rather than on every
+	 * callback, and never while a frame is being encoded. Pipelines and materials don't depend on
+	 * the size and are left untouched.
+	 *
+	 * `m_info` belongs to the thread encoding frames. Other threads read the size through `info()`,
+	 * which is published as a whole once the backend has been resized.
 	 */
 	export class IRenderSurfaceImpl
 	{
+		using Clock = std::chrono::steady_clock;
+
+		std::atomic<uint64_t> m_pendingSize; ///< Latest requested size, width in the high bits.
+		std::atomic<Clock::rep> m_resizeRequested{}; ///< Time of the latest request.
+		std::atomic<uint64_t> m_appliedSize; ///< Size of `m_info`, packed like `m_pendingSize`.
+		std::atomic<uint32_t> m_generation{};
+
 	protected:
 		RenderSurfaceInfo m_info;
 
 	public:
-		explicit IRenderSurfaceImpl(const RenderSurfaceInfo& info) : m_info(info)
+		/// How long the size must stay unchanged before a resize is applied.
+		static constexpr std::chrono::milliseconds RESIZE_DEBOUNCE{100};
+
+		explicit IRenderSurfaceImpl(const RenderSurfaceInfo& info) :
+			m_pendingSize(pack(info.width, info.height)),
+			m_appliedSize(pack(info.width, info.height)), m_info(info)
 		{
 		}
 
@@ -31,9 +55,77 @@ namespace lune::gfx
 		virtual void* currentDrawable() = 0;
 		virtual void* nextDrawable() = 0;
 
-		[[nodiscard]] const RenderSurfaceInfo& info() const noexcept
+		/**
+		 * @brief Gets the size of the surface as of the latest applied resize. Safe to call from
+		 * any thread; width and height always belong to the same resize.
+		 */
+		[[nodiscard]] RenderSurfaceInfo info() const noexcept
+		{
+			const uint64_t size{m_appliedSize.load(std::memory_order_acquire)};
+			return {static_cast<int>(size >> 32), static_cast<int>(size & 0xFFFFFFFF)};
+		}
+
+		/**
+		 * @brief Records a new size to apply once it stops changing. Cheap enough to call from
+		 * every resize callback, from any thread. Empty sizes (e.g. minimized windows) are ignored.
+		 */
+		void requestResize(const int width, const int height) noexcept
+		{
+			if (width <= 0 || height <= 0)
+				return;
+
+			m_resizeRequested.store(Clock::now().time_since_epoch().count(),
+									std::memory_order_relaxed);
+			m_pendingSize.store(pack(width, height), std::memory_order_release);
+		}
+
+		/**
+		 * @brief Applies the latest requested size if it has been stable for `RESIZE_DEBOUNCE`.
+		 * Call from the thread encoding frames, before acquiring a drawable.
+		 *
+		 * @return true if the surface was resized.
+		 */
+		bool applyPendingResize(const Clock::time_point now = Clock::now())
+		{
+			const uint64_t size{m_pendingSize.load(std::memory_order_acquire)};
+			if (size == pack(m_info.width, m_info.height))
+				return false;
+
+			const Clock::time_point requested{
+					Clock::duration{m_resizeRequested.load(std::memory_order_relaxed)}};
+			if (now - requested < RESIZE_DEBOUNCE)
+				return false;
+
+			m_info.width = static_cast<int>(size >> 32);
+			m_info.height = static_cast<int>(size & 0xFFFFFFFF);
+			onResize();
+			m_appliedSize.store(size, std::memory_order_release);
+			m_generation.fetch_add(1, std::memory_order_release);
+			return true;
+		}
+
+		/**
+		 * @brief Gets the number of resizes applied, so size-dependent attachments can tell
+		 * when they need to be recreated.
+		 */
+		[[nodiscard]] uint32_t generation() const noexcept
 		{
-			return m_info;
+			return m_generation.load(std::memory_order_acquire);
+		}
+
+	protected:
+		/**
+		 * @brief Recreates the size-dependent resources of the backend for `m_info`.
+		 */
+		virtual void onResize()
+		{
+		}
+
+	private:
+		static constexpr uint64_t pack(const int width, const int height) noexcept
+		{
+			return static_cast<uint64_t>(static_cast<uint32_t>(width)) << 32 |
+				   static_cast<uint32_t>(height);
 		}
 	};
 
@@ -64,9 +156,24 @@ namespace lune::gfx
 			return m_impl->nextDrawable();
 		}
 
-		[[nodiscard]] const RenderSurfaceInfo& info() const noexcept
+		[[nodiscard]] RenderSurfaceInfo info() const noexcept
 		{
 			return m_impl->info();
 		}
+
+		void requestResize(const int width, const int height) const noexcept
+		{
+			m_impl->requestResize(width, height);
+		}
+
+		bool applyPendingResize() const
+		{
+			return m_impl->applyPendingResize();
+		}
+
+		[[nodiscard]] uint32_t generation() const noexcept
+		{
+			return m_impl->generation();
+		}
 	};
 } // namespace lune::gfx
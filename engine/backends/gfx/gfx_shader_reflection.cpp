@@ -0,0 +1,134 @@
+module;
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+module lune.gfx;
+
+import lune.vfs;
+
+namespace lune::gfx
+{
+	namespace
+	{
+		std::optional<ShaderStage> toStage(const std::string_view name)
+		{
+			if (name == "vertex")
+				return VertexStage;
+			if (name == "fragment")
+				return FragmentStage;
+			if (name == "compute")
+				return ComputeStage;
+
+			return std::nullopt;
+		}
+
+		std::optional<BindingType> toBindingType(const std::string_view name)
+		{
+			if (name == "buffer")
+				return BufferBinding;
+			if (name == "texture")
+				return TextureBinding;
+			if (name == "sampler")
+				return SamplerBinding;
+
+			return std::nullopt;
+		}
+	} // namespace
+
+	std::optional<ShaderReflection> ShaderReflection::parse(const std::string_view text)
+	{
+		std::istringstream stream{std::string(text)};
+		std::string line;
+
+		std::string magic;
+		uint32_t version{};
+		if (!std::getline(stream, line) || !(std::istringstream(line) >> magic >> version) ||
+			magic != "lune-reflection" || version != VERSION)
+		{
+			return std::nullopt;
+		}
+
+		ShaderReflection reflection;
+		while (std::getline(stream, line))
+		{
+			std::istringstream fields{line};
+			std::string keyword;
+			if (!(fields >> keyword) || keyword.starts_with('#'))
+				continue;
+
+			if (keyword == "entry")
+			{
+				ShaderEntryPoint entry;
+				std::string stage;
+				if (!(fields >> entry.name >> stage))
+					return std::nullopt;
+
+				const auto parsedStage{toStage(stage)};
+				if (!parsedStage)
+					return std::nullopt;
+
+				entry.stage = *parsedStage;
+				for (uint32_t& size : entry.threadGroupSize)
+				{
+					if (!(fields >> size))
+						break;
+				}
+
+				reflection.m_entryPoints.push_back(std::move(entry));
+				continue;
+			}
+
+			const auto type{toBindingType(keyword)};
+			ShaderBinding binding;
+			if (!type || reflection.m_entryPoints.empty() ||
+				!(fields >> binding.index >> binding.name))
+			{
+				return std::nullopt;
+			}
+
+			binding.type = *type;
+			reflection.m_entryPoints.back().bindings.push_back(std::move(binding));
+		}
+
+		return reflection;
+	}
+
+	std::optional<ShaderReflection> ShaderReflection::load(const std::string& path)
+	{
+		const auto contents{Vfs::read(path)};
+		if (!contents)
+			return std::nullopt;
+
+		auto reflection{parse(*contents)};
+		if (!reflection)
+			std::cerr << "Malformed shader reflection: " << path << "\n";
+
+		return reflection;
+	}
+
+	std::optional<ShaderReflection> ShaderReflection::loadSidecar(const std::string& shaderPath)
+	{
+		const bool precompiled{shaderPath.ends_with(".metallib") || shaderPath.ends_with(".spv")};
+		if (!precompiled)
+			return std::nullopt;
+
+		return load(sidecarPath(shaderPath));
+	}
+
+	std::string ShaderReflection::sidecarPath(const std::string& shaderPath)
+	{
+		return std::filesystem::path(shaderPath).replace_extension(".reflect").string();
+	}
+
+	const ShaderEntryPoint* ShaderReflection::find(const std::string_view name) const
+	{
+		const auto it{std::ranges::find(m_entryPoints, name, &ShaderEntryPoint::name)};
+		return it != m_entryPoints.end() ? &*it : nullptr;
+	}
+} // namespace lune::gfx
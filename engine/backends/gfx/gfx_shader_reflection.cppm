@@ -0,0 +1,111 @@
+module;
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+export module lune.gfx:shader_reflection;
+
+namespace lune::gfx
+{
+	export enum ShaderStage
+	{
+		VertexStage,
+		FragmentStage,
+		ComputeStage,
+	};
+
+
+	export enum BindingType
+	{
+		BufferBinding,
+		TextureBinding,
+		SamplerBinding,
+	};
+
+
+	export struct ShaderBinding
+	{
+		std::string name;
+		uint32_t index{};
+		BindingType type{BufferBinding};
+	};
+
+
+	export struct ShaderEntryPoint
+	{
+		std::string name;
+		ShaderStage stage{ComputeStage};
+		std::array<uint32_t, 3> threadGroupSize{}; ///< Zero for graphics stages.
+		std::vector<ShaderBinding> bindings;
+	};
+
+
+	/**
+	 * @brief Binding table of a precompiled shader, read from the sidecar written by the offline
+	 * shader build (`lune_compile_shaders` in CMake).
+	 *
+	 * Backends use it instead of asking the driver to reflect the shader at load time. The
+	 * sidecar sits next to the compiled shader with a `.reflect` extension, e.g. `life.metallib`
+	 * and `life.reflect`, and is a line-based text file:
+	 *
+	 * @code
+	 * lune-reflection 1
+	 * entry computeMain compute 16 16 1
+	 * buffer 0 cells
+	 * texture 0 image
+	 * @endcode
+	 *
+	 * Binding lines belong to the entry point above them.
+	 */
+	export class ShaderReflection
+	{
+		std::vector<ShaderEntryPoint> m_entryPoints;
+
+	public:
+		/// Format version written on the first line.
+		static constexpr uint32_t VERSION{1};
+
+		/**
+		 * @brief Parses a sidecar.
+		 *
+		 * @return The table; std::nullopt if the text is malformed or of another version.
+		 */
+		[[nodiscard]] static std::optional<ShaderReflection> parse(std::string_view text);
+
+		/**
+		 * @brief Reads and parses a sidecar file.
+		 *
+		 * @return The table; std::nullopt if the file can't be read or is malformed.
+		 */
+		[[nodiscard]] static std::optional<ShaderReflection> load(const std::string& path);
+
+		/**
+		 * @brief Loads the sidecar of a precompiled shader, if the offline build wrote one.
+		 *
+		 * @param shaderPath Path of the shader; sources compiled at runtime have no sidecar.
+		 *
+		 * @return The table; std::nullopt if the shader has none.
+		 */
+		[[nodiscard]] static std::optional<ShaderReflection>
+		loadSidecar(const std::string& shaderPath);
+
+		/**
+		 * @brief Gets the sidecar path of a compiled shader.
+		 */
+		[[nodiscard]] static std::string sidecarPath(const std::string& shaderPath);
+
+		/**
+		 * @brief Finds an entry point by name.
+		 *
+		 * @return The entry point; nullptr if the shader has none of that name.
+		 */
+		[[nodiscard]] const ShaderEntryPoint* find(std::string_view name) const;
+
+		[[nodiscard]] const std::vector<ShaderEntryPoint>& entryPoints() const noexcept
+		{
+			return m_entryPoints;
+		}
+	};
+} // namespace lune::gfx
@@ -0,0 +1,163 @@
+module;
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <lune/profiler.hpp>
+#include <memory>
+#include <utility>
+module lune.gfx;
+
+namespace lune::gfx
+{
+	StagingManager::StagingManager(const Context& context, const StagingDesc& desc) :
+		m_context(context), m_desc(desc), m_queue(context.getImpl()->createTransferQueue())
+	{
+		m_batches.reserve(m_desc.bufferCount);
+		for (uint32_t i = 0; i < std::max(m_desc.bufferCount, 1u); ++i)
+		{
+			auto& batch{m_batches.emplace_back(std::make_unique<Batch>())};
+			batch->staging = std::make_unique<Buffer>(m_context.createBuffer(m_desc.bufferSize));
+		}
+	}
+
+	StagingManager::~StagingManager()
+	{
+		waitIdle();
+	}
+
+	void StagingManager::upload(const Buffer& destination, const void* data, const size_t size,
+								const size_t offset)
+	{
+		if (m_delivering)
+		{
+			std::cerr << "StagingManager::upload() called from a readback callback\n";
+			return;
+		}
+
+		if (!data || size == 0 || offset + size > destination.size())
+			return;
+
+		const auto [staging, stagingOffset]{allocate(size)};
+		std::memcpy(static_cast<std::byte*>(staging->data()) + stagingOffset, data, size);
+		m_batches[m_current]->copies.push_back({
+				.source = staging,
+				.sourceOffset = stagingOffset,
+				.destination = &destination,
+				.destinationOffset = offset,
+				.size = size,
+		});
+	}
+
+	void StagingManager::readbackAsync(const Buffer& source, const size_t offset,
+									   const size_t size, ReadbackCallback callback)
+	{
+		if (m_delivering)
+		{
+			std::cerr << "StagingManager::readbackAsync() called from a readback callback\n";
+			return;
+		}
+
+		if (size == 0 || offset + size > source.size())
+			return;
+
+		const auto [staging, stagingOffset]{allocate(size)};
+		Batch& batch{*m_batches[m_current]};
+		batch.copies.push_back({
+				.source = &source,
+				.sourceOffset = offset,
+				.destination = staging,
+				.destinationOffset = stagingOffset,
+				.size = size,
+		});
+		batch.readbacks.push_back({staging, stagingOffset, size, std::move(callback)});
+	}
+
+	void StagingManager::flush()
+	{
+		LUNE_ZONE("StagingManager::flush");
+
+		Batch& batch{*m_batches[m_current]};
+		if (m_delivering || batch.copies.empty())
+			return;
+
+		batch.inFlight.store(true, std::memory_order_relaxed);
+		m_submitted.push_back(m_current);
+		m_queue->submit(batch.copies,
+						[&batch]
+						{
+							batch.inFlight.store(false, std::memory_order_release);
+							batch.inFlight.notify_all();
+						});
+
+		// The next batch of the ring is the oldest one when they are all in flight
+		m_current = (m_current + 1) % m_batches.size();
+		if (m_submitted.size() == m_batches.size())
+			retireOldest();
+	}
+
+	size_t StagingManager::poll()
+	{
+		size_t delivered{};
+		while (!m_submitted.empty() &&
+			   !m_batches[m_submitted.front()]->inFlight.load(std::memory_order_acquire))
+		{
+			delivered += retireOldest();
+		}
+		return delivered;
+	}
+
+	void StagingManager::waitIdle()
+	{
+		flush();
+		while (!m_submitted.empty())
+			retireOldest();
+	}
+
+	std::pair<const Buffer*, size_t> StagingManager::allocate(const size_t size)
+	{
+		if (size > m_desc.bufferSize)
+		{
+			auto& dedicated{m_batches[m_current]->dedicated};
+			dedicated.push_back(std::make_unique<Buffer>(m_context.createBuffer(size)));
+			return {dedicated.back().get(), 0};
+		}
+
+		size_t offset{(m_batches[m_current]->used + COPY_ALIGNMENT - 1) & ~(COPY_ALIGNMENT - 1)};
+		if (offset + size > m_desc.bufferSize)
+		{
+			flush();
+			offset = 0;
+		}
+
+		Batch& batch{*m_batches[m_current]};
+		batch.used = offset + size;
+		return {batch.staging.get(), offset};
+	}
+
+	size_t StagingManager::retireOldest()
+	{
+		LUNE_ZONE("StagingManager::retireOldest");
+
+		Batch& batch{*m_batches[m_submitted.front()]};
+		batch.inFlight.wait(true, std::memory_order_acquire);
+		m_submitted.pop_front();
+
+		m_delivering = true;
+		for (const Readback& readback : batch.readbacks)
+		{
+			const auto* bytes{static_cast<const std::byte*>(readback.staging->data())};
+			readback.callback({bytes + readback.offset, readback.size});
+		}
+		m_delivering = false;
+
+		const size_t delivered{batch.readbacks.size()};
+		batch.used = 0;
+		batch.copies.clear();
+		batch.readbacks.clear();
+		batch.dedicated.clear();
+		return delivered;
+	}
+} // namespace lune::gfx
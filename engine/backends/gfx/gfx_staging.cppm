@@ -0,0 +1,153 @@
+module;
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+export module lune.gfx:staging;
+
+import :buffer;
+import :context;
+
+namespace lune::gfx
+{
+	export struct StagingDesc
+	{
+		size_t bufferSize{4 * 1024 * 1024}; ///< Size of each staging buffer of the ring.
+
+		/// Staging buffers in the ring, i.e. how many batches can be in flight at once.
+		uint32_t bufferCount{3};
+	};
+
+
+	/**
+	 * @brief Moves data in and out of GPU buffers without stalling the frame.
+	 *
+	 * Uploads are copied into a ring of CPU-visible staging buffers and copied on to their
+	 * destination by the backend's transfer queue; readbacks go the other way and hand their
+	 * bytes to a callback once the GPU has written them. Transfers are batched until `flush()`,
+	 * and every batch occupies one staging buffer of the ring until the GPU is done with it.
+	 * Recording only blocks when the ring is full of batches still in flight. Transfers larger
+	 * than a staging buffer get a staging buffer of their own.
+	 *
+	 * @code
+	 * gfx::Buffer vertices{ctx.createBuffer(size, gfx::Private)};
+	 * gfx::StagingManager staging{ctx};
+	 * staging.upload(vertices, data, size);
+	 * staging.readbackAsync(results, 0, results.size(), [](std::span<const std::byte> bytes) {});
+	 * staging.flush();
+	 * ...
+	 * staging.poll(); // Once per frame, delivers the readbacks that have completed
+	 * @endcode
+	 *
+	 * Destination and source buffers must outlive the transfers that use them.
+	 */
+	export class StagingManager
+	{
+	public:
+		using ReadbackCallback = std::function<void(std::span<const std::byte>)>;
+
+	private:
+		struct Readback
+		{
+			const Buffer* staging;
+			size_t offset;
+			size_t size;
+			ReadbackCallback callback;
+		};
+
+		struct Batch
+		{
+			std::unique_ptr<Buffer> staging;
+			size_t used{};
+			std::vector<BufferCopy> copies;
+			std::vector<Readback> readbacks;
+			std::vector<std::unique_ptr<Buffer>> dedicated; ///< Staging for oversized transfers.
+			std::atomic<bool> inFlight{false};
+		};
+
+		/// Copies are aligned for every backend's buffer-copy requirements.
+		static constexpr size_t COPY_ALIGNMENT{16};
+
+		const Context& m_context;
+		StagingDesc m_desc;
+		std::unique_ptr<ITransferQueueImpl> m_queue;
+
+		std::vector<std::unique_ptr<Batch>> m_batches; ///< The ring.
+		size_t m_current{}; ///< Batch recording transfers.
+		std::deque<size_t> m_submitted; ///< Batches in flight or undelivered, oldest first.
+		bool m_delivering{};
+
+	public:
+		explicit StagingManager(const Context& context, const StagingDesc& desc = {});
+
+		/**
+		 * @brief Waits for every transfer, delivering the pending readbacks.
+		 */
+		~StagingManager();
+
+		StagingManager(const StagingManager&) = delete;
+		StagingManager& operator=(const StagingManager&) = delete;
+
+		/**
+		 * @brief Copies data into a buffer on the next flush. The data is copied before the call
+		 * returns, so it may be freed right away.
+		 */
+		void upload(const Buffer& destination, const void* data, size_t size, size_t offset = 0);
+
+		/**
+		 * @brief Copies a range of a buffer back to the CPU on the next flush.
+		 *
+		 * @param callback Called by `poll()` once the copy has completed. The span is only valid
+		 * during the call, and the callback must not record transfers itself.
+		 */
+		void readbackAsync(const Buffer& source, size_t offset, size_t size,
+						   ReadbackCallback callback);
+
+		/**
+		 * @brief Submits the recorded transfers to the transfer queue without waiting for them.
+		 *
+		 * Uploads are seen by the work submitted after the flush, and readbacks see the work
+		 * submitted before it.
+		 */
+		void flush();
+
+		/**
+		 * @brief Delivers the readbacks of completed batches, in submission order, and recycles
+		 * their staging buffers. Call regularly, e.g. once per frame.
+		 *
+		 * @return The number of readbacks delivered.
+		 */
+		size_t poll();
+
+		/**
+		 * @brief Flushes and waits until every transfer has completed, delivering the readbacks.
+		 */
+		void waitIdle();
+
+		/**
+		 * @brief Gets the number of submitted batches not yet recycled by `poll()`.
+		 */
+		[[nodiscard]] size_t pendingBatches() const noexcept
+		{
+			return m_submitted.size();
+		}
+
+	private:
+		/**
+		 * @brief Reserves staging memory in the current batch, flushing it when full.
+		 *
+		 * @return The staging buffer and the offset of the reservation in it.
+		 */
+		std::pair<const Buffer*, size_t> allocate(size_t size);
+
+		/**
+		 * @brief Waits for the oldest submitted batch, then delivers its readbacks and resets it.
+		 */
+		size_t retireOldest();
+	};
+} // namespace lune::gfx
@@ -1,4 +1,5 @@
 module;
+#include <cstddef>
 #include <stb_image.h>
 #include <string>
 #include <memory>
@@ -45,6 +46,14 @@ namespace lune::gfx
 		 * @param desiredChannelCount Number of channels to load (e.g., STBI_rgb_alpha).
 		 */
 		virtual void load(const std::string& path, int desiredChannelCount) = 0;
+
+		/**
+		 * @brief Replaces the pixels of the whole texture, after the GPU work already submitted.
+		 *
+		 * @param data Pixels in the texture's format, row by row.
+		 * @param bytesPerRow Distance between the starts of two rows of `data`.
+		 */
+		virtual void setData(const void* data, size_t bytesPerRow) = 0;
 	};
 
 	/**
@@ -68,6 +77,9 @@ namespace lune::gfx
 
 		~Texture() = default;
 
+		Texture(Texture&&) noexcept = default;
+		Texture& operator=(Texture&&) noexcept = default;
+
 		/**
 		 * @brief Gets the platform-specific implementation of a texture.
 		 *
@@ -91,6 +103,20 @@ namespace lune::gfx
 			m_impl->load(path, desiredChannelCount);
 		}
 
+		/**
+		 * @brief Replaces the pixels of the whole texture from CPU memory.
+		 *
+		 * The pixels are copied before the call returns and reach the texture once the GPU work
+		 * already submitted has completed, so frames still sampling the texture are unaffected.
+		 *
+		 * @param data Pixels in the texture's format, row by row.
+		 * @param bytesPerRow Distance between the starts of two rows of `data`.
+		 */
+		void setData(const void* data, const size_t bytesPerRow) const
+		{
+			m_impl->setData(data, bytesPerRow);
+		}
+
 		/**
 		 * @brief Returns texture width in pixels.
 		 */
@@ -0,0 +1,84 @@
+module;
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+module lune.gfx;
+
+namespace lune::gfx
+{
+	void GpuTimings::record(const std::string& label, const double start, const double end)
+	{
+		const double duration{end - start};
+
+		std::lock_guard lock(m_mutex);
+
+		auto [it, inserted]{m_stats.try_emplace(label)};
+		GpuTimingStats& stats = it->second;
+		stats.min = inserted ? duration : std::min(stats.min, duration);
+		stats.max = inserted ? duration : std::max(stats.max, duration);
+		stats.last = duration;
+		stats.total += duration;
+		++stats.count;
+
+		if (m_pending.size() < MAX_PENDING_SAMPLES)
+		{
+			m_pending.push_back({label, start, end});
+		}
+		else
+		{
+			++m_droppedSamples;
+		}
+	}
+
+	std::vector<GpuTiming> GpuTimings::collect()
+	{
+		std::vector<GpuTiming> samples;
+		size_t dropped;
+		{
+			std::lock_guard lock(m_mutex);
+			samples = std::exchange(m_pending, {});
+			dropped = std::exchange(m_droppedSamples, 0);
+		}
+
+		if (dropped > 0)
+		{
+			std::cerr << "GpuTimings dropped " << dropped
+					  << " samples; call collect() more often.\n";
+		}
+
+		return samples;
+	}
+
+	std::optional<GpuTimingStats> GpuTimings::getStats(const std::string& label)
+	{
+		std::lock_guard lock(m_mutex);
+
+		const auto it{m_stats.find(label)};
+		if (it == m_stats.end())
+		{
+			return std::nullopt;
+		}
+
+		return it->second;
+	}
+
+	std::map<std::string, GpuTimingStats, std::less<>> GpuTimings::getAllStats()
+	{
+		std::lock_guard lock(m_mutex);
+		return m_stats;
+	}
+
+	void GpuTimings::reset()
+	{
+		std::lock_guard lock(m_mutex);
+		m_pending.clear();
+		m_stats.clear();
+		m_droppedSamples = 0;
+	}
+} // namespace lune::gfx
@@ -0,0 +1,121 @@
+module;
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+export module lune.gfx:timing;
+
+namespace lune::gfx
+{
+	/**
+	 * @brief GPU execution time of one dispatch or render pass.
+	 */
+	export struct GpuTiming
+	{
+		std::string label; ///< Kernel name or render pass label.
+		double start{};	   ///< GPU start time in seconds, in the backend's host time domain.
+		double end{};	   ///< GPU end time in seconds.
+
+		[[nodiscard]] double duration() const noexcept
+		{
+			return end - start;
+		}
+	};
+
+
+	/**
+	 * @brief Accumulated GPU times of all work submitted under one label.
+	 */
+	export struct GpuTimingStats
+	{
+		uint64_t count{};
+		double last{};	///< Duration of the most recent sample, in seconds.
+		double total{}; ///< Sum of all durations, in seconds.
+		double min{};
+		double max{};
+
+		[[nodiscard]] double average() const noexcept
+		{
+			return count > 0 ? total / static_cast<double>(count) : 0.0;
+		}
+	};
+
+
+	/**
+	 * @brief Collects GPU timestamps of compute dispatches and render passes.
+	 *
+	 * Backends read the timestamps of each submission once the GPU has finished it (e.g. from a
+	 * completion handler) and report them here, so timing never waits on the GPU. Samples arrive
+	 * a frame or more after submission, in completion order and from backend threads.
+	 *
+	 * @code
+	 * kernel.dispatch(width, height, 1);
+	 * ...
+	 * for (const GpuTiming& timing : GpuTimings::collect())
+	 *     std::println("{}: {} ms", timing.label, timing.duration() * 1000.0);
+	 * @endcode
+	 */
+	export class GpuTimings
+	{
+		static inline std::atomic<bool> m_enabled{true};
+		static inline std::mutex m_mutex;
+		static inline std::vector<GpuTiming> m_pending;
+		static inline std::map<std::string, GpuTimingStats, std::less<>> m_stats;
+		static inline size_t m_droppedSamples{};
+
+	public:
+		/// Uncollected samples kept before new ones are dropped; stats are always updated.
+		static constexpr size_t MAX_PENDING_SAMPLES{4096};
+
+		/**
+		 * @brief Enables or disables timing. Disabled backends skip reading timestamps entirely.
+		 */
+		static void setEnabled(const bool enabled) noexcept
+		{
+			m_enabled.store(enabled, std::memory_order_relaxed);
+		}
+
+		[[nodiscard]] static bool isEnabled() noexcept
+		{
+			return m_enabled.load(std::memory_order_relaxed);
+		}
+
+		/**
+		 * @brief Reports a completed submission. Called by backends from any thread.
+		 *
+		 * @param label Kernel name or render pass label.
+		 * @param start GPU start time in seconds.
+		 * @param end GPU end time in seconds.
+		 */
+		static void record(const std::string& label, double start, double end);
+
+		/**
+		 * @brief Takes the samples completed since the last call.
+		 *
+		 * @return The samples, in completion order.
+		 */
+		[[nodiscard]] static std::vector<GpuTiming> collect();
+
+		/**
+		 * @brief Gets the accumulated stats of a label.
+		 *
+		 * @return The stats; std::nullopt if nothing was recorded under the label.
+		 */
+		[[nodiscard]] static std::optional<GpuTimingStats> getStats(const std::string& label);
+
+		/**
+		 * @brief Gets the accumulated stats of every label.
+		 */
+		[[nodiscard]] static std::map<std::string, GpuTimingStats, std::less<>> getAllStats();
+
+		/**
+		 * @brief Clears pending samples and accumulated stats.
+		 */
+		static void reset();
+	};
+} // namespace lune::gfx
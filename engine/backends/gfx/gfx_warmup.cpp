@@ -0,0 +1,156 @@
+module;
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+module lune.gfx;
+
+import lune.jobs;
+
+namespace lune::gfx
+{
+	PipelineWarmup::PipelineWarmup(const Context& context, WarmupManifest manifest) :
+		m_context(context), m_manifest(std::move(manifest))
+	{
+		// Pipelines sharing a shader wait on a single compilation of it
+		std::vector<size_t> shaderDescs;
+		for (size_t pipeline = 0; pipeline < m_manifest.pipelines.size(); ++pipeline)
+		{
+			const ShaderDesc& desc{m_manifest.pipelines[pipeline].shader};
+			const auto it{std::ranges::find_if(
+					shaderDescs,
+					[&](const size_t other)
+					{
+						const ShaderDesc& shader{m_manifest.pipelines[other].shader};
+						return shader.path == desc.path && shader.vsMain == desc.vsMain &&
+							   shader.fsMain == desc.fsMain;
+					})};
+
+			const auto shader{static_cast<size_t>(it - shaderDescs.begin())};
+			if (it == shaderDescs.end())
+			{
+				shaderDescs.push_back(pipeline);
+				m_shaderPipelines.emplace_back();
+			}
+
+			m_shaderPipelines[shader].push_back(pipeline);
+			m_pipelineShaders.push_back(shader);
+		}
+
+		// Every job writes to its own slot, so the results need no locking
+		m_shaders.resize(m_shaderPipelines.size());
+		m_pipelines.resize(m_manifest.pipelines.size());
+		m_computeShaders.resize(m_manifest.computeShaders.size());
+		m_total = m_shaders.size() + m_pipelines.size() + m_computeShaders.size();
+
+		JobSystem& jobs{JobSystem::instance()};
+		for (size_t shader = 0; shader < m_shaders.size(); ++shader)
+			jobs.submit([this, shader] { compileShader(shader); }, &m_counter);
+
+		for (size_t shader = 0; shader < m_computeShaders.size(); ++shader)
+			jobs.submit([this, shader] { compileComputeShader(shader); }, &m_counter);
+	}
+
+	PipelineWarmup::~PipelineWarmup()
+	{
+		wait();
+	}
+
+	void PipelineWarmup::wait() const
+	{
+		JobSystem::instance().wait(m_counter);
+	}
+
+	Pipeline* PipelineWarmup::pipeline(const size_t index) const
+	{
+		return m_pipelines.at(index).get();
+	}
+
+	Shader* PipelineWarmup::shader(const size_t index) const
+	{
+		return m_shaders[m_pipelineShaders.at(index)].get();
+	}
+
+	ComputeShader* PipelineWarmup::computeShader(const size_t index) const
+	{
+		return m_computeShaders.at(index).get();
+	}
+
+	void PipelineWarmup::compileShader(const size_t shader)
+	{
+		const ShaderDesc& desc{m_manifest.pipelines[m_shaderPipelines[shader].front()].shader};
+		try
+		{
+			auto created{std::make_unique<Shader>(m_context.createShader(desc))};
+			if (created->isValid())
+				m_shaders[shader] = std::move(created);
+			else
+				std::cerr << "Failed to warm up shader " << desc.path << "\n";
+		}
+		catch (const std::exception& exception)
+		{
+			std::cerr << "Failed to warm up shader " << desc.path << ": " << exception.what()
+					  << "\n";
+		}
+		m_completed.fetch_add(1, std::memory_order_relaxed);
+
+		// Submitted before this job finishes, so the counter never drops to zero in between
+		for (const size_t pipeline : m_shaderPipelines[shader])
+		{
+			if (m_shaders[shader])
+			{
+				JobSystem::instance().submit([this, pipeline] { buildPipeline(pipeline); },
+											 &m_counter);
+			}
+			else
+			{
+				m_completed.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+	}
+
+	void PipelineWarmup::buildPipeline(const size_t pipeline)
+	{
+		const Shader& shader{*m_shaders[m_pipelineShaders[pipeline]]};
+		try
+		{
+			auto created{std::make_unique<Pipeline>(
+					m_context.createPipeline(shader, m_manifest.pipelines[pipeline].pipeline))};
+			if (created->isValid())
+				m_pipelines[pipeline] = std::move(created);
+			else
+				std::cerr << "Failed to warm up pipeline of "
+						  << m_manifest.pipelines[pipeline].shader.path << "\n";
+		}
+		catch (const std::exception& exception)
+		{
+			std::cerr << "Failed to warm up pipeline of "
+					  << m_manifest.pipelines[pipeline].shader.path << ": " << exception.what()
+					  << "\n";
+		}
+		m_completed.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void PipelineWarmup::compileComputeShader(const size_t shader)
+	{
+		const std::string& path{m_manifest.computeShaders[shader]};
+		try
+		{
+			auto created{std::make_unique<ComputeShader>(m_context.createComputeShader(path))};
+			if (created->isValid())
+				m_computeShaders[shader] = std::move(created);
+			else
+				std::cerr << "Failed to warm up compute shader " << path << "\n";
+		}
+		catch (const std::exception& exception)
+		{
+			std::cerr << "Failed to warm up compute shader " << path << ": " << exception.what()
+					  << "\n";
+		}
+		m_completed.fetch_add(1, std::memory_order_relaxed);
+	}
+} // namespace lune::gfx
@@ -0,0 +1,133 @@
+module;
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+export module lune.gfx:warmup;
+
+import lune.jobs;
+import :graphics;
+import :compute;
+import :context;
+
+namespace lune::gfx
+{
+	export struct PipelineWarmupDesc
+	{
+		ShaderDesc shader;
+		PipelineDesc pipeline{};
+	};
+
+
+	/**
+	 * @brief Shaders and pipelines an application needs before its first frame.
+	 */
+	export struct WarmupManifest
+	{
+		std::vector<PipelineWarmupDesc> pipelines;
+		std::vector<std::string> computeShaders; ///< Paths; every kernel of a shader is built.
+	};
+
+
+	/**
+	 * @brief Compiles a manifest of shaders and pipelines in parallel on the job system.
+	 *
+	 * Every distinct shader of the manifest is compiled once, and the pipelines using it are built
+	 * as soon as it is ready. The results stay owned by the warm-up, in manifest order, so a
+	 * loading screen can poll `progress()` while they compile:
+	 *
+	 * @code
+	 * gfx::WarmupManifest manifest;
+	 * manifest.pipelines.push_back({.shader = {"shaders/basic.metal"}});
+	 * manifest.computeShaders.push_back("shaders/life.metallib");
+	 *
+	 * gfx::PipelineWarmup warmup{ctx, std::move(manifest)};
+	 * warmup.wait();
+	 * gfx::Material material{ctx.createMaterial(*warmup.pipeline(0))};
+	 * @endcode
+	 */
+	export class PipelineWarmup
+	{
+		const Context& m_context;
+		WarmupManifest m_manifest;
+
+		std::vector<std::unique_ptr<Shader>> m_shaders; ///< One per distinct shader.
+		std::vector<std::vector<size_t>> m_shaderPipelines; ///< Pipelines using each shader.
+		std::vector<size_t> m_pipelineShaders; ///< Shader of each pipeline.
+		std::vector<std::unique_ptr<Pipeline>> m_pipelines;
+		std::vector<std::unique_ptr<ComputeShader>> m_computeShaders;
+
+		JobCounter m_counter;
+		std::atomic<size_t> m_completed{0};
+		size_t m_total{};
+
+	public:
+		/**
+		 * @brief Starts compiling the manifest.
+		 *
+		 * @param context Context creating the objects; must outlive the warm-up.
+		 */
+		PipelineWarmup(const Context& context, WarmupManifest manifest);
+
+		/**
+		 * @brief Waits for the jobs still running.
+		 */
+		~PipelineWarmup();
+
+		PipelineWarmup(const PipelineWarmup&) = delete;
+		PipelineWarmup& operator=(const PipelineWarmup&) = delete;
+
+		[[nodiscard]] bool isDone() const noexcept
+		{
+			return m_counter.isDone();
+		}
+
+		/**
+		 * @brief Gets the fraction of shaders and pipelines finished so far, failed ones included.
+		 */
+		[[nodiscard]] float progress() const noexcept
+		{
+			const size_t completed{m_completed.load(std::memory_order_relaxed)};
+			return m_total > 0 ? static_cast<float>(completed) / static_cast<float>(m_total) : 1.0f;
+		}
+
+		/**
+		 * @brief Blocks until the manifest is compiled, executing queued jobs in the meantime.
+		 */
+		void wait() const;
+
+		/**
+		 * @brief Gets a pipeline of the manifest. Only valid once the warm-up is done.
+		 *
+		 * @param index Index in `WarmupManifest::pipelines`.
+		 *
+		 * @return The pipeline; nullptr if it or its shader failed to build.
+		 */
+		[[nodiscard]] Pipeline* pipeline(size_t index) const;
+
+		/**
+		 * @brief Gets the shader of a pipeline of the manifest. Only valid once the warm-up is
+		 * done.
+		 *
+		 * @param index Index in `WarmupManifest::pipelines`.
+		 *
+		 * @return The shader; nullptr if it failed to compile.
+		 */
+		[[nodiscard]] Shader* shader(size_t index) const;
+
+		/**
+		 * @brief Gets a compute shader of the manifest. Only valid once the warm-up is done.
+		 *
+		 * @param index Index in `WarmupManifest::computeShaders`.
+		 *
+		 * @return The compute shader; nullptr if it failed to compile.
+		 */
+		[[nodiscard]] ComputeShader* computeShader(size_t index) const;
+
+	private:
+		void compileShader(size_t shader);
+		void buildPipeline(size_t pipeline);
+		void compileComputeShader(size_t shader);
+	};
+} // namespace lune::gfx
@@ -1,5 +1,7 @@
 module;
 #include <Metal/Metal.hpp>
+#include <cstring>
+#include <iostream>
 module lune.metal;
 
 namespace lune::metal
@@ -9,6 +11,13 @@ namespace lune::metal
 		if (!data || size == 0)
 			return;
 
+		if (m_usage == gfx::Private || m_usage == gfx::Memoryless)
+		{
+			std::cerr << "Buffer::setData(): the buffer isn't CPU accessible; upload through a "
+						 "StagingManager\n";
+			return;
+		}
+
 		// Clamp to avoid overrunning the buffer
 		if (offset >= m_size)
 			return;
@@ -18,7 +27,8 @@ namespace lune::metal
 		void* dst = static_cast<uint8_t*>(m_buffer->contents()) + offset;
 		std::memcpy(dst, data, size);
 
-		// Tell Metal the CPU modified the range
-		m_buffer->didModifyRange(NS::Range{offset, size});
+		// Managed buffers keep a separate GPU copy, which must be told about the CPU write
+		if (m_usage == gfx::Managed)
+			m_buffer->didModifyRange(NS::Range{offset, size});
 	}
 } // namespace lune::metal
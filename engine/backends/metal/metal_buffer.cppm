@@ -3,6 +3,8 @@ module;
 export module lune.metal:buffer;
 
 import lune.gfx;
+import lune.memory;
+import :mappings;
 
 namespace lune::metal
 {
@@ -10,13 +12,17 @@ namespace lune::metal
 	{
 		NS::SharedPtr<MTL::Buffer> m_buffer{};
 		size_t m_size{};
+		gfx::BufferUsage m_usage{};
+		TrackedAllocation m_allocation;
 
 	public:
-		MetalBufferImpl(MTL::Device* device, const size_t size) : m_size(size)
+		MetalBufferImpl(MTL::Device* device, const size_t size,
+						const gfx::BufferUsage usage = gfx::Shared) :
+			m_size(size), m_usage(usage)
 		{
-			// Todo Allow setting the option externally through universal api
 			m_buffer = NS::TransferPtr(
-					device->newBuffer(static_cast<NS::Integer>(size), MTL::StorageModeShared));
+					device->newBuffer(static_cast<NS::Integer>(size), toMetal(usage)));
+			m_allocation = TrackedAllocation{MEMORY_TAG_GPU_BUFFER, m_buffer->allocatedSize()};
 		}
 
 		void setData(const void* data, size_t size, size_t offset) override;
@@ -28,6 +34,7 @@ namespace lune::metal
 
 		[[nodiscard]] void* data() const override
 		{
+			// Private and memoryless buffers have no CPU mapping
 			return m_buffer->contents();
 		}
 
@@ -1,11 +1,371 @@
 module;
 #include <Metal/Metal.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <utility>
+#include <vector>
 module lune.metal;
 
+import lune.jobs;
+
 namespace lune::metal
 {
+	namespace
+	{
+		/// Threads per threadgroup of every primitive, one element each. Must match the source.
+		constexpr size_t BLOCK_SIZE{256};
+		constexpr uint32_t RADIX_BITS{4};
+
+		/// Most threadgroups of the kernels that loop over their input.
+		constexpr size_t MAX_STRIDED_GROUPS{1024};
+
+		/// Mirrors `Params` in the kernel source.
+		struct PrimitiveParams
+		{
+			uint32_t count;
+			uint32_t shift;
+			uint32_t binCount;
+			uint32_t flags; ///< Inclusive scan, or a sort with values.
+		};
+
+		constexpr const char* PRIMITIVES_SOURCE{R"(
+#include <metal_stdlib>
+using namespace metal;
+
+constant uint BLOCK_SIZE = 256;
+constant uint SIMD_WIDTH = 32; // Every Apple GPU
+constant uint SIMD_COUNT = BLOCK_SIZE / SIMD_WIDTH;
+constant uint RADIX_BITS = 4;
+constant uint RADIX = 1 << RADIX_BITS;
+constant uint LOCAL_BINS = 4096;
+
+struct Params
+{
+	uint count;
+	uint shift;
+	uint binCount;
+	uint flags;
+};
+
+// Exclusive prefix sum across the threadgroup; `totals` holds SIMD_COUNT + 1 elements
+uint blockExclusiveScan(uint value, uint lane, uint simd, threadgroup uint* totals,
+						thread uint& total)
+{
+	const uint prefix = simd_prefix_exclusive_sum(value);
+	if (lane == SIMD_WIDTH - 1)
+		totals[simd] = prefix + value;
+	threadgroup_barrier(mem_flags::mem_threadgroup);
+
+	if (simd == 0)
+	{
+		const uint simdTotal = lane < SIMD_COUNT ? totals[lane] : 0;
+		const uint simdPrefix = simd_prefix_exclusive_sum(simdTotal);
+		if (lane < SIMD_COUNT)
+			totals[lane] = simdPrefix;
+		if (lane == SIMD_COUNT - 1)
+			totals[SIMD_COUNT] = simdPrefix + simdTotal;
+	}
+	threadgroup_barrier(mem_flags::mem_threadgroup);
+
+	total = totals[SIMD_COUNT];
+	const uint result = prefix + totals[simd];
+	threadgroup_barrier(mem_flags::mem_threadgroup);
+	return result;
+}
+
+kernel void lune_scan_blocks(device const uint* input [[buffer(0)]],
+							 device uint* output [[buffer(1)]],
+							 device uint* blockSums [[buffer(2)]],
+							 constant Params& params [[buffer(3)]],
+							 uint id [[thread_position_in_grid]],
+							 uint local [[thread_position_in_threadgroup]],
+							 uint group [[threadgroup_position_in_grid]],
+							 uint lane [[thread_index_in_simdgroup]],
+							 uint simd [[simdgroup_index_in_threadgroup]])
+{
+	threadgroup uint totals[SIMD_COUNT + 1];
+
+	const uint value = id < params.count ? input[id] : 0;
+	uint total;
+	const uint prefix = blockExclusiveScan(value, lane, simd, totals, total);
+	if (id < params.count)
+		output[id] = params.flags ? prefix + value : prefix;
+	if (local == 0)
+		blockSums[group] = total;
+}
+
+kernel void lune_add_block_offsets(device uint* output [[buffer(0)]],
+								   device const uint* blockOffsets [[buffer(1)]],
+								   constant Params& params [[buffer(2)]],
+								   uint id [[thread_position_in_grid]],
+								   uint group [[threadgroup_position_in_grid]])
+{
+	if (id < params.count)
+		output[id] += blockOffsets[group];
+}
+
+kernel void lune_reduce(device const uint* input [[buffer(0)]],
+						device atomic_uint* result [[buffer(1)]],
+						constant Params& params [[buffer(2)]],
+						uint id [[thread_position_in_grid]],
+						uint gridSize [[threads_per_grid]],
+						uint local [[thread_position_in_threadgroup]],
+						uint lane [[thread_index_in_simdgroup]],
+						uint simd [[simdgroup_index_in_threadgroup]])
+{
+	threadgroup uint totals[SIMD_COUNT];
+
+	uint sum = 0;
+	for (uint i = id; i < params.count; i += gridSize)
+		sum += input[i];
+
+	sum = simd_sum(sum);
+	if (lane == 0)
+		totals[simd] = sum;
+	threadgroup_barrier(mem_flags::mem_threadgroup);
+
+	if (local == 0)
+	{
+		uint total = 0;
+		for (uint i = 0; i < SIMD_COUNT; ++i)
+			total += totals[i];
+		atomic_fetch_add_explicit(result, total, memory_order_relaxed);
+	}
+}
+
+kernel void lune_compact_scatter(device const uint* input [[buffer(0)]],
+								 device const uint* flags [[buffer(1)]],
+								 device const uint* offsets [[buffer(2)]],
+								 device uint* output [[buffer(3)]],
+								 device uint* outputCount [[buffer(4)]],
+								 constant Params& params [[buffer(5)]],
+								 uint id [[thread_position_in_grid]])
+{
+	if (id >= params.count)
+		return;
+
+	if (flags[id] != 0)
+		output[offsets[id]] = input[id];
+	if (id == params.count - 1)
+		*outputCount = offsets[id] + (flags[id] != 0 ? 1 : 0);
+}
+
+kernel void lune_histogram(device const uint* input [[buffer(0)]],
+						   device atomic_uint* bins [[buffer(1)]],
+						   constant Params& params [[buffer(2)]],
+						   uint id [[thread_position_in_grid]],
+						   uint gridSize [[threads_per_grid]],
+						   uint local [[thread_position_in_threadgroup]])
+{
+	// Bins that fit are counted in threadgroup memory first, so the device atomics only see
+	// one add per bin and threadgroup
+	threadgroup atomic_uint localBins[LOCAL_BINS];
+	const bool useLocal = params.binCount <= LOCAL_BINS;
+
+	if (useLocal)
+	{
+		for (uint bin = local; bin < params.binCount; bin += BLOCK_SIZE)
+			atomic_store_explicit(&localBins[bin], 0, memory_order_relaxed);
+	}
+	threadgroup_barrier(mem_flags::mem_threadgroup);
+
+	for (uint i = id; i < params.count; i += gridSize)
+	{
+		const uint bin = (input[i] >> params.shift) % params.binCount;
+		if (useLocal)
+			atomic_fetch_add_explicit(&localBins[bin], 1, memory_order_relaxed);
+		else
+			atomic_fetch_add_explicit(&bins[bin], 1, memory_order_relaxed);
+	}
+	threadgroup_barrier(mem_flags::mem_threadgroup);
+
+	if (useLocal)
+	{
+		for (uint bin = local; bin < params.binCount; bin += BLOCK_SIZE)
+		{
+			const uint count = atomic_load_explicit(&localBins[bin], memory_order_relaxed);
+			if (count != 0)
+				atomic_fetch_add_explicit(&bins[bin], count, memory_order_relaxed);
+		}
+	}
+}
+
+template <typename Key>
+uint digitOf(Key key, constant Params& params)
+{
+	return uint(key >> params.shift) & (RADIX - 1);
+}
+
+// Counts the digits of a block, digit-major, so a scan of the counts gives every block the
+// offset of each of its digits
+template <typename Key>
+void radixCount(device const Key* keys, device uint* blockCounts, constant Params& params,
+				threadgroup atomic_uint* counts, uint id, uint local, uint group, uint groupCount)
+{
+	if (local < RADIX)
+		atomic_store_explicit(&counts[local], 0, memory_order_relaxed);
+	threadgroup_barrier(mem_flags::mem_threadgroup);
+
+	if (id < params.count)
+		atomic_fetch_add_explicit(&counts[digitOf(keys[id], params)], 1, memory_order_relaxed);
+	threadgroup_barrier(mem_flags::mem_threadgroup);
+
+	if (local < RADIX)
+	{
+		blockCounts[local * groupCount + group] =
+				atomic_load_explicit(&counts[local], memory_order_relaxed);
+	}
+}
+
+template <typename Key>
+void radixScatter(device const Key* keysIn, device const uint* valuesIn, device Key* keysOut,
+				  device uint* valuesOut, device const uint* blockOffsets,
+				  constant Params& params, threadgroup Key* sortedKeys,
+				  threadgroup uint* sortedValues, threadgroup uint* digitStarts,
+				  threadgroup uint* totals, uint id, uint local, uint group, uint groupCount,
+				  uint lane, uint simd)
+{
+	const bool hasValues = params.flags != 0;
+
+	// Past the end, keys have the largest digit and sort after every real key of the block
+	Key key = id < params.count ? keysIn[id] : ~Key(0);
+	uint value = hasValues && id < params.count ? valuesIn[id] : 0;
+	uint digit = digitOf(key, params);
+
+	// Stable split of the block on every bit of the digit, leaving it sorted by digit
+	for (uint bit = 0; bit < RADIX_BITS; ++bit)
+	{
+		const uint one = (digit >> bit) & 1;
+		uint ones;
+		const uint onesBefore = blockExclusiveScan(one, lane, simd, totals, ones);
+		const uint position = one ? BLOCK_SIZE - ones + onesBefore : local - onesBefore;
+
+		sortedKeys[position] = key;
+		sortedValues[position] = value;
+		threadgroup_barrier(mem_flags::mem_threadgroup);
+
+		key = sortedKeys[local];
+		value = sortedValues[local];
+		digit = digitOf(key, params);
+		threadgroup_barrier(mem_flags::mem_threadgroup);
+	}
+
+	// Where every digit starts in the sorted block
+	sortedValues[local] = digit;
+	threadgroup_barrier(mem_flags::mem_threadgroup);
+	if (local == 0 || sortedValues[local - 1] != digit)
+		digitStarts[digit] = local;
+	threadgroup_barrier(mem_flags::mem_threadgroup);
+
+	if (local < min(BLOCK_SIZE, params.count - group * BLOCK_SIZE))
+	{
+		const uint destination =
+				blockOffsets[digit * groupCount + group] + local - digitStarts[digit];
+		keysOut[destination] = key;
+		if (hasValues)
+			valuesOut[destination] = value;
+	}
+}
+
+kernel void lune_radix_count32(device const uint* keys [[buffer(0)]],
+							   device uint* blockCounts [[buffer(1)]],
+							   constant Params& params [[buffer(2)]],
+							   uint id [[thread_position_in_grid]],
+							   uint local [[thread_position_in_threadgroup]],
+							   uint group [[threadgroup_position_in_grid]],
+							   uint groupCount [[threadgroups_per_grid]])
+{
+	threadgroup atomic_uint counts[RADIX];
+	radixCount(keys, blockCounts, params, counts, id, local, group, groupCount);
+}
+
+kernel void lune_radix_count64(device const ulong* keys [[buffer(0)]],
+							   device uint* blockCounts [[buffer(1)]],
+							   constant Params& params [[buffer(2)]],
+							   uint id [[thread_position_in_grid]],
+							   uint local [[thread_position_in_threadgroup]],
+							   uint group [[threadgroup_position_in_grid]],
+							   uint groupCount [[threadgroups_per_grid]])
+{
+	threadgroup atomic_uint counts[RADIX];
+	radixCount(keys, blockCounts, params, counts, id, local, group, groupCount);
+}
+
+kernel void lune_radix_scatter32(device const uint* keysIn [[buffer(0)]],
+								 device const uint* valuesIn [[buffer(1)]],
+								 device uint* keysOut [[buffer(2)]],
+								 device uint* valuesOut [[buffer(3)]],
+								 device const uint* blockOffsets [[buffer(4)]],
+								 constant Params& params [[buffer(5)]],
+								 uint id [[thread_position_in_grid]],
+								 uint local [[thread_position_in_threadgroup]],
+								 uint group [[threadgroup_position_in_grid]],
+								 uint groupCount [[threadgroups_per_grid]],
+								 uint lane [[thread_index_in_simdgroup]],
+								 uint simd [[simdgroup_index_in_threadgroup]])
+{
+	threadgroup uint sortedKeys[BLOCK_SIZE];
+	threadgroup uint sortedValues[BLOCK_SIZE];
+	threadgroup uint digitStarts[RADIX];
+	threadgroup uint totals[SIMD_COUNT + 1];
+	radixScatter(keysIn, valuesIn, keysOut, valuesOut, blockOffsets, params, sortedKeys,
+				 sortedValues, digitStarts, totals, id, local, group, groupCount, lane, simd);
+}
+
+kernel void lune_radix_scatter64(device const ulong* keysIn [[buffer(0)]],
+								 device const uint* valuesIn [[buffer(1)]],
+								 device ulong* keysOut [[buffer(2)]],
+								 device uint* valuesOut [[buffer(3)]],
+								 device const uint* blockOffsets [[buffer(4)]],
+								 constant Params& params [[buffer(5)]],
+								 uint id [[thread_position_in_grid]],
+								 uint local [[thread_position_in_threadgroup]],
+								 uint group [[threadgroup_position_in_grid]],
+								 uint groupCount [[threadgroups_per_grid]],
+								 uint lane [[thread_index_in_simdgroup]],
+								 uint simd [[simdgroup_index_in_threadgroup]])
+{
+	threadgroup ulong sortedKeys[BLOCK_SIZE];
+	threadgroup uint sortedValues[BLOCK_SIZE];
+	threadgroup uint digitStarts[RADIX];
+	threadgroup uint totals[SIMD_COUNT + 1];
+	radixScatter(keysIn, valuesIn, keysOut, valuesOut, blockOffsets, params, sortedKeys,
+				 sortedValues, digitStarts, totals, id, local, group, groupCount, lane, simd);
+}
+)"};
+
+		constexpr const char* PRIMITIVE_KERNELS[]{
+				"lune_scan_blocks",
+				"lune_add_block_offsets",
+				"lune_reduce",
+				"lune_compact_scatter",
+				"lune_histogram",
+				"lune_radix_count32",
+				"lune_radix_count64",
+				"lune_radix_scatter32",
+				"lune_radix_scatter64",
+		};
+
+		size_t blockCount(const size_t count) noexcept
+		{
+			return (count + BLOCK_SIZE - 1) / BLOCK_SIZE;
+		}
+
+		MTL::CommandBuffer* newCommandBuffer()
+		{
+			return MetalContextImpl::instance().commandQueue()->commandBuffer();
+		}
+
+		void dispatchBlocks(MTL::ComputeCommandEncoder* encoder, const size_t blocks)
+		{
+			encoder->dispatchThreadgroups({blocks, 1, 1}, {BLOCK_SIZE, 1, 1});
+		}
+	} // namespace
+
 	void bufferToTexture(const gfx::Buffer& buffer, const gfx::Texture& texture,
 						 uint32_t bytesPerRow, const uint32_t sourceSize[3],
 						 const bool waitUntilComplete)
@@ -30,16 +390,17 @@ namespace lune::metal
 		const auto commandBuffer{MetalContextImpl::instance().commandQueue()->commandBuffer()};
 		const auto encoder{commandBuffer->computeCommandEncoder()};
 
-		encoder->setComputePipelineState(m_pipeline.get());
+		encoder->setComputePipelineState(m_current.pipeline.get());
 
 		bindBuffers(encoder);
 		bindTextures(encoder);
 
-		NS::UInteger tgSize{m_pipeline->maxTotalThreadsPerThreadgroup()};
+		NS::UInteger tgSize{m_current.pipeline->maxTotalThreadsPerThreadgroup()};
 		NS::UInteger groups{(threadCount + tgSize - 1) / tgSize};
 
 		encoder->dispatchThreadgroups({groups, 1, 1}, {tgSize, 1, 1});
 		encoder->endEncoding();
+		addTimingHandler(commandBuffer, m_name);
 		commandBuffer->commit();
 		m_lastCommandBuffer = NS::TransferPtr(commandBuffer);
 	}
@@ -49,7 +410,7 @@ namespace lune::metal
 		const auto commandBuffer{MetalContextImpl::instance().commandQueue()->commandBuffer()};
 		const auto encoder{commandBuffer->computeCommandEncoder()};
 
-		encoder->setComputePipelineState(m_pipeline.get());
+		encoder->setComputePipelineState(m_current.pipeline.get());
 
 		bindBuffers(encoder);
 		bindTextures(encoder);
@@ -59,6 +420,7 @@ namespace lune::metal
 
 		encoder->dispatchThreadgroups(groups, threadsPerGroup);
 		encoder->endEncoding();
+		addTimingHandler(commandBuffer, m_name);
 		commandBuffer->commit();
 		m_lastCommandBuffer = NS::TransferPtr(commandBuffer);
 	}
@@ -69,7 +431,7 @@ namespace lune::metal
 		const auto commandBuffer{MetalContextImpl::instance().commandQueue()->commandBuffer()};
 		const auto encoder{commandBuffer->computeCommandEncoder()};
 
-		encoder->setComputePipelineState(m_pipeline.get());
+		encoder->setComputePipelineState(m_current.pipeline.get());
 
 		bindBuffers(encoder);
 		bindTextures(encoder);
@@ -81,6 +443,7 @@ namespace lune::metal
 		encoder->endEncoding();
 		commandBuffer->addCompletedHandler([callback = std::move(callback)](MTL::CommandBuffer*)
 										   { callback(); });
+		addTimingHandler(commandBuffer, m_name);
 		commandBuffer->commit();
 		m_lastCommandBuffer = NS::TransferPtr(commandBuffer);
 	}
@@ -88,6 +451,7 @@ namespace lune::metal
 
 	void MetalComputeKernelImpl::setUniform(const std::string& name, const gfx::Buffer& buffer)
 	{
+		m_uniformData.erase(name);
 		m_mtlBuffers[name] = toMetalImpl(buffer)->buffer();
 	}
 
@@ -98,11 +462,22 @@ namespace lune::metal
 
 	void MetalComputeKernelImpl::setUniform(const std::string& name, const void* data, size_t size)
 	{
-		// Allocate a small temp buffer for byte data
-		auto buffer{m_device->newBuffer(size, MTL::ResourceStorageModeShared)};
+		const auto bytes{static_cast<const std::byte*>(data)};
+		if (size <= MAX_INLINE_UNIFORM_SIZE)
+		{
+			m_mtlBuffers.erase(name);
+			m_uniformData[name].assign(bytes, bytes + size);
+			return;
+		}
+
+		// Larger data gets a buffer owned by the kernel, reused while it is big enough
+		NS::SharedPtr<MTL::Buffer>& buffer{m_ownedBuffers[name]};
+		if (!buffer || buffer->length() < size)
+			buffer = NS::TransferPtr(m_device->newBuffer(size, MTL::ResourceStorageModeShared));
 
 		std::memcpy(buffer->contents(), data, size);
-		m_mtlBuffers[name] = buffer;
+		m_uniformData.erase(name);
+		m_mtlBuffers[name] = buffer.get();
 	}
 
 	void MetalComputeKernelImpl::waitUntilComplete()
@@ -110,30 +485,85 @@ namespace lune::metal
 		m_lastCommandBuffer->waitUntilCompleted();
 	}
 
-	void MetalComputeKernelImpl::createPipeline(MTL::Library* library)
+	void MetalComputeKernelImpl::createPipeline(MTL::Library* library,
+												const gfx::ShaderReflection* reflection)
+	{
+		build(library, reflection, m_current);
+	}
+
+	bool MetalComputeKernelImpl::prepareReload(MTL::Library* library,
+											   const gfx::ShaderReflection* reflection)
+	{
+		m_reloaded = {};
+		return build(library, reflection, m_reloaded);
+	}
+
+	void MetalComputeKernelImpl::applyReload()
+	{
+		if (!m_reloaded.pipeline)
+			return;
+
+		m_current = std::move(m_reloaded);
+		m_reloaded = {};
+	}
+
+	bool MetalComputeKernelImpl::build(MTL::Library* library,
+									   const gfx::ShaderReflection* reflection,
+									   KernelState& out) const
 	{
 		// Load the kernel function
-		m_function = NS::TransferPtr(
+		out.function = NS::TransferPtr(
 				library->newFunction(NS::String::string(m_name.c_str(), NS::UTF8StringEncoding)));
+		if (!out.function)
+		{
+			std::cerr << "Kernel " << m_name << " not found in library\n";
+			return false;
+		}
 
-		// Create pipeline state with reflection
 		NS::Error* error{};
-		MTL::ComputePipelineReflection* reflection{};
+
+		// Precompiled libraries carry their bindings, so the driver doesn't need to reflect them
+		if (const gfx::ShaderEntryPoint* entry{reflection ? reflection->find(m_name) : nullptr})
+		{
+			out.pipeline =
+					NS::TransferPtr(m_device->newComputePipelineState(out.function.get(), &error));
+			if (error)
+			{
+				std::cerr << "Failed to create pipeline state for kernel " << m_name << ": "
+						  << error->localizedDescription()->utf8String() << "\n";
+				return false;
+			}
+
+			for (const gfx::ShaderBinding& binding : entry->bindings)
+			{
+				out.arguments.push_back({binding.name, binding.index, 1, toMetal(binding.type)});
+
+				if (binding.type == gfx::BufferBinding)
+					out.bindings[binding.name] = binding.index;
+				else if (binding.type == gfx::TextureBinding)
+					out.textureBindings[binding.name] = binding.index;
+			}
+
+			return true;
+		}
+
+		// Create pipeline state with reflection
+		MTL::ComputePipelineReflection* pipelineReflection{};
 
 		// Create the pipeline
-		m_pipeline = NS::TransferPtr(m_device->newComputePipelineState(
-				m_function.get(), MTL::PipelineOptionArgumentInfo, &reflection, &error));
+		out.pipeline = NS::TransferPtr(m_device->newComputePipelineState(
+				out.function.get(), MTL::PipelineOptionArgumentInfo, &pipelineReflection, &error));
 		if (error)
 		{
 			std::cerr << "Failed to create pipeline state for kernel " << m_name << ": "
 					  << error->localizedDescription()->utf8String() << "\n";
-			return;
+			return false;
 		}
 
-		m_computeArguments = getComputeArguments(reflection);
+		out.arguments = getComputeArguments(pipelineReflection);
 
 		// Automatically populate bufferBindings from reflection
-		const NS::Array* args{reflection->arguments()};
+		const NS::Array* args{pipelineReflection->arguments()};
 		for (NS::UInteger i = 0; i < args->count(); ++i)
 		{
 			const auto arg{static_cast<MTL::Argument*>(args->object(i))};
@@ -144,15 +574,17 @@ namespace lune::metal
 			switch (arg->type())
 			{
 			case MTL::ArgumentTypeBuffer:
-				m_bindings[name] = index;
+				out.bindings[name] = index;
 				break;
 			case MTL::ArgumentTypeTexture:
-				m_textureBindings[name] = index;
+				out.textureBindings[name] = index;
 				break;
 			default:
 				break;
 			}
 		}
+
+		return true;
 	}
 
 	std::vector<MetalComputeKernelImpl::ArgumentInfo>
@@ -181,16 +613,22 @@ namespace lune::metal
 	{
 		for (auto& [name, buf] : m_mtlBuffers)
 		{
-			const NS::UInteger index{m_bindings[name]};
+			const NS::UInteger index{m_current.bindings[name]};
 			commandEncoder->setBuffer(buf, 0, index);
 		}
+
+		for (auto& [name, bytes] : m_uniformData)
+		{
+			const NS::UInteger index{m_current.bindings[name]};
+			commandEncoder->setBytes(bytes.data(), bytes.size(), index);
+		}
 	}
 
 	void MetalComputeKernelImpl::bindTextures(MTL::ComputeCommandEncoder* commandEncoder)
 	{
 		for (auto& [name, tex] : m_mtlTextures)
 		{
-			const NS::UInteger index{m_textureBindings[name]};
+			const NS::UInteger index{m_current.textureBindings[name]};
 			commandEncoder->setTexture(tex, index);
 		}
 	}
@@ -202,17 +640,20 @@ namespace lune::metal
 
 		if (error || !m_library)
 		{
-			if (const auto desc = error->localizedDescription())
-				std::cerr << "Failed to create library: " << desc->cString(NS::UTF8StringEncoding)
-						  << "\n";
-			else
+			// A missing file is reported by createLibrary, without an error
+			if (error && error->localizedDescription())
+				std::cerr << "Failed to create library: "
+						  << error->localizedDescription()->cString(NS::UTF8StringEncoding) << "\n";
+			else if (error)
 				std::cerr << "Failed to create library: unknown error\n";
 
 			return;
 		}
 
+		const auto reflection{gfx::ShaderReflection::loadSidecar(m_path)};
 		const NS::Array* functionNames{m_library->functionNames()};
 
+		std::vector<MetalComputeKernelImpl*> kernels;
 		for (int i = 0; i < functionNames->count(); ++i)
 		{
 			NS::String* nsName{functionNames->object<NS::String>(i)};
@@ -225,9 +666,357 @@ namespace lune::metal
 			{
 				m_kernels[name] = std::make_unique<gfx::ComputeKernel>(
 						std::make_unique<MetalComputeKernelImpl>(m_device, name));
-				auto& kernel = *m_kernels[name];
-				toMetalImpl(kernel)->createPipeline(m_library.get());
+				kernels.push_back(toMetalImpl(*m_kernels[name]));
 			}
 		}
+
+		// Pipeline states are built independently, so kernels compile in parallel
+		const gfx::ShaderReflection* table{reflection ? &*reflection : nullptr};
+		JobSystem::instance().parallelFor(
+				kernels.size(), 1,
+				[&](const size_t begin, const size_t end)
+				{
+					for (size_t i = begin; i < end; ++i)
+						kernels[i]->createPipeline(m_library.get(), table);
+				});
+	}
+
+	bool MetalComputeShaderImpl::isValid() const noexcept
+	{
+		if (!m_library)
+			return false;
+
+		return std::ranges::all_of(m_kernels, [](const auto& entry)
+								   { return toMetalImpl(*entry.second)->isValid(); });
+	}
+
+	bool MetalComputeShaderImpl::prepareReload()
+	{
+		NS::Error* error{};
+		m_reloadedLibrary = NS::TransferPtr(createLibrary(m_path, m_device, &error));
+
+		if (error || !m_reloadedLibrary)
+		{
+			if (error && error->localizedDescription())
+				std::cerr << "Failed to create library: "
+						  << error->localizedDescription()->cString(NS::UTF8StringEncoding) << "\n";
+			else if (error)
+				std::cerr << "Failed to create library: unknown error\n";
+
+			return false;
+		}
+
+		// The offline build rewrites the sidecar along with the library
+		const auto reflection{gfx::ShaderReflection::loadSidecar(m_path)};
+		const gfx::ShaderReflection* table{reflection ? &*reflection : nullptr};
+
+		std::vector<MetalComputeKernelImpl*> kernels;
+		for (const auto& [name, kernel] : m_kernels)
+			kernels.push_back(toMetalImpl(*kernel));
+
+		std::atomic<bool> succeeded{true};
+		JobSystem::instance().parallelFor(
+				kernels.size(), 1,
+				[&](const size_t begin, const size_t end)
+				{
+					for (size_t i = begin; i < end; ++i)
+					{
+						if (!kernels[i]->prepareReload(m_reloadedLibrary.get(), table))
+							succeeded.store(false, std::memory_order_relaxed);
+					}
+				});
+
+		return succeeded.load(std::memory_order_relaxed);
+	}
+
+	void MetalComputeShaderImpl::applyReload()
+	{
+		if (!m_reloadedLibrary)
+			return;
+
+		m_library = std::move(m_reloadedLibrary);
+		for (const auto& [name, kernel] : m_kernels)
+			toMetalImpl(*kernel)->applyReload();
+	}
+
+	MetalComputePrimitivesImpl::MetalComputePrimitivesImpl(MTL::Device* device) : m_device(device)
+	{
+		NS::Error* error{};
+		const NS::SharedPtr<MTL::Library> library{NS::TransferPtr(m_device->newLibrary(
+				NS::String::string(PRIMITIVES_SOURCE, NS::UTF8StringEncoding), nullptr, &error))};
+		if (!library)
+		{
+			std::cerr << "Failed to compile the compute primitives: "
+					  << (error ? error->localizedDescription()->utf8String() : "unknown error")
+					  << "\n";
+			return;
+		}
+
+		for (const char* name : PRIMITIVE_KERNELS)
+		{
+			const NS::SharedPtr<MTL::Function> function{NS::TransferPtr(
+					library->newFunction(NS::String::string(name, NS::UTF8StringEncoding)))};
+			m_pipelines[name] =
+					NS::TransferPtr(m_device->newComputePipelineState(function.get(), &error));
+			if (!m_pipelines[name])
+			{
+				std::cerr << "Failed to create pipeline state for kernel " << name << "\n";
+				return;
+			}
+		}
+
+		m_compiled = true;
+	}
+
+	bool MetalComputePrimitivesImpl::isUsable(const char* operation)
+	{
+		if (m_compiled)
+			return true;
+
+		if (!m_reportedFailure)
+		{
+			std::cerr << operation << " skipped: the compute primitives failed to compile\n";
+			m_reportedFailure = true;
+		}
+		return false;
+	}
+
+	void MetalComputePrimitivesImpl::exclusiveScan(const gfx::Buffer& input,
+												   const gfx::Buffer& output, const size_t count)
+	{
+		scan(input, output, count, false);
+	}
+
+	void MetalComputePrimitivesImpl::inclusiveScan(const gfx::Buffer& input,
+												   const gfx::Buffer& output, const size_t count)
+	{
+		scan(input, output, count, true);
+	}
+
+	void MetalComputePrimitivesImpl::reduce(const gfx::Buffer& input, const gfx::Buffer& result,
+											const size_t count)
+	{
+		if (!isUsable("Reduce"))
+			return;
+
+		MTL::CommandBuffer* commandBuffer{newCommandBuffer()};
+		MTL::Buffer* sum{toMetalImpl(result)->buffer()};
+		encodeClear(commandBuffer, sum, sizeof(uint32_t));
+
+		if (count > 0)
+		{
+			const PrimitiveParams params{.count = static_cast<uint32_t>(count)};
+			MTL::ComputeCommandEncoder* encoder{commandBuffer->computeCommandEncoder()};
+			encoder->setComputePipelineState(pipeline("lune_reduce"));
+			encoder->setBuffer(toMetalImpl(input)->buffer(), 0, 0);
+			encoder->setBuffer(sum, 0, 1);
+			encoder->setBytes(&params, sizeof(params), 2);
+			dispatchBlocks(encoder, std::min(blockCount(count), MAX_STRIDED_GROUPS));
+			encoder->endEncoding();
+		}
+
+		commit(commandBuffer, "Reduce");
+	}
+
+	void MetalComputePrimitivesImpl::compact(const gfx::Buffer& input, const gfx::Buffer& flags,
+											 const gfx::Buffer& output,
+											 const gfx::Buffer& outputCount, const size_t count)
+	{
+		if (!isUsable("Compact"))
+			return;
+
+		MTL::CommandBuffer* commandBuffer{newCommandBuffer()};
+		MTL::Buffer* kept{toMetalImpl(outputCount)->buffer()};
+		if (count == 0)
+		{
+			encodeClear(commandBuffer, kept, sizeof(uint32_t));
+			commit(commandBuffer, "Compact");
+			return;
+		}
+
+		// Every kept element's destination is the number of kept elements before it
+		MTL::Buffer* flagBuffer{toMetalImpl(flags)->buffer()};
+		MTL::Buffer* offsets{scratch(m_offsets, count * sizeof(uint32_t))};
+		MTL::ComputeCommandEncoder* encoder{commandBuffer->computeCommandEncoder()};
+		encodeScan(encoder, flagBuffer, offsets, count, false);
+
+		const PrimitiveParams params{.count = static_cast<uint32_t>(count)};
+		encoder->setComputePipelineState(pipeline("lune_compact_scatter"));
+		encoder->setBuffer(toMetalImpl(input)->buffer(), 0, 0);
+		encoder->setBuffer(flagBuffer, 0, 1);
+		encoder->setBuffer(offsets, 0, 2);
+		encoder->setBuffer(toMetalImpl(output)->buffer(), 0, 3);
+		encoder->setBuffer(kept, 0, 4);
+		encoder->setBytes(&params, sizeof(params), 5);
+		dispatchBlocks(encoder, blockCount(count));
+		encoder->endEncoding();
+
+		commit(commandBuffer, "Compact");
+	}
+
+	void MetalComputePrimitivesImpl::histogram(const gfx::Buffer& input, const gfx::Buffer& bins,
+											   const size_t count, const uint32_t binCount,
+											   const uint32_t shift)
+	{
+		if (binCount == 0 || !isUsable("Histogram"))
+			return;
+
+		MTL::CommandBuffer* commandBuffer{newCommandBuffer()};
+		MTL::Buffer* binBuffer{toMetalImpl(bins)->buffer()};
+		encodeClear(commandBuffer, binBuffer, binCount * sizeof(uint32_t));
+
+		if (count > 0)
+		{
+			const PrimitiveParams params{
+					.count = static_cast<uint32_t>(count), .shift = shift, .binCount = binCount};
+			MTL::ComputeCommandEncoder* encoder{commandBuffer->computeCommandEncoder()};
+			encoder->setComputePipelineState(pipeline("lune_histogram"));
+			encoder->setBuffer(toMetalImpl(input)->buffer(), 0, 0);
+			encoder->setBuffer(binBuffer, 0, 1);
+			encoder->setBytes(&params, sizeof(params), 2);
+			dispatchBlocks(encoder, std::min(blockCount(count), MAX_STRIDED_GROUPS));
+			encoder->endEncoding();
+		}
+
+		commit(commandBuffer, "Histogram");
+	}
+
+	void MetalComputePrimitivesImpl::sortPairs(const gfx::Buffer& keys, const gfx::Buffer* values,
+											   const size_t count,
+											   const gfx::SortKeySize keySize)
+	{
+		if (count < 2 || !isUsable("Sort"))
+			return;
+
+		const bool wide{keySize == gfx::SortKey64};
+		const size_t keyBytes{wide ? sizeof(uint64_t) : sizeof(uint32_t)};
+		const size_t blocks{blockCount(count)};
+		const size_t digitCounts{blocks << RADIX_BITS};
+
+		// An even number of passes, so the last one scatters back into the caller's buffers
+		MTL::Buffer* sourceKeys{toMetalImpl(keys)->buffer()};
+		MTL::Buffer* destinationKeys{scratch(m_sortKeys, count * keyBytes)};
+		MTL::Buffer* sourceValues{values ? toMetalImpl(*values)->buffer() : sourceKeys};
+		MTL::Buffer* destinationValues{values ? scratch(m_sortValues, count * sizeof(uint32_t))
+											  : destinationKeys};
+		MTL::Buffer* offsets{scratch(m_offsets, digitCounts * sizeof(uint32_t))};
+
+		MTL::CommandBuffer* commandBuffer{newCommandBuffer()};
+		MTL::ComputeCommandEncoder* encoder{commandBuffer->computeCommandEncoder()};
+		for (uint32_t shift = 0; shift < keyBytes * 8; shift += RADIX_BITS)
+		{
+			const PrimitiveParams params{.count = static_cast<uint32_t>(count),
+										 .shift = shift,
+										 .flags = values != nullptr};
+
+			encoder->setComputePipelineState(
+					pipeline(wide ? "lune_radix_count64" : "lune_radix_count32"));
+			encoder->setBuffer(sourceKeys, 0, 0);
+			encoder->setBuffer(offsets, 0, 1);
+			encoder->setBytes(&params, sizeof(params), 2);
+			dispatchBlocks(encoder, blocks);
+
+			encodeScan(encoder, offsets, offsets, digitCounts, false);
+
+			encoder->setComputePipelineState(
+					pipeline(wide ? "lune_radix_scatter64" : "lune_radix_scatter32"));
+			encoder->setBuffer(sourceKeys, 0, 0);
+			encoder->setBuffer(sourceValues, 0, 1);
+			encoder->setBuffer(destinationKeys, 0, 2);
+			encoder->setBuffer(destinationValues, 0, 3);
+			encoder->setBuffer(offsets, 0, 4);
+			encoder->setBytes(&params, sizeof(params), 5);
+			dispatchBlocks(encoder, blocks);
+
+			std::swap(sourceKeys, destinationKeys);
+			std::swap(sourceValues, destinationValues);
+		}
+		encoder->endEncoding();
+
+		commit(commandBuffer, "RadixSort");
+	}
+
+	void MetalComputePrimitivesImpl::waitUntilComplete()
+	{
+		if (m_lastCommandBuffer)
+			m_lastCommandBuffer->waitUntilCompleted();
+	}
+
+	void MetalComputePrimitivesImpl::scan(const gfx::Buffer& input, const gfx::Buffer& output,
+										  const size_t count, const bool inclusive)
+	{
+		if (count == 0 || !isUsable("Scan"))
+			return;
+
+		MTL::CommandBuffer* commandBuffer{newCommandBuffer()};
+		MTL::ComputeCommandEncoder* encoder{commandBuffer->computeCommandEncoder()};
+		encodeScan(encoder, toMetalImpl(input)->buffer(), toMetalImpl(output)->buffer(), count,
+				   inclusive);
+		encoder->endEncoding();
+
+		commit(commandBuffer, "Scan");
+	}
+
+	void MetalComputePrimitivesImpl::encodeScan(MTL::ComputeCommandEncoder* encoder,
+												MTL::Buffer* input, MTL::Buffer* output,
+												const size_t count, const bool inclusive,
+												const size_t level)
+	{
+		const size_t blocks{blockCount(count)};
+		if (m_scanLevels.size() <= level)
+			m_scanLevels.resize(level + 1);
+		MTL::Buffer* blockSums{scratch(m_scanLevels[level], blocks * sizeof(uint32_t))};
+
+		const PrimitiveParams params{.count = static_cast<uint32_t>(count), .flags = inclusive};
+		encoder->setComputePipelineState(pipeline("lune_scan_blocks"));
+		encoder->setBuffer(input, 0, 0);
+		encoder->setBuffer(output, 0, 1);
+		encoder->setBuffer(blockSums, 0, 2);
+		encoder->setBytes(&params, sizeof(params), 3);
+		dispatchBlocks(encoder, blocks);
+
+		if (blocks == 1)
+			return;
+
+		encodeScan(encoder, blockSums, blockSums, blocks, false, level + 1);
+
+		encoder->setComputePipelineState(pipeline("lune_add_block_offsets"));
+		encoder->setBuffer(output, 0, 0);
+		encoder->setBuffer(blockSums, 0, 1);
+		encoder->setBytes(&params, sizeof(params), 2);
+		dispatchBlocks(encoder, blocks);
+	}
+
+	void MetalComputePrimitivesImpl::encodeClear(MTL::CommandBuffer* commandBuffer,
+												 MTL::Buffer* buffer, const size_t size)
+	{
+		MTL::BlitCommandEncoder* blit{commandBuffer->blitCommandEncoder()};
+		blit->fillBuffer(buffer, NS::Range::Make(0, size), 0);
+		blit->endEncoding();
+	}
+
+	MTL::ComputePipelineState* MetalComputePrimitivesImpl::pipeline(const std::string& name) const
+	{
+		return m_pipelines.at(name).get();
+	}
+
+	MTL::Buffer* MetalComputePrimitivesImpl::scratch(NS::SharedPtr<MTL::Buffer>& buffer,
+													 const size_t size) const
+	{
+		// Command buffers retain the buffers they use, so replacing one in flight is safe
+		if (!buffer || buffer->length() < size)
+		{
+			buffer = NS::TransferPtr(m_device->newBuffer(std::max(size, size_t{16}),
+														 MTL::ResourceStorageModePrivate));
+		}
+		return buffer.get();
+	}
+
+	void MetalComputePrimitivesImpl::commit(MTL::CommandBuffer* commandBuffer,
+											const std::string& label)
+	{
+		addTimingHandler(commandBuffer, label);
+		commandBuffer->commit();
+		m_lastCommandBuffer = NS::RetainPtr(commandBuffer);
 	}
 } // namespace lune::metal
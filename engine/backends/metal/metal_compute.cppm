@@ -1,7 +1,10 @@
 module;
 #include <Metal/Metal.hpp>
+#include <cstddef>
+#include <cstdint>
 #include <map>
 #include <string>
+#include <vector>
 export module lune.metal:compute;
 
 import :mappings;
@@ -23,17 +26,32 @@ namespace lune::metal
 			MTL::ArgumentType type;
 		};
 
+		/**
+		 * @brief Everything built from the shader library, replaced as a whole on reload.
+		 */
+		struct KernelState
+		{
+			NS::SharedPtr<MTL::ComputePipelineState> pipeline;
+			NS::SharedPtr<MTL::Function> function;
+			std::map<std::string, NS::UInteger> bindings{};
+			std::map<std::string, NS::UInteger> textureBindings{};
+			std::vector<ArgumentInfo> arguments{};
+		};
+
 		NS::SharedPtr<MTL::CommandBuffer> m_lastCommandBuffer;
-		NS::SharedPtr<MTL::ComputePipelineState> m_pipeline;
-		NS::SharedPtr<MTL::Function> m_function;
 		MTL::Device* m_device{};
 
-		std::map<std::string, NS::UInteger> m_bindings{};
-		std::map<std::string, NS::UInteger> m_textureBindings{};
+		KernelState m_current;
+		KernelState m_reloaded; ///< Built by `prepareReload`, swapped in by `applyReload`.
+
 		std::map<std::string, MTL::Buffer*> m_mtlBuffers;
 		std::map<std::string, MTL::Texture*> m_mtlTextures;
 
-		std::vector<ArgumentInfo> m_computeArguments{};
+		/// Small uniforms set by value, encoded inline on every dispatch.
+		std::map<std::string, std::vector<std::byte>> m_uniformData;
+
+		/// Buffers owned by the kernel for uniforms too large to encode inline.
+		std::map<std::string, NS::SharedPtr<MTL::Buffer>> m_ownedBuffers;
 
 	public:
 		MetalComputeKernelImpl(MTL::Device* device, const std::string& name) :
@@ -53,9 +71,30 @@ namespace lune::metal
 
 		void waitUntilComplete() override;
 
-		void createPipeline(MTL::Library* library);
+		[[nodiscard]] bool isValid() const noexcept
+		{
+			return m_current.pipeline.get() != nullptr;
+		}
+
+		/**
+		 * @param library Library holding the kernel function.
+		 * @param reflection Binding table of a precompiled library; nullptr to reflect the
+		 * pipeline at creation instead.
+		 */
+		void createPipeline(MTL::Library* library, const gfx::ShaderReflection* reflection);
+
+		/**
+		 * @brief Builds the kernel from a recompiled library without touching the current one.
+		 *
+		 * @return true if the library still has the kernel and its pipeline was created.
+		 */
+		bool prepareReload(MTL::Library* library, const gfx::ShaderReflection* reflection);
+		void applyReload();
 
 	private:
+		bool build(MTL::Library* library, const gfx::ShaderReflection* reflection,
+				   KernelState& out) const;
+
 		[[nodiscard]] static std::vector<ArgumentInfo>
 		getComputeArguments(const MTL::ComputePipelineReflection* reflection);
 
@@ -64,25 +103,114 @@ namespace lune::metal
 	};
 
 
-	export class MetalComputeShaderImpl : public gfx::IComputeShaderImpl
+	export class MetalComputeShaderImpl : public gfx::IComputeShaderImpl,
+										  public gfx::IHotReloadable
 	{
 		MTL::Device* m_device{};
 		NS::SharedPtr<MTL::Library> m_library{};
+		NS::SharedPtr<MTL::Library> m_reloadedLibrary{};
 
 	public:
 		MetalComputeShaderImpl(MTL::Device* device, const std::string& path) :
 			IComputeShaderImpl(path), m_device(device)
 		{
 			createPipelines();
+			gfx::HotReload::add(m_path, *this);
 		}
 
-		~MetalComputeShaderImpl() override = default;
+		~MetalComputeShaderImpl() override
+		{
+			gfx::HotReload::remove(*this);
+		}
+
+		[[nodiscard]] bool isValid() const noexcept override;
+
+		/**
+		 * @brief Recompiles the library and rebuilds every existing kernel from it. Kernels added
+		 * to the source are not picked up until the shader is recreated.
+		 */
+		bool prepareReload() override;
+		void applyReload() override;
 
 	private:
 		void createPipelines();
 	};
 
 
+	/**
+	 * @brief Kernels of `gfx::ComputePrimitives`, compiled from source built into the engine.
+	 * Each operation is encoded into a command buffer of its own on the context's queue, so it
+	 * runs after the compute work submitted before it.
+	 */
+	export class MetalComputePrimitivesImpl final : public gfx::IComputePrimitivesImpl
+	{
+		MTL::Device* m_device{};
+		std::map<std::string, NS::SharedPtr<MTL::ComputePipelineState>> m_pipelines;
+		bool m_compiled{}; ///< Every kernel compiled; operations do nothing otherwise.
+		bool m_reportedFailure{};
+		NS::SharedPtr<MTL::CommandBuffer> m_lastCommandBuffer;
+
+		/// Block sums of every level of a scan, grown on demand.
+		std::vector<NS::SharedPtr<MTL::Buffer>> m_scanLevels;
+
+		/// Compaction offsets, or the per-block digit counts of a sort.
+		NS::SharedPtr<MTL::Buffer> m_offsets;
+
+		/// Where sort passes scatter to, every other pass.
+		NS::SharedPtr<MTL::Buffer> m_sortKeys;
+		NS::SharedPtr<MTL::Buffer> m_sortValues;
+
+	public:
+		explicit MetalComputePrimitivesImpl(MTL::Device* device);
+
+		void exclusiveScan(const gfx::Buffer& input, const gfx::Buffer& output,
+						   size_t count) override;
+		void inclusiveScan(const gfx::Buffer& input, const gfx::Buffer& output,
+						   size_t count) override;
+		void reduce(const gfx::Buffer& input, const gfx::Buffer& result, size_t count) override;
+		void compact(const gfx::Buffer& input, const gfx::Buffer& flags, const gfx::Buffer& output,
+					 const gfx::Buffer& outputCount, size_t count) override;
+		void histogram(const gfx::Buffer& input, const gfx::Buffer& bins, size_t count,
+					   uint32_t binCount, uint32_t shift) override;
+		void sortPairs(const gfx::Buffer& keys, const gfx::Buffer* values, size_t count,
+					   gfx::SortKeySize keySize) override;
+
+		void waitUntilComplete() override;
+
+	private:
+		/**
+		 * @brief Tells whether the kernels compiled, reporting the first operation skipped
+		 * because they didn't.
+		 */
+		[[nodiscard]] bool isUsable(const char* operation);
+
+		void scan(const gfx::Buffer& input, const gfx::Buffer& output, size_t count,
+				  bool inclusive);
+
+		/**
+		 * @brief Encodes a scan of `count` elements: every block is scanned, then the block sums
+		 * are scanned one level down and added back to their blocks.
+		 */
+		void encodeScan(MTL::ComputeCommandEncoder* encoder, MTL::Buffer* input,
+						MTL::Buffer* output, size_t count, bool inclusive, size_t level = 0);
+
+		/**
+		 * @brief Clears the first `size` bytes of a buffer ahead of the compute work.
+		 */
+		static void encodeClear(MTL::CommandBuffer* commandBuffer, MTL::Buffer* buffer,
+								size_t size);
+
+		[[nodiscard]] MTL::ComputePipelineState* pipeline(const std::string& name) const;
+
+		/**
+		 * @brief Grows a GPU-only scratch buffer to at least `size` bytes.
+		 */
+		MTL::Buffer* scratch(NS::SharedPtr<MTL::Buffer>& buffer, size_t size) const;
+
+		void commit(MTL::CommandBuffer* commandBuffer, const std::string& label);
+	};
+
+
 	constexpr MetalComputeKernelImpl* toMetalImpl(const gfx::ComputeKernel& kernel)
 	{
 		const auto impl = kernel.getImpl();
@@ -1,10 +1,53 @@
 module;
 #include <Metal/Metal.hpp>
+#include <functional>
 #include <iostream>
+#include <span>
+#include <string>
+#include <utility>
 module lune.metal;
 
 namespace lune::metal
 {
+	void addTimingHandler(MTL::CommandBuffer* commandBuffer, const std::string& label)
+	{
+		if (!gfx::GpuTimings::isEnabled())
+			return;
+
+		// GPUStartTime/GPUEndTime are only valid once the command buffer has completed, so they
+		// are read in its completion handler instead of waiting on it
+		commandBuffer->addCompletedHandler(
+				[label](MTL::CommandBuffer* completed)
+				{
+					if (completed->status() != MTL::CommandBufferStatusCompleted)
+						return;
+
+					gfx::GpuTimings::record(label, completed->GPUStartTime(),
+											completed->GPUEndTime());
+				});
+	}
+
+	void MetalTransferQueueImpl::submit(const std::span<const gfx::BufferCopy> copies,
+										std::function<void()> onComplete)
+	{
+		// A queue of its own would run the copies unordered against the frames and dispatches
+		MTL::CommandBuffer* commandBuffer{
+				MetalContextImpl::instance().commandQueue()->commandBuffer()};
+		MTL::BlitCommandEncoder* encoder{commandBuffer->blitCommandEncoder()};
+		for (const gfx::BufferCopy& copy : copies)
+		{
+			encoder->copyFromBuffer(toMetalImpl(*copy.source)->buffer(), copy.sourceOffset,
+									toMetalImpl(*copy.destination)->buffer(),
+									copy.destinationOffset, copy.size);
+		}
+		encoder->endEncoding();
+
+		commandBuffer->addCompletedHandler([onComplete = std::move(onComplete)](MTL::CommandBuffer*)
+										   { onComplete(); });
+		addTimingHandler(commandBuffer, "Transfer");
+		commandBuffer->commit();
+	}
+
 	MetalContextImpl::MetalContextImpl()
 	{
 		createDefaultDevice();
@@ -1,6 +1,9 @@
 module;
 #include <Metal/Metal.hpp>
+#include <functional>
 #include <memory>
+#include <span>
+#include <string>
 export module lune.metal:context;
 
 import :buffer;
@@ -12,6 +15,26 @@ import lune.gfx;
 
 namespace lune::metal
 {
+	/**
+	 * @brief Reports the GPU start and end time of a command buffer to `gfx::GpuTimings` once it
+	 * has completed. Must be called before the command buffer is committed.
+	 */
+	void addTimingHandler(MTL::CommandBuffer* commandBuffer, const std::string& label);
+
+
+	/**
+	 * @brief Runs buffer copies in blit passes on the queue frames and dispatches are committed
+	 * on, so uploads are visible to the work committed after them, and readbacks see the work
+	 * committed before.
+	 */
+	class MetalTransferQueueImpl final : public gfx::ITransferQueueImpl
+	{
+	public:
+		void submit(std::span<const gfx::BufferCopy> copies,
+					std::function<void()> onComplete) override;
+	};
+
+
 	export class MetalContextImpl final : public gfx::IContextImpl
 	{
 		NS::SharedPtr<MTL::Device> m_device{};
@@ -39,9 +62,10 @@ namespace lune::metal
 			return m_commandQueue.get();
 		}
 
-		[[nodiscard]] gfx::Buffer createBuffer(const size_t size) const override
+		[[nodiscard]] gfx::Buffer createBuffer(const size_t size,
+											   const gfx::BufferUsage usage) const override
 		{
-			auto impl{std::make_unique<MetalBufferImpl>(m_device.get(), size)};
+			auto impl{std::make_unique<MetalBufferImpl>(m_device.get(), size, usage)};
 			return gfx::Buffer(std::move(impl));
 		}
 
@@ -83,5 +107,16 @@ namespace lune::metal
 			auto impl{std::make_unique<MetalComputeShaderImpl>(m_device.get(), path)};
 			return gfx::ComputeShader(std::move(impl));
 		}
+
+		[[nodiscard]] std::unique_ptr<gfx::ITransferQueueImpl> createTransferQueue() const override
+		{
+			return std::make_unique<MetalTransferQueueImpl>();
+		}
+
+		[[nodiscard]] std::unique_ptr<gfx::IComputePrimitivesImpl>
+		createComputePrimitives() const override
+		{
+			return std::make_unique<MetalComputePrimitivesImpl>(m_device.get());
+		}
 	};
 } // namespace lune::metal
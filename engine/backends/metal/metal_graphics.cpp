@@ -1,7 +1,12 @@
 module;
 #include <Metal/Metal.hpp>
 #include <QuartzCore/QuartzCore.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <dispatch/dispatch.h>
 #include <iostream>
+#include <utility>
 module lune.metal;
 
 import lune;
@@ -18,8 +23,6 @@ namespace lune::metal
 			const auto shaderSource = File::read(path);
 			if (!shaderSource.has_value())
 			{
-				if (error)
-					*error = NS::Error::alloc()->init();
 				std::cerr << "Shader file not found: " << path << "\n";
 				return nullptr;
 			}
@@ -30,17 +33,59 @@ namespace lune::metal
 		}
 		else if (path.ends_with(".metallib")) // Precompiled shader
 		{
-			const auto nsPath = NS::String::string(path.c_str(), NS::UTF8StringEncoding);
-			library = device->newLibrary(nsPath, error);
+			// Loaded from memory rather than by path, so libraries can come from archives
+			const auto bytes = File::readBinary(path);
+			if (!bytes.has_value())
+			{
+				std::cerr << "Shader library not found: " << path << "\n";
+				return nullptr;
+			}
+
+			dispatch_data_t data{dispatch_data_create(bytes->data(), bytes->size(), nullptr,
+													   DISPATCH_DATA_DESTRUCTOR_DEFAULT)};
+			library = device->newLibrary(data, error);
+			dispatch_release(data);
 		}
 
 		return library;
 	}
 
 	void MetalShaderImpl::create()
+	{
+		compile(m_library, m_vertex, m_fragment);
+	}
+
+	bool MetalShaderImpl::prepareReload()
+	{
+		m_reloadedLibrary.reset();
+		m_reloadedVertex.reset();
+		m_reloadedFragment.reset();
+
+		if (compile(m_reloadedLibrary, m_reloadedVertex, m_reloadedFragment))
+			return true;
+
+		// Pipelines prepared alongside must not pick up a half-built shader
+		m_reloadedVertex.reset();
+		m_reloadedFragment.reset();
+		return false;
+	}
+
+	void MetalShaderImpl::applyReload()
+	{
+		if (!m_reloadedLibrary || !m_reloadedVertex || !m_reloadedFragment)
+			return;
+
+		m_library = std::move(m_reloadedLibrary);
+		m_vertex = std::move(m_reloadedVertex);
+		m_fragment = std::move(m_reloadedFragment);
+	}
+
+	bool MetalShaderImpl::compile(NS::SharedPtr<MTL::Library>& library,
+								  NS::SharedPtr<MTL::Function>& vertex,
+								  NS::SharedPtr<MTL::Function>& fragment) const
 	{
 		NS::Error* error{};
-		m_library = NS::TransferPtr(createLibrary(m_desc.path, m_device, &error));
+		library = NS::TransferPtr(createLibrary(m_desc.path, m_device, &error));
 
 		if (error)
 		{
@@ -49,18 +94,20 @@ namespace lune::metal
 						  << "\n";
 			else
 				std::cerr << "Failed to create library: unknown error\n";
+
+			return false;
 		}
-		else
-		{
-			// If library creation succeeded, fetch functions
-			if (m_library)
-			{
-				m_vertex = NS::TransferPtr(m_library->newFunction(
-						NS::String::string(m_desc.vsMain.c_str(), NS::UTF8StringEncoding)));
-				m_fragment = NS::TransferPtr(m_library->newFunction(
-						NS::String::string(m_desc.fsMain.c_str(), NS::UTF8StringEncoding)));
-			}
-		}
+
+		// If library creation succeeded, fetch functions
+		if (!library)
+			return false;
+
+		vertex = NS::TransferPtr(library->newFunction(
+				NS::String::string(m_desc.vsMain.c_str(), NS::UTF8StringEncoding)));
+		fragment = NS::TransferPtr(library->newFunction(
+				NS::String::string(m_desc.fsMain.c_str(), NS::UTF8StringEncoding)));
+
+		return vertex && fragment;
 	}
 
 	void MetalMaterialImpl::setUniform(const std::string& name, const gfx::Texture& texture)
@@ -70,22 +117,36 @@ namespace lune::metal
 
 	void MetalMaterialImpl::setUniform(const std::string& name, const gfx::Buffer& buffer)
 	{
+		m_uniformData.erase(name);
 		m_uniformBuffers[name] = toMetalImpl(buffer)->buffer();
 	}
 
 	void MetalMaterialImpl::setUniform(const std::string& name, const void* data, size_t size)
 	{
-		auto buffer =
-				MetalContextImpl::instance().device()->newBuffer(size, MTL::ResourceStorageModeShared);
-		if (!buffer)
+		const auto bytes{static_cast<const std::byte*>(data)};
+		if (size <= MAX_INLINE_UNIFORM_SIZE)
 		{
-			std::cerr << "Failed to create uniform buffer for '" << name << "'\n";
+			m_uniformBuffers.erase(name);
+			m_uniformData[name].assign(bytes, bytes + size);
 			return;
 		}
 
-		// Copy data to the newly created buffer and set as uniform
+		NS::SharedPtr<MTL::Buffer>& buffer{m_ownedBuffers[name]};
+		if (!buffer || buffer->length() < size)
+		{
+			buffer = NS::TransferPtr(MetalContextImpl::instance().device()->newBuffer(
+					size, MTL::ResourceStorageModeShared));
+			if (!buffer)
+			{
+				std::cerr << "Failed to create uniform buffer for '" << name << "'\n";
+				return;
+			}
+		}
+
+		// Copy data to the material's buffer and set as uniform
 		std::memcpy(buffer->contents(), data, size);
-		m_uniformBuffers[name] = buffer;
+		m_uniformData.erase(name);
+		m_uniformBuffers[name] = buffer.get();
 	}
 
 	void MetalMaterialImpl::bind(MTL::RenderCommandEncoder* encoder) const
@@ -105,6 +166,10 @@ namespace lune::metal
 				{
 					encoder->setVertexBuffer(it->second, 0, arg.index);
 				}
+				else if (auto data = m_uniformData.find(arg.name); data != m_uniformData.end())
+				{
+					encoder->setVertexBytes(data->second.data(), data->second.size(), arg.index);
+				}
 			}
 			else if (arg.type == MTL::ArgumentTypeTexture)
 			{
@@ -125,6 +190,10 @@ namespace lune::metal
 				{
 					encoder->setFragmentBuffer(it->second, 0, arg.index);
 				}
+				else if (auto data = m_uniformData.find(arg.name); data != m_uniformData.end())
+				{
+					encoder->setFragmentBytes(data->second.data(), data->second.size(), arg.index);
+				}
 			}
 			else if (arg.type == MTL::ArgumentTypeTexture)
 			{
@@ -137,7 +206,38 @@ namespace lune::metal
 		}
 	}
 
+	MetalPipelineImpl::MetalPipelineImpl(const gfx::Shader& shader, const gfx::PipelineDesc& desc) :
+		m_shader(&shader), m_desc(desc)
+	{
+		MetalPipelineImpl::createPipeline();
+		gfx::HotReload::add(toMetalImpl(shader)->path(), *this);
+	}
+
 	void MetalPipelineImpl::createPipeline()
+	{
+		const MetalShaderImpl* metalShader{toMetalImpl(*m_shader)};
+		build(metalShader->vertex(), metalShader->fragment(), m_current);
+	}
+
+	bool MetalPipelineImpl::prepareReload()
+	{
+		// The shader is registered first, so its reloaded functions are already built
+		const MetalShaderImpl* metalShader{toMetalImpl(*m_shader)};
+		m_reloaded = {};
+		return build(metalShader->reloadedVertex(), metalShader->reloadedFragment(), m_reloaded);
+	}
+
+	void MetalPipelineImpl::applyReload()
+	{
+		if (!m_reloaded.state)
+			return;
+
+		m_current = std::move(m_reloaded);
+		m_reloaded = {};
+	}
+
+	bool MetalPipelineImpl::build(MTL::Function* vertex, MTL::Function* fragment,
+								  PipelineState& out) const
 	{
 		NS::Error* error{};
 		MTL::RenderPipelineReflection* reflection{};
@@ -145,8 +245,8 @@ namespace lune::metal
 
 		const auto descriptor{NS::TransferPtr(MTL::RenderPipelineDescriptor::alloc()->init())};
 
-		descriptor->setVertexFunction(metalShader->vertex());
-		descriptor->setFragmentFunction(metalShader->fragment());
+		descriptor->setVertexFunction(vertex);
+		descriptor->setFragmentFunction(fragment);
 		descriptor->colorAttachments()->object(0)->setPixelFormat(toMetal(m_desc.colorFormat));
 		descriptor->setDepthAttachmentPixelFormat(toMetal(m_desc.depthFormat));
 
@@ -166,15 +266,31 @@ namespace lune::metal
 		const auto depthDesc{NS::TransferPtr(MTL::DepthStencilDescriptor::alloc()->init())};
 		depthDesc->setDepthWriteEnabled(true);
 		depthDesc->setDepthCompareFunction(MTL::CompareFunctionLess);
-		m_depthStencilState =
+		out.depthStencilState =
 				NS::TransferPtr(metalShader->device()->newDepthStencilState(depthDesc.get()));
 
 
-		// Create pipeline state with reflection info (request argument info)
-		m_state = NS::TransferPtr(metalShader->device()->newRenderPipelineState(
-				descriptor.get(), MTL::PipelineOptionArgumentInfo, &reflection, &error));
+		// Precompiled shaders carry their bindings, so the driver doesn't need to reflect them
+		const auto table{gfx::ShaderReflection::loadSidecar(metalShader->path())};
+		const gfx::ShaderEntryPoint* vertexEntry{
+				table ? table->find(metalShader->desc().vsMain) : nullptr};
+		const gfx::ShaderEntryPoint* fragmentEntry{
+				table ? table->find(metalShader->desc().fsMain) : nullptr};
+		const bool reflected{vertexEntry && fragmentEntry};
+
+		if (reflected)
+		{
+			out.state = NS::TransferPtr(
+					metalShader->device()->newRenderPipelineState(descriptor.get(), &error));
+		}
+		else
+		{
+			// Create pipeline state with reflection info (request argument info)
+			out.state = NS::TransferPtr(metalShader->device()->newRenderPipelineState(
+					descriptor.get(), MTL::PipelineOptionArgumentInfo, &reflection, &error));
+		}
 
-		if (!m_state)
+		if (!out.state)
 		{
 			if (error && error->localizedDescription())
 				std::cerr << "Failed to create pipeline state: "
@@ -182,11 +298,21 @@ namespace lune::metal
 			else
 				std::cerr << "Failed to create pipeline state: unknown error\n";
 
-			return;
+			return false;
+		}
+
+		if (reflected)
+		{
+			out.vertexArguments = parse(*vertexEntry);
+			out.fragmentArguments = parse(*fragmentEntry);
+		}
+		else
+		{
+			out.vertexArguments = parse(reflection->vertexArguments());
+			out.fragmentArguments = parse(reflection->fragmentArguments());
 		}
 
-		m_vertexArguments = parse(reflection->vertexArguments());
-		m_fragmentArguments = parse(reflection->fragmentArguments());
+		return true;
 	}
 
 	std::vector<MetalPipelineImpl::ArgumentInfo>
@@ -214,6 +340,25 @@ namespace lune::metal
 		return out;
 	}
 
+	std::vector<MetalPipelineImpl::ArgumentInfo>
+	MetalPipelineImpl::parse(const gfx::ShaderEntryPoint& entryPoint)
+	{
+		std::vector<ArgumentInfo> out;
+		out.reserve(entryPoint.bindings.size());
+
+		for (const gfx::ShaderBinding& binding : entryPoint.bindings)
+		{
+			out.push_back({
+					.name = binding.name,
+					.index = binding.index,
+					.arrayLength = 1,
+					.type = toMetal(binding.type),
+			});
+		}
+
+		return out;
+	}
+
 	void MetalRenderPassImpl::bind(const gfx::IMaterialImpl& material)
 	{
 		auto metalMaterial = static_cast<const MetalMaterialImpl&>(material);
@@ -228,14 +373,30 @@ namespace lune::metal
 
 	void MetalRenderPassImpl::begin()
 	{
-		const auto* drawable{
-				static_cast<CA::MetalDrawable*>(toMetalImpl(m_surface)->nextDrawable())};
+		// Resizes requested by the window are applied between frames, never mid-encode
+		m_surface.applyPendingResize();
+
+		// nextDrawable blocks while every drawable is queued for display
+		const auto waitStart{std::chrono::steady_clock::now()};
+		auto* drawable{static_cast<CA::MetalDrawable*>(toMetalImpl(m_surface)->nextDrawable())};
+		FrameStats::instance().addCpuWait(
+				std::chrono::duration<double>(std::chrono::steady_clock::now() - waitStart)
+						.count());
+
 		if (!drawable)
 		{
 			std::cerr << "RenderPass::begin(): drawable is null\n";
 			return;
 		}
 
+		// Dropped drawables report a presented time of 0
+		drawable->addPresentedHandler(
+				[](MTL::Drawable* presented)
+				{
+					if (const double time{presented->presentedTime()}; time > 0.0)
+						FrameStats::instance().recordPresent(time);
+				});
+
 		m_commandBuffer = NS::TransferPtr(MetalContextImpl::instance().commandQueue()->commandBuffer());
 
 		const auto renderPassDescriptor{
@@ -262,6 +423,7 @@ namespace lune::metal
 		m_encoder->endEncoding();
 
 		m_commandBuffer->presentDrawable(drawable);
+		addTimingHandler(m_commandBuffer.get(), m_label);
 		m_commandBuffer->commit();
 	}
 
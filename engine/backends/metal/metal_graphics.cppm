@@ -1,16 +1,27 @@
 module;
 #include <Metal/Metal.hpp>
+#include <cstddef>
 #include <iostream>
 #include <map>
+#include <vector>
 export module lune.metal:graphics;
 
 import lune.gfx;
 
 namespace lune::metal
 {
+	/// Largest uniform passed inline with set*Bytes; Metal's limit for inline data.
+	constexpr size_t MAX_INLINE_UNIFORM_SIZE{4096};
+
+	/**
+	 * @brief Compiles a `.metal` source or loads a precompiled `.metallib`.
+	 *
+	 * @return The library; nullptr on failure. A missing file is reported on stderr without
+	 * setting `error`.
+	 */
 	MTL::Library* createLibrary(const std::string& path, MTL::Device* device, NS::Error** error);
 
-	export class MetalShaderImpl : public gfx::IShaderImpl
+	export class MetalShaderImpl : public gfx::IShaderImpl, public gfx::IHotReloadable
 	{
 		MTL::Device* m_device{};
 
@@ -18,6 +29,11 @@ namespace lune::metal
 		NS::SharedPtr<MTL::Function> m_vertex{};
 		NS::SharedPtr<MTL::Function> m_fragment{};
 
+		/// Built by `prepareReload`, swapped in by `applyReload`.
+		NS::SharedPtr<MTL::Library> m_reloadedLibrary;
+		NS::SharedPtr<MTL::Function> m_reloadedVertex{};
+		NS::SharedPtr<MTL::Function> m_reloadedFragment{};
+
 		gfx::ShaderDesc m_desc{};
 
 	public:
@@ -25,6 +41,12 @@ namespace lune::metal
 			m_device(device), m_desc(desc)
 		{
 			MetalShaderImpl::create();
+			gfx::HotReload::add(m_desc.path, *this);
+		}
+
+		~MetalShaderImpl() override
+		{
+			gfx::HotReload::remove(*this);
 		}
 
 		[[nodiscard]] MTL::Device* device() const noexcept
@@ -32,6 +54,16 @@ namespace lune::metal
 			return m_device;
 		}
 
+		[[nodiscard]] const gfx::ShaderDesc& desc() const noexcept
+		{
+			return m_desc;
+		}
+
+		[[nodiscard]] const std::string& path() const noexcept
+		{
+			return m_desc.path;
+		}
+
 		[[nodiscard]] MTL::Function* vertex() const noexcept
 		{
 			return m_vertex.get();
@@ -42,7 +74,38 @@ namespace lune::metal
 			return m_fragment.get();
 		}
 
+		/**
+		 * @brief Gets the vertex function a reload being prepared will swap in; the current one if
+		 * no reload is prepared.
+		 */
+		[[nodiscard]] MTL::Function* reloadedVertex() const noexcept
+		{
+			return m_reloadedVertex ? m_reloadedVertex.get() : m_vertex.get();
+		}
+
+		[[nodiscard]] MTL::Function* reloadedFragment() const noexcept
+		{
+			return m_reloadedFragment ? m_reloadedFragment.get() : m_fragment.get();
+		}
+
 		void create() override;
+
+		[[nodiscard]] bool isValid() const noexcept override
+		{
+			return m_vertex.get() && m_fragment.get();
+		}
+
+		bool prepareReload() override;
+		void applyReload() override;
+
+	private:
+		/**
+		 * @brief Compiles the shader source and looks up its entry points.
+		 *
+		 * @return true if the library and both functions were created.
+		 */
+		bool compile(NS::SharedPtr<MTL::Library>& library, NS::SharedPtr<MTL::Function>& vertex,
+					 NS::SharedPtr<MTL::Function>& fragment) const;
 	};
 
 
@@ -53,6 +116,13 @@ namespace lune::metal
 		std::map<std::string, MTL::Buffer*> m_uniformBuffers;
 		std::map<std::string, MTL::Texture*> m_textures;
 
+		/// Small uniforms set by value, encoded inline on every bind. Each entry keeps its
+		/// capacity, so updating a uniform every draw doesn't allocate.
+		std::map<std::string, std::vector<std::byte>> m_uniformData;
+
+		/// Buffers owned by the material for uniforms too large to encode inline.
+		std::map<std::string, NS::SharedPtr<MTL::Buffer>> m_ownedBuffers;
+
 	public:
 		explicit MetalMaterialImpl(const gfx::Pipeline& pipeline) : m_pipeline(&pipeline)
 		{
@@ -71,7 +141,7 @@ namespace lune::metal
 	};
 
 
-	export class MetalPipelineImpl : public gfx::IPipelineImpl
+	export class MetalPipelineImpl : public gfx::IPipelineImpl, public gfx::IHotReloadable
 	{
 		struct ArgumentInfo
 		{
@@ -81,47 +151,71 @@ namespace lune::metal
 			MTL::ArgumentType type;
 		};
 
+		/**
+		 * @brief Everything built from the shader, replaced as a whole on reload.
+		 */
+		struct PipelineState
+		{
+			NS::SharedPtr<MTL::RenderPipelineState> state;
+			NS::SharedPtr<MTL::DepthStencilState> depthStencilState;
+			std::vector<ArgumentInfo> vertexArguments;
+			std::vector<ArgumentInfo> fragmentArguments;
+		};
+
 		const gfx::Shader* m_shader{};
 		gfx::PipelineDesc m_desc{};
 
-		NS::SharedPtr<MTL::RenderPipelineState> m_state;
-		NS::SharedPtr<MTL::DepthStencilState> m_depthStencilState;
-
-		std::vector<ArgumentInfo> m_vertexArguments;
-		std::vector<ArgumentInfo> m_fragmentArguments;
+		PipelineState m_current;
+		PipelineState m_reloaded; ///< Built by `prepareReload`, swapped in by `applyReload`.
 
 	public:
-		explicit MetalPipelineImpl(const gfx::Shader& shader, const gfx::PipelineDesc& desc) :
-			m_shader(&shader), m_desc(desc)
+		explicit MetalPipelineImpl(const gfx::Shader& shader, const gfx::PipelineDesc& desc);
+
+		~MetalPipelineImpl() override
 		{
-			MetalPipelineImpl::createPipeline();
+			gfx::HotReload::remove(*this);
 		}
 
-		~MetalPipelineImpl() override = default;
-
 		[[nodiscard]] const std::vector<ArgumentInfo>& vertexArguments() const noexcept
 		{
-			return m_vertexArguments;
+			return m_current.vertexArguments;
 		}
 
 		[[nodiscard]] const std::vector<ArgumentInfo>& fragmentArguments() const noexcept
 		{
-			return m_fragmentArguments;
+			return m_current.fragmentArguments;
 		}
 
 		[[nodiscard]] MTL::RenderPipelineState* state() const noexcept
 		{
-			return m_state.get();
+			return m_current.state.get();
 		}
 
 		[[nodiscard]] MTL::DepthStencilState* depthStencilState() const noexcept
 		{
-			return m_depthStencilState.get();
+			return m_current.depthStencilState.get();
 		}
 
+		[[nodiscard]] bool isValid() const noexcept override
+		{
+			return m_current.state.get() != nullptr;
+		}
+
+		bool prepareReload() override;
+		void applyReload() override;
+
 	private:
 		void createPipeline() override;
+
+		/**
+		 * @brief Builds the pipeline state for the given shader functions.
+		 *
+		 * @return true if the state was created.
+		 */
+		bool build(MTL::Function* vertex, MTL::Function* fragment, PipelineState& out) const;
+
 		static std::vector<ArgumentInfo> parse(const NS::Array* arguments);
+		static std::vector<ArgumentInfo> parse(const gfx::ShaderEntryPoint& entryPoint);
 	};
 
 
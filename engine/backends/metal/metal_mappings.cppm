@@ -13,14 +13,14 @@ namespace lune::metal
 		switch (usage)
 		{
 		case BufferUsage::Managed:
-			return MTL::StorageModeManaged;
+			return MTL::ResourceStorageModeManaged;
 		case BufferUsage::Memoryless:
-			return MTL::StorageModeMemoryless;
+			return MTL::ResourceStorageModeMemoryless;
 		case BufferUsage::Private:
-			return MTL::StorageModePrivate;
+			return MTL::ResourceStorageModePrivate;
 		case BufferUsage::Shared:
 		default:
-			return MTL::StorageModeShared;
+			return MTL::ResourceStorageModeShared;
 		}
 	}
 
@@ -139,4 +139,20 @@ namespace lune::metal
 			return MTL::WindingCounterClockwise;
 		}
 	}
+
+	export constexpr MTL::ArgumentType toMetal(const gfx::BindingType type) noexcept
+	{
+		using namespace lune::gfx;
+
+		switch (type)
+		{
+		case TextureBinding:
+			return MTL::ArgumentTypeTexture;
+		case SamplerBinding:
+			return MTL::ArgumentTypeSampler;
+		case BufferBinding:
+		default:
+			return MTL::ArgumentTypeBuffer;
+		}
+	}
 } // namespace lune::metal
@@ -50,6 +50,13 @@ namespace lune::metal
 		{
 			return m_layer.get();
 		}
+
+	protected:
+		void onResize() override
+		{
+			// Only the drawables are sized; pipelines keep rendering into whatever they receive
+			setDrawableSize(m_info.width, m_info.height);
+		}
 	};
 
 	export MetalRenderSurfaceImpl* toMetalImpl(const gfx::RenderSurface& surface)
@@ -1,9 +1,13 @@
 module;
 #include <Metal/Metal.hpp>
+#include <cstring>
 #include <iostream>
 #include <stb_image.h>
 module lune.metal;
 
+import lune.jobs;
+import lune.vfs;
+
 namespace lune::metal
 {
 	MetalTextureImpl::MetalTextureImpl(MTL::Device* device,
@@ -15,10 +19,19 @@ namespace lune::metal
 
 	void MetalTextureImpl::load(const std::string& file, const int desiredChannelCount)
 	{
+		const auto bytes{Vfs::readBinary(file, &JobSystem::instance())};
+		if (!bytes)
+		{
+			std::cerr << "Failed to load " << file << std::endl;
+			return;
+		}
+
 		stbi_set_flip_vertically_on_load(true);
 		int channelCount;
-		unsigned char* image{stbi_load(file.c_str(), &m_info.width, &m_info.height, &channelCount,
-									   desiredChannelCount)};
+		unsigned char* image{stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(bytes->data()),
+												   static_cast<int>(bytes->size()), &m_info.width,
+												   &m_info.height, &channelCount,
+												   desiredChannelCount)};
 
 		if (!image)
 		{
@@ -32,6 +45,7 @@ namespace lune::metal
 		textureDescriptor->setHeight(m_info.height);
 
 		m_texture = NS::TransferPtr(m_texture->device()->newTexture(textureDescriptor));
+		m_allocation = TrackedAllocation{MEMORY_TAG_GPU_TEXTURE, m_texture->allocatedSize()};
 
 		const MTL::Region region{0,
 								 0,
@@ -46,6 +60,51 @@ namespace lune::metal
 		stbi_image_free(image);
 	}
 
+	void MetalTextureImpl::setData(const void* data, const size_t bytesPerRow)
+	{
+		const size_t size{bytesPerRow * static_cast<size_t>(m_info.height)};
+		const std::shared_ptr<Staging> staging{acquireStaging(size)};
+		std::memcpy(staging->buffer->contents(), data, size);
+
+		// replaceRegion would write the pixels right away, under the frames still sampling the
+		// texture. A blit on the queue frames are committed to runs after them instead.
+		MTL::CommandBuffer* commandBuffer{
+				MetalContextImpl::instance().commandQueue()->commandBuffer()};
+		MTL::BlitCommandEncoder* encoder{commandBuffer->blitCommandEncoder()};
+		encoder->copyFromBuffer(staging->buffer.get(), 0, bytesPerRow, size,
+								MTL::Size{static_cast<NS::UInteger>(m_info.width),
+										  static_cast<NS::UInteger>(m_info.height), 1},
+								m_texture.get(), 0, 0, MTL::Origin{0, 0, 0});
+		encoder->endEncoding();
+
+		commandBuffer->addCompletedHandler(
+				[staging](MTL::CommandBuffer*)
+				{ staging->inFlight.store(false, std::memory_order_release); });
+		addTimingHandler(commandBuffer, "Texture upload");
+		commandBuffer->commit();
+	}
+
+	std::shared_ptr<MetalTextureImpl::Staging> MetalTextureImpl::acquireStaging(const size_t size)
+	{
+		for (const std::shared_ptr<Staging>& staging : m_staging)
+		{
+			if (!staging->inFlight.load(std::memory_order_acquire) &&
+				staging->buffer->length() >= size)
+			{
+				staging->inFlight.store(true, std::memory_order_relaxed);
+				return staging;
+			}
+		}
+
+		// One per update in flight, i.e. usually one per frame the GPU is behind
+		auto staging{std::make_shared<Staging>()};
+		staging->buffer = NS::TransferPtr(
+				m_texture->device()->newBuffer(size, MTL::ResourceStorageModeShared));
+		staging->inFlight.store(true, std::memory_order_relaxed);
+		m_staging.push_back(staging);
+		return staging;
+	}
+
 	void MetalTextureImpl::create(MTL::Device* device)
 	{
 		const auto pixelFmt{toMetal(m_info.pixelFormat)};
@@ -54,5 +113,6 @@ namespace lune::metal
 		desc->setUsage(MTL::TextureUsageShaderRead | MTL::TextureUsageShaderWrite);
 
 		m_texture = NS::TransferPtr(device->newTexture(desc));
+		m_allocation = TrackedAllocation{MEMORY_TAG_GPU_TEXTURE, m_texture->allocatedSize()};
 	}
 } // namespace lune::metal
@@ -1,14 +1,27 @@
 module;
 #include <Metal/Metal.hpp>
+#include <atomic>
+#include <memory>
+#include <vector>
 export module lune.metal:texture;
 
 import lune.gfx;
+import lune.memory;
 
 namespace lune::metal
 {
 	class MetalTextureImpl final : public gfx::ITextureImpl
 	{
+		/// Pixels of an update, copied into the texture by a blit once the GPU gets to it.
+		struct Staging
+		{
+			NS::SharedPtr<MTL::Buffer> buffer;
+			std::atomic<bool> inFlight{false};
+		};
+
 		NS::SharedPtr<MTL::Texture> m_texture;
+		TrackedAllocation m_allocation;
+		std::vector<std::shared_ptr<Staging>> m_staging; ///< Reused once their blit has completed.
 
 	public:
 		explicit MetalTextureImpl(MTL::Device* device,
@@ -16,6 +29,7 @@ namespace lune::metal
 		~MetalTextureImpl() override = default;
 
 		void load(const std::string& file, int desiredChannelCount) override;
+		void setData(const void* data, size_t bytesPerRow) override;
 
 		[[nodiscard]] MTL::Texture* texture() const noexcept
 		{
@@ -24,6 +38,11 @@ namespace lune::metal
 
 	private:
 		void create(MTL::Device* device);
+
+		/**
+		 * @brief Gets a staging buffer of at least `size` bytes that no blit is reading.
+		 */
+		[[nodiscard]] std::shared_ptr<Staging> acquireStaging(size_t size);
 	};
 
 
@@ -1,27 +1,33 @@
 module;
+#include <cstddef>
 #include <fstream>
 #include <iosfwd>
 #include <iostream>
 #include <optional>
 #include <ostream>
-#include <sstream>
+#include <span>
 #include <string>
+#include <vector>
 module lune;
 
 namespace lune
 {
 	std::optional<std::string> File::read(const std::string& path)
 	{
-		std::ifstream file(path);
-		if (!file)
-		{
+		auto content{Vfs::read(path, &JobSystem::instance())};
+		if (!content)
+			std::cerr << "Failed to open file: " << path;
+
+		return content;
+	}
+
+	std::optional<std::vector<std::byte>> File::readBinary(const std::string& path)
+	{
+		auto bytes{Vfs::readBinary(path, &JobSystem::instance())};
+		if (!bytes)
 			std::cerr << "Failed to open file: " << path;
-			return std::nullopt;
-		}
 
-		std::ostringstream ss;
-		ss << file.rdbuf();
-		return ss.str();
+		return bytes;
 	}
 
 	void File::write(const std::string& path, const std::string& content)
@@ -37,6 +43,21 @@ namespace lune
 		out << content;
 	}
 
+	bool File::writeBinary(const std::string& path, const std::span<const std::byte> content)
+	{
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+
+		if (!out)
+		{
+			std::cerr << "Failed to open file for writing: " << path;
+			return false;
+		}
+
+		out.write(reinterpret_cast<const char*>(content.data()),
+				  static_cast<std::streamsize>(content.size()));
+		return static_cast<bool>(out);
+	}
+
 	void File::append(const std::string& path, const std::string& content)
 	{
 		std::ofstream file(path, std::ios::app);
@@ -1,10 +1,19 @@
 module;
+#include <cstddef>
 #include <optional>
+#include <span>
 #include <string>
+#include <vector>
 export module lune:file;
 
 namespace lune
 {
+	/**
+	 * @brief Whole-file reads and writes.
+	 *
+	 * Reads go through the virtual file system (`Vfs`), so paths are looked up in the mounted
+	 * directories and archives first and fall back to the disk. Writes always go to the disk.
+	 */
 	export class File
 	{
 	public:
@@ -19,6 +28,16 @@ namespace lune
 		 */
 		static std::optional<std::string> read(const std::string& path);
 
+		/**
+		 * @brief Reads the raw bytes of a file.
+		 *
+		 * @param path Path to the file.
+		 *
+		 * @return std::optional containing the file bytes if the file was successfully opened and
+		 * read; std::nullopt otherwise.
+		 */
+		static std::optional<std::vector<std::byte>> readBinary(const std::string& path);
+
 		/**
 		 * @brief Overwrites all data in the file with the new content.
 		 *
@@ -27,6 +46,16 @@ namespace lune
 		 */
 		static void write(const std::string& path, const std::string& content);
 
+		/**
+		 * @brief Overwrites all data in the file with the given bytes.
+		 *
+		 * @param path Path to the file.
+		 * @param content Bytes being written to the file. Overwrites all data.
+		 *
+		 * @return true if every byte was written; false otherwise.
+		 */
+		static bool writeBinary(const std::string& path, std::span<const std::byte> content);
+
 		/**
 		 * @brief Appends content to the desired file.
 		 *
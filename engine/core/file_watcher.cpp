@@ -0,0 +1,212 @@
+module;
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+module lune;
+
+namespace lune
+{
+	namespace
+	{
+		std::string normalize(const std::string& path)
+		{
+			std::error_code error;
+			const std::filesystem::path canonical{std::filesystem::weakly_canonical(path, error)};
+			return error ? std::filesystem::path(path).lexically_normal().string()
+						 : canonical.string();
+		}
+	} // namespace
+
+	FileWatcher::FileWatcher(std::function<void(const std::string&)> callback) :
+		m_callback(std::move(callback))
+	{
+#ifdef __linux__
+		m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (m_inotify < 0)
+			std::cerr << "Failed to initialize inotify: " << std::strerror(errno) << "\n";
+#endif
+
+		m_thread = std::thread(&FileWatcher::run, this);
+	}
+
+	FileWatcher::~FileWatcher()
+	{
+		{
+			std::lock_guard lock(m_mutex);
+			m_running.store(false, std::memory_order_relaxed);
+		}
+		m_stopCondition.notify_all();
+		m_thread.join();
+
+#ifdef __linux__
+		if (m_inotify >= 0)
+			close(m_inotify);
+#endif
+	}
+
+	bool FileWatcher::watch(const std::string& path)
+	{
+		const std::string file{normalize(path)};
+
+		std::error_code error;
+		if (!std::filesystem::is_regular_file(file, error))
+		{
+			std::cerr << "Cannot watch " << path << ": not a file\n";
+			return false;
+		}
+
+		std::lock_guard lock(m_mutex);
+
+#ifdef __linux__
+		if (m_inotify < 0)
+			return false;
+
+		// Watching the directory rather than the file also catches saves that replace the file
+		const std::string directory{std::filesystem::path(file).parent_path().string()};
+		const int descriptor{
+				inotify_add_watch(m_inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO)};
+		if (descriptor < 0)
+		{
+			std::cerr << "Failed to watch " << directory << ": " << std::strerror(errno) << "\n";
+			return false;
+		}
+
+		m_directories[descriptor] = directory;
+#else
+		m_writeTimes[file] = std::filesystem::last_write_time(file, error);
+#endif
+
+		m_files.insert(file);
+		return true;
+	}
+
+	void FileWatcher::unwatch(const std::string& path)
+	{
+		const std::string file{normalize(path)};
+
+		std::lock_guard lock(m_mutex);
+		if (m_files.erase(file) == 0)
+			return;
+
+#ifdef __linux__
+		const std::filesystem::path directory{std::filesystem::path(file).parent_path()};
+		const bool directoryUsed{std::ranges::any_of(
+				m_files, [&](const std::string& other)
+				{ return std::filesystem::path(other).parent_path() == directory; })};
+		if (directoryUsed)
+			return;
+
+		const auto it{std::ranges::find_if(m_directories, [&](const auto& entry)
+										   { return entry.second == directory.string(); })};
+		if (it != m_directories.end())
+		{
+			inotify_rm_watch(m_inotify, it->first);
+			m_directories.erase(it);
+		}
+#else
+		m_writeTimes.erase(file);
+#endif
+	}
+
+	void FileWatcher::run()
+	{
+		std::vector<std::string> changed;
+		while (m_running.load(std::memory_order_relaxed))
+		{
+			collect(changed);
+			if (changed.empty())
+				continue;
+
+			// Editors often save in several steps; report once the writes have settled
+			size_t count;
+			do
+			{
+				count = changed.size();
+				collect(changed);
+			} while (changed.size() != count && m_running.load(std::memory_order_relaxed));
+
+			std::ranges::sort(changed);
+			const auto [first, last]{std::ranges::unique(changed)};
+			changed.erase(first, last);
+
+			for (const std::string& path : changed)
+				m_callback(path);
+
+			changed.clear();
+		}
+	}
+
+#ifdef __linux__
+	void FileWatcher::collect(std::vector<std::string>& changed)
+	{
+		if (m_inotify < 0)
+		{
+			std::unique_lock lock(m_mutex);
+			m_stopCondition.wait_for(lock, POLL_INTERVAL,
+									 [this] { return !m_running.load(std::memory_order_relaxed); });
+			return;
+		}
+
+		pollfd descriptor{.fd = m_inotify, .events = POLLIN};
+		if (poll(&descriptor, 1, static_cast<int>(POLL_INTERVAL.count())) <= 0)
+			return;
+
+		alignas(inotify_event) std::array<std::byte, 4096> buffer;
+		ssize_t length;
+		while ((length = read(m_inotify, buffer.data(), buffer.size())) > 0)
+		{
+			std::lock_guard lock(m_mutex);
+			for (ssize_t offset = 0; offset < length;)
+			{
+				const auto* event{reinterpret_cast<const inotify_event*>(buffer.data() + offset)};
+				offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+				const auto directory{m_directories.find(event->wd)};
+				if (event->len == 0 || directory == m_directories.end())
+					continue;
+
+				std::string file{
+						(std::filesystem::path(directory->second) / event->name).string()};
+				if (m_files.contains(file))
+					changed.push_back(std::move(file));
+			}
+		}
+	}
+#else
+	void FileWatcher::collect(std::vector<std::string>& changed)
+	{
+		std::unique_lock lock(m_mutex);
+		if (m_stopCondition.wait_for(lock, POLL_INTERVAL,
+									 [this] { return !m_running.load(std::memory_order_relaxed); }))
+			return;
+
+		for (auto& [file, writeTime] : m_writeTimes)
+		{
+			// Missing while a save replaces the file; picked up on the next poll
+			std::error_code error;
+			const auto current{std::filesystem::last_write_time(file, error)};
+			if (error || current == writeTime)
+				continue;
+
+			writeTime = current;
+			changed.push_back(file);
+		}
+	}
+#endif
+} // namespace lune
@@ -0,0 +1,85 @@
+module;
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+export module lune:file_watcher;
+
+namespace lune
+{
+	/**
+	 * @brief Watches files for changes on a background thread.
+	 *
+	 * On Linux, the directories of the watched files are monitored with inotify, so saves are
+	 * seen immediately; elsewhere, modification times are polled every `POLL_INTERVAL`. Both
+	 * catch files being rewritten in place and files replaced by a rename, as most editors save.
+	 * Changes within `POLL_INTERVAL` of each other are reported once, after the last one.
+	 *
+	 * The callback runs on the watcher thread, so it can do slow work such as recompiling a
+	 * shader without stalling anything else.
+	 *
+	 * @code
+	 * FileWatcher watcher{[](const std::string& path) { std::println("{} changed", path); }};
+	 * watcher.watch("shaders/basic.metal");
+	 * @endcode
+	 */
+	export class FileWatcher
+	{
+		std::function<void(const std::string&)> m_callback;
+
+		std::mutex m_mutex;
+		std::condition_variable m_stopCondition;
+		std::set<std::string> m_files;
+		std::atomic<bool> m_running{true};
+		std::thread m_thread;
+
+#ifdef __linux__
+		int m_inotify{-1};
+		std::map<int, std::string> m_directories; ///< Watch descriptor to directory.
+#else
+		std::map<std::string, std::filesystem::file_time_type> m_writeTimes;
+#endif
+
+	public:
+		/// Latency of change detection when polling, and how long changes are coalesced.
+		static constexpr std::chrono::milliseconds POLL_INTERVAL{100};
+
+		/**
+		 * @param callback Called on the watcher thread with the absolute path of each changed file.
+		 */
+		explicit FileWatcher(std::function<void(const std::string&)> callback);
+		~FileWatcher();
+
+		FileWatcher(const FileWatcher&) = delete;
+		FileWatcher& operator=(const FileWatcher&) = delete;
+
+		/**
+		 * @brief Starts watching a file.
+		 *
+		 * @param path Path to an existing file.
+		 *
+		 * @return true if the file is being watched.
+		 */
+		bool watch(const std::string& path);
+
+		/**
+		 * @brief Stops watching a file.
+		 */
+		void unwatch(const std::string& path);
+
+	private:
+		void run();
+
+		/**
+		 * @brief Waits up to `POLL_INTERVAL` for changes and appends the changed files.
+		 */
+		void collect(std::vector<std::string>& changed);
+	};
+} // namespace lune
@@ -0,0 +1,55 @@
+module;
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+module lune;
+
+namespace lune
+{
+	GameLoop::GameLoop(const GameLoopDesc& desc) : m_desc(desc)
+	{
+		// A zero, negative or infinite rate would make every step zero-length or never due
+		if (!std::isfinite(m_desc.tickRate) || m_desc.tickRate <= 0.0)
+		{
+			std::cerr << "Invalid game loop tick rate " << m_desc.tickRate << "; using "
+					  << GameLoopDesc{}.tickRate << "\n";
+			m_desc.tickRate = GameLoopDesc{}.tickRate;
+		}
+
+		m_tickDelta = 1.0 / m_desc.tickRate;
+	}
+
+	uint32_t GameLoop::advance(const double frameTime) noexcept
+	{
+		m_accumulator += std::max(frameTime, 0.0);
+
+		auto ticks{static_cast<uint64_t>(std::floor(m_accumulator / m_tickDelta))};
+		if (ticks > m_desc.maxTicksPerFrame)
+		{
+			// Catching up would take longer than the frames it simulates; skip ahead instead
+			const auto excess{static_cast<double>(ticks - m_desc.maxTicksPerFrame)};
+			const double dropped{excess * m_tickDelta};
+			m_accumulator -= dropped;
+			m_droppedTime += dropped;
+			ticks = m_desc.maxTicksPerFrame;
+		}
+
+		m_accumulator = std::max(m_accumulator - static_cast<double>(ticks) * m_tickDelta, 0.0);
+		m_alpha = std::min(m_accumulator / m_tickDelta, 1.0);
+		m_tickCount += ticks;
+		return static_cast<uint32_t>(ticks);
+	}
+
+	void GameLoop::processEvents() const
+	{
+		if (!m_desc.idle)
+		{
+			Window::pollEvents();
+			return;
+		}
+
+		// Sleep until input arrives or the next update is due
+		Window::waitEvents(std::max(m_tickDelta - m_accumulator - m_timer.peakDelta(), 0.0));
+	}
+} // namespace lune
@@ -0,0 +1,134 @@
+module;
+#include <cstdint>
+export module lune:game_loop;
+
+import :timer;
+
+namespace lune
+{
+	export struct GameLoopDesc
+	{
+		double tickRate{60.0}; ///< Fixed updates per second; must be positive and finite.
+
+		/// Most updates run per frame. When a frame falls further behind, the excess time is
+		/// dropped rather than simulated, so a slow frame can't make the next one slower.
+		uint32_t maxTicksPerFrame{8};
+
+		/// Waits for window events instead of polling, for tools that don't animate. Frames then
+		/// run when an event arrives or the next update is due, at most `tickRate` times a second.
+		bool idle{false};
+	};
+
+
+	/**
+	 * @brief Drives a fixed-rate simulation and a variable-rate render from one loop.
+	 *
+	 * Every frame, the time elapsed since the previous one is added to an accumulator, which
+	 * `update` drains in steps of exactly `tickDelta()` seconds. `render` then runs once with the
+	 * fraction of a step left over, to interpolate between the last two simulated states. The
+	 * simulation therefore behaves the same at any refresh rate:
+	 *
+	 * @code
+	 * GameLoop loop{{.tickRate = 120.0}};
+	 * loop.run(window,
+	 *          [&](const double dt) { previous = current; current = simulate(current, dt); },
+	 *          [&](const double alpha) { draw(lerp(previous, current, alpha)); });
+	 * @endcode
+	 */
+	export class GameLoop
+	{
+		GameLoopDesc m_desc;
+		double m_tickDelta{};
+		Timer m_timer;
+		bool m_started{};
+
+		double m_accumulator{};
+		double m_alpha{};
+		uint64_t m_tickCount{};
+		double m_droppedTime{};
+
+	public:
+		/**
+		 * @brief Creates the loop. An invalid `tickRate` is reported and replaced by the default.
+		 */
+		explicit GameLoop(const GameLoopDesc& desc = {});
+
+		/**
+		 * @brief Runs frames until the window should close.
+		 *
+		 * @param update Called with `tickDelta()` for every fixed step.
+		 * @param render Called once per frame with the interpolation factor, in [0, 1).
+		 */
+		template <typename WindowT, typename Update, typename Render>
+		void run(const WindowT& window, Update&& update, Render&& render)
+		{
+			while (!window.shouldClose())
+				frame(update, render);
+		}
+
+		/**
+		 * @brief Runs one frame: the updates that are due, the render, then the window events.
+		 * For loops that need to do more per frame than `run()` allows.
+		 */
+		template <typename Update, typename Render> void frame(Update&& update, Render&& render)
+		{
+			if (!m_started)
+			{
+				m_timer.start();
+				m_started = true;
+			}
+
+			const uint32_t ticks{advance(m_timer.delta())};
+			for (uint32_t i = 0; i < ticks; ++i)
+				update(m_tickDelta);
+
+			render(m_alpha);
+			processEvents();
+		}
+
+		/**
+		 * @brief Adds elapsed time to the accumulator and consumes the whole steps it contains.
+		 * Called by `frame()`; exposed for custom loops and tests.
+		 *
+		 * @param frameTime Seconds since the previous frame.
+		 *
+		 * @return The number of fixed updates to run, at most `maxTicksPerFrame`.
+		 */
+		uint32_t advance(double frameTime) noexcept;
+
+		/**
+		 * @brief Gets the duration of a fixed update, in seconds.
+		 */
+		[[nodiscard]] double tickDelta() const noexcept
+		{
+			return m_tickDelta;
+		}
+
+		/**
+		 * @brief Gets how far the simulation is into the next step, in [0, 1).
+		 */
+		[[nodiscard]] double alpha() const noexcept
+		{
+			return m_alpha;
+		}
+
+		[[nodiscard]] uint64_t tickCount() const noexcept
+		{
+			return m_tickCount;
+		}
+
+		/**
+		 * @brief Gets the total time, in seconds, dropped because frames fell too far behind.
+		 */
+		[[nodiscard]] double droppedTime() const noexcept
+		{
+			return m_droppedTime;
+		}
+
+	private:
+		/**
+		 * @brief Polls window events, or waits for them until the next update in idle mode.
+		 */
+		void processEvents() const;
+	};
+} // namespace lune
@@ -0,0 +1,88 @@
+module;
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+export module lune:ring_buffer;
+
+namespace lune
+{
+	/**
+	 * @brief Fixed-capacity, lock-free queue for exactly one producer and one consumer thread.
+	 *
+	 * Elements are copied in and out, so the queue never allocates after construction. Producer
+	 * and consumer indices live on separate cache lines to avoid false sharing.
+	 *
+	 * @tparam T Trivially copyable element type.
+	 * @tparam Capacity Maximum number of queued elements; must be a power of two.
+	 */
+	export template <typename T, size_t Capacity> class SpscRingBuffer
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+					  "SpscRingBuffer capacity must be a power of two");
+
+		static constexpr size_t CACHE_LINE_SIZE{64};
+		static constexpr size_t MASK{Capacity - 1};
+
+		alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_head{0}; ///< Next slot to read.
+		alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_tail{0}; ///< Next slot to write.
+		alignas(CACHE_LINE_SIZE) std::array<T, Capacity> m_buffer{};
+
+	public:
+		/**
+		 * @brief Appends an element. Producer thread only.
+		 *
+		 * @return false if the queue is full and the element was dropped.
+		 */
+		bool tryPush(const T& value) noexcept
+		{
+			const size_t tail{m_tail.load(std::memory_order_relaxed)};
+			if (tail - m_head.load(std::memory_order_acquire) == Capacity)
+			{
+				return false;
+			}
+
+			m_buffer[tail & MASK] = value;
+			m_tail.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+		/**
+		 * @brief Removes the oldest element. Consumer thread only.
+		 *
+		 * @return false if the queue is empty.
+		 */
+		bool tryPop(T& value) noexcept
+		{
+			const size_t head{m_head.load(std::memory_order_relaxed)};
+			if (head == m_tail.load(std::memory_order_acquire))
+			{
+				return false;
+			}
+
+			value = m_buffer[head & MASK];
+			m_head.store(head + 1, std::memory_order_release);
+			return true;
+		}
+
+		/**
+		 * @brief Approximate number of queued elements; exact when called from either end while
+		 * the other is idle.
+		 */
+		[[nodiscard]] size_t size() const noexcept
+		{
+			return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+		}
+
+		[[nodiscard]] bool isEmpty() const noexcept
+		{
+			return size() == 0;
+		}
+
+		[[nodiscard]] static constexpr size_t capacity() noexcept
+		{
+			return Capacity;
+		}
+	};
+} // namespace lune
@@ -6,13 +6,13 @@ namespace lune
 {
 	void Timer::start()
 	{
-		m_start = std::chrono::high_resolution_clock::now();
+		m_start = std::chrono::steady_clock::now();
 		m_prevTime = m_start;
 	}
 
 	double Timer::delta()
 	{
-		const auto now{std::chrono::high_resolution_clock::now()};
+		const auto now{std::chrono::steady_clock::now()};
 		const double time{
 				std::chrono::duration_cast<std::chrono::duration<double>>(now - m_prevTime)
 						.count()};
@@ -23,13 +23,13 @@ namespace lune
 
 	double Timer::peakDelta() const
 	{
-		const auto now{std::chrono::high_resolution_clock::now()};
+		const auto now{std::chrono::steady_clock::now()};
 		return std::chrono::duration_cast<std::chrono::duration<double>>(now - m_prevTime).count();
 	}
 
 	double Timer::elapsed()
 	{
-		const auto now{std::chrono::high_resolution_clock::now()};
+		const auto now{std::chrono::steady_clock::now()};
 		const double time{
 				std::chrono::duration_cast<std::chrono::duration<double>>(now - m_start).count()};
 		m_start = now;
@@ -38,7 +38,7 @@ namespace lune
 
 	double Timer::peakElapsed() const
 	{
-		const auto now{std::chrono::high_resolution_clock::now()};
+		const auto now{std::chrono::steady_clock::now()};
 		return std::chrono::duration_cast<std::chrono::duration<double>>(now - m_start).count();
 	}
 } // namespace lune
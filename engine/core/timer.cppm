@@ -5,12 +5,12 @@ export module lune:timer;
 namespace lune
 {
 	/**
-	 * @brief A high-resolution timer for measuring time intervals.
+	 * @brief A monotonic timer for measuring time intervals.
 	 */
 	export class Timer
 	{
-		std::chrono::time_point<std::chrono::high_resolution_clock> m_start;
-		std::chrono::time_point<std::chrono::high_resolution_clock> m_prevTime;
+		std::chrono::time_point<std::chrono::steady_clock> m_start;
+		std::chrono::time_point<std::chrono::steady_clock> m_prevTime;
 
 	public:
 		/**
@@ -0,0 +1,38 @@
+#pragma once
+
+/**
+ * @brief Profiling macros. Modules can't export macros, so this header is included next to
+ * `import lune;` wherever zones are placed:
+ *
+ * @code
+ * #include <lune/profiler.hpp>
+ * import lune;
+ *
+ * void update()
+ * {
+ *     LUNE_ZONE("update");
+ *     ...
+ * }
+ * @endcode
+ *
+ * Zones cost nothing beyond a flag check while no capture is running, and compile away
+ * entirely when the library is built with LUNE_PROFILER=OFF.
+ */
+
+#define LUNE_PROFILER_CONCAT_IMPL(a, b) a##b
+#define LUNE_PROFILER_CONCAT(a, b) LUNE_PROFILER_CONCAT_IMPL(a, b)
+
+#ifdef LUNE_ENABLE_PROFILER
+/// Times the enclosing scope. `name` must be a string literal (or otherwise outlive the capture).
+#define LUNE_ZONE(name) const ::lune::ProfileZone LUNE_PROFILER_CONCAT(luneZone, __LINE__){name}
+
+/// Times the enclosing scope, named after the current function.
+#define LUNE_ZONE_FUNCTION() LUNE_ZONE(__func__)
+
+/// Marks the end of a frame. Called by `Window::pollEvents`, so only needed for custom loops.
+#define LUNE_FRAME_MARK() ::lune::Profiler::markFrame()
+#else
+#define LUNE_ZONE(name) ((void)0)
+#define LUNE_ZONE_FUNCTION() ((void)0)
+#define LUNE_FRAME_MARK() ((void)0)
+#endif
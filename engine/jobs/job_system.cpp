@@ -0,0 +1,234 @@
+module;
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <lune/profiler.hpp>
+#include <mutex>
+#include <thread>
+#include <string>
+#include <utility>
+#include <vector>
+module lune.jobs;
+
+import lune.profiler;
+
+namespace lune
+{
+	namespace
+	{
+		void reportException(const std::exception_ptr& exception)
+		{
+			try
+			{
+				std::rethrow_exception(exception);
+			}
+			catch (const std::exception& e)
+			{
+				std::cerr << "Job failed: " << e.what() << "\n";
+			}
+			catch (...)
+			{
+				std::cerr << "Job failed with an unknown exception\n";
+			}
+		}
+	} // namespace
+
+	JobSystem::JobSystem(const size_t threadCount)
+	{
+		m_workers.reserve(threadCount);
+		for (size_t i = 0; i < threadCount; ++i)
+		{
+			m_workers.emplace_back(
+					[this, i]
+					{
+						Profiler::setThreadName("Worker " + std::to_string(i));
+						workerLoop();
+					});
+		}
+	}
+
+	JobSystem::~JobSystem()
+	{
+		{
+			std::lock_guard lock(m_mutex);
+			m_running = false;
+		}
+		m_condition.notify_all();
+
+		for (std::thread& worker : m_workers)
+		{
+			worker.join();
+		}
+	}
+
+	JobSystem& JobSystem::instance()
+	{
+		static JobSystem system;
+		return system;
+	}
+
+	size_t JobSystem::defaultThreadCount() noexcept
+	{
+		const size_t hardwareThreads{std::thread::hardware_concurrency()};
+		return std::max<size_t>(hardwareThreads, 2) - 1;
+	}
+
+	void JobSystem::submit(std::function<void()> job, JobCounter* counter)
+	{
+		if (counter)
+		{
+			counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		{
+			std::lock_guard lock(m_mutex);
+			m_queue.push_back({std::move(job), counter});
+		}
+		m_condition.notify_one();
+	}
+
+	void JobSystem::wait(const JobCounter& counter)
+	{
+		while (!counter.isDone())
+		{
+			if (!executeOne())
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		std::exception_ptr exception;
+		{
+			std::lock_guard lock(counter.m_exceptionMutex);
+			exception = std::exchange(counter.m_exception, nullptr);
+		}
+
+		if (exception)
+		{
+			std::rethrow_exception(exception);
+		}
+	}
+
+	void JobSystem::parallelFor(const size_t count, const size_t grainSize,
+								const std::function<void(size_t, size_t)>& function)
+	{
+		const size_t grain{std::max<size_t>(grainSize, 1)};
+		if (count <= grain || m_workers.empty())
+		{
+			function(0, count);
+			return;
+		}
+
+		// The first range is kept for the calling thread
+		JobCounter counter;
+		for (size_t begin = grain; begin < count; begin += grain)
+		{
+			const size_t end{std::min(begin + grain, count)};
+			submit([&function, begin, end] { function(begin, end); }, &counter);
+		}
+
+		// The jobs reference the function, so they must finish before anything is rethrown
+		std::exception_ptr exception;
+		try
+		{
+			function(0, grain);
+		}
+		catch (...)
+		{
+			exception = std::current_exception();
+		}
+
+		try
+		{
+			wait(counter);
+		}
+		catch (...)
+		{
+			if (!exception)
+			{
+				exception = std::current_exception();
+			}
+		}
+
+		if (exception)
+		{
+			std::rethrow_exception(exception);
+		}
+	}
+
+	void JobSystem::workerLoop()
+	{
+		while (true)
+		{
+			Job job;
+			{
+				std::unique_lock lock(m_mutex);
+				m_condition.wait(lock, [this] { return !m_running || !m_queue.empty(); });
+
+				if (m_queue.empty())
+				{
+					return;
+				}
+
+				job = std::move(m_queue.front());
+				m_queue.pop_front();
+			}
+
+			execute(job);
+		}
+	}
+
+	bool JobSystem::executeOne()
+	{
+		Job job;
+		{
+			std::lock_guard lock(m_mutex);
+			if (m_queue.empty())
+			{
+				return false;
+			}
+
+			job = std::move(m_queue.front());
+			m_queue.pop_front();
+		}
+
+		execute(job);
+		return true;
+	}
+
+	void JobSystem::execute(Job& job)
+	{
+		LUNE_ZONE("Job");
+
+		// The counter is decremented however the job ends, so waiting on it never hangs
+		try
+		{
+			job.function();
+		}
+		catch (...)
+		{
+			if (job.counter)
+			{
+				std::lock_guard lock(job.counter->m_exceptionMutex);
+				if (!job.counter->m_exception)
+				{
+					job.counter->m_exception = std::current_exception();
+				}
+			}
+			else
+			{
+				reportException(std::current_exception());
+			}
+		}
+
+		if (job.counter)
+		{
+			job.counter->m_pending.fetch_sub(1, std::memory_order_release);
+		}
+	}
+} // namespace lune
@@ -0,0 +1,124 @@
+module;
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+export module lune.jobs;
+
+namespace lune
+{
+	/**
+	 * @brief Tracks the number of unfinished jobs of a batch. Pass the same counter to every
+	 * `JobSystem::submit` call of the batch and wait on it with `JobSystem::wait`.
+	 *
+	 * The first exception thrown by a job of the batch is kept and rethrown by `JobSystem::wait`.
+	 */
+	export class JobCounter
+	{
+		std::atomic<size_t> m_pending{0};
+		mutable std::mutex m_exceptionMutex;
+		mutable std::exception_ptr m_exception; ///< Cleared once rethrown.
+
+		friend class JobSystem;
+
+	public:
+		[[nodiscard]] bool isDone() const noexcept
+		{
+			return m_pending.load(std::memory_order_acquire) == 0;
+		}
+	};
+
+
+	/**
+	 * @brief Fixed-size pool of worker threads executing fire-and-forget jobs.
+	 *
+	 * Waiting threads help execute queued jobs instead of blocking, so jobs may themselves submit
+	 * and wait on nested jobs (e.g. recursive `parallelFor`) without deadlocking the pool.
+	 */
+	export class JobSystem
+	{
+		struct Job
+		{
+			std::function<void()> function;
+			JobCounter* counter{};
+		};
+
+		std::vector<std::thread> m_workers;
+		std::deque<Job> m_queue;
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+		bool m_running{true};
+
+	public:
+		/**
+		 * @brief Starts the worker threads.
+		 *
+		 * @param threadCount Number of workers. Defaults to one less than the hardware
+		 * concurrency, leaving a core for the calling thread.
+		 */
+		explicit JobSystem(size_t threadCount = defaultThreadCount());
+		~JobSystem();
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+		/**
+		 * @brief Gets the engine-wide job system, created on first use.
+		 */
+		static JobSystem& instance();
+
+		/**
+		 * @brief Queues a job for execution on a worker thread. Exceptions thrown by the job are
+		 * handed to its counter, or reported to stderr without one.
+		 *
+		 * @param job Function to execute.
+		 * @param counter Optional counter that is incremented now and decremented once the job
+		 * has finished.
+		 */
+		void submit(std::function<void()> job, JobCounter* counter = nullptr);
+
+		/**
+		 * @brief Blocks until every job tracked by the counter has finished, executing queued
+		 * jobs on the calling thread in the meantime.
+		 *
+		 * @throws The first exception thrown by one of the jobs, once all of them have finished.
+		 */
+		void wait(const JobCounter& counter);
+
+		/**
+		 * @brief Splits `[0, count)` into ranges of at most `grainSize` elements, executes them
+		 * across the pool and the calling thread, and returns once all ranges are done. If a
+		 * range throws, the first exception is rethrown after all of them are done.
+		 *
+		 * @param count Number of elements.
+		 * @param grainSize Maximum number of elements handled by a single job.
+		 * @param function Called with the `[begin, end)` range of each job.
+		 */
+		void parallelFor(size_t count, size_t grainSize,
+						 const std::function<void(size_t begin, size_t end)>& function);
+
+		[[nodiscard]] size_t threadCount() const noexcept
+		{
+			return m_workers.size();
+		}
+
+		[[nodiscard]] static size_t defaultThreadCount() noexcept;
+
+	private:
+		void workerLoop();
+
+		/**
+		 * @brief Pops and executes a single queued job, if any.
+		 *
+		 * @return true if a job was executed.
+		 */
+		bool executeOne();
+
+		static void execute(Job& job);
+	};
+} // namespace lune
@@ -1,12 +1,31 @@
 export module lune;
 
 export import :file;
+export import :file_watcher;
 export import :timer;
+export import :game_loop;
+export import :ring_buffer;
 export import :matrix;
 export import :vector;
+export import :bounds;
 export import :window;
 export import :input_manager;
 export import :input_event;
 export import :input_map;
+export import :input_recorder;
+export import :action_map;
 export import :utils;
+export import :mesh;
+export import :mesh_cooker;
+export import :shader_hot_reload;
+export import :bvh;
+export import :world;
+export import :system_scheduler;
+export import :scene_graph;
+export import :resource_manager;
+export import :cellular_automaton;
 export import lune.gfx;
+export import lune.jobs;
+export import lune.profiler;
+export import lune.memory;
+export import lune.vfs;
@@ -0,0 +1,257 @@
+module;
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+module lune;
+
+namespace lune
+{
+	namespace
+	{
+		constexpr size_t CULL_BATCH_SIZE{8};
+
+		Vec4 normalizePlane(const Vec4& plane) noexcept
+		{
+			const float length{std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z)};
+			return length > 0.0f ? plane / length : plane;
+		}
+
+		/**
+		 * @brief Signed distance of the box center to the plane and the projected radius of the
+		 * box onto the plane normal.
+		 */
+		void planeDistance(const Vec4& plane, const Aabb& box, float& distance, float& radius)
+		{
+			const Vec3 c = box.center();
+			const Vec3 e = box.extents();
+			distance = plane.x * c.x + plane.y * c.y + plane.z * c.z + plane.w;
+			radius = std::abs(plane.x) * e.x + std::abs(plane.y) * e.y + std::abs(plane.z) * e.z;
+		}
+
+		/**
+		 * @brief Culls boxes [begin, end) one at a time, used for the remainder of a SIMD batch and
+		 * on targets without a vector path.
+		 */
+		void cullScalar(const Frustum& frustum, const AabbArray& boxes, const size_t begin,
+						const size_t end, std::vector<uint32_t>& visible)
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				bool outside{false};
+				for (const Vec4& p : frustum.planes)
+				{
+					const float distance{p.x * boxes.centerX()[i] + p.y * boxes.centerY()[i] +
+										 p.z * boxes.centerZ()[i] + p.w};
+					const float radius{std::abs(p.x) * boxes.extentX()[i] +
+									   std::abs(p.y) * boxes.extentY()[i] +
+									   std::abs(p.z) * boxes.extentZ()[i]};
+					outside |= distance + radius < 0.0f;
+				}
+
+				if (!outside)
+				{
+					visible.push_back(static_cast<uint32_t>(i));
+				}
+			}
+		}
+
+		void appendVisible(uint32_t outsideMask, const size_t base, std::vector<uint32_t>& visible)
+		{
+			uint32_t visibleMask{~outsideMask & 0xFFu};
+			while (visibleMask)
+			{
+				visible.push_back(static_cast<uint32_t>(base) + std::countr_zero(visibleMask));
+				visibleMask &= visibleMask - 1;
+			}
+		}
+	} // namespace
+
+	Frustum Frustum::fromMatrix(const Mat4& viewProjection) noexcept
+	{
+		const auto& m = viewProjection.m;
+		const auto row = [&m](const int r) { return Vec4{m[0][r], m[1][r], m[2][r], m[3][r]}; };
+
+		const Vec4 x = row(0);
+		const Vec4 y = row(1);
+		const Vec4 z = row(2);
+		const Vec4 w = row(3);
+
+		Frustum frustum{};
+		frustum.planes[PLANE_LEFT] = normalizePlane(w + x);
+		frustum.planes[PLANE_RIGHT] = normalizePlane(w - x);
+		frustum.planes[PLANE_BOTTOM] = normalizePlane(w + y);
+		frustum.planes[PLANE_TOP] = normalizePlane(w - y);
+		frustum.planes[PLANE_NEAR] = normalizePlane(w + z);
+		frustum.planes[PLANE_FAR] = normalizePlane(w - z);
+		return frustum;
+	}
+
+	bool Frustum::contains(const Vec3& point) const noexcept
+	{
+		for (const Vec4& p : planes)
+		{
+			if (p.x * point.x + p.y * point.y + p.z * point.z + p.w < 0.0f)
+				return false;
+		}
+		return true;
+	}
+
+	bool Frustum::intersects(const Sphere& sphere) const noexcept
+	{
+		for (const Vec4& p : planes)
+		{
+			const Vec3& c = sphere.center;
+			if (p.x * c.x + p.y * c.y + p.z * c.z + p.w < -sphere.radius)
+				return false;
+		}
+		return true;
+	}
+
+	bool Frustum::intersects(const Aabb& box) const noexcept
+	{
+		for (const Vec4& p : planes)
+		{
+			float distance, radius;
+			planeDistance(p, box, distance, radius);
+			if (distance + radius < 0.0f)
+				return false;
+		}
+		return true;
+	}
+
+	CullResult Frustum::classify(const Aabb& box) const noexcept
+	{
+		CullResult result{CULL_INSIDE};
+		for (const Vec4& p : planes)
+		{
+			float distance, radius;
+			planeDistance(p, box, distance, radius);
+			if (distance + radius < 0.0f)
+				return CULL_OUTSIDE;
+			if (distance - radius < 0.0f)
+				result = CULL_INTERSECTING;
+		}
+		return result;
+	}
+
+	size_t Frustum::cull(const AabbArray& boxes, std::vector<uint32_t>& visible) const
+	{
+		const size_t startSize{visible.size()};
+		const size_t count{boxes.size()};
+		const size_t batchEnd{count - count % CULL_BATCH_SIZE};
+
+		const float* cx{boxes.centerX()};
+		const float* cy{boxes.centerY()};
+		const float* cz{boxes.centerZ()};
+		const float* ex{boxes.extentX()};
+		const float* ey{boxes.extentY()};
+		const float* ez{boxes.extentZ()};
+
+#if defined(__AVX__)
+		const __m256 signMask{_mm256_set1_ps(-0.0f)};
+		for (size_t i = 0; i < batchEnd; i += CULL_BATCH_SIZE)
+		{
+			const __m256 centerX{_mm256_loadu_ps(cx + i)};
+			const __m256 centerY{_mm256_loadu_ps(cy + i)};
+			const __m256 centerZ{_mm256_loadu_ps(cz + i)};
+			const __m256 extentX{_mm256_loadu_ps(ex + i)};
+			const __m256 extentY{_mm256_loadu_ps(ey + i)};
+			const __m256 extentZ{_mm256_loadu_ps(ez + i)};
+
+			__m256 outside{_mm256_setzero_ps()};
+			for (const Vec4& p : planes)
+			{
+				const __m256 nx{_mm256_set1_ps(p.x)};
+				const __m256 ny{_mm256_set1_ps(p.y)};
+				const __m256 nz{_mm256_set1_ps(p.z)};
+
+				__m256 distance{_mm256_add_ps(_mm256_mul_ps(nx, centerX), _mm256_set1_ps(p.w))};
+				distance = _mm256_add_ps(distance, _mm256_mul_ps(ny, centerY));
+				distance = _mm256_add_ps(distance, _mm256_mul_ps(nz, centerZ));
+
+				__m256 radius{_mm256_mul_ps(_mm256_andnot_ps(signMask, nx), extentX)};
+				radius = _mm256_add_ps(radius, _mm256_mul_ps(_mm256_andnot_ps(signMask, ny), extentY));
+				radius = _mm256_add_ps(radius, _mm256_mul_ps(_mm256_andnot_ps(signMask, nz), extentZ));
+
+				const __m256 test{_mm256_cmp_ps(_mm256_add_ps(distance, radius),
+												_mm256_setzero_ps(), _CMP_LT_OQ)};
+				outside = _mm256_or_ps(outside, test);
+			}
+
+			appendVisible(static_cast<uint32_t>(_mm256_movemask_ps(outside)), i, visible);
+		}
+#elif defined(__ARM_NEON)
+		// Two 4-wide halves per iteration to keep the batch size in line with AVX
+		for (size_t i = 0; i < batchEnd; i += CULL_BATCH_SIZE)
+		{
+			uint32_t outsideMask{};
+			for (size_t half = 0; half < 2; ++half)
+			{
+				const size_t j{i + half * 4};
+				const float32x4_t centerX{vld1q_f32(cx + j)};
+				const float32x4_t centerY{vld1q_f32(cy + j)};
+				const float32x4_t centerZ{vld1q_f32(cz + j)};
+				const float32x4_t extentX{vld1q_f32(ex + j)};
+				const float32x4_t extentY{vld1q_f32(ey + j)};
+				const float32x4_t extentZ{vld1q_f32(ez + j)};
+
+				uint32x4_t outside{vdupq_n_u32(0)};
+				for (const Vec4& p : planes)
+				{
+					float32x4_t distance{vdupq_n_f32(p.w)};
+					distance = vfmaq_n_f32(distance, centerX, p.x);
+					distance = vfmaq_n_f32(distance, centerY, p.y);
+					distance = vfmaq_n_f32(distance, centerZ, p.z);
+
+					float32x4_t radius{vmulq_n_f32(extentX, std::abs(p.x))};
+					radius = vfmaq_n_f32(radius, extentY, std::abs(p.y));
+					radius = vfmaq_n_f32(radius, extentZ, std::abs(p.z));
+
+					outside = vorrq_u32(outside,
+										vcltq_f32(vaddq_f32(distance, radius), vdupq_n_f32(0.0f)));
+				}
+
+				// Collapse the lane masks into one bit per box
+				const uint32x4_t bits{vandq_u32(outside, uint32x4_t{1, 2, 4, 8})};
+				outsideMask |= vaddvq_u32(bits) << (half * 4);
+			}
+
+			appendVisible(outsideMask, i, visible);
+		}
+#else
+		// No vector path; keep the batch shape so the compiler can auto-vectorize
+		for (size_t i = 0; i < batchEnd; i += CULL_BATCH_SIZE)
+		{
+			bool outside[CULL_BATCH_SIZE]{};
+			for (const Vec4& p : planes)
+			{
+				for (size_t lane = 0; lane < CULL_BATCH_SIZE; ++lane)
+				{
+					const size_t j{i + lane};
+					const float distance{p.x * cx[j] + p.y * cy[j] + p.z * cz[j] + p.w};
+					const float radius{std::abs(p.x) * ex[j] + std::abs(p.y) * ey[j] +
+									   std::abs(p.z) * ez[j]};
+					outside[lane] |= distance + radius < 0.0f;
+				}
+			}
+
+			uint32_t outsideMask{};
+			for (size_t lane = 0; lane < CULL_BATCH_SIZE; ++lane)
+				outsideMask |= static_cast<uint32_t>(outside[lane]) << lane;
+
+			appendVisible(outsideMask, i, visible);
+		}
+#endif
+
+		cullScalar(*this, boxes, batchEnd, count, visible);
+		return visible.size() - startSize;
+	}
+} // namespace lune
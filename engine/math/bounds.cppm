@@ -0,0 +1,322 @@
+module;
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <vector>
+export module lune:bounds;
+
+import :vector;
+import :matrix;
+
+export namespace lune
+{
+	/**
+	 * @brief Axis-aligned bounding box.
+	 *
+	 * A default constructed box is empty (`min > max`), so merging points or boxes into it
+	 * yields their exact bounds.
+	 */
+	struct Aabb
+	{
+		Vec3 min{std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+				 std::numeric_limits<float>::max()};
+		Vec3 max{std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(),
+				 std::numeric_limits<float>::lowest()};
+
+		constexpr Aabb() noexcept = default;
+
+		constexpr Aabb(const Vec3& Min, const Vec3& Max) noexcept : min(Min), max(Max)
+		{
+		}
+
+		[[nodiscard]] static constexpr Aabb fromCenterExtents(const Vec3& center,
+															  const Vec3& extents) noexcept
+		{
+			return {center - extents, center + extents};
+		}
+
+		[[nodiscard]] constexpr bool isEmpty() const noexcept
+		{
+			return min.x > max.x || min.y > max.y || min.z > max.z;
+		}
+
+		[[nodiscard]] constexpr Vec3 center() const noexcept
+		{
+			return (min + max) * 0.5f;
+		}
+
+		/**
+		 * @return Half the size of the box along each axis.
+		 */
+		[[nodiscard]] constexpr Vec3 extents() const noexcept
+		{
+			return (max - min) * 0.5f;
+		}
+
+		[[nodiscard]] constexpr float surfaceArea() const noexcept
+		{
+			const Vec3 d = max - min;
+			return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+		}
+
+		constexpr Aabb& merge(const Vec3& point) noexcept
+		{
+			min = Vec3::min(min, point);
+			max = Vec3::max(max, point);
+			return *this;
+		}
+
+		constexpr Aabb& merge(const Aabb& o) noexcept
+		{
+			min = Vec3::min(min, o.min);
+			max = Vec3::max(max, o.max);
+			return *this;
+		}
+
+		[[nodiscard]] static constexpr Aabb merge(const Aabb& a, const Aabb& b) noexcept
+		{
+			return {Vec3::min(a.min, b.min), Vec3::max(a.max, b.max)};
+		}
+
+		[[nodiscard]] constexpr bool contains(const Vec3& p) const noexcept
+		{
+			return p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y && p.z >= min.z &&
+				   p.z <= max.z;
+		}
+
+		[[nodiscard]] constexpr bool contains(const Aabb& o) const noexcept
+		{
+			return o.min.x >= min.x && o.max.x <= max.x && o.min.y >= min.y && o.max.y <= max.y &&
+				   o.min.z >= min.z && o.max.z <= max.z;
+		}
+
+		[[nodiscard]] constexpr bool intersects(const Aabb& o) const noexcept
+		{
+			return min.x <= o.max.x && max.x >= o.min.x && min.y <= o.max.y && max.y >= o.min.y &&
+				   min.z <= o.max.z && max.z >= o.min.z;
+		}
+
+		/**
+		 * @brief Bounds of this box after being transformed by an affine matrix.
+		 */
+		[[nodiscard]] Aabb transformed(const Mat4& transform) const noexcept
+		{
+			const Vec3 c = center();
+			const Vec3 e = extents();
+			const auto& m = transform.m;
+
+			const Vec3 newCenter{
+					m[0][0] * c.x + m[1][0] * c.y + m[2][0] * c.z + m[3][0],
+					m[0][1] * c.x + m[1][1] * c.y + m[2][1] * c.z + m[3][1],
+					m[0][2] * c.x + m[1][2] * c.y + m[2][2] * c.z + m[3][2],
+			};
+			const Vec3 newExtents{
+					std::abs(m[0][0]) * e.x + std::abs(m[1][0]) * e.y + std::abs(m[2][0]) * e.z,
+					std::abs(m[0][1]) * e.x + std::abs(m[1][1]) * e.y + std::abs(m[2][1]) * e.z,
+					std::abs(m[0][2]) * e.x + std::abs(m[1][2]) * e.y + std::abs(m[2][2]) * e.z,
+			};
+
+			return fromCenterExtents(newCenter, newExtents);
+		}
+	};
+
+
+	struct Sphere
+	{
+		Vec3 center{};
+		float radius{};
+
+		constexpr Sphere() noexcept = default;
+
+		constexpr Sphere(const Vec3& Center, const float Radius) noexcept :
+			center(Center), radius(Radius)
+		{
+		}
+
+		/**
+		 * @brief Sphere enclosing the box. Not minimal, but cheap to compute.
+		 */
+		[[nodiscard]] static Sphere fromAabb(const Aabb& box) noexcept
+		{
+			return {box.center(), box.extents().length()};
+		}
+
+		[[nodiscard]] constexpr bool contains(const Vec3& p) const noexcept
+		{
+			const Vec3 d = p - center;
+			return d.dot(d) <= radius * radius;
+		}
+
+		[[nodiscard]] constexpr bool intersects(const Sphere& o) const noexcept
+		{
+			const Vec3 d = o.center - center;
+			const float r = radius + o.radius;
+			return d.dot(d) <= r * r;
+		}
+	};
+
+
+	/**
+	 * @brief Boxes stored as separate center/extent streams, so they can be culled several at a
+	 * time with SIMD.
+	 */
+	class AabbArray
+	{
+		std::vector<float> m_centerX, m_centerY, m_centerZ;
+		std::vector<float> m_extentX, m_extentY, m_extentZ;
+
+	public:
+		/**
+		 * @return Index of the added box.
+		 */
+		size_t add(const Aabb& box)
+		{
+			const Vec3 c = box.center();
+			const Vec3 e = box.extents();
+			m_centerX.push_back(c.x);
+			m_centerY.push_back(c.y);
+			m_centerZ.push_back(c.z);
+			m_extentX.push_back(e.x);
+			m_extentY.push_back(e.y);
+			m_extentZ.push_back(e.z);
+			return m_centerX.size() - 1;
+		}
+
+		void set(const size_t index, const Aabb& box) noexcept
+		{
+			const Vec3 c = box.center();
+			const Vec3 e = box.extents();
+			m_centerX[index] = c.x;
+			m_centerY[index] = c.y;
+			m_centerZ[index] = c.z;
+			m_extentX[index] = e.x;
+			m_extentY[index] = e.y;
+			m_extentZ[index] = e.z;
+		}
+
+		[[nodiscard]] Aabb get(const size_t index) const noexcept
+		{
+			return Aabb::fromCenterExtents({m_centerX[index], m_centerY[index], m_centerZ[index]},
+										   {m_extentX[index], m_extentY[index], m_extentZ[index]});
+		}
+
+		void reserve(const size_t count)
+		{
+			for (auto* stream : {&m_centerX, &m_centerY, &m_centerZ, &m_extentX, &m_extentY,
+								 &m_extentZ})
+				stream->reserve(count);
+		}
+
+		void clear() noexcept
+		{
+			for (auto* stream : {&m_centerX, &m_centerY, &m_centerZ, &m_extentX, &m_extentY,
+								 &m_extentZ})
+				stream->clear();
+		}
+
+		[[nodiscard]] size_t size() const noexcept
+		{
+			return m_centerX.size();
+		}
+
+		[[nodiscard]] const float* centerX() const noexcept
+		{
+			return m_centerX.data();
+		}
+
+		[[nodiscard]] const float* centerY() const noexcept
+		{
+			return m_centerY.data();
+		}
+
+		[[nodiscard]] const float* centerZ() const noexcept
+		{
+			return m_centerZ.data();
+		}
+
+		[[nodiscard]] const float* extentX() const noexcept
+		{
+			return m_extentX.data();
+		}
+
+		[[nodiscard]] const float* extentY() const noexcept
+		{
+			return m_extentY.data();
+		}
+
+		[[nodiscard]] const float* extentZ() const noexcept
+		{
+			return m_extentZ.data();
+		}
+	};
+
+
+	enum CullResult
+	{
+		CULL_OUTSIDE,
+		CULL_INTERSECTING,
+		CULL_INSIDE,
+	};
+
+
+	/**
+	 * @brief View frustum as six inward facing planes (`xyz` normal, `w` distance).
+	 */
+	struct Frustum
+	{
+		enum PlaneIndex
+		{
+			PLANE_LEFT,
+			PLANE_RIGHT,
+			PLANE_BOTTOM,
+			PLANE_TOP,
+			PLANE_NEAR,
+			PLANE_FAR,
+			PLANE_COUNT,
+		};
+
+		Vec4 planes[PLANE_COUNT]{};
+
+		/**
+		 * @brief Extracts the planes of a combined view-projection matrix (Gribb-Hartmann).
+		 *
+		 * @param viewProjection Matrix mapping world space to clip space, with clip space depth
+		 * in [-1, 1] as produced by `Mat4::perspective` and `Mat4::orthographic`.
+		 */
+		[[nodiscard]] static Frustum fromMatrix(const Mat4& viewProjection) noexcept;
+
+		/**
+		 * @brief Builds the frustum of a camera from the matrices created by
+		 * `Mat4::perspective` and `Mat4::lookAt`.
+		 */
+		[[nodiscard]] static Frustum fromCamera(const Mat4& projection, const Mat4& view) noexcept
+		{
+			// Mat4 stores columns first, so this is projection * view in math notation
+			return fromMatrix(view * projection);
+		}
+
+		[[nodiscard]] bool contains(const Vec3& point) const noexcept;
+		[[nodiscard]] bool intersects(const Sphere& sphere) const noexcept;
+		[[nodiscard]] bool intersects(const Aabb& box) const noexcept;
+
+		/**
+		 * @brief Classifies a box as fully outside, partially inside or fully inside. Slightly
+		 * more expensive than `intersects`, useful for hierarchical culling where fully inside
+		 * nodes need no further tests.
+		 */
+		[[nodiscard]] CullResult classify(const Aabb& box) const noexcept;
+
+		/**
+		 * @brief Tests every box of the array against the frustum, 8 boxes per iteration on
+		 * AVX and NEON.
+		 *
+		 * @param boxes Boxes to cull.
+		 * @param visible Indices of the visible boxes are appended to this vector.
+		 *
+		 * @return The number of visible boxes.
+		 */
+		size_t cull(const AabbArray& boxes, std::vector<uint32_t>& visible) const;
+	};
+} // namespace lune
@@ -0,0 +1,28 @@
+module;
+#include <cstdint>
+module lune.memory;
+
+namespace lune
+{
+	namespace
+	{
+		struct ThreadFrameArena
+		{
+			MemoryArena arena{MEMORY_TAG_FRAME, FrameArena::BLOCK_SIZE};
+			uint64_t frame{};
+		};
+
+		thread_local ThreadFrameArena threadArena;
+	} // namespace
+
+	MemoryArena& FrameArena::get()
+	{
+		if (const uint64_t frame{frameIndex()}; threadArena.frame != frame)
+		{
+			threadArena.arena.reset();
+			threadArena.frame = frame;
+		}
+
+		return threadArena.arena;
+	}
+} // namespace lune
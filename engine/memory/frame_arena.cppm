@@ -0,0 +1,79 @@
+module;
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+export module lune.memory:frame_arena;
+
+import :arena;
+
+namespace lune
+{
+	/**
+	 * @brief Thread-local bump allocator for data that only lives until the end of the frame.
+	 *
+	 * Each thread allocates from its own `MemoryArena`, so allocation is a pointer bump without
+	 * locks. `Window::pollEvents` starts a new frame, and each thread's arena is rewound the next
+	 * time that thread uses it. Once the arenas have grown to a frame's peak usage, per-frame
+	 * allocation never reaches `malloc`.
+	 *
+	 * Memory from the arena is invalidated by the next frame; never keep it, or a container
+	 * using it, across `Window::pollEvents`.
+	 *
+	 * @code
+	 * FrameVector<DrawCommand> commands{FrameArena::resource()};
+	 * commands.reserve(objectCount);
+	 * @endcode
+	 */
+	export class FrameArena
+	{
+		static inline std::atomic<uint64_t> m_frame{};
+
+	public:
+		/// Initial block size of each thread's arena.
+		static constexpr size_t BLOCK_SIZE{256 * 1024};
+
+		/**
+		 * @brief Gets the calling thread's arena, rewound if a new frame has started since the
+		 * thread last used it.
+		 */
+		static MemoryArena& get();
+
+		/**
+		 * @brief Gets the calling thread's arena as a memory resource for `std::pmr` containers.
+		 */
+		static std::pmr::memory_resource* resource()
+		{
+			return &get();
+		}
+
+		/**
+		 * @brief Allocates uninitialized storage for `count` objects of type T.
+		 */
+		template <typename T> [[nodiscard]] static T* allocate(const size_t count)
+		{
+			return get().allocateArray<T>(count);
+		}
+
+		/**
+		 * @brief Starts a new frame, invalidating every frame allocation of every thread. Called by
+		 * `Window::pollEvents`.
+		 */
+		static void nextFrame() noexcept
+		{
+			m_frame.fetch_add(1, std::memory_order_release);
+		}
+
+		[[nodiscard]] static uint64_t frameIndex() noexcept
+		{
+			return m_frame.load(std::memory_order_acquire);
+		}
+	};
+
+
+	/**
+	 * @brief Vector for per-frame data, constructed with `FrameArena::resource()`.
+	 */
+	export template <typename T> using FrameVector = std::pmr::vector<T>;
+} // namespace lune
@@ -0,0 +1,5 @@
+export module lune.memory;
+
+export import :tracker;
+export import :arena;
+export import :frame_arena;
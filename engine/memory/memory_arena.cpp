@@ -0,0 +1,129 @@
+module;
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <vector>
+module lune.memory;
+
+namespace lune
+{
+	void* TaggedMemoryResource::do_allocate(const size_t bytes, const size_t alignment)
+	{
+		void* data{m_upstream->allocate(bytes, alignment)};
+		MemoryTracker::recordAllocation(m_tag, bytes);
+		return data;
+	}
+
+	void TaggedMemoryResource::do_deallocate(void* data, const size_t bytes,
+											 const size_t alignment)
+	{
+		MemoryTracker::recordFree(m_tag, bytes);
+		m_upstream->deallocate(data, bytes, alignment);
+	}
+
+	bool TaggedMemoryResource::do_is_equal(const memory_resource& other) const noexcept
+	{
+		const auto* tagged{dynamic_cast<const TaggedMemoryResource*>(&other)};
+		return tagged && tagged->m_tag == m_tag && m_upstream->is_equal(*tagged->m_upstream);
+	}
+
+
+	MemoryArena::MemoryArena(const MemoryTag tag, const size_t blockSize) :
+		m_blockSize(std::max<size_t>(blockSize, BLOCK_ALIGNMENT)), m_tag(tag)
+	{
+	}
+
+	MemoryArena::~MemoryArena()
+	{
+		release();
+	}
+
+	void MemoryArena::reset()
+	{
+		// Fold an overflowing cycle into one block to avoid chasing blocks every cycle
+		if (m_blocks.size() > 1)
+		{
+			const size_t total{capacity()};
+			release();
+			addBlock(total);
+		}
+
+		m_block = 0;
+		m_offset = 0;
+		m_used = 0;
+	}
+
+	void MemoryArena::release() noexcept
+	{
+		for (const Block& block : m_blocks)
+		{
+			MemoryTracker::recordFree(m_tag, block.size);
+			::operator delete(block.data, std::align_val_t{BLOCK_ALIGNMENT});
+		}
+
+		m_blocks.clear();
+		m_block = 0;
+		m_offset = 0;
+		m_used = 0;
+	}
+
+	size_t MemoryArena::capacity() const noexcept
+	{
+		size_t total{};
+		for (const Block& block : m_blocks)
+			total += block.size;
+
+		return total;
+	}
+
+	void* MemoryArena::do_allocate(const size_t bytes, const size_t alignment)
+	{
+		while (m_block < m_blocks.size())
+		{
+			const Block& block = m_blocks[m_block];
+			const auto address{reinterpret_cast<uintptr_t>(block.data) + m_offset};
+			const size_t padding{(alignment - address % alignment) % alignment};
+
+			if (m_offset + padding + bytes <= block.size)
+			{
+				m_offset += padding + bytes;
+				m_used += padding + bytes;
+				return reinterpret_cast<void*>(address + padding);
+			}
+
+			// Blocks left over from before a reset are reused before growing
+			++m_block;
+			m_offset = 0;
+		}
+
+		addBlock(bytes + alignment);
+		m_block = m_blocks.size() - 1;
+		m_offset = 0;
+		return do_allocate(bytes, alignment);
+	}
+
+	void MemoryArena::do_deallocate(void* data, const size_t bytes, size_t)
+	{
+		if (m_block >= m_blocks.size())
+			return;
+
+		// Only the last allocation can be given back without tracking anything else
+		const std::byte* top{m_blocks[m_block].data + m_offset};
+		if (static_cast<std::byte*>(data) + bytes == top)
+		{
+			m_offset -= bytes;
+			m_used -= bytes;
+		}
+	}
+
+	void MemoryArena::addBlock(const size_t minimumSize)
+	{
+		const size_t size{std::max(m_blockSize, minimumSize)};
+		auto* data{static_cast<std::byte*>(::operator new(size, std::align_val_t{BLOCK_ALIGNMENT}))};
+
+		m_blocks.push_back({data, size});
+		MemoryTracker::recordAllocation(m_tag, size);
+	}
+} // namespace lune
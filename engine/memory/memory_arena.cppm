@@ -0,0 +1,133 @@
+module;
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+export module lune.memory:arena;
+
+import :tracker;
+
+namespace lune
+{
+	/**
+	 * @brief Memory resource that accounts the allocations of an upstream resource to a tag, so
+	 * any `std::pmr` container can be attributed to a subsystem.
+	 */
+	export class TaggedMemoryResource final : public std::pmr::memory_resource
+	{
+		std::pmr::memory_resource* m_upstream;
+		MemoryTag m_tag;
+
+	public:
+		explicit TaggedMemoryResource(
+				const MemoryTag tag,
+				std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) noexcept :
+			m_upstream(upstream), m_tag(tag)
+		{
+		}
+
+		[[nodiscard]] MemoryTag tag() const noexcept
+		{
+			return m_tag;
+		}
+
+	private:
+		void* do_allocate(size_t bytes, size_t alignment) override;
+		void do_deallocate(void* data, size_t bytes, size_t alignment) override;
+		[[nodiscard]] bool do_is_equal(const memory_resource& other) const noexcept override;
+	};
+
+
+	/**
+	 * @brief Tagged bump allocator for data that is freed all at once.
+	 *
+	 * Allocations are carved linearly out of large blocks. Freeing the most recent allocation
+	 * gives its memory back, so scoped temporaries unwind like a stack; other deallocations are
+	 * no-ops. `reset` rewinds the arena in O(1) while keeping its memory for reuse. Blocks are
+	 * accounted to the arena's tag. Not thread-safe; give each thread its own arena.
+	 *
+	 * As a `std::pmr::memory_resource` it backs standard containers directly:
+	 *
+	 * @code
+	 * MemoryArena arena{MEMORY_TAG_SCENE};
+	 * std::pmr::vector<uint32_t> visible{&arena};
+	 * @endcode
+	 */
+	export class MemoryArena : public std::pmr::memory_resource
+	{
+		struct Block
+		{
+			std::byte* data{};
+			size_t size{};
+		};
+
+		std::vector<Block> m_blocks;
+		size_t m_block{};  ///< Block currently allocated from.
+		size_t m_offset{}; ///< Offset of the next allocation in the current block.
+		size_t m_used{};   ///< Bytes handed out since the last reset, including padding.
+		size_t m_blockSize;
+		MemoryTag m_tag;
+
+	public:
+		static constexpr size_t DEFAULT_BLOCK_SIZE{64 * 1024};
+		static constexpr size_t BLOCK_ALIGNMENT{64};
+
+		/**
+		 * @param tag Tag the arena's blocks are accounted to.
+		 * @param blockSize Minimum size of each block; larger allocations get a block of their own.
+		 */
+		explicit MemoryArena(MemoryTag tag, size_t blockSize = DEFAULT_BLOCK_SIZE);
+		~MemoryArena() override;
+
+		MemoryArena(const MemoryArena&) = delete;
+		MemoryArena& operator=(const MemoryArena&) = delete;
+
+		/**
+		 * @brief Allocates uninitialized storage for `count` objects of type T.
+		 */
+		template <typename T> [[nodiscard]] T* allocateArray(const size_t count)
+		{
+			return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+		}
+
+		/**
+		 * @brief Frees every allocation at once, keeping the memory. If the arena grew past one
+		 * block, the blocks are merged so the next cycle fits in a single block.
+		 */
+		void reset();
+
+		/**
+		 * @brief Frees every allocation and returns all memory.
+		 */
+		void release() noexcept;
+
+		/**
+		 * @brief Gets the bytes allocated since the last reset.
+		 */
+		[[nodiscard]] size_t used() const noexcept
+		{
+			return m_used;
+		}
+
+		/**
+		 * @brief Gets the bytes of all blocks owned by the arena.
+		 */
+		[[nodiscard]] size_t capacity() const noexcept;
+
+		[[nodiscard]] MemoryTag tag() const noexcept
+		{
+			return m_tag;
+		}
+
+	private:
+		void* do_allocate(size_t bytes, size_t alignment) override;
+
+		void do_deallocate(void* data, size_t bytes, size_t alignment) override;
+
+		[[nodiscard]] bool do_is_equal(const memory_resource& other) const noexcept override
+		{
+			return this == &other;
+		}
+
+		void addBlock(size_t minimumSize);
+	};
+} // namespace lune
@@ -0,0 +1,128 @@
+module;
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <ostream>
+module lune.memory;
+
+namespace lune
+{
+	namespace
+	{
+		constexpr const char* TAG_NAMES[MEMORY_TAG_COUNT]{
+				"General", "GPU buffers", "GPU textures", "Assets", "Scene",
+				"Input",   "Jobs",		  "Profiler",	  "Frame",
+		};
+
+		/// Prints the report during static destruction if enabled.
+		struct ExitReporter
+		{
+			std::atomic<bool> enabled{std::getenv("LUNE_MEMORY_REPORT") != nullptr};
+
+			~ExitReporter()
+			{
+				if (enabled.load(std::memory_order_relaxed))
+					MemoryTracker::report(std::clog);
+			}
+		};
+
+		ExitReporter exitReporter;
+
+		double toMegabytes(const size_t bytes)
+		{
+			return static_cast<double>(bytes) / (1024.0 * 1024.0);
+		}
+	} // namespace
+
+	void MemoryTracker::recordAllocation(const MemoryTag tag, const size_t bytes) noexcept
+	{
+		add(m_counters[tag], bytes);
+		add(m_counters[MEMORY_TAG_COUNT], bytes);
+	}
+
+	void MemoryTracker::recordFree(const MemoryTag tag, const size_t bytes) noexcept
+	{
+		subtract(m_counters[tag], bytes);
+		subtract(m_counters[MEMORY_TAG_COUNT], bytes);
+	}
+
+	MemoryStats MemoryTracker::getStats(const MemoryTag tag) noexcept
+	{
+		return load(m_counters[tag]);
+	}
+
+	MemoryStats MemoryTracker::getTotal() noexcept
+	{
+		return load(m_counters[MEMORY_TAG_COUNT]);
+	}
+
+	const char* MemoryTracker::getTagName(const MemoryTag tag) noexcept
+	{
+		return tag >= 0 && tag < MEMORY_TAG_COUNT ? TAG_NAMES[tag] : "Unknown";
+	}
+
+	void MemoryTracker::report(std::ostream& stream)
+	{
+		const auto flags{stream.flags()};
+		const auto precision{stream.precision()};
+
+		stream << std::fixed << std::setprecision(2) << std::left << std::setw(14) << "Memory"
+			   << std::right << std::setw(12) << "Live MiB" << std::setw(12) << "Peak MiB"
+			   << std::setw(10) << "Live" << std::setw(12) << "Total" << '\n';
+
+		const auto writeRow = [&stream](const char* name, const MemoryStats& stats)
+		{
+			stream << std::left << std::setw(14) << name << std::right << std::setw(12)
+				   << toMegabytes(stats.liveBytes) << std::setw(12) << toMegabytes(stats.peakBytes)
+				   << std::setw(10) << stats.liveAllocations << std::setw(12)
+				   << stats.totalAllocations << '\n';
+		};
+
+		for (int tag = 0; tag < MEMORY_TAG_COUNT; ++tag)
+		{
+			const MemoryStats stats{getStats(static_cast<MemoryTag>(tag))};
+			if (stats.totalAllocations > 0)
+				writeRow(TAG_NAMES[tag], stats);
+		}
+		writeRow("Total", getTotal());
+
+		stream.flags(flags);
+		stream.precision(precision);
+	}
+
+	void MemoryTracker::setReportOnExit(const bool enabled) noexcept
+	{
+		exitReporter.enabled.store(enabled, std::memory_order_relaxed);
+	}
+
+	void MemoryTracker::add(Counters& counters, const size_t bytes) noexcept
+	{
+		const size_t live{counters.liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes};
+		counters.liveAllocations.fetch_add(1, std::memory_order_relaxed);
+		counters.totalAllocations.fetch_add(1, std::memory_order_relaxed);
+
+		size_t peak{counters.peakBytes.load(std::memory_order_relaxed)};
+		while (live > peak &&
+			   !counters.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	void MemoryTracker::subtract(Counters& counters, const size_t bytes) noexcept
+	{
+		counters.liveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+		counters.liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	MemoryStats MemoryTracker::load(const Counters& counters) noexcept
+	{
+		return {
+				.liveBytes = counters.liveBytes.load(std::memory_order_relaxed),
+				.peakBytes = counters.peakBytes.load(std::memory_order_relaxed),
+				.liveAllocations = counters.liveAllocations.load(std::memory_order_relaxed),
+				.totalAllocations = counters.totalAllocations.load(std::memory_order_relaxed),
+		};
+	}
+} // namespace lune
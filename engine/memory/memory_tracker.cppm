@@ -0,0 +1,200 @@
+module;
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <utility>
+export module lune.memory:tracker;
+
+namespace lune
+{
+	/**
+	 * @brief Subsystem an allocation is accounted to.
+	 */
+	export enum MemoryTag : int
+	{
+		MEMORY_TAG_GENERAL,
+		MEMORY_TAG_GPU_BUFFER,
+		MEMORY_TAG_GPU_TEXTURE,
+		MEMORY_TAG_ASSETS,
+		MEMORY_TAG_SCENE,
+		MEMORY_TAG_INPUT,
+		MEMORY_TAG_JOBS,
+		MEMORY_TAG_PROFILER,
+		MEMORY_TAG_FRAME, ///< Per-frame transient allocations.
+		MEMORY_TAG_COUNT,
+	};
+
+
+	/**
+	 * @brief Allocation counters of one tag.
+	 */
+	export struct MemoryStats
+	{
+		size_t liveBytes{};
+		size_t peakBytes{};
+		size_t liveAllocations{};
+		size_t totalAllocations{}; ///< Allocations made since startup, including freed ones.
+	};
+
+
+	/**
+	 * @brief Accounts allocations to subsystems.
+	 *
+	 * Nothing is intercepted globally: allocations are reported by the allocators built on top
+	 * of the tracker (`TaggedAllocator`, `TaggedMemoryResource`, `MemoryArena`) and by the
+	 * graphics backends for GPU resources. Counters are lock-free, so reporting is safe from any
+	 * thread.
+	 *
+	 * Setting `LUNE_MEMORY_REPORT` in the environment prints a report when the program exits.
+	 */
+	export class MemoryTracker
+	{
+		struct alignas(64) Counters
+		{
+			std::atomic<size_t> liveBytes;
+			std::atomic<size_t> peakBytes;
+			std::atomic<size_t> liveAllocations;
+			std::atomic<size_t> totalAllocations;
+		};
+
+		/// One entry per tag plus the total of all tags.
+		static inline std::array<Counters, MEMORY_TAG_COUNT + 1> m_counters{};
+
+	public:
+		/**
+		 * @brief Accounts an allocation.
+		 */
+		static void recordAllocation(MemoryTag tag, size_t bytes) noexcept;
+
+		/**
+		 * @brief Accounts the release of an allocation previously passed to `recordAllocation`.
+		 */
+		static void recordFree(MemoryTag tag, size_t bytes) noexcept;
+
+		[[nodiscard]] static MemoryStats getStats(MemoryTag tag) noexcept;
+
+		/**
+		 * @brief Gets the counters of all tags combined. The peak is the peak of the sum, not the
+		 * sum of the peaks.
+		 */
+		[[nodiscard]] static MemoryStats getTotal() noexcept;
+
+		[[nodiscard]] static const char* getTagName(MemoryTag tag) noexcept;
+
+		/**
+		 * @brief Writes a table of all tags with allocations.
+		 */
+		static void report(std::ostream& stream);
+
+		/**
+		 * @brief Enables or disables printing the report to `std::clog` at exit.
+		 */
+		static void setReportOnExit(bool enabled) noexcept;
+
+	private:
+		static void add(Counters& counters, size_t bytes) noexcept;
+		static void subtract(Counters& counters, size_t bytes) noexcept;
+		static MemoryStats load(const Counters& counters) noexcept;
+	};
+
+
+	/**
+	 * @brief Owns the accounting of one allocation made elsewhere, e.g. a GPU resource; reported
+	 * on construction and released on destruction.
+	 */
+	export class TrackedAllocation
+	{
+		MemoryTag m_tag{MEMORY_TAG_GENERAL};
+		size_t m_bytes{};
+
+	public:
+		TrackedAllocation() = default;
+
+		TrackedAllocation(const MemoryTag tag, const size_t bytes) noexcept :
+			m_tag(tag), m_bytes(bytes)
+		{
+			MemoryTracker::recordAllocation(m_tag, m_bytes);
+		}
+
+		~TrackedAllocation()
+		{
+			reset();
+		}
+
+		TrackedAllocation(const TrackedAllocation&) = delete;
+		TrackedAllocation& operator=(const TrackedAllocation&) = delete;
+
+		TrackedAllocation(TrackedAllocation&& other) noexcept :
+			m_tag(other.m_tag), m_bytes(std::exchange(other.m_bytes, 0))
+		{
+		}
+
+		TrackedAllocation& operator=(TrackedAllocation&& other) noexcept
+		{
+			if (this != &other)
+			{
+				reset();
+				m_tag = other.m_tag;
+				m_bytes = std::exchange(other.m_bytes, 0);
+			}
+			return *this;
+		}
+
+		void reset() noexcept
+		{
+			if (m_bytes > 0)
+				MemoryTracker::recordFree(m_tag, std::exchange(m_bytes, 0));
+		}
+
+		[[nodiscard]] size_t bytes() const noexcept
+		{
+			return m_bytes;
+		}
+	};
+
+
+	/**
+	 * @brief Standard allocator that accounts its allocations to a tag, for containers owned by a
+	 * subsystem.
+	 *
+	 * @code
+	 * std::vector<Node, TaggedAllocator<Node, MEMORY_TAG_SCENE>> nodes;
+	 * @endcode
+	 */
+	export template <typename T, MemoryTag Tag> class TaggedAllocator
+	{
+	public:
+		using value_type = T;
+
+		template <typename U> struct rebind
+		{
+			using other = TaggedAllocator<U, Tag>;
+		};
+
+		TaggedAllocator() noexcept = default;
+
+		template <typename U> TaggedAllocator(const TaggedAllocator<U, Tag>&) noexcept
+		{
+		}
+
+		[[nodiscard]] T* allocate(const size_t count)
+		{
+			T* data{std::allocator<T>{}.allocate(count)};
+			MemoryTracker::recordAllocation(Tag, count * sizeof(T));
+			return data;
+		}
+
+		void deallocate(T* data, const size_t count) noexcept
+		{
+			MemoryTracker::recordFree(Tag, count * sizeof(T));
+			std::allocator<T>{}.deallocate(data, count);
+		}
+
+		template <typename U> bool operator==(const TaggedAllocator<U, Tag>&) const noexcept
+		{
+			return true;
+		}
+	};
+} // namespace lune
@@ -0,0 +1,281 @@
+module;
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+module lune;
+
+namespace lune
+{
+	ActionId ActionMap::addAction(const std::string& name)
+	{
+		m_actionNames.push_back(name);
+		m_actionStates.emplace_back();
+		return static_cast<ActionId>(m_actionNames.size() - 1);
+	}
+
+	std::optional<ActionId> ActionMap::findAction(const std::string& name) const
+	{
+		const auto it{std::ranges::find(m_actionNames, name)};
+		if (it == m_actionNames.end())
+		{
+			return std::nullopt;
+		}
+
+		return static_cast<ActionId>(it - m_actionNames.begin());
+	}
+
+	void ActionMap::bind(const ActionId action, const std::initializer_list<Key> keys,
+						 const ActionBindingType type, const double maxInterval)
+	{
+		bind(action, std::span{keys.begin(), keys.size()}, type, maxInterval);
+	}
+
+	void ActionMap::bind(const ActionId action, const std::span<const Key> keys,
+						 const ActionBindingType type, const double maxInterval)
+	{
+		if (keys.empty())
+		{
+			return;
+		}
+
+		const size_t firstKey{m_bindingKeys.size()};
+		for (const Key key : keys)
+		{
+			// A sequence may repeat a key, e.g. a double tap, but a key is only held once
+			const auto chordKeys{m_bindingKeys.begin() + static_cast<std::ptrdiff_t>(firstKey)};
+			if (type == ACTION_SEQUENCE ||
+				std::find(chordKeys, m_bindingKeys.end(), key) == m_bindingKeys.end())
+			{
+				m_bindingKeys.push_back(key);
+			}
+		}
+
+		m_bindings.push_back({
+				.type = type,
+				.action = action,
+				.firstKey = static_cast<uint32_t>(firstKey),
+				.keyCount = static_cast<uint32_t>(m_bindingKeys.size() - firstKey),
+				.maxInterval = maxInterval,
+		});
+		m_compiled = false;
+	}
+
+	void ActionMap::compile()
+	{
+		// Each binding is listed once per distinct key, at the first position of that key
+		std::vector<KeyEntry> entries;
+		std::vector<Key> entryKeys;
+		for (uint32_t b = 0; b < m_bindings.size(); ++b)
+		{
+			const Binding& binding = m_bindings[b];
+			const auto first{m_bindingKeys.begin() + binding.firstKey};
+			for (uint32_t i = 0; i < binding.keyCount; ++i)
+			{
+				const Key key{first[i]};
+				if (std::find(first, first + i, key) != first + i)
+				{
+					continue;
+				}
+
+				entries.push_back({b, i});
+				entryKeys.push_back(key);
+			}
+		}
+
+		// Counting sort into per-key ranges
+		m_keyOffsets.assign(KEY_COUNT + 1, 0);
+		for (const Key key : entryKeys)
+		{
+			++m_keyOffsets[key + 1];
+		}
+		for (size_t k = 0; k < KEY_COUNT; ++k)
+		{
+			m_keyOffsets[k + 1] += m_keyOffsets[k];
+		}
+
+		m_keyEntries.resize(entries.size());
+		std::vector<uint32_t> cursor{m_keyOffsets.begin(), m_keyOffsets.end() - 1};
+		for (size_t i = 0; i < entries.size(); ++i)
+		{
+			m_keyEntries[cursor[entryKeys[i]]++] = entries[i];
+		}
+
+		m_bindingStates.assign(m_bindings.size(), {});
+		m_actionStates.assign(m_actionNames.size(), {});
+		m_changedActions.clear();
+		m_heldKeys.reset();
+		m_compiled = true;
+	}
+
+	void ActionMap::update()
+	{
+		update(InputManager::getFrameEvents());
+	}
+
+	void ActionMap::update(const std::span<const InputEvent> events)
+	{
+		for (const ActionId action : m_changedActions)
+		{
+			m_actionStates[action].justPressed = false;
+			m_actionStates[action].justReleased = false;
+		}
+		m_changedActions.clear();
+
+		if (!m_compiled)
+		{
+			compile();
+		}
+
+		for (const InputEvent& event : events)
+		{
+			if (event.getType() != INPUT_EVENT_KEY)
+			{
+				continue;
+			}
+
+			if (event.isJustPressed())
+			{
+				onKeyPressed(event.getKey(), event.getTimestamp());
+			}
+			else if (event.isJustReleased())
+			{
+				onKeyReleased(event.getKey());
+			}
+		}
+	}
+
+	void ActionMap::onKeyPressed(const Key key, const double timestamp)
+	{
+		if (m_heldKeys[key])
+		{
+			return;
+		}
+		m_heldKeys.set(key);
+
+		for (uint32_t e = m_keyOffsets[key]; e < m_keyOffsets[key + 1]; ++e)
+		{
+			const KeyEntry& entry = m_keyEntries[e];
+			const Binding& binding = m_bindings[entry.binding];
+			BindingState& state = m_bindingStates[entry.binding];
+
+			switch (binding.type)
+			{
+				case ACTION_CHORD:
+					if (++state.held == binding.keyCount)
+					{
+						activate(entry.binding);
+					}
+					break;
+
+				case ACTION_ORDERED_CHORD:
+					++state.held;
+					if (!state.broken && entry.position == state.progress)
+					{
+						if (++state.progress == binding.keyCount)
+						{
+							activate(entry.binding);
+						}
+					}
+					else
+					{
+						state.broken = true;
+					}
+					break;
+
+				case ACTION_SEQUENCE:
+				{
+					const Key* keys{m_bindingKeys.data() + binding.firstKey};
+					const bool inTime{state.progress == 0 ||
+									  timestamp - state.lastPress <= binding.maxInterval};
+
+					if (keys[state.progress] == key && inTime)
+					{
+						++state.progress;
+					}
+					else
+					{
+						// A wrong or late key may still start a new attempt
+						state.progress = keys[0] == key ? 1 : 0;
+					}
+					state.lastPress = timestamp;
+
+					if (state.progress == binding.keyCount)
+					{
+						state.progress = 0;
+						m_actionStates[binding.action].justPressed = true;
+						markChanged(binding.action);
+					}
+					break;
+				}
+			}
+		}
+	}
+
+	void ActionMap::onKeyReleased(const Key key)
+	{
+		if (!m_heldKeys[key])
+		{
+			return;
+		}
+		m_heldKeys.reset(key);
+
+		for (uint32_t e = m_keyOffsets[key]; e < m_keyOffsets[key + 1]; ++e)
+		{
+			const KeyEntry& entry = m_keyEntries[e];
+			const Binding& binding = m_bindings[entry.binding];
+			BindingState& state = m_bindingStates[entry.binding];
+
+			if (binding.type == ACTION_SEQUENCE)
+			{
+				continue;
+			}
+
+			--state.held;
+			if (state.active)
+			{
+				deactivate(entry.binding);
+			}
+
+			// Releasing part of an ordered chord requires releasing all of it to start over
+			if (binding.type == ACTION_ORDERED_CHORD)
+			{
+				state.broken = state.held > 0;
+				state.progress = 0;
+			}
+		}
+	}
+
+	void ActionMap::activate(const uint32_t binding)
+	{
+		m_bindingStates[binding].active = true;
+
+		const ActionId action{m_bindings[binding].action};
+		if (m_actionStates[action].activeBindings++ == 0)
+		{
+			m_actionStates[action].justPressed = true;
+			markChanged(action);
+		}
+	}
+
+	void ActionMap::deactivate(const uint32_t binding)
+	{
+		m_bindingStates[binding].active = false;
+
+		const ActionId action{m_bindings[binding].action};
+		if (--m_actionStates[action].activeBindings == 0)
+		{
+			m_actionStates[action].justReleased = true;
+			markChanged(action);
+		}
+	}
+
+	void ActionMap::markChanged(const ActionId action)
+	{
+		m_changedActions.push_back(action);
+	}
+} // namespace lune
@@ -0,0 +1,196 @@
+module;
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+export module lune:action_map;
+
+import :input_event;
+import :input_map;
+
+namespace lune
+{
+	export using ActionId = uint32_t;
+
+
+	/**
+	 * @brief How the keys of a binding have to be pressed to activate its action.
+	 */
+	export enum ActionBindingType : int
+	{
+		ACTION_CHORD,		  ///< All keys held, in any order. A single key is a chord of one.
+		ACTION_ORDERED_CHORD, ///< All keys held, pressed in the listed order.
+		ACTION_SEQUENCE,	  ///< Keys pressed one after another within a time window.
+	};
+
+
+	/**
+	 * @brief Maps named actions to keys, chords and sequences.
+	 *
+	 * Bindings are compiled into per-key dispatch tables, and each event only advances the small
+	 * state machines of the bindings that reference its key. Evaluating the map costs
+	 * O(bindings per key) per event and nothing for frames without input, regardless of how many
+	 * actions are bound; queries are array lookups.
+	 *
+	 * @code
+	 * ActionMap actions;
+	 * const ActionId jump{actions.addAction("jump")};
+	 * actions.bind(jump, {KEY_SPACE});
+	 * actions.bind(jump, {KEY_LEFT_CONTROL, KEY_J}, ACTION_ORDERED_CHORD);
+	 *
+	 * // Every frame, after Window::pollEvents()
+	 * actions.update();
+	 * if (actions.isJustPressed(jump)) { ... }
+	 * @endcode
+	 */
+	export class ActionMap
+	{
+		struct Binding
+		{
+			ActionBindingType type{};
+			ActionId action{};
+			uint32_t firstKey{}; ///< Offset into `m_bindingKeys`.
+			uint32_t keyCount{};
+			double maxInterval{};
+		};
+
+		struct BindingState
+		{
+			uint32_t held{};	 ///< Number of the binding's keys currently held.
+			uint32_t progress{}; ///< Keys matched so far, for ordered chords and sequences.
+			double lastPress{};	 ///< Timestamp of the last matched sequence key.
+			bool broken{};		 ///< Ordered chord pressed out of order; waits for a full release.
+			bool active{};
+		};
+
+		struct ActionState
+		{
+			uint32_t activeBindings{};
+			bool justPressed{};
+			bool justReleased{};
+		};
+
+		/// Entry of the per-key dispatch table.
+		struct KeyEntry
+		{
+			uint32_t binding{};
+			uint32_t position{}; ///< Index of the key within the binding.
+		};
+
+		std::vector<std::string> m_actionNames;
+		std::vector<Binding> m_bindings;
+		std::vector<Key> m_bindingKeys;
+
+		// Compiled state
+		std::vector<uint32_t> m_keyOffsets; ///< `KEY_COUNT + 1` offsets into `m_keyEntries`.
+		std::vector<KeyEntry> m_keyEntries;
+		std::vector<BindingState> m_bindingStates;
+		std::vector<ActionState> m_actionStates;
+		std::vector<ActionId> m_changedActions; ///< Actions with per-frame flags to clear.
+		std::bitset<KEY_COUNT> m_heldKeys;
+		bool m_compiled{};
+
+	public:
+		/**
+		 * @brief Declares an action.
+		 *
+		 * @param name Unique name of the action.
+		 *
+		 * @return The id used to bind and query the action.
+		 */
+		ActionId addAction(const std::string& name);
+
+		/**
+		 * @brief Looks up an action by name.
+		 *
+		 * @return The action id; std::nullopt if no action has this name.
+		 */
+		[[nodiscard]] std::optional<ActionId> findAction(const std::string& name) const;
+
+		/**
+		 * @brief Binds keys to an action. An action may have any number of bindings and is
+		 * pressed while any of them is active. Keys repeated in a chord are only bound once.
+		 *
+		 * @param action Action to bind.
+		 * @param keys Keys of the binding.
+		 * @param type How the keys have to be pressed.
+		 * @param maxInterval Maximum time in seconds between consecutive keys of a sequence.
+		 */
+		void bind(ActionId action, std::initializer_list<Key> keys,
+				  ActionBindingType type = ACTION_CHORD, double maxInterval = 0.3);
+
+		/**
+		 * @brief Binds keys to an action.
+		 *
+		 * @param action Action to bind.
+		 * @param keys Keys of the binding.
+		 * @param type How the keys have to be pressed.
+		 * @param maxInterval Maximum time in seconds between consecutive keys of a sequence.
+		 */
+		void bind(ActionId action, std::span<const Key> keys, ActionBindingType type = ACTION_CHORD,
+				  double maxInterval = 0.3);
+
+		/**
+		 * @brief Builds the dispatch tables and resets all binding state. Called automatically by
+		 * `update` after bindings changed.
+		 */
+		void compile();
+
+		/**
+		 * @brief Advances the bindings with this frame's events from `InputManager`.
+		 */
+		void update();
+
+		/**
+		 * @brief Advances the bindings with the given events, e.g. from a replay.
+		 *
+		 * @param events Events of one frame, in the order they were received.
+		 */
+		void update(std::span<const InputEvent> events);
+
+		/**
+		 * @return true while any binding of the action is active.
+		 */
+		[[nodiscard]] bool isPressed(const ActionId action) const noexcept
+		{
+			return m_actionStates[action].activeBindings > 0;
+		}
+
+		/**
+		 * @return true if the action became active, or a sequence completed, in the last update.
+		 */
+		[[nodiscard]] bool isJustPressed(const ActionId action) const noexcept
+		{
+			return m_actionStates[action].justPressed;
+		}
+
+		/**
+		 * @return true if the action stopped being active in the last update.
+		 */
+		[[nodiscard]] bool isJustReleased(const ActionId action) const noexcept
+		{
+			return m_actionStates[action].justReleased;
+		}
+
+		[[nodiscard]] const std::string& getName(const ActionId action) const noexcept
+		{
+			return m_actionNames[action];
+		}
+
+		[[nodiscard]] size_t actionCount() const noexcept
+		{
+			return m_actionNames.size();
+		}
+
+	private:
+		void onKeyPressed(Key key, double timestamp);
+		void onKeyReleased(Key key);
+		void activate(uint32_t binding);
+		void deactivate(uint32_t binding);
+		void markChanged(ActionId action);
+	};
+} // namespace lune
@@ -1,16 +1,33 @@
+module;
+#include <type_traits>
 export module lune:input_event;
 
 import :input_map;
 
 namespace lune
 {
+	export enum InputEventType : int
+	{
+		INPUT_EVENT_KEY,		///< Key or mouse button transition.
+		INPUT_EVENT_MOUSE_MOVE, ///< Cursor moved to a new position.
+	};
+
+
 	/**
-	 * @brief Stores the state of a give Key.
+	 * @brief Stores the state of a give Key, or a cursor position for mouse movement.
+	 *
+	 * Kept trivially copyable so events can be passed through lock-free queues by value. The
+	 * timestamp is taken when the event is received from the OS, on the `InputManager::getTime()`
+	 * clock.
 	 */
 	export class InputEvent
 	{
+		InputEventType m_type{INPUT_EVENT_KEY};
 		Key m_key{};
 		InputState m_state{RELEASED};
+		double m_x{};
+		double m_y{};
+		double m_timestamp{};
 
 	public:
 		InputEvent() = default;
@@ -19,8 +36,53 @@ namespace lune
 		{
 		}
 
-		explicit InputEvent(const Key key, const InputState state) : m_key(key), m_state(state)
+		explicit InputEvent(const Key key, const InputState state, const double timestamp = 0.0) :
+			m_key(key), m_state(state), m_timestamp(timestamp)
+		{
+		}
+
+		/**
+		 * @brief Creates a cursor movement event.
+		 *
+		 * @param x New cursor X position in screen coordinates.
+		 * @param y New cursor Y position in screen coordinates.
+		 * @param timestamp Time the movement was received.
+		 */
+		[[nodiscard]] static InputEvent mouseMove(const double x, const double y,
+												  const double timestamp)
+		{
+			InputEvent event;
+			event.m_type = INPUT_EVENT_MOUSE_MOVE;
+			event.m_x = x;
+			event.m_y = y;
+			event.m_timestamp = timestamp;
+			return event;
+		}
+
+		[[nodiscard]] InputEventType getType() const
 		{
+			return m_type;
+		}
+
+		[[nodiscard]] double getTimestamp() const
+		{
+			return m_timestamp;
+		}
+
+		/**
+		 * @return The cursor X position of a mouse movement event.
+		 */
+		[[nodiscard]] double getX() const
+		{
+			return m_x;
+		}
+
+		/**
+		 * @return The cursor Y position of a mouse movement event.
+		 */
+		[[nodiscard]] double getY() const
+		{
+			return m_y;
 		}
 
 		bool operator==(const Key key) const
@@ -58,4 +120,6 @@ namespace lune
 			return m_state;
 		}
 	};
+
+	static_assert(std::is_trivially_copyable_v<InputEvent>);
 } // namespace lune
@@ -1,17 +1,22 @@
 module;
 #include <GLFW/glfw3.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <glm/vec2.hpp>
+#include <cstdint>
 #include <initializer_list>
-#include <map>
-#include <memory>
-#include <queue>
+#include <iostream>
+#include <lune/profiler.hpp>
+#include <span>
+#include <string>
 module lune;
 
 namespace lune
 {
-	std::map<Key, std::shared_ptr<InputEvent>> InputManager::getEvents()
+	std::span<const InputState, KEY_COUNT> InputManager::getKeyStates()
 	{
-		return m_events;
+		return m_keyStates;
 	}
 
 	void InputManager::_processInputCallback(GLFWwindow* window, const int key, const int scancode,
@@ -23,21 +28,7 @@ namespace lune
 	void InputManager::_processMouseCallback(GLFWwindow* window, const double xposIn,
 											 const double yposIn)
 	{
-		if (m_firstMouse)
-		{
-			m_prevMouseX = xposIn;
-			m_prevMouseY = yposIn;
-			m_firstMouse = false;
-		}
-
-		const double deltaX{xposIn - m_prevMouseX};
-		const double deltaY{m_prevMouseY - yposIn};
-
-		m_prevMouseX = xposIn;
-		m_prevMouseY = yposIn;
-
-		m_deltaX = deltaX;
-		m_deltaY = deltaY;
+		pushEvent(InputEvent::mouseMove(xposIn, yposIn, getTime()));
 	}
 
 	void InputManager::_processMouseButtonCallback(GLFWwindow* window, const int key,
@@ -48,145 +39,175 @@ namespace lune
 
 	void InputManager::_process()
 	{
-		// Handle all events in the queue by iterating through the queue and popping all events.
-		// After popping an event from the eventQueue, the state of the key in the map is
-		// either:
-		// 1. Updated to reflect it being "PRESSED"
-		// 2. Erased to reflect it being "RELEASED"
-		while (!m_eventQueue.empty())
+		LUNE_ZONE("InputManager::_process");
+
+		// Settle the transitions of the previous frame
+		for (size_t i = 0; i < m_changedKeyCount; ++i)
 		{
-			// Extract event from the eventQueue
-			const std::shared_ptr event{m_eventQueue.front()};
-			m_eventQueue.pop();
+			InputState& state{m_keyStates[m_changedKeys[i]]};
+			state = state == JUST_PRESSED ? PRESSED : RELEASED;
+		}
+		m_changedKeyCount = 0;
 
-			Key key = event->getKey();
-			const InputState state{event->getState()};
+		m_deltaX = 0.0;
+		m_deltaY = 0.0;
 
-			// Update the map depending on the event state
-			if (state == JUST_PRESSED)
-			{
-				m_events[key]->setState(PRESSED);
-			}
-			else if (state == JUST_RELEASED)
+		m_frameEventCount = 0;
+		if (m_replayer)
+		{
+			replayFrame();
+		}
+		else
+		{
+			// Bounded so a producer on another thread can't keep this loop running
+			while (m_frameEventCount < m_frameEvents.size() &&
+				   m_eventQueue.tryPop(m_frameEvents[m_frameEventCount]))
 			{
-				m_events.erase(key); // Key is released, remove from active map
+				applyEvent(m_frameEvents[m_frameEventCount++]);
 			}
 		}
 
-		clearRecentQueue();
+		if (const size_t dropped{m_droppedEvents.exchange(0, std::memory_order_relaxed)})
+		{
+			std::cerr << "Input event queue is full, dropped " << dropped << " events\n";
+		}
+
+		if (m_recorder)
+		{
+			m_recorder->write(m_frameIndex - m_recordStartFrame, getFrameEvents());
+		}
+
+		++m_frameIndex;
 	}
 
-	bool InputManager::isPressed(const Key key)
+	bool InputManager::startRecording(const std::string& path)
 	{
-		if (!m_events.contains(key))
+		stopRecording();
+
+		m_recorder = InputRecorder::create(path);
+		if (!m_recorder)
 		{
 			return false;
 		}
 
-		return m_events[key]->isPressed();
+		reset();
+		m_recordStartFrame = m_frameIndex;
+		return true;
 	}
 
-	bool InputManager::isJustPressed(const Key key)
+	void InputManager::stopRecording()
 	{
-		if (!m_events.contains(key))
+		if (m_recorder)
 		{
-			return false;
+			m_recorder->finish(m_frameIndex - m_recordStartFrame);
+			m_recorder.reset();
 		}
-
-		return m_events[key]->isJustPressed();
 	}
 
-	bool InputManager::isJustReleased(const Key key)
+	bool InputManager::startReplay(const std::string& path)
 	{
-		if (!m_events.contains(key))
+		m_replayer = InputReplayer::load(path);
+		m_replayFinished = false;
+		if (!m_replayer)
 		{
 			return false;
 		}
 
-		return m_events[key]->isJustReleased();
+		reset();
+		m_replayStartFrame = m_frameIndex;
+		return true;
+	}
+
+	void InputManager::stopReplay()
+	{
+		m_replayer.reset();
+	}
+
+	bool InputManager::isRecording()
+	{
+		return m_recorder.has_value();
+	}
+
+	bool InputManager::isReplaying()
+	{
+		return m_replayer.has_value();
+	}
+
+	bool InputManager::isReplayFinished()
+	{
+		return m_replayFinished;
+	}
+
+	std::span<const InputEvent> InputManager::getFrameEvents()
+	{
+		return {m_frameEvents.data(), m_frameEventCount};
+	}
+
+	double InputManager::getTime()
+	{
+		static const Timer clock{[]
+		{
+			Timer timer;
+			timer.start();
+			return timer;
+		}()};
+
+		return clock.peakElapsed();
+	}
+
+	bool InputManager::isPressed(const Key key)
+	{
+		return m_keyStates[key] == PRESSED;
+	}
+
+	bool InputManager::isJustPressed(const Key key)
+	{
+		return m_keyStates[key] == JUST_PRESSED;
+	}
+
+	bool InputManager::isJustReleased(const Key key)
+	{
+		return m_keyStates[key] == JUST_RELEASED;
 	}
 
 	bool InputManager::isReleased(const Key key)
 	{
-		return !m_events.contains(key);
+		return m_keyStates[key] == RELEASED;
 	}
 
 	bool InputManager::isOrderedPressed(const std::initializer_list<Key>& keys)
 	{
-		return isOrderedPressed(std::vector(keys));
+		return isOrderedPressed(std::span{keys.begin(), keys.size()});
 	}
 
-	bool InputManager::isOrderedPressed(const std::vector<Key>& keys)
+	bool InputManager::isOrderedPressed(const std::span<const Key> keys)
 	{
-		std::queue tempRecentQueue{m_recentQueue};
-		auto it{keys.begin()};
-
-		while (it != keys.end() && !tempRecentQueue.empty())
+		// The held keys must be exactly the combination, pressed in the same order
+		if (keys.size() != m_pressOrderCount)
 		{
-			std::shared_ptr currentEvent{tempRecentQueue.front()};
-			if (currentEvent->getKey() == *it &&
-				(currentEvent->isPressed() || currentEvent->isJustPressed()))
-			{
-				tempRecentQueue.pop();
-				++it;
-			}
-			else if (!currentEvent->isJustPressed())
-			{
-				tempRecentQueue.pop(); // Skip non-JUST_PRESSED events
-			}
-			else
-			{
-				return false; // Sequence doesn't match
-			}
+			return false;
 		}
 
-		// If we've gone through all the keys in the desired sequence,
-		// now check if all those keys are currently being held down.
-		if (it == keys.end())
+		for (size_t i = 0; i < keys.size(); ++i)
 		{
-			for (const Key& key : keys)
+			if (m_pressOrder[i] != keys[i])
 			{
-				if (!m_events.contains(key) ||
-					!(m_events[key]->isPressed() || m_events[key]->isJustPressed()))
-				{
-					return false; // Not all keys are held
-				}
+				return false;
 			}
-
-			// Iterate through each Key, InputEvent
-			for (const auto& [key, event] : m_events)
-			{
-				bool inCombo{};
-				for (const Key& comboKey : keys)
-				{
-					if (key == comboKey)
-					{
-						inCombo = true;
-						break;
-					}
-				}
-
-				if (!inCombo && event->isPressed())
-				{
-					return false; // Another key is pressed
-				}
-			}
-
-			return true; // Sequence matched and all keys are held
 		}
 
-		return false; // The recent queue didn't contain the full sequence of presses
+		return true;
 	}
 
 	bool InputManager::isOrderedJustPressed(const std::initializer_list<Key>& keys)
 	{
-		return isOrderedJustPressed(std::vector(keys));
+		return isOrderedJustPressed(std::span{keys.begin(), keys.size()});
 	}
 
-	bool InputManager::isOrderedJustPressed(const std::vector<Key>& keys)
+	bool InputManager::isOrderedJustPressed(const std::span<const Key> keys)
 	{
 		// Last key must just have been pressed for this to be valid
-		if (!isJustPressed(keys.back()))
+		if (keys.empty() || !isJustPressed(keys.back()))
 		{
 			return false;
 		}
@@ -204,53 +225,117 @@ namespace lune
 		return {m_deltaX, m_deltaY};
 	}
 
-	void InputManager::clearRecentQueue()
+	void InputManager::processKeyEvent(const int key, const int action)
 	{
-		// Clear recentQueue of all !is_pressed elements
-		std::queue<std::shared_ptr<InputEvent>> tempQueue;
-		while (!m_recentQueue.empty())
+		// Ignore repeated events as the key is already held
+		if (action == GLFW_REPEAT || key < 0 || key >= static_cast<int>(KEY_COUNT))
 		{
-			std::shared_ptr<InputEvent> event = m_recentQueue.front();
-			m_recentQueue.pop();
+			return;
+		}
 
-			// Copy element to other queue
-			if (event->isPressed()) // Checks if event contains key and is pressed
+		const InputState state{action == GLFW_PRESS ? JUST_PRESSED : JUST_RELEASED};
+		pushEvent(InputEvent{static_cast<Key>(key), state, getTime()});
+	}
+
+	void InputManager::reset()
+	{
+		m_keyStates.fill(RELEASED);
+		m_changedKeyCount = 0;
+		m_pressOrderCount = 0;
+		m_deltaX = 0.0;
+		m_deltaY = 0.0;
+		m_firstMouse = true;
+	}
+
+	void InputManager::replayFrame()
+	{
+		// Live input is dropped so it can't interfere with the recorded sequence
+		InputEvent discarded;
+		while (m_eventQueue.tryPop(discarded))
+		{
+		}
+
+		const uint32_t frame{m_frameIndex - m_replayStartFrame};
+		for (const InputRecord& record : m_replayer->replay(frame))
+		{
+			if (m_frameEventCount == m_frameEvents.size())
 			{
-				tempQueue.emplace(event);
+				break;
 			}
+
+			m_frameEvents[m_frameEventCount] = record.toEvent();
+			applyEvent(m_frameEvents[m_frameEventCount++]);
 		}
 
-		// Update queue
-		m_recentQueue = tempQueue;
+		if (m_replayer->isFinished(frame + 1))
+		{
+			m_replayer.reset();
+			m_replayFinished = true;
+		}
 	}
 
-	void InputManager::processKeyEvent(const int key, const int action)
+	void InputManager::pushEvent(const InputEvent& event)
+	{
+		if (!m_eventQueue.tryPush(event))
+		{
+			m_droppedEvents.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	void InputManager::applyEvent(const InputEvent& event)
 	{
-		// Ignore repeated events as they are updated in _process() when called externally
-		if (action == GLFW_REPEAT)
+		if (event.getType() == INPUT_EVENT_MOUSE_MOVE)
 		{
+			if (m_firstMouse)
+			{
+				m_prevMouseX = event.getX();
+				m_prevMouseY = event.getY();
+				m_firstMouse = false;
+			}
+
+			// Accumulate so no movement is lost when several arrive within one frame
+			m_deltaX += event.getX() - m_prevMouseX;
+			m_deltaY += m_prevMouseY - event.getY();
+
+			m_prevMouseX = event.getX();
+			m_prevMouseY = event.getY();
 			return;
 		}
 
-		const auto libKey{static_cast<Key>(key)};
-		InputState state;
+		const Key key{event.getKey()};
+		InputState& state{m_keyStates[key]};
+		const bool held{state == PRESSED || state == JUST_PRESSED};
 
-		if (action == GLFW_PRESS && !m_events.contains(libKey))
+		// Presses of held keys and releases of released keys carry no information
+		if (event.isJustPressed() == held)
+		{
+			return;
+		}
+
+		// Keys in a JUST_* state are already tracked from an earlier event this frame
+		if (state == PRESSED || state == RELEASED)
+		{
+			m_changedKeys[m_changedKeyCount++] = key;
+		}
+
+		if (event.isJustPressed())
 		{
 			state = JUST_PRESSED;
+			if (m_pressOrderCount < MAX_HELD_KEYS)
+			{
+				m_pressOrder[m_pressOrderCount++] = key;
+			}
 		}
-		else if (action == GLFW_RELEASE)
+		else
 		{
 			state = JUST_RELEASED;
+			const auto last{m_pressOrder.begin() + m_pressOrderCount};
+			const auto it{std::find(m_pressOrder.begin(), last, key)};
+			if (it != last)
+			{
+				std::copy(it + 1, last, it);
+				--m_pressOrderCount;
+			}
 		}
-
-		const auto event{std::make_shared<InputEvent>(libKey, state)};
-
-		// Add to recent queue if just pressed
-		// Used for handling combinations of keys being pressed
-		m_recentQueue.push(event);
-
-		m_eventQueue.push(event);
-		m_events[libKey] = event;
 	}
 } // namespace lune
@@ -1,14 +1,20 @@
 module;
 #include <GLFW/glfw3.h>
+#include <array>
+#include <atomic>
+#include <cstddef>
 #include <glm/vec2.hpp>
+#include <cstdint>
 #include <initializer_list>
-#include <map>
-#include <memory>
-#include <queue>
+#include <optional>
+#include <span>
+#include <string>
 export module lune:input_manager;
 
 export import :input_event;
 export import :input_map;
+import :input_recorder;
+import :ring_buffer;
 
 namespace lune
 {
@@ -18,12 +24,50 @@ namespace lune
 	 * The `InputManager` class provides static methods to query the state of keys, check for key
 	 * combinations, and retrieve mouse position and movement. It is designed to be used globally
 	 * and does not require instantiation.
+	 *
+	 * GLFW callbacks only push timestamped events into a fixed-size ring buffer; `_process()`
+	 * drains it once per frame into a dense array of key states, so neither side allocates and
+	 * every query is a single array lookup. Events are collected at callback time rather than on
+	 * a separate thread because GLFW only delivers events on the main thread (a hard requirement
+	 * on macOS); the ring buffer is safe for a dedicated producer thread should a backend allow
+	 * one.
+	 *
+	 * Every event of the frame, including each individual mouse movement, stays available through
+	 * `getFrameEvents()` so precision-sensitive code can replay input at sub-frame granularity.
 	 */
 	export class InputManager
 	{
-		static inline std::queue<std::shared_ptr<InputEvent>> m_eventQueue;
-		static inline std::queue<std::shared_ptr<InputEvent>> m_recentQueue;
-		static inline std::map<Key, std::shared_ptr<InputEvent>> m_events;
+		static constexpr size_t EVENT_QUEUE_CAPACITY{4096};
+		static constexpr size_t MAX_HELD_KEYS{16};
+
+		static inline SpscRingBuffer<InputEvent, EVENT_QUEUE_CAPACITY> m_eventQueue;
+		static inline std::array<InputState, KEY_COUNT> m_keyStates{[]
+		{
+			std::array<InputState, KEY_COUNT> states{};
+			states.fill(RELEASED);
+			return states;
+		}()};
+
+		/// Keys in a JUST_PRESSED or JUST_RELEASED state, settled on the next `_process()`.
+		static inline std::array<Key, KEY_COUNT> m_changedKeys{};
+		static inline size_t m_changedKeyCount{};
+
+		/// Held keys in the order they were pressed, used for ordered combinations.
+		static inline std::array<Key, MAX_HELD_KEYS> m_pressOrder{};
+		static inline size_t m_pressOrderCount{};
+
+		/// Events applied by the last `_process()`, in arrival order.
+		static inline std::array<InputEvent, EVENT_QUEUE_CAPACITY> m_frameEvents{};
+		static inline size_t m_frameEventCount{};
+		static inline std::atomic<size_t> m_droppedEvents{};
+
+		/// Number of processed frames, used to index recordings.
+		static inline uint32_t m_frameIndex{};
+		static inline std::optional<InputRecorder> m_recorder;
+		static inline uint32_t m_recordStartFrame{};
+		static inline std::optional<InputReplayer> m_replayer;
+		static inline uint32_t m_replayStartFrame{};
+		static inline bool m_replayFinished{};
 
 		static inline double m_deltaX;
 		static inline double m_deltaY;
@@ -34,11 +78,70 @@ namespace lune
 
 	public:
 		/**
-		 * @brief Gets a map of all active input events.
+		 * @brief Gets the state of every key, indexed by `Key`.
+		 *
+		 * @return A view of the key states; valid for the lifetime of the program.
+		 */
+		static std::span<const InputState, KEY_COUNT> getKeyStates();
+
+		/**
+		 * @brief Gets every event applied this frame, in the order they were received.
+		 *
+		 * Unlike the state queries, this preserves presses and releases that happened within a
+		 * single frame and every intermediate cursor position, each with its timestamp.
+		 *
+		 * @return A view of this frame's events; invalidated by the next `Window::pollEvents()`.
+		 */
+		static std::span<const InputEvent> getFrameEvents();
+
+		/**
+		 * @brief Starts recording every applied event to a binary file.
+		 *
+		 * Input state is reset first, so a replay of the file starts from the same state.
+		 *
+		 * @param path Path of the recording to write.
+		 *
+		 * @return true if the file was created.
+		 */
+		static bool startRecording(const std::string& path);
+
+		/**
+		 * @brief Stops the current recording and finalizes the file.
+		 */
+		static void stopRecording();
+
+		/**
+		 * @brief Replays a recording in place of live input, starting with the next frame.
 		 *
-		 * @return std::map<Key, std::shared_ptr<InputEvent>> A map of key to input event pairs.
+		 * Events are applied in the same frames they were recorded in, with their original
+		 * timestamps, so repeated runs see identical input. Live input is discarded until the
+		 * replay finishes or is stopped.
+		 *
+		 * @param path Path of the recording to replay.
+		 *
+		 * @return true if the recording was loaded.
 		 */
-		static std::map<Key, std::shared_ptr<InputEvent>> getEvents();
+		static bool startReplay(const std::string& path);
+
+		/**
+		 * @brief Stops the current replay and returns to live input.
+		 */
+		static void stopReplay();
+
+		[[nodiscard]] static bool isRecording();
+		[[nodiscard]] static bool isReplaying();
+
+		/**
+		 * @return true if a replay has played every recorded frame.
+		 */
+		[[nodiscard]] static bool isReplayFinished();
+
+		/**
+		 * @brief Gets the current time on the clock used to timestamp events.
+		 *
+		 * @return Seconds since the first use of the input clock.
+		 */
+		static double getTime();
 
 		/**
 		 * @brief Internally called by GLFW when a key event occurs.
@@ -74,9 +177,9 @@ namespace lune
 		/**
 		 * @brief Processes and updates input states and events.
 		 *
-		 * This method is called internally by the Window class and should NOT
-		 * be called directly. It updates the state of all input events and
-		 * clears outdated events.
+		 * This method is called internally by the Window class after polling GLFW and should NOT
+		 * be called directly. It settles the transitions of the previous frame and applies all
+		 * queued events.
 		 */
 		static void _process();
 
@@ -134,7 +237,7 @@ namespace lune
 		 * @return false If not all keys are pressed or if an extra key is
 		 * pressed.
 		 */
-		static bool isOrderedPressed(const std::vector<Key>& keys);
+		static bool isOrderedPressed(std::span<const Key> keys);
 
 		/**
 		 * @brief Checks if keys were pressed in a specific order in the current
@@ -158,7 +261,7 @@ namespace lune
 		 * @return false If not all keys were pressed in the current frame or if
 		 * an extra key was pressed.
 		 */
-		static bool isOrderedJustPressed(const std::vector<Key>& keys);
+		static bool isOrderedJustPressed(std::span<const Key> keys);
 
 		/**
 		 * @brief Gets the current mouse position.
@@ -168,29 +271,40 @@ namespace lune
 		static glm::vec2 getMousePosition();
 
 		/**
-		 * @brief Gets the mouse movement delta since the last frame.
+		 * @brief Gets the mouse movement since the last frame.
 		 *
-		 * @return glm::vec2 The mouse movement delta (x, y) since the last
-		 * frame.
+		 * @return glm::vec2 The sum of every cursor movement (x, y) received since the last
+		 * frame; zero if the mouse did not move.
 		 */
 		static glm::vec2 getMouseDelta();
 
 	private:
 		/**
-		 * @brief Clears all elements from the recent queue that are not
-		 * currently pressed.
-		 *
-		 * This method is called internally to clean up outdated events.
-		 */
-		static void clearRecentQueue();
-
-		/**
-		 * @brief Processes a new input given from GLFW and updates
-		 * input-related maps.
+		 * @brief Queues a new input given from GLFW. Repeats and unknown keys are ignored.
 		 *
 		 * @param key Keycode being pressed.
 		 * @param action Action for the given key.
 		 */
 		static void processKeyEvent(int key, int action);
+
+		/**
+		 * @brief Resets key states, press order and mouse tracking to their initial values.
+		 */
+		static void reset();
+
+		/**
+		 * @brief Fills this frame's events from the replay, discarding live input.
+		 */
+		static void replayFrame();
+
+		/**
+		 * @brief Queues an event, counting it as dropped if the queue is full.
+		 */
+		static void pushEvent(const InputEvent& event);
+
+		/**
+		 * @brief Applies a queued event to the key states, press order and mouse state.
+		 */
+		static void applyEvent(const InputEvent& event);
 	};
 } // namespace lune
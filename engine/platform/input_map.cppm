@@ -1,5 +1,6 @@
 module;
 #include <GLFW/glfw3.h>
+#include <cstddef>
 export module lune:input_map;
 
 namespace lune
@@ -12,6 +13,11 @@ namespace lune
 		JUST_RELEASED,
 	};
 
+	/**
+	 * @brief Number of distinct `Key` values; keys can be used directly as array indices.
+	 */
+	export inline constexpr size_t KEY_COUNT{GLFW_KEY_LAST + 1};
+
 	export enum Key : int
 	{
 		KEY_0 = GLFW_KEY_0,
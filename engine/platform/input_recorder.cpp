@@ -0,0 +1,120 @@
+module;
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+module lune;
+
+namespace lune
+{
+	std::optional<InputRecorder> InputRecorder::create(const std::string& path)
+	{
+		InputRecorder recorder;
+		recorder.m_stream.open(path, std::ios::binary | std::ios::trunc);
+		if (!recorder.m_stream)
+		{
+			std::cerr << "Failed to open input recording for writing: " << path << "\n";
+			return std::nullopt;
+		}
+
+		// Placeholder header, completed by finish()
+		recorder.m_stream.write(reinterpret_cast<const char*>(&recorder.m_header),
+								sizeof(InputRecordingHeader));
+		return recorder;
+	}
+
+	void InputRecorder::write(const uint32_t frame, const std::span<const InputEvent> events)
+	{
+		for (const InputEvent& event : events)
+		{
+			const InputRecord record{InputRecord::fromEvent(frame, event)};
+			m_stream.write(reinterpret_cast<const char*>(&record), sizeof(InputRecord));
+		}
+
+		m_header.recordCount += static_cast<uint32_t>(events.size());
+	}
+
+	void InputRecorder::finish(const uint32_t frameCount)
+	{
+		if (!m_stream.is_open())
+			return;
+
+		m_header.frameCount = frameCount;
+		m_stream.seekp(0);
+		m_stream.write(reinterpret_cast<const char*>(&m_header), sizeof(InputRecordingHeader));
+		m_stream.close();
+	}
+
+	std::optional<InputReplayer> InputReplayer::load(const std::string& path)
+	{
+		const auto bytes{File::readBinary(path)};
+		if (!bytes)
+			return std::nullopt;
+
+		InputRecordingHeader header;
+		if (bytes->size() < sizeof(header))
+		{
+			std::cerr << "Input recording is too small: " << path << "\n";
+			return std::nullopt;
+		}
+
+		std::memcpy(&header, bytes->data(), sizeof(header));
+		if (header.magic != INPUT_RECORDING_MAGIC || header.version != INPUT_RECORDING_VERSION)
+		{
+			std::cerr << "Unsupported input recording: " << path << "\n";
+			return std::nullopt;
+		}
+
+		// A recording that was never finished still holds every complete record
+		const size_t recordCount{(bytes->size() - sizeof(header)) / sizeof(InputRecord)};
+
+		InputReplayer replayer;
+		replayer.m_records.resize(recordCount);
+		std::memcpy(replayer.m_records.data(), bytes->data() + sizeof(header),
+					recordCount * sizeof(InputRecord));
+
+		// Records are cast back to enums when replayed, so a corrupt file is rejected here
+		uint32_t lastFrame{};
+		for (size_t i{}; i < recordCount; ++i)
+		{
+			const InputRecord& record{replayer.m_records[i]};
+			if (!record.isValid())
+			{
+				std::cerr << "Invalid input record " << i << " in " << path << "\n";
+				return std::nullopt;
+			}
+
+			if (record.frame < lastFrame)
+			{
+				std::cerr << "Input record " << i << " goes back to frame " << record.frame
+						  << " in " << path << "\n";
+				return std::nullopt;
+			}
+			lastFrame = record.frame;
+		}
+
+		replayer.m_frameCount = header.frameCount;
+		if (replayer.m_frameCount == 0 && !replayer.m_records.empty())
+			replayer.m_frameCount = replayer.m_records.back().frame + 1;
+
+		return replayer;
+	}
+
+	std::span<const InputRecord> InputReplayer::replay(const uint32_t frame)
+	{
+		// Skip anything left from frames that were never replayed
+		while (m_next < m_records.size() && m_records[m_next].frame < frame)
+			++m_next;
+
+		const size_t begin{m_next};
+		while (m_next < m_records.size() && m_records[m_next].frame == frame)
+			++m_next;
+
+		return {m_records.data() + begin, m_next - begin};
+	}
+} // namespace lune
@@ -0,0 +1,167 @@
+module;
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+export module lune:input_recorder;
+
+import lune.memory;
+import :input_event;
+import :input_map;
+
+namespace lune
+{
+	export inline constexpr uint32_t INPUT_RECORDING_MAGIC{0x504E494C}; ///< "LINP" in little-endian.
+	export inline constexpr uint32_t INPUT_RECORDING_VERSION{1};
+
+
+	/**
+	 * @brief Fixed-size header at the start of every input recording.
+	 */
+	export struct InputRecordingHeader
+	{
+		uint32_t magic{INPUT_RECORDING_MAGIC};
+		uint32_t version{INPUT_RECORDING_VERSION};
+		uint32_t frameCount{};	///< Number of frames recorded; written when recording stops.
+		uint32_t recordCount{}; ///< Number of records; written when recording stops.
+	};
+
+
+	/**
+	 * @brief A single recorded event and the frame it was applied in.
+	 */
+	export struct InputRecord
+	{
+		uint32_t frame{};
+		int32_t type{}; ///< `InputEventType`.
+		int32_t key{};
+		int32_t state{};
+		double x{};
+		double y{};
+		double timestamp{};
+
+		[[nodiscard]] static InputRecord fromEvent(const uint32_t frame,
+												   const InputEvent& event) noexcept
+		{
+			return {
+					.frame = frame,
+					.type = event.getType(),
+					.key = event.getKey(),
+					.state = event.getState(),
+					.x = event.getX(),
+					.y = event.getY(),
+					.timestamp = event.getTimestamp(),
+			};
+		}
+
+		/**
+		 * @return true if the type, key and state are values an `InputEvent` can hold.
+		 */
+		[[nodiscard]] bool isValid() const noexcept
+		{
+			if (type == INPUT_EVENT_MOUSE_MOVE)
+				return true;
+
+			return type == INPUT_EVENT_KEY && key >= 0 && key < static_cast<int32_t>(KEY_COUNT) &&
+				   state >= PRESSED && state <= JUST_RELEASED;
+		}
+
+		/**
+		 * @brief Converts the record back to an event; the record must be valid.
+		 */
+		[[nodiscard]] InputEvent toEvent() const noexcept
+		{
+			if (type == INPUT_EVENT_MOUSE_MOVE)
+				return InputEvent::mouseMove(x, y, timestamp);
+
+			return InputEvent{static_cast<Key>(key), static_cast<InputState>(state), timestamp};
+		}
+	};
+
+	static_assert(sizeof(InputRecord) == 40);
+
+
+	/**
+	 * @brief Streams the events applied by `InputManager` to a binary file.
+	 *
+	 * Records are appended as frames are processed, so a recording survives until the last
+	 * flushed frame even if the application is killed.
+	 */
+	export class InputRecorder
+	{
+		std::ofstream m_stream;
+		InputRecordingHeader m_header{};
+
+	public:
+		/**
+		 * @brief Creates the recording file.
+		 *
+		 * @param path Path of the recording to write.
+		 *
+		 * @return The recorder; std::nullopt if the file could not be created.
+		 */
+		static std::optional<InputRecorder> create(const std::string& path);
+
+		/**
+		 * @brief Appends the events applied in a frame.
+		 */
+		void write(uint32_t frame, std::span<const InputEvent> events);
+
+		/**
+		 * @brief Writes the final header and closes the file.
+		 *
+		 * @param frameCount Number of frames covered by the recording.
+		 */
+		void finish(uint32_t frameCount);
+	};
+
+
+	/**
+	 * @brief Plays back a recording made by `InputRecorder`, frame by frame.
+	 *
+	 * Events are replayed by frame index rather than by wall clock time, so a replay applies
+	 * exactly the same input in the same frames regardless of how fast the frames run.
+	 */
+	export class InputReplayer
+	{
+		std::vector<InputRecord, TaggedAllocator<InputRecord, MEMORY_TAG_INPUT>> m_records;
+		uint32_t m_frameCount{};
+		size_t m_next{};
+
+	public:
+		/**
+		 * @brief Loads a recording.
+		 *
+		 * @param path Path of the recording to read.
+		 *
+		 * @return The replayer; std::nullopt if the file is missing or malformed, holds an invalid
+		 * record, or has records out of frame order.
+		 */
+		static std::optional<InputReplayer> load(const std::string& path);
+
+		/**
+		 * @brief Gets the events recorded for a frame.
+		 *
+		 * @param frame Frame to replay; frames must be replayed in increasing order.
+		 *
+		 * @return The frame's records, in the order they were applied.
+		 */
+		std::span<const InputRecord> replay(uint32_t frame);
+
+		/**
+		 * @return true once every recorded frame has been replayed.
+		 */
+		[[nodiscard]] bool isFinished(const uint32_t frame) const noexcept
+		{
+			return frame >= m_frameCount;
+		}
+
+		[[nodiscard]] uint32_t frameCount() const noexcept
+		{
+			return m_frameCount;
+		}
+	};
+} // namespace lune
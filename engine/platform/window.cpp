@@ -8,9 +8,12 @@ module;
 #endif
 
 #include <GLFW/glfw3native.h>
+#include <cstdlib>
 #include <iostream>
+#include <lune/profiler.hpp>
 #include <stdexcept>
 #include <string>
+#include <utility>
 module lune;
 
 #ifdef USE_METAL
@@ -21,6 +24,89 @@ import :input_manager;
 
 namespace lune
 {
+	namespace
+	{
+		/// Set when a replay was requested through the environment, for unattended runs.
+		bool closeOnReplayEnd{};
+
+		/// Trace path requested through `LUNE_PROFILE`, written when the process exits.
+		const char* profilePath{};
+
+		/// Frame stats path requested through `LUNE_FRAME_STATS`, written when the process exits.
+		const char* frameStatsPath{};
+
+		/**
+		 * @brief Starts input recording or replay if requested through `LUNE_INPUT_RECORD` or
+		 * `LUNE_INPUT_REPLAY`, so any application can be captured and replayed unmodified.
+		 */
+		void startInputCaptureFromEnvironment()
+		{
+			if (const char* path{std::getenv("LUNE_INPUT_REPLAY")})
+			{
+				closeOnReplayEnd = InputManager::startReplay(path);
+			}
+
+			if (const char* path{std::getenv("LUNE_INPUT_RECORD")})
+			{
+				InputManager::startRecording(path);
+			}
+		}
+
+		/**
+		 * @brief Starts a profiler capture if requested through `LUNE_PROFILE`, so any application
+		 * can be profiled unmodified.
+		 */
+		void startProfilerFromEnvironment()
+		{
+			profilePath = std::getenv("LUNE_PROFILE");
+			if (profilePath)
+				Profiler::beginCapture();
+
+			// Constructed before the exit handler is registered, so it is destroyed after it runs
+			frameStatsPath = std::getenv("LUNE_FRAME_STATS");
+			if (frameStatsPath)
+				FrameStats::instance();
+		}
+
+		/**
+		 * @brief Starts watching shader sources if requested through `LUNE_SHADER_HOT_RELOAD`.
+		 */
+		void startShaderHotReloadFromEnvironment()
+		{
+			if (std::getenv("LUNE_SHADER_HOT_RELOAD"))
+				ShaderHotReload::start();
+		}
+
+		/**
+		 * @brief Finishes what was started from the environment when the process exits, as windows
+		 * may be destroyed and created again before then.
+		 */
+		void shutdown()
+		{
+			InputManager::stopRecording();
+
+			if (profilePath)
+				Profiler::exportChromeTrace(profilePath);
+
+			if (frameStatsPath)
+				FrameStats::instance().writeCsv(frameStatsPath);
+
+			ShaderHotReload::stop();
+		}
+
+		/**
+		 * @brief Ends the current frame for the profiler and frame-scoped allocations.
+		 */
+		void nextFrame()
+		{
+			FrameStats::instance().markFrame();
+			FrameArena::nextFrame();
+
+			// Shaders recompiled since the last frame are swapped in before anything is drawn
+			gfx::HotReload::applyPending();
+		}
+	} // namespace
+
 	Window::~Window()
 	{
 		destroy();
@@ -34,6 +120,11 @@ namespace lune
 			if (!glfwInit())
 				throw std::runtime_error("Failed to initialize GLFW!");
 			glfwInitialized = true;
+
+			startInputCaptureFromEnvironment();
+			startProfilerFromEnvironment();
+			startShaderHotReloadFromEnvironment();
+			std::atexit(shutdown);
 		}
 
 		// Destroy old window if we double create
@@ -59,6 +150,7 @@ namespace lune
 		glfwSetCursorPosCallback(m_handle, InputManager::_processMouseCallback);
 		glfwSetMouseButtonCallback(m_handle, InputManager::_processMouseButtonCallback);
 		glfwSetFramebufferSizeCallback(m_handle, _onFrameBufferSizeCallback);
+		glfwSetWindowSizeCallback(m_handle, _onWindowSizeCallback);
 
 #ifdef USE_METAL
 		attachMetalToGLFW();
@@ -84,10 +176,19 @@ namespace lune
 		window->m_frameBufferHeight = height;
 
 #ifdef USE_METAL
-		metal::toMetalImpl(window->surface())->setDrawableSize(width, height);
+		// Applied by the next render pass once the size settles, so live resizing stays cheap
+		window->surface().requestResize(width, height);
 #endif
 	}
 
+	void Window::_onWindowSizeCallback(GLFWwindow* handle, const int width, const int height)
+	{
+		const auto window = static_cast<Window*>(glfwGetWindowUserPointer(handle));
+
+		window->m_width = width;
+		window->m_height = height;
+	}
+
 #ifdef USE_VULKAN
 	void Window::attachVulkanToGLFW()
 	{
@@ -96,12 +197,21 @@ namespace lune
 #endif
 
 	Window::Window(Window&& other) noexcept :
-		m_handle(other.m_handle),
+		m_handle(std::exchange(other.m_handle, nullptr)),
 		m_width(other.m_width),
 		m_height(other.m_height),
-		m_title(std::move(other.m_title))
+		m_frameBufferWidth(other.m_frameBufferWidth),
+		m_frameBufferHeight(other.m_frameBufferHeight),
+		m_title(std::move(other.m_title)),
+		m_mode(other.m_mode)
 	{
-		other.m_handle = nullptr;
+#ifdef USE_METAL
+		m_surface = std::move(other.m_surface);
+#endif
+
+		// Callbacks find the window through the user pointer, which still names `other`
+		if (m_handle)
+			glfwSetWindowUserPointer(m_handle, this);
 	}
 
 	Window& Window::operator=(Window&& other) noexcept
@@ -109,11 +219,19 @@ namespace lune
 		if (this != &other)
 		{
 			destroy();
-			m_handle = other.m_handle;
+			m_handle = std::exchange(other.m_handle, nullptr);
 			m_width = other.m_width;
 			m_height = other.m_height;
+			m_frameBufferWidth = other.m_frameBufferWidth;
+			m_frameBufferHeight = other.m_frameBufferHeight;
 			m_title = std::move(other.m_title);
-			other.m_handle = nullptr;
+			m_mode = other.m_mode;
+#ifdef USE_METAL
+			m_surface = std::move(other.m_surface);
+#endif
+
+			if (m_handle)
+				glfwSetWindowUserPointer(m_handle, this);
 		}
 		return *this;
 	}
@@ -130,6 +248,9 @@ namespace lune
 
 	bool Window::shouldClose() const
 	{
+		if (closeOnReplayEnd && InputManager::isReplayFinished())
+			return true;
+
 		return m_handle && glfwWindowShouldClose(m_handle);
 	}
 
@@ -166,8 +287,23 @@ namespace lune
 
 	void Window::pollEvents()
 	{
-		InputManager::_process();
+		LUNE_FRAME_MARK();
+		LUNE_ZONE("Window::pollEvents");
+		nextFrame();
+
+		// Callbacks only queue input, so apply it once everything for this frame has arrived
 		glfwPollEvents();
+		InputManager::_process();
+	}
+
+	void Window::waitEvents(const double timeout)
+	{
+		LUNE_FRAME_MARK();
+		LUNE_ZONE("Window::waitEvents");
+		nextFrame();
+
+		glfwWaitEventsTimeout(timeout);
+		InputManager::_process();
 	}
 
 #ifdef USE_METAL
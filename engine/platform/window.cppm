@@ -143,6 +143,14 @@ namespace lune
 		 */
 		static void pollEvents();
 
+		/**
+		 * @brief Waits for window events and processes them, like `pollEvents()`, but sleeps until
+		 * an event arrives or the timeout expires. Keeps tools from spinning while idle.
+		 *
+		 * @param timeout The longest time to wait, in seconds.
+		 */
+		static void waitEvents(double timeout);
+
 		/**
 		 * @brief Creates the window using the provided configuration.
 		 *
@@ -165,6 +173,20 @@ namespace lune
 			return m_height;
 		}
 
+		/**
+		 * @brief Gets the framebuffer width in pixels, which differs from `width()` on high-DPI
+		 * displays.
+		 */
+		[[nodiscard]] int frameBufferWidth() const
+		{
+			return m_frameBufferWidth;
+		}
+
+		[[nodiscard]] int frameBufferHeight() const
+		{
+			return m_frameBufferHeight;
+		}
+
 		[[nodiscard]] gfx::RenderSurface& surface() const
 		{
 			return *m_surface;
@@ -180,6 +202,15 @@ namespace lune
 		 */
 		static void _onFrameBufferSizeCallback(GLFWwindow* handle, int width, int height);
 
+		/**
+		 * @brief Callback for window resize events.
+		 *
+		 * @param handle The GLFW window handle.
+		 * @param width The new width in screen coordinates.
+		 * @param height The new height in screen coordinates.
+		 */
+		static void _onWindowSizeCallback(GLFWwindow* handle, int width, int height);
+
 #ifdef USE_METAL
 		/**
 		 * @brief Attaches a Metal layer to the GLFW window (macOS only).
@@ -287,6 +318,16 @@ namespace lune
 				return m_rawWindow.height();
 			}
 
+			[[nodiscard]] int frameBufferWidth() const
+			{
+				return m_rawWindow.frameBufferWidth();
+			}
+
+			[[nodiscard]] int frameBufferHeight() const
+			{
+				return m_rawWindow.frameBufferHeight();
+			}
+
 			[[nodiscard]] gfx::RenderSurface& surface() const
 			{
 				return m_rawWindow.surface();
@@ -0,0 +1,278 @@
+module;
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+module lune.profiler;
+
+namespace lune
+{
+	namespace
+	{
+		/// Percentiles resolve to 0.1 ms, up to 250 ms; longer frames share the overflow bucket.
+		constexpr double BUCKET_WIDTH{0.0001};
+		constexpr size_t BUCKET_COUNT{2500};
+
+		double secondsNow()
+		{
+			return std::chrono::duration<double>(
+						   std::chrono::steady_clock::now().time_since_epoch())
+					.count();
+		}
+	} // namespace
+
+	RollingHistogram::RollingHistogram(const size_t window, const double bucketWidth,
+									   const size_t bucketCount) :
+		m_values(std::max<size_t>(window, 1)), m_buckets(bucketCount + 1), m_bucketWidth(bucketWidth)
+	{
+	}
+
+	void RollingHistogram::add(const double value)
+	{
+		if (m_count == m_values.size())
+		{
+			const double evicted{m_values[m_next]};
+			--m_buckets[bucketOf(evicted)];
+			m_sum -= evicted;
+		}
+		else
+		{
+			++m_count;
+		}
+
+		m_values[m_next] = value;
+		m_next = (m_next + 1) % m_values.size();
+		++m_buckets[bucketOf(value)];
+		m_sum += value;
+	}
+
+	void RollingHistogram::clear()
+	{
+		std::ranges::fill(m_buckets, 0);
+		m_next = 0;
+		m_count = 0;
+		m_sum = 0.0;
+	}
+
+	double RollingHistogram::percentile(const double fraction) const
+	{
+		if (m_count == 0)
+			return 0.0;
+
+		const auto rank{std::max<size_t>(
+				static_cast<size_t>(std::ceil(std::clamp(fraction, 0.0, 1.0) *
+											  static_cast<double>(m_count))),
+				1)};
+
+		size_t accumulated{};
+		for (size_t b = 0; b + 1 < m_buckets.size(); ++b)
+		{
+			accumulated += m_buckets[b];
+			if (accumulated >= rank)
+				return std::min(static_cast<double>(b + 1) * m_bucketWidth, max());
+		}
+
+		return max();
+	}
+
+	double RollingHistogram::max() const
+	{
+		double result{};
+		for (size_t i = 0; i < m_count; ++i)
+			result = std::max(result, recent(i));
+
+		return result;
+	}
+
+	size_t RollingHistogram::bucketOf(const double value) const noexcept
+	{
+		if (value <= 0.0)
+			return 0;
+
+		const size_t overflow{m_buckets.size() - 1};
+		const double bucket{value / m_bucketWidth};
+		return bucket >= static_cast<double>(overflow) ? overflow : static_cast<size_t>(bucket);
+	}
+
+
+	FrameStats::FrameStats(const double budget) : m_budget(budget)
+	{
+		m_histograms.reserve(FRAME_METRIC_COUNT);
+		for (int i = 0; i < FRAME_METRIC_COUNT; ++i)
+			m_histograms.emplace_back(WINDOW_SIZE, BUCKET_WIDTH, BUCKET_COUNT);
+
+		m_hitches.reserve(MAX_HITCHES);
+		m_framePresents.assign(WINDOW_SIZE, -1.0);
+	}
+
+	FrameStats& FrameStats::instance()
+	{
+		static FrameStats stats;
+		return stats;
+	}
+
+	void FrameStats::markFrame()
+	{
+		markFrame(secondsNow());
+	}
+
+	void FrameStats::markFrame(const double timestamp)
+	{
+		std::lock_guard lock(m_mutex);
+
+		// The first mark only starts the first frame
+		if (m_lastFrame < 0.0)
+		{
+			m_lastFrame = timestamp;
+			m_cpuWait = 0.0;
+			m_presentInterval = -1.0;
+			return;
+		}
+
+		const double frameTime{timestamp - m_lastFrame};
+		m_lastFrame = timestamp;
+
+		m_histograms[FRAME_TIME].add(frameTime);
+		m_histograms[FRAME_CPU_WAIT].add(m_cpuWait);
+		m_cpuWait = 0.0;
+		m_framePresents[m_frameCount % WINDOW_SIZE] = m_presentInterval;
+		m_presentInterval = -1.0;
+
+		if (frameTime > m_budget)
+		{
+			const FrameHitch hitch{m_frameCount, frameTime};
+			if (m_hitches.size() < MAX_HITCHES)
+				m_hitches.push_back(hitch);
+			else
+				m_hitches[m_hitchCount % MAX_HITCHES] = hitch;
+
+			++m_hitchCount;
+		}
+
+		++m_frameCount;
+	}
+
+	void FrameStats::addCpuWait(const double seconds)
+	{
+		std::lock_guard lock(m_mutex);
+		m_cpuWait += seconds;
+	}
+
+	void FrameStats::recordPresent(const double timestamp)
+	{
+		std::lock_guard lock(m_mutex);
+
+		if (m_lastPresent >= 0.0 && timestamp > m_lastPresent)
+		{
+			m_presentInterval = timestamp - m_lastPresent;
+			m_histograms[FRAME_PRESENT_INTERVAL].add(m_presentInterval);
+		}
+
+		m_lastPresent = timestamp;
+	}
+
+	void FrameStats::setBudget(const double seconds)
+	{
+		std::lock_guard lock(m_mutex);
+		m_budget = seconds;
+	}
+
+	double FrameStats::getBudget() const
+	{
+		std::lock_guard lock(m_mutex);
+		return m_budget;
+	}
+
+	FrameMetricSummary FrameStats::getSummary(const FrameMetric metric) const
+	{
+		std::lock_guard lock(m_mutex);
+
+		const RollingHistogram& histogram = m_histograms[metric];
+		return {
+				.count = histogram.count(),
+				.average = histogram.average(),
+				.p50 = histogram.percentile(0.50),
+				.p95 = histogram.percentile(0.95),
+				.p99 = histogram.percentile(0.99),
+				.max = histogram.max(),
+		};
+	}
+
+	uint64_t FrameStats::frameCount() const
+	{
+		std::lock_guard lock(m_mutex);
+		return m_frameCount;
+	}
+
+	uint64_t FrameStats::hitchCount() const
+	{
+		std::lock_guard lock(m_mutex);
+		return m_hitchCount;
+	}
+
+	std::vector<FrameHitch> FrameStats::getHitches() const
+	{
+		std::lock_guard lock(m_mutex);
+
+		std::vector<FrameHitch> hitches{m_hitches};
+		if (m_hitchCount > MAX_HITCHES)
+			std::ranges::rotate(hitches, hitches.begin() + m_hitchCount % MAX_HITCHES);
+
+		return hitches;
+	}
+
+	bool FrameStats::writeCsv(const std::string& path) const
+	{
+		std::ofstream stream(path);
+		if (!stream)
+		{
+			std::cerr << "Failed to write frame stats: " << path << '\n';
+			return false;
+		}
+
+		std::lock_guard lock(m_mutex);
+
+		const RollingHistogram& frameTimes = m_histograms[FRAME_TIME];
+		const RollingHistogram& cpuWaits = m_histograms[FRAME_CPU_WAIT];
+		const size_t count{frameTimes.count()};
+
+		stream << "frame,frame_time_ms,cpu_wait_ms,present_interval_ms,hitch\n";
+		for (size_t age = count; age-- > 0;)
+		{
+			const uint64_t frame{m_frameCount - 1 - age};
+			const double frameTime{frameTimes.recent(age)};
+			stream << frame << ',' << frameTime * 1000.0 << ',' << cpuWaits.recent(age) * 1000.0
+				   << ',';
+
+			if (const double present{m_framePresents[frame % WINDOW_SIZE]}; present >= 0.0)
+				stream << present * 1000.0;
+
+			stream << ',' << (frameTime > m_budget ? 1 : 0) << '\n';
+		}
+
+		return stream.good();
+	}
+
+	void FrameStats::reset()
+	{
+		std::lock_guard lock(m_mutex);
+
+		for (RollingHistogram& histogram : m_histograms)
+			histogram.clear();
+
+		m_hitches.clear();
+		m_lastFrame = -1.0;
+		m_lastPresent = -1.0;
+		m_cpuWait = 0.0;
+		m_presentInterval = -1.0;
+		std::ranges::fill(m_framePresents, -1.0);
+		m_frameCount = 0;
+		m_hitchCount = 0;
+	}
+} // namespace lune
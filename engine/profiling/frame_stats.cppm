@@ -0,0 +1,216 @@
+module;
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+export module lune.profiler:frame_stats;
+
+namespace lune
+{
+	/**
+	 * @brief Histogram over the last `window` values, for percentiles that follow recent
+	 * behavior without sorting.
+	 *
+	 * Values are counted in fixed-width buckets; adding a value evicts the oldest one in O(1), and
+	 * percentiles are resolved to the bucket width in O(bucket count).
+	 */
+	export class RollingHistogram
+	{
+		std::vector<double> m_values; ///< Ring of the last `window` values.
+		std::vector<uint32_t> m_buckets;
+		size_t m_next{};
+		size_t m_count{};
+		double m_sum{};
+		double m_bucketWidth;
+
+	public:
+		/**
+		 * @param window Number of most recent values covered.
+		 * @param bucketWidth Resolution of percentiles.
+		 * @param bucketCount Number of buckets; larger values share an overflow bucket.
+		 */
+		RollingHistogram(size_t window, double bucketWidth, size_t bucketCount);
+
+		void add(double value);
+		void clear();
+
+		/**
+		 * @brief Gets the value below which the given fraction of the window falls.
+		 *
+		 * @param fraction Fraction in [0, 1], e.g. 0.99 for the 99th percentile.
+		 *
+		 * @return The upper edge of the bucket holding the percentile, capped at the window's
+		 * maximum; 0 if the window is empty.
+		 */
+		[[nodiscard]] double percentile(double fraction) const;
+
+		[[nodiscard]] double max() const;
+
+		[[nodiscard]] double average() const noexcept
+		{
+			return m_count > 0 ? m_sum / static_cast<double>(m_count) : 0.0;
+		}
+
+		[[nodiscard]] size_t count() const noexcept
+		{
+			return m_count;
+		}
+
+		/**
+		 * @brief Gets a value of the window.
+		 *
+		 * @param age 0 for the most recent value, up to `count() - 1` for the oldest.
+		 */
+		[[nodiscard]] double recent(size_t age) const noexcept
+		{
+			return m_values[(m_next + m_values.size() - 1 - age) % m_values.size()];
+		}
+
+	private:
+		[[nodiscard]] size_t bucketOf(double value) const noexcept;
+	};
+
+
+	/**
+	 * @brief The metrics tracked by `FrameStats`.
+	 */
+	export enum FrameMetric : int
+	{
+		FRAME_TIME,				///< Time between consecutive frame marks.
+		FRAME_CPU_WAIT,			///< Time the CPU spent blocked on the GPU or display in a frame.
+		FRAME_PRESENT_INTERVAL, ///< Time between consecutive presents, as seen by the display.
+		FRAME_METRIC_COUNT,
+	};
+
+
+	/**
+	 * @brief Distribution of a metric over the rolling window, in seconds.
+	 */
+	export struct FrameMetricSummary
+	{
+		size_t count{};
+		double average{};
+		double p50{};
+		double p95{};
+		double p99{};
+		double max{};
+	};
+
+
+	/**
+	 * @brief A frame that exceeded the frame budget.
+	 */
+	export struct FrameHitch
+	{
+		uint64_t frame{};
+		double frameTime{};
+	};
+
+
+	/**
+	 * @brief Frame pacing statistics over a rolling window of frames.
+	 *
+	 * Frames are marked by `Window::pollEvents`, CPU waits and presents are reported by the
+	 * graphics backend. Summaries can be polled at any time or every frame of the window dumped
+	 * to CSV, e.g. to fail a benchmark run when p99 frame time regresses.
+	 *
+	 * @code
+	 * FrameStats::instance().setBudget(1.0 / 120.0);
+	 * ...
+	 * const FrameMetricSummary frameTime{FrameStats::instance().getSummary(FRAME_TIME)};
+	 * if (frameTime.p99 > 1.0 / 60.0) { ... }
+	 * @endcode
+	 */
+	export class FrameStats
+	{
+		mutable std::mutex m_mutex;
+		std::vector<RollingHistogram> m_histograms;
+		std::vector<FrameHitch> m_hitches; ///< Ring of the last `MAX_HITCHES` hitches.
+
+		/// Present interval of each frame of the window, by frame number; negative if none.
+		std::vector<double> m_framePresents;
+		double m_budget;
+		double m_lastFrame{-1.0};
+		double m_lastPresent{-1.0};
+		double m_cpuWait{};
+		double m_presentInterval{-1.0}; ///< Latest present interval of the current frame.
+		uint64_t m_frameCount{};
+		uint64_t m_hitchCount{};
+
+	public:
+		/// Number of most recent frames summarized.
+		static constexpr size_t WINDOW_SIZE{1024};
+
+		/// Number of most recent hitches kept.
+		static constexpr size_t MAX_HITCHES{64};
+
+		/**
+		 * @param budget Target frame time in seconds; longer frames are counted as hitches.
+		 */
+		explicit FrameStats(double budget = 1.0 / 60.0);
+
+		/**
+		 * @brief Gets the engine-wide stats, fed by `Window` and the graphics backend.
+		 */
+		static FrameStats& instance();
+
+		/**
+		 * @brief Ends the current frame at the current time.
+		 */
+		void markFrame();
+
+		/**
+		 * @brief Ends the current frame.
+		 *
+		 * @param timestamp Time of the frame boundary in seconds, from a monotonic clock.
+		 */
+		void markFrame(double timestamp);
+
+		/**
+		 * @brief Adds time the CPU spent blocked during the current frame.
+		 */
+		void addCpuWait(double seconds);
+
+		/**
+		 * @brief Reports that a frame reached the display. May be called from any thread.
+		 *
+		 * @param timestamp Time the frame was presented in seconds, from a monotonic clock.
+		 */
+		void recordPresent(double timestamp);
+
+		void setBudget(double seconds);
+		[[nodiscard]] double getBudget() const;
+
+		/**
+		 * @brief Gets the distribution of a metric over the last `WINDOW_SIZE` samples.
+		 */
+		[[nodiscard]] FrameMetricSummary getSummary(FrameMetric metric) const;
+
+		[[nodiscard]] uint64_t frameCount() const;
+		[[nodiscard]] uint64_t hitchCount() const;
+
+		/**
+		 * @brief Gets the most recent hitches, oldest first.
+		 */
+		[[nodiscard]] std::vector<FrameHitch> getHitches() const;
+
+		/**
+		 * @brief Writes the frames of the rolling window as CSV, oldest first.
+		 *
+		 * The present interval of a frame is the latest one reported while it ran, left empty if
+		 * there was none. Presents complete a few frames after they are encoded, so it shows the
+		 * display's pacing at the time rather than that of the frame itself.
+		 *
+		 * @param path Path of the file to write.
+		 *
+		 * @return true if the file was written.
+		 */
+		bool writeCsv(const std::string& path) const;
+
+		/**
+		 * @brief Discards all samples, keeping the budget.
+		 */
+		void reset();
+	};
+} // namespace lune
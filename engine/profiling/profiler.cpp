@@ -0,0 +1,259 @@
+module;
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+module lune.profiler;
+
+import lune.memory;
+
+namespace lune
+{
+	namespace
+	{
+		/**
+		 * @brief Zones of one thread. Only the owning thread writes; readers see the first `count`
+		 * events of the current generation.
+		 */
+		struct ThreadBuffer
+		{
+			std::unique_ptr<ProfileEvent[]> events{
+					std::make_unique<ProfileEvent[]>(Profiler::THREAD_BUFFER_CAPACITY)};
+			TrackedAllocation allocation{MEMORY_TAG_PROFILER,
+										 Profiler::THREAD_BUFFER_CAPACITY * sizeof(ProfileEvent)};
+			std::atomic<size_t> count{};
+			std::atomic<uint32_t> generation{}; ///< Capture the events belong to.
+			uint32_t threadId{};
+			std::string name; ///< Guarded by `registryMutex`.
+		};
+
+		std::mutex registryMutex;
+
+		/// Interned zone names; set nodes never move, so their strings stay put.
+		std::set<std::string, std::less<>> internedNames;
+
+		/// Buffers are never freed, so threads that exit mid-capture still show up in the trace.
+		std::vector<std::unique_ptr<ThreadBuffer>> threadBuffers;
+		thread_local ThreadBuffer* currentBuffer{};
+
+		/// Frames get their own track (tid 0) so they don't overlap the zones of the main thread.
+		/// Allocated by the first capture.
+		std::unique_ptr<ThreadBuffer> frameBuffer;
+		uint64_t lastFrameTicks{};
+
+		std::atomic<uint32_t> captureGeneration{};
+		std::atomic<size_t> droppedZoneCount{};
+
+		// Clock calibration of the last capture
+		uint64_t startTicks{};
+		uint64_t endTicks{};
+		std::chrono::steady_clock::time_point startTime{};
+		std::chrono::steady_clock::time_point endTime{};
+
+		ThreadBuffer& threadBuffer()
+		{
+			if (!currentBuffer)
+			{
+				std::lock_guard lock(registryMutex);
+				auto& buffer{threadBuffers.emplace_back(std::make_unique<ThreadBuffer>())};
+				buffer->threadId = static_cast<uint32_t>(threadBuffers.size());
+				buffer->name = "Thread " + std::to_string(buffer->threadId);
+				currentBuffer = buffer.get();
+			}
+
+			return *currentBuffer;
+		}
+
+		void push(ThreadBuffer& buffer, const ProfileEvent& event) noexcept
+		{
+			const uint32_t generation{captureGeneration.load(std::memory_order_acquire)};
+			size_t index{buffer.count.load(std::memory_order_relaxed)};
+
+			// First zone of a new capture; the count is cleared before the generation is
+			// published so readers never pair the new generation with stale events
+			if (buffer.generation.load(std::memory_order_relaxed) != generation)
+			{
+				index = 0;
+				buffer.count.store(0, std::memory_order_relaxed);
+				buffer.generation.store(generation, std::memory_order_release);
+			}
+
+			if (index >= Profiler::THREAD_BUFFER_CAPACITY)
+			{
+				droppedZoneCount.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+
+			buffer.events[index] = event;
+			buffer.count.store(index + 1, std::memory_order_release);
+		}
+
+		void writeJsonString(std::ostream& stream, const std::string_view text)
+		{
+			stream << '"';
+			for (const char c : text)
+			{
+				if (c == '"' || c == '\\')
+					stream << '\\' << c;
+				else if (static_cast<unsigned char>(c) >= 0x20)
+					stream << c;
+			}
+			stream << '"';
+		}
+
+		void writeThread(std::ostream& stream, const ThreadBuffer& buffer, const uint32_t generation,
+						 const double microsecondsPerTick, bool& first)
+		{
+			if (buffer.generation.load(std::memory_order_acquire) != generation)
+				return;
+
+			const size_t count{buffer.count.load(std::memory_order_acquire)};
+			if (count == 0)
+				return;
+
+			stream << (first ? "" : ",\n") << R"({"ph":"M","pid":1,"tid":)" << buffer.threadId
+				   << R"(,"name":"thread_name","args":{"name":)";
+			writeJsonString(stream, buffer.name);
+			stream << "}}";
+			first = false;
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				const ProfileEvent& event = buffer.events[i];
+
+				// Zones opened before the capture started
+				if (event.start < startTicks)
+					continue;
+
+				stream << R"(,
+{"ph":"X","pid":1,"tid":)"
+					   << buffer.threadId << R"(,"name":)";
+				writeJsonString(stream, event.name);
+				stream << R"(,"ts":)"
+					   << static_cast<double>(event.start - startTicks) * microsecondsPerTick
+					   << R"(,"dur":)"
+					   << static_cast<double>(event.end - event.start) * microsecondsPerTick << '}';
+			}
+		}
+	} // namespace
+
+	void Profiler::beginCapture()
+	{
+		m_capturing.store(false, std::memory_order_relaxed);
+		captureGeneration.fetch_add(1, std::memory_order_acq_rel);
+		droppedZoneCount.store(0, std::memory_order_relaxed);
+		lastFrameTicks = 0;
+
+		if (!frameBuffer)
+		{
+			frameBuffer = std::make_unique<ThreadBuffer>();
+			frameBuffer->name = "Frames";
+		}
+
+		startTime = std::chrono::steady_clock::now();
+		startTicks = now();
+		m_capturing.store(true, std::memory_order_release);
+	}
+
+	void Profiler::endCapture()
+	{
+		if (!m_capturing.exchange(false, std::memory_order_acq_rel))
+			return;
+
+		endTicks = now();
+		endTime = std::chrono::steady_clock::now();
+
+		if (const size_t dropped{droppedZones()}; dropped > 0)
+		{
+			std::cerr << "Profiler dropped " << dropped << " zones; thread buffers are full.\n";
+		}
+	}
+
+	bool Profiler::exportChromeTrace(const std::string& path)
+	{
+		if (isCapturing())
+			endCapture();
+
+		std::ofstream stream(path);
+		if (!stream)
+		{
+			std::cerr << "Failed to write profiler trace: " << path << '\n';
+			return false;
+		}
+
+		const double elapsedMicroseconds{
+				std::chrono::duration<double, std::micro>(endTime - startTime).count()};
+		const double microsecondsPerTick{
+				endTicks > startTicks ? elapsedMicroseconds / static_cast<double>(endTicks - startTicks)
+									  : 0.0};
+		const uint32_t generation{captureGeneration.load(std::memory_order_acquire)};
+
+		stream.precision(3);
+		stream << std::fixed << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+		bool first{true};
+		if (frameBuffer)
+			writeThread(stream, *frameBuffer, generation, microsecondsPerTick, first);
+		{
+			std::lock_guard lock(registryMutex);
+			for (const auto& buffer : threadBuffers)
+				writeThread(stream, *buffer, generation, microsecondsPerTick, first);
+		}
+
+		stream << "\n]}\n";
+		return stream.good();
+	}
+
+	void Profiler::markFrame() noexcept
+	{
+		// Acquire pairs with `beginCapture` so the frame buffer is visible
+		if (!m_capturing.load(std::memory_order_acquire))
+			return;
+
+		const uint64_t ticks{now()};
+		if (lastFrameTicks != 0)
+			push(*frameBuffer, {"Frame", lastFrameTicks, ticks});
+
+		lastFrameTicks = ticks;
+	}
+
+	void Profiler::setThreadName(const std::string& name)
+	{
+		ThreadBuffer& buffer = threadBuffer();
+
+		std::lock_guard lock(registryMutex);
+		buffer.name = name;
+	}
+
+	const char* Profiler::intern(const std::string_view name)
+	{
+		std::lock_guard lock(registryMutex);
+
+		auto it{internedNames.find(name)};
+		if (it == internedNames.end())
+			it = internedNames.emplace(name).first;
+		return it->c_str();
+	}
+
+	void Profiler::recordZone(const char* name, const uint64_t start, const uint64_t end) noexcept
+	{
+		if (!isCapturing())
+			return;
+
+		push(threadBuffer(), {name, start, end});
+	}
+
+	size_t Profiler::droppedZones() noexcept
+	{
+		return droppedZoneCount.load(std::memory_order_relaxed);
+	}
+} // namespace lune
@@ -0,0 +1,151 @@
+module;
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <x86intrin.h>
+#endif
+export module lune.profiler;
+
+export import :frame_stats;
+
+namespace lune
+{
+	/**
+	 * @brief A completed zone as stored in a thread's buffer. Times are raw `Profiler::now()`
+	 * ticks.
+	 */
+	export struct ProfileEvent
+	{
+		const char* name{};
+		uint64_t start{};
+		uint64_t end{};
+	};
+
+
+	/**
+	 * @brief Low-overhead instrumenting CPU profiler.
+	 *
+	 * Zones are placed with the `LUNE_ZONE` macro from `<lune/profiler.hpp>`. Every thread writes
+	 * completed zones into its own preallocated buffer, so recording is wait-free and never
+	 * allocates; buffers are only read when a capture is exported. Timestamps come from the CPU
+	 * cycle counter (`rdtsc`, `cntvct_el0`) where available and are converted to wall time with a
+	 * calibration taken at the start and end of each capture.
+	 *
+	 * @code
+	 * Profiler::beginCapture();
+	 * // ... run some frames ...
+	 * Profiler::endCapture();
+	 * Profiler::exportChromeTrace("trace.json"); // Open in ui.perfetto.dev or chrome://tracing
+	 * @endcode
+	 */
+	export class Profiler
+	{
+		static inline std::atomic<bool> m_capturing{};
+
+	public:
+		/// Zones recorded per thread and capture; further zones are dropped.
+		static constexpr size_t THREAD_BUFFER_CAPACITY{1 << 16};
+
+		/**
+		 * @brief Starts a capture, discarding the zones of any previous capture.
+		 */
+		static void beginCapture();
+
+		/**
+		 * @brief Stops recording zones. Zones still open at this point are not recorded.
+		 */
+		static void endCapture();
+
+		[[nodiscard]] static bool isCapturing() noexcept
+		{
+			return m_capturing.load(std::memory_order_relaxed);
+		}
+
+		/**
+		 * @brief Writes the last capture in the Chrome trace event format, readable by Perfetto and
+		 * chrome://tracing.
+		 *
+		 * @param path Path of the JSON file to write.
+		 *
+		 * @return true if the file was written.
+		 */
+		static bool exportChromeTrace(const std::string& path);
+
+		/**
+		 * @brief Ends the current frame and starts the next one. Frames are shown on their own
+		 * track in the trace. Called by `Window::pollEvents`; only ever call it from one thread.
+		 */
+		static void markFrame() noexcept;
+
+		/**
+		 * @brief Names the calling thread in exported traces.
+		 */
+		static void setThreadName(const std::string& name);
+
+		/**
+		 * @brief Gets a copy of a zone name that lives as long as the program, for names built at
+		 * runtime. Interning the same name again returns the same pointer.
+		 */
+		[[nodiscard]] static const char* intern(std::string_view name);
+
+		/**
+		 * @brief Records a completed zone on the calling thread. Prefer `LUNE_ZONE`.
+		 */
+		static void recordZone(const char* name, uint64_t start, uint64_t end) noexcept;
+
+		/**
+		 * @brief Gets the number of zones dropped because a thread buffer was full.
+		 */
+		[[nodiscard]] static size_t droppedZones() noexcept;
+
+		/**
+		 * @brief Reads the profiler clock.
+		 *
+		 * @return A monotonic tick count in unspecified units.
+		 */
+		[[nodiscard]] static uint64_t now() noexcept
+		{
+#if defined(__x86_64__) || defined(_M_X64)
+			return __rdtsc();
+#elif defined(__aarch64__)
+			uint64_t ticks;
+			asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+			return ticks;
+#else
+			return static_cast<uint64_t>(
+					std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+		}
+	};
+
+
+	/**
+	 * @brief Records the lifetime of a scope as a zone. Created by `LUNE_ZONE`.
+	 */
+	export class ProfileZone
+	{
+		const char* m_name;
+		uint64_t m_start{};
+
+	public:
+		explicit ProfileZone(const char* name) noexcept : m_name(name)
+		{
+			if (Profiler::isCapturing())
+				m_start = Profiler::now();
+		}
+
+		~ProfileZone()
+		{
+			if (m_start != 0)
+				Profiler::recordZone(m_name, m_start, Profiler::now());
+		}
+
+		ProfileZone(const ProfileZone&) = delete;
+		ProfileZone& operator=(const ProfileZone&) = delete;
+	};
+} // namespace lune
@@ -0,0 +1,382 @@
+module;
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <lune/profiler.hpp>
+#include <memory_resource>
+#include <vector>
+module lune;
+
+namespace lune
+{
+	namespace
+	{
+		constexpr uint32_t SAH_BIN_COUNT{12};
+
+		/// Subtrees with fewer primitives are built on the current thread.
+		constexpr uint32_t PARALLEL_BUILD_THRESHOLD{4096};
+
+		/// Refits may loosen the tree; past this cost ratio a rebuild is cheaper than traversal.
+		constexpr float REBUILD_COST_RATIO{1.5f};
+
+		/// Cost the ratio applies to at least, in square world units. Trees of points or collinear
+		/// boxes cost nothing, and would otherwise be rebuilt after any movement.
+		constexpr float MIN_REBUILD_BASELINE{1.0f};
+
+		float axisValue(const Vec3& v, const int axis) noexcept
+		{
+			return axis == 0 ? v.x : axis == 1 ? v.y : v.z;
+		}
+
+		struct Bin
+		{
+			Aabb bounds{};
+			uint32_t count{};
+		};
+	} // namespace
+
+
+	struct Bvh::BuildContext
+	{
+		std::vector<Vec3> centroids;
+		std::atomic<uint32_t> nodeCount{1};
+		JobSystem* jobs{};
+		JobCounter counter;
+	};
+
+
+	uint32_t Bvh::insert(const Aabb& bounds, const uint32_t userData)
+	{
+		uint32_t proxy;
+		if (!m_freeProxies.empty())
+		{
+			proxy = m_freeProxies.back();
+			m_freeProxies.pop_back();
+		}
+		else
+		{
+			proxy = static_cast<uint32_t>(m_proxies.size());
+			m_proxies.emplace_back();
+		}
+
+		m_proxies[proxy] = {bounds, userData, true};
+		m_needsRebuild = true;
+		return proxy;
+	}
+
+	void Bvh::remove(const uint32_t proxy)
+	{
+		if (proxy >= m_proxies.size() || !m_proxies[proxy].alive)
+			return;
+
+		m_proxies[proxy].alive = false;
+		m_freeProxies.push_back(proxy);
+		m_needsRebuild = true;
+	}
+
+	void Bvh::update(const uint32_t proxy, const Aabb& bounds)
+	{
+		m_proxies[proxy].bounds = bounds;
+		m_needsRefit = true;
+	}
+
+	void Bvh::commit(JobSystem* jobs)
+	{
+		if (m_needsRebuild)
+		{
+			rebuild(jobs);
+			return;
+		}
+
+		if (m_needsRefit)
+		{
+			refit();
+			if (cost() > std::max(m_builtCost, MIN_REBUILD_BASELINE) * REBUILD_COST_RATIO)
+				rebuild(jobs);
+		}
+	}
+
+	void Bvh::rebuild(JobSystem* jobs)
+	{
+		LUNE_ZONE("Bvh::rebuild");
+		++m_rebuildCount;
+		m_needsRebuild = false;
+		m_needsRefit = false;
+
+		m_primitives.clear();
+		for (uint32_t i = 0; i < m_proxies.size(); ++i)
+		{
+			if (m_proxies[i].alive)
+				m_primitives.push_back(i);
+		}
+
+		const auto primitiveCount{static_cast<uint32_t>(m_primitives.size())};
+		if (primitiveCount == 0)
+		{
+			m_nodes.clear();
+			m_nodeCount = 0;
+			m_builtCost = 0.0f;
+			return;
+		}
+
+		BuildContext context;
+		context.jobs = jobs;
+		context.centroids.resize(m_proxies.size());
+		for (const uint32_t proxy : m_primitives)
+			context.centroids[proxy] = m_proxies[proxy].bounds.center();
+
+		// A binary tree with at most one leaf per primitive
+		m_nodes.resize(2 * static_cast<size_t>(primitiveCount) - 1);
+		buildNode(context, 0, 0, primitiveCount);
+
+		if (jobs)
+			jobs->wait(context.counter);
+
+		m_nodeCount = context.nodeCount.load();
+		m_builtCost = cost();
+	}
+
+	void Bvh::buildNode(BuildContext& context, const uint32_t nodeIndex, const uint32_t begin,
+						const uint32_t end)
+	{
+		Node& node = m_nodes[nodeIndex];
+		const uint32_t count{end - begin};
+
+		Aabb bounds{};
+		Aabb centroidBounds{};
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			bounds.merge(m_proxies[m_primitives[i]].bounds);
+			centroidBounds.merge(context.centroids[m_primitives[i]]);
+		}
+		node.bounds = bounds;
+
+		if (count <= MAX_LEAF_SIZE)
+		{
+			node.first = begin;
+			node.count = count;
+			return;
+		}
+
+		const Vec3 extent = centroidBounds.max - centroidBounds.min;
+		const int axis{extent.x > extent.y && extent.x > extent.z ? 0 : extent.y > extent.z ? 1 : 2};
+		const float axisMin{axisValue(centroidBounds.min, axis)};
+		const float axisExtent{axisValue(extent, axis)};
+
+		uint32_t* primitives{m_primitives.data()};
+		uint32_t mid{begin + count / 2};
+
+		if (axisExtent > 0.0f)
+		{
+			const float scale{static_cast<float>(SAH_BIN_COUNT) / axisExtent};
+			const auto binOf = [&](const uint32_t proxy)
+			{
+				const auto bin{static_cast<uint32_t>(
+						(axisValue(context.centroids[proxy], axis) - axisMin) * scale)};
+				return std::min(bin, SAH_BIN_COUNT - 1);
+			};
+
+			Bin bins[SAH_BIN_COUNT]{};
+			for (uint32_t i = begin; i < end; ++i)
+			{
+				Bin& bin = bins[binOf(primitives[i])];
+				bin.bounds.merge(m_proxies[primitives[i]].bounds);
+				++bin.count;
+			}
+
+			// Sweep from the right to get the cost of everything after each split plane
+			float rightArea[SAH_BIN_COUNT]{};
+			uint32_t rightCount[SAH_BIN_COUNT]{};
+			Aabb accumulated{};
+			uint32_t accumulatedCount{};
+			for (uint32_t i = SAH_BIN_COUNT - 1; i > 0; --i)
+			{
+				accumulated.merge(bins[i].bounds);
+				accumulatedCount += bins[i].count;
+				rightArea[i] = accumulated.isEmpty() ? 0.0f : accumulated.surfaceArea();
+				rightCount[i] = accumulatedCount;
+			}
+
+			float bestCost{std::numeric_limits<float>::max()};
+			uint32_t bestSplit{0};
+			accumulated = {};
+			accumulatedCount = 0;
+			for (uint32_t i = 0; i < SAH_BIN_COUNT - 1; ++i)
+			{
+				accumulated.merge(bins[i].bounds);
+				accumulatedCount += bins[i].count;
+
+				const float leftArea{accumulated.isEmpty() ? 0.0f : accumulated.surfaceArea()};
+				const float splitCost{leftArea * static_cast<float>(accumulatedCount) +
+									  rightArea[i + 1] * static_cast<float>(rightCount[i + 1])};
+				if (splitCost < bestCost)
+				{
+					bestCost = splitCost;
+					bestSplit = i;
+				}
+			}
+
+			uint32_t* split{std::partition(primitives + begin, primitives + end,
+										   [&](const uint32_t proxy)
+										   { return binOf(proxy) <= bestSplit; })};
+			mid = static_cast<uint32_t>(split - primitives);
+		}
+
+		// Degenerate splits (e.g. all centroids in one bin) fall back to a median split
+		if (mid == begin || mid == end)
+		{
+			mid = begin + count / 2;
+			std::nth_element(primitives + begin, primitives + mid, primitives + end,
+							 [&](const uint32_t a, const uint32_t b)
+							 {
+								 return axisValue(context.centroids[a], axis) <
+										axisValue(context.centroids[b], axis);
+							 });
+		}
+
+		const uint32_t children{context.nodeCount.fetch_add(2, std::memory_order_relaxed)};
+		node.first = children;
+		node.count = 0;
+
+		if (context.jobs && count >= PARALLEL_BUILD_THRESHOLD)
+		{
+			context.jobs->submit([this, &context, children, begin, mid]
+								 { buildNode(context, children, begin, mid); },
+								 &context.counter);
+		}
+		else
+		{
+			buildNode(context, children, begin, mid);
+		}
+
+		buildNode(context, children + 1, mid, end);
+	}
+
+	void Bvh::refit()
+	{
+		LUNE_ZONE("Bvh::refit");
+		m_needsRefit = false;
+
+		// Children are always allocated after their parent, so a reverse sweep visits them first
+		for (size_t i = m_nodeCount; i-- > 0;)
+		{
+			Node& node = m_nodes[i];
+			if (node.count > 0)
+			{
+				Aabb bounds{};
+				for (uint32_t p = node.first; p < node.first + node.count; ++p)
+					bounds.merge(m_proxies[m_primitives[p]].bounds);
+				node.bounds = bounds;
+			}
+			else
+			{
+				node.bounds = Aabb::merge(m_nodes[node.first].bounds, m_nodes[node.first + 1].bounds);
+			}
+		}
+	}
+
+	float Bvh::cost() const noexcept
+	{
+		float total{};
+		for (size_t i = 0; i < m_nodeCount; ++i)
+		{
+			if (m_nodes[i].count == 0)
+				total += m_nodes[i].bounds.surfaceArea();
+		}
+		return total;
+	}
+
+	void Bvh::query(const Frustum& frustum, std::vector<uint32_t>& result) const
+	{
+		if (m_nodeCount == 0)
+			return;
+
+		FrameVector<uint32_t> stack{FrameArena::resource()};
+		stack.reserve(64);
+		stack.push_back(0);
+
+		while (!stack.empty())
+		{
+			const Node& node = m_nodes[stack.back()];
+			const uint32_t nodeIndex{stack.back()};
+			stack.pop_back();
+
+			const CullResult cull{frustum.classify(node.bounds)};
+			if (cull == CULL_OUTSIDE)
+				continue;
+
+			if (cull == CULL_INSIDE)
+			{
+				appendSubtree(nodeIndex, result);
+				continue;
+			}
+
+			if (node.count == 0)
+			{
+				stack.push_back(node.first);
+				stack.push_back(node.first + 1);
+				continue;
+			}
+
+			for (uint32_t p = node.first; p < node.first + node.count; ++p)
+			{
+				const Proxy& proxy = m_proxies[m_primitives[p]];
+				if (proxy.alive && frustum.intersects(proxy.bounds))
+					result.push_back(proxy.userData);
+			}
+		}
+	}
+
+	void Bvh::query(const Aabb& bounds, std::vector<uint32_t>& result) const
+	{
+		if (m_nodeCount == 0)
+			return;
+
+		FrameVector<uint32_t> stack{FrameArena::resource()};
+		stack.reserve(64);
+		stack.push_back(0);
+
+		while (!stack.empty())
+		{
+			const Node& node = m_nodes[stack.back()];
+			stack.pop_back();
+
+			if (!node.bounds.intersects(bounds))
+				continue;
+
+			if (node.count == 0)
+			{
+				stack.push_back(node.first);
+				stack.push_back(node.first + 1);
+				continue;
+			}
+
+			for (uint32_t p = node.first; p < node.first + node.count; ++p)
+			{
+				const Proxy& proxy = m_proxies[m_primitives[p]];
+				if (proxy.alive && proxy.bounds.intersects(bounds))
+					result.push_back(proxy.userData);
+			}
+		}
+	}
+
+	void Bvh::appendSubtree(const uint32_t nodeIndex, std::vector<uint32_t>& result) const
+	{
+		const Node& node = m_nodes[nodeIndex];
+		if (node.count == 0)
+		{
+			appendSubtree(node.first, result);
+			appendSubtree(node.first + 1, result);
+			return;
+		}
+
+		for (uint32_t p = node.first; p < node.first + node.count; ++p)
+		{
+			const Proxy& proxy = m_proxies[m_primitives[p]];
+			if (proxy.alive)
+				result.push_back(proxy.userData);
+		}
+	}
+} // namespace lune
@@ -0,0 +1,155 @@
+module;
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+export module lune:bvh;
+
+import lune.jobs;
+import lune.memory;
+import :bounds;
+
+namespace lune
+{
+	export inline constexpr uint32_t BVH_NULL_PROXY{std::numeric_limits<uint32_t>::max()};
+
+
+	/**
+	 * @brief Bounding volume hierarchy over dynamic objects, used to find the objects inside a
+	 * view frustum or region without testing each one.
+	 *
+	 * Objects are registered as proxies. Changes are batched and applied by `commit()`, typically
+	 * once per frame before culling: moved proxies only refit the node bounds, while inserted or
+	 * removed proxies (or a tree degraded by too many refits) trigger a full rebuild, optionally
+	 * spread across a `JobSystem`.
+	 */
+	export class Bvh
+	{
+		struct Node
+		{
+			Aabb bounds{};
+			uint32_t first{}; ///< First primitive for leaves; left child for inner nodes.
+			uint32_t count{}; ///< Number of primitives; 0 for inner nodes.
+		};
+
+		struct Proxy
+		{
+			Aabb bounds{};
+			uint32_t userData{};
+			bool alive{};
+		};
+
+		struct BuildContext;
+
+		template <typename T>
+		using SceneVector = std::vector<T, TaggedAllocator<T, MEMORY_TAG_SCENE>>;
+
+		SceneVector<Node> m_nodes;
+		SceneVector<uint32_t> m_primitives; ///< Proxy indices, grouped by leaf.
+		SceneVector<Proxy> m_proxies;
+		SceneVector<uint32_t> m_freeProxies;
+
+		size_t m_nodeCount{};
+		float m_builtCost{};
+		uint64_t m_rebuildCount{};
+		bool m_needsRebuild{};
+		bool m_needsRefit{};
+
+	public:
+		static constexpr uint32_t MAX_LEAF_SIZE{4};
+
+		/**
+		 * @brief Registers an object. It is added to the tree on the next `commit()`.
+		 *
+		 * @param bounds World space bounds of the object.
+		 * @param userData Value reported by queries, e.g. an entity or draw index.
+		 *
+		 * @return The proxy identifying the object.
+		 */
+		uint32_t insert(const Aabb& bounds, uint32_t userData);
+
+		/**
+		 * @brief Unregisters an object. It is no longer reported by queries.
+		 */
+		void remove(uint32_t proxy);
+
+		/**
+		 * @brief Updates the bounds of a moved object. Node bounds are refit on the next
+		 * `commit()`.
+		 */
+		void update(uint32_t proxy, const Aabb& bounds);
+
+		/**
+		 * @brief Applies pending changes with the cheapest operation that keeps the tree valid.
+		 *
+		 * @param jobs Job system used if a rebuild is needed; nullptr to build on the calling
+		 * thread.
+		 */
+		void commit(JobSystem* jobs = nullptr);
+
+		/**
+		 * @brief Rebuilds the tree from scratch using binned SAH splits. Top level subtrees are
+		 * built in parallel when a job system is given.
+		 */
+		void rebuild(JobSystem* jobs = nullptr);
+
+		/**
+		 * @brief Recomputes node bounds bottom-up without changing the topology.
+		 */
+		void refit();
+
+		/**
+		 * @brief Appends the user data of every proxy whose bounds intersect the frustum.
+		 * Subtrees fully inside the frustum are accepted without further tests.
+		 */
+		void query(const Frustum& frustum, std::vector<uint32_t>& result) const;
+
+		/**
+		 * @brief Appends the user data of every proxy whose bounds intersect the box.
+		 */
+		void query(const Aabb& bounds, std::vector<uint32_t>& result) const;
+
+		[[nodiscard]] const Aabb& bounds(const uint32_t proxy) const noexcept
+		{
+			return m_proxies[proxy].bounds;
+		}
+
+		[[nodiscard]] uint32_t userData(const uint32_t proxy) const noexcept
+		{
+			return m_proxies[proxy].userData;
+		}
+
+		[[nodiscard]] size_t proxyCount() const noexcept
+		{
+			return m_proxies.size() - m_freeProxies.size();
+		}
+
+		[[nodiscard]] size_t nodeCount() const noexcept
+		{
+			return m_nodeCount;
+		}
+
+		[[nodiscard]] bool isEmpty() const noexcept
+		{
+			return m_nodeCount == 0;
+		}
+
+		/**
+		 * @brief Gets the number of full rebuilds, whether requested or done by `commit()`.
+		 */
+		[[nodiscard]] uint64_t rebuildCount() const noexcept
+		{
+			return m_rebuildCount;
+		}
+
+	private:
+		void buildNode(BuildContext& context, uint32_t nodeIndex, uint32_t begin, uint32_t end);
+
+		/**
+		 * @return The summed surface area of the inner nodes, a proxy for the traversal cost.
+		 */
+		[[nodiscard]] float cost() const noexcept;
+
+		void appendSubtree(uint32_t nodeIndex, std::vector<uint32_t>& result) const;
+	};
+} // namespace lune
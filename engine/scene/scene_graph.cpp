@@ -0,0 +1,322 @@
+module;
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <lune/profiler.hpp>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+module lune;
+
+namespace lune
+{
+	uint32_t SceneGraph::create(const uint32_t parent, const Transform& local)
+	{
+		if (parent != SCENE_NULL_NODE && !isAlive(parent))
+			throw std::invalid_argument("Cannot create a node under a destroyed parent");
+
+		uint32_t node;
+		if (!m_freeNodes.empty())
+		{
+			node = m_freeNodes.back();
+			m_freeNodes.pop_back();
+		}
+		else
+		{
+			node = static_cast<uint32_t>(m_nodes.size());
+			m_nodes.emplace_back();
+		}
+
+		// Appended unsorted; placed after its parent by the next sort
+		const auto position{static_cast<uint32_t>(m_parents.size())};
+		m_nodes[node] = {.position = position, .alive = true};
+		m_parents.push_back(SCENE_NULL_NODE);
+		m_subtreeEnds.push_back(position + 1);
+		m_locals.push_back(local);
+		m_localMatrices.push_back(Mat4::identity());
+		m_worlds.push_back(Mat4::identity());
+		m_flags.push_back(0);
+
+		link(node, parent);
+		markDirty(node, LOCAL_DIRTY);
+		m_needsSort = true;
+		++m_nodeCount;
+		return node;
+	}
+
+	void SceneGraph::destroy(const uint32_t node)
+	{
+		if (!isAlive(node))
+			return;
+
+		unlink(node);
+
+		std::vector<uint32_t> stack{node};
+		while (!stack.empty())
+		{
+			const uint32_t current{stack.back()};
+			stack.pop_back();
+
+			for (uint32_t child = m_nodes[current].firstChild; child != SCENE_NULL_NODE;
+				 child = m_nodes[child].nextSibling)
+			{
+				stack.push_back(child);
+			}
+
+			m_nodes[current] = {};
+			m_freeNodes.push_back(current);
+			--m_nodeCount;
+		}
+
+		m_needsSort = true;
+	}
+
+	bool SceneGraph::setParent(const uint32_t node, const uint32_t parent)
+	{
+		if (!isAlive(node) || (parent != SCENE_NULL_NODE && !isAlive(parent)))
+			return false;
+
+		for (uint32_t ancestor = parent; ancestor != SCENE_NULL_NODE;
+			 ancestor = m_nodes[ancestor].parent)
+		{
+			if (ancestor == node)
+				return false;
+		}
+
+		if (m_nodes[node].parent == parent)
+			return true;
+
+		unlink(node);
+		link(node, parent);
+		markDirty(node, 0);
+		m_needsSort = true;
+		return true;
+	}
+
+	void SceneGraph::setLocal(const uint32_t node, const Transform& local)
+	{
+		m_locals[m_nodes[node].position] = local;
+		markDirty(node, LOCAL_DIRTY);
+	}
+
+	void SceneGraph::setTranslation(const uint32_t node, const Vec3& translation)
+	{
+		m_locals[m_nodes[node].position].translation = translation;
+		markDirty(node, LOCAL_DIRTY);
+	}
+
+	void SceneGraph::setRotation(const uint32_t node, const Vec3& rotation)
+	{
+		m_locals[m_nodes[node].position].rotation = rotation;
+		markDirty(node, LOCAL_DIRTY);
+	}
+
+	void SceneGraph::setScale(const uint32_t node, const Vec3& scale)
+	{
+		m_locals[m_nodes[node].position].scale = scale;
+		markDirty(node, LOCAL_DIRTY);
+	}
+
+	void SceneGraph::update(JobSystem* jobs)
+	{
+		LUNE_ZONE("SceneGraph::update");
+
+		if (m_needsSort)
+			sort();
+
+		m_updatedCount = 0;
+		if (m_dirty.empty())
+			return;
+
+		m_dirtyPositions.clear();
+		for (const uint32_t node : m_dirty)
+		{
+			if (isAlive(node))
+				m_dirtyPositions.push_back(m_nodes[node].position);
+		}
+		m_dirty.clear();
+		std::ranges::sort(m_dirtyPositions);
+
+		// Subtrees are contiguous, so dirty nodes inside an earlier dirty subtree are covered by it
+		m_ranges.clear();
+		uint32_t covered{};
+		for (const uint32_t position : m_dirtyPositions)
+		{
+			if (position < covered)
+				continue;
+
+			covered = m_subtreeEnds[position];
+			m_ranges.push_back({position, covered});
+			m_updatedCount += covered - position;
+		}
+
+		if (!jobs || m_updatedCount <= PARALLEL_GRAIN)
+		{
+			for (const Range& range : m_ranges)
+				updateRange(range.begin, range.end);
+			return;
+		}
+
+		SceneVector<Range> tasks;
+		for (const Range& range : m_ranges)
+			split(range, tasks);
+
+		jobs->parallelFor(tasks.size(), 1,
+						  [&](const size_t begin, const size_t end)
+						  {
+							  for (size_t i = begin; i < end; ++i)
+								  updateRange(tasks[i].begin, tasks[i].end);
+						  });
+	}
+
+	void SceneGraph::markDirty(const uint32_t node, const uint8_t flags)
+	{
+		uint8_t& nodeFlags{m_flags[m_nodes[node].position]};
+		if (!(nodeFlags & QUEUED))
+			m_dirty.push_back(node);
+
+		nodeFlags |= QUEUED | flags;
+	}
+
+	void SceneGraph::link(const uint32_t node, const uint32_t parent)
+	{
+		uint32_t& head{parent == SCENE_NULL_NODE ? m_firstRoot : m_nodes[parent].firstChild};
+		if (head != SCENE_NULL_NODE)
+			m_nodes[head].previousSibling = node;
+
+		m_nodes[node].parent = parent;
+		m_nodes[node].nextSibling = head;
+		m_nodes[node].previousSibling = SCENE_NULL_NODE;
+		head = node;
+	}
+
+	void SceneGraph::unlink(const uint32_t node)
+	{
+		Node& current{m_nodes[node]};
+		if (current.previousSibling != SCENE_NULL_NODE)
+			m_nodes[current.previousSibling].nextSibling = current.nextSibling;
+		else if (current.parent != SCENE_NULL_NODE)
+			m_nodes[current.parent].firstChild = current.nextSibling;
+		else
+			m_firstRoot = current.nextSibling;
+
+		if (current.nextSibling != SCENE_NULL_NODE)
+			m_nodes[current.nextSibling].previousSibling = current.previousSibling;
+
+		current.parent = SCENE_NULL_NODE;
+		current.nextSibling = SCENE_NULL_NODE;
+		current.previousSibling = SCENE_NULL_NODE;
+	}
+
+	void SceneGraph::sort()
+	{
+		LUNE_ZONE("SceneGraph::sort");
+
+		SceneVector<uint32_t> parents(m_nodeCount);
+		SceneVector<uint32_t> subtreeEnds(m_nodeCount);
+		SceneVector<Transform> locals(m_nodeCount);
+		SceneVector<Mat4> localMatrices(m_nodeCount);
+		SceneVector<Mat4> worlds(m_nodeCount);
+		SceneVector<uint8_t> flags(m_nodeCount);
+
+		// Children are visited right after their parent, so every subtree ends up contiguous
+		std::vector<uint32_t> stack;
+		for (uint32_t root = m_firstRoot; root != SCENE_NULL_NODE; root = m_nodes[root].nextSibling)
+			stack.push_back(root);
+
+		uint32_t next{};
+		while (!stack.empty())
+		{
+			const uint32_t node{stack.back()};
+			stack.pop_back();
+
+			Node& current{m_nodes[node]};
+			const uint32_t previous{std::exchange(current.position, next)};
+			parents[next] = current.parent == SCENE_NULL_NODE ? SCENE_NULL_NODE
+															  : m_nodes[current.parent].position;
+			subtreeEnds[next] = next + 1;
+			locals[next] = m_locals[previous];
+			localMatrices[next] = m_localMatrices[previous];
+			worlds[next] = m_worlds[previous];
+			flags[next] = m_flags[previous];
+			++next;
+
+			for (uint32_t child = current.firstChild; child != SCENE_NULL_NODE;
+				 child = m_nodes[child].nextSibling)
+			{
+				stack.push_back(child);
+			}
+		}
+
+		// Descendants follow their ancestors, so a reverse pass extends each parent's range
+		for (uint32_t position = next; position-- > 0;)
+		{
+			if (parents[position] != SCENE_NULL_NODE)
+			{
+				subtreeEnds[parents[position]] =
+						std::max(subtreeEnds[parents[position]], subtreeEnds[position]);
+			}
+		}
+
+		m_parents = std::move(parents);
+		m_subtreeEnds = std::move(subtreeEnds);
+		m_locals = std::move(locals);
+		m_localMatrices = std::move(localMatrices);
+		m_worlds = std::move(worlds);
+		m_flags = std::move(flags);
+		m_needsSort = false;
+	}
+
+	void SceneGraph::updateRange(const uint32_t begin, const uint32_t end)
+	{
+		for (uint32_t position = begin; position < end; ++position)
+		{
+			if (m_flags[position] & LOCAL_DIRTY)
+			{
+				const Transform& local{m_locals[position]};
+				m_localMatrices[position] =
+						Mat4::transform(local.translation, local.rotation, local.scale);
+			}
+
+			// Mat4 stores columns first, so this is parent * local in math notation
+			const uint32_t parent{m_parents[position]};
+			m_worlds[position] = parent == SCENE_NULL_NODE
+										 ? m_localMatrices[position]
+										 : m_localMatrices[position] * m_worlds[parent];
+			m_flags[position] = 0;
+		}
+	}
+
+	void SceneGraph::split(const Range subtree, SceneVector<Range>& tasks)
+	{
+		std::vector<Range> pending{subtree};
+		while (!pending.empty())
+		{
+			const Range range{pending.back()};
+			pending.pop_back();
+
+			if (range.end - range.begin > PARALLEL_GRAIN)
+			{
+				// The root goes first; its child subtrees are then independent of each other
+				updateRange(range.begin, range.begin + 1);
+				for (uint32_t child = range.begin + 1; child < range.end;
+					 child = m_subtreeEnds[child])
+				{
+					pending.push_back({child, m_subtreeEnds[child]});
+				}
+				continue;
+			}
+
+			// Adjacent small subtrees are batched into one job; their parents are already done
+			if (!tasks.empty() && tasks.back().begin == range.end &&
+				tasks.back().end - range.begin <= PARALLEL_GRAIN)
+			{
+				tasks.back().begin = range.begin;
+			}
+			else
+			{
+				tasks.push_back(range);
+			}
+		}
+	}
+} // namespace lune
@@ -0,0 +1,190 @@
+module;
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+export module lune:scene_graph;
+
+import lune.jobs;
+import lune.memory;
+import :matrix;
+import :vector;
+
+namespace lune
+{
+	export inline constexpr uint32_t SCENE_NULL_NODE{std::numeric_limits<uint32_t>::max()};
+
+
+	/**
+	 * @brief Local transform of a scene node, relative to its parent.
+	 */
+	export struct Transform
+	{
+		Vec3 translation{};
+		Vec3 rotation{}; ///< Euler angles in radians, as taken by `Mat4::transform`.
+		Vec3 scale{1.0f, 1.0f, 1.0f};
+	};
+
+
+	/**
+	 * @brief Transform hierarchy computing the world matrix of every node.
+	 *
+	 * Nodes are stored in flat arrays sorted depth-first, so every parent precedes its children
+	 * and every subtree is a contiguous range. Changing a local transform only marks the node;
+	 * `update()` recomputes the world matrices of the marked subtrees and nothing else, so the
+	 * per-frame cost follows the number of moved nodes rather than the size of the scene.
+	 * Independent subtrees are propagated in parallel when a `JobSystem` is given.
+	 *
+	 * Creating, destroying and reparenting nodes re-sorts the arrays on the next `update()`.
+	 */
+	export class SceneGraph
+	{
+		struct Node
+		{
+			uint32_t parent{SCENE_NULL_NODE};
+			uint32_t firstChild{SCENE_NULL_NODE};
+			uint32_t nextSibling{SCENE_NULL_NODE};
+			uint32_t previousSibling{SCENE_NULL_NODE};
+			uint32_t position{}; ///< Index in the sorted arrays.
+			bool alive{};
+		};
+
+		struct Range
+		{
+			uint32_t begin;
+			uint32_t end;
+		};
+
+		enum Flags : uint8_t
+		{
+			QUEUED = 1 << 0, ///< In `m_dirty`.
+			LOCAL_DIRTY = 1 << 1, ///< Local matrix out of date.
+		};
+
+		template <typename T>
+		using SceneVector = std::vector<T, TaggedAllocator<T, MEMORY_TAG_SCENE>>;
+
+		SceneVector<Node> m_nodes; ///< Indexed by node.
+		SceneVector<uint32_t> m_freeNodes;
+		uint32_t m_firstRoot{SCENE_NULL_NODE};
+
+		// Indexed by position, in depth-first order
+		SceneVector<uint32_t> m_parents; ///< Position of the parent.
+		SceneVector<uint32_t> m_subtreeEnds; ///< One past the last position of the subtree.
+		SceneVector<Transform> m_locals;
+		SceneVector<Mat4> m_localMatrices;
+		SceneVector<Mat4> m_worlds;
+		SceneVector<uint8_t> m_flags;
+
+		SceneVector<uint32_t> m_dirty; ///< Nodes to recompute on the next update.
+		SceneVector<uint32_t> m_dirtyPositions;
+		SceneVector<Range> m_ranges;
+
+		size_t m_nodeCount{};
+		size_t m_updatedCount{};
+		bool m_needsSort{};
+
+	public:
+		/// Subtrees with fewer nodes are propagated by a single job.
+		static constexpr uint32_t PARALLEL_GRAIN{1024};
+
+		/**
+		 * @brief Creates a node. Its world matrix is computed on the next `update()`.
+		 *
+		 * @param parent Parent node; SCENE_NULL_NODE for a root.
+		 *
+		 * @return The node.
+		 *
+		 * @throws std::invalid_argument if the parent doesn't exist or was destroyed.
+		 */
+		uint32_t create(uint32_t parent = SCENE_NULL_NODE, const Transform& local = {});
+
+		/**
+		 * @brief Destroys a node and all of its descendants.
+		 */
+		void destroy(uint32_t node);
+
+		/**
+		 * @brief Moves a node, with its descendants, under another parent. The local transform
+		 * is kept, so the node moves in world space.
+		 *
+		 * @param parent New parent; SCENE_NULL_NODE to make the node a root.
+		 *
+		 * @return false if either node is destroyed, or the parent is the node itself or one of
+		 * its descendants.
+		 */
+		bool setParent(uint32_t node, uint32_t parent);
+
+		void setLocal(uint32_t node, const Transform& local);
+		void setTranslation(uint32_t node, const Vec3& translation);
+		void setRotation(uint32_t node, const Vec3& rotation);
+		void setScale(uint32_t node, const Vec3& scale);
+
+		/**
+		 * @brief Recomputes the world matrices of the nodes changed since the last update and of
+		 * their descendants.
+		 *
+		 * @param jobs Job system propagating independent subtrees in parallel; nullptr to update
+		 * on the calling thread.
+		 */
+		void update(JobSystem* jobs = nullptr);
+
+		[[nodiscard]] const Transform& local(const uint32_t node) const noexcept
+		{
+			return m_locals[m_nodes[node].position];
+		}
+
+		/**
+		 * @brief Gets the world matrix of a node as of the last `update()`.
+		 */
+		[[nodiscard]] const Mat4& world(const uint32_t node) const noexcept
+		{
+			return m_worlds[m_nodes[node].position];
+		}
+
+		[[nodiscard]] uint32_t parent(const uint32_t node) const noexcept
+		{
+			return m_nodes[node].parent;
+		}
+
+		[[nodiscard]] bool isAlive(const uint32_t node) const noexcept
+		{
+			return node < m_nodes.size() && m_nodes[node].alive;
+		}
+
+		[[nodiscard]] size_t nodeCount() const noexcept
+		{
+			return m_nodeCount;
+		}
+
+		/**
+		 * @brief Gets the number of world matrices recomputed by the last `update()`.
+		 */
+		[[nodiscard]] size_t updatedCount() const noexcept
+		{
+			return m_updatedCount;
+		}
+
+	private:
+		void markDirty(uint32_t node, uint8_t flags);
+
+		void link(uint32_t node, uint32_t parent);
+		void unlink(uint32_t node);
+
+		/**
+		 * @brief Re-sorts the arrays depth-first, dropping destroyed nodes.
+		 */
+		void sort();
+
+		/**
+		 * @brief Recomputes a range of positions whose parents are up to date.
+		 */
+		void updateRange(uint32_t begin, uint32_t end);
+
+		/**
+		 * @brief Splits a subtree into ranges of at most `PARALLEL_GRAIN` nodes that can be
+		 * updated independently, updating the roots left out of every range.
+		 */
+		void split(Range subtree, SceneVector<Range>& tasks);
+	};
+} // namespace lune
@@ -0,0 +1,73 @@
+module;
+#include <algorithm>
+#include <cstddef>
+#include <lune/profiler.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+module lune;
+
+namespace lune
+{
+	void SystemScheduler::run(World& world, JobSystem* jobs)
+	{
+		for (const std::vector<size_t>& stage : m_stages)
+		{
+			const auto runSystem{[&](const size_t begin, const size_t end)
+								 {
+									 for (size_t i = begin; i < end; ++i)
+									 {
+										 const System& system{m_systems[stage[i]]};
+										 LUNE_ZONE(system.zoneName);
+										 system.function(world);
+									 }
+								 }};
+
+			if (jobs && stage.size() > 1)
+				jobs->parallelFor(stage.size(), 1, runSystem);
+			else
+				runSystem(0, stage.size());
+		}
+	}
+
+	std::vector<std::vector<std::string>> SystemScheduler::stages() const
+	{
+		std::vector<std::vector<std::string>> names;
+		for (const std::vector<size_t>& stage : m_stages)
+		{
+			std::vector<std::string>& stageNames{names.emplace_back()};
+			for (const size_t system : stage)
+				stageNames.push_back(m_systems[system].name);
+		}
+		return names;
+	}
+
+	void SystemScheduler::add(System system)
+	{
+		system.zoneName = Profiler::intern(system.name);
+
+		// Run after everything this system conflicts with, as early as possible otherwise
+		size_t stage{};
+		for (size_t i = 0; i < m_systems.size(); ++i)
+		{
+			if (conflicts(m_systems[i], system))
+				stage = std::max(stage, m_systemStages[i] + 1);
+		}
+
+		if (stage == m_stages.size())
+			m_stages.emplace_back();
+
+		m_stages[stage].push_back(m_systems.size());
+		m_systemStages.push_back(stage);
+		m_systems.push_back(std::move(system));
+	}
+
+	bool SystemScheduler::conflicts(const System& first, const System& second) noexcept
+	{
+		if (first.exclusive || second.exclusive)
+			return true;
+
+		return (first.writes & (second.reads | second.writes)).any() ||
+			   (second.writes & first.reads).any();
+	}
+} // namespace lune
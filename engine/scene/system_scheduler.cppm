@@ -0,0 +1,93 @@
+module;
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <vector>
+export module lune:system_scheduler;
+
+import lune.jobs;
+import :world;
+
+namespace lune
+{
+	/**
+	 * @brief Runs systems over a `World`, in parallel where their component accesses allow.
+	 *
+	 * Each system declares the components it reads and writes. Two systems conflict if one writes
+	 * a component the other reads or writes; conflicting systems run in the order they were added,
+	 * all others may run at the same time. Systems are grouped into stages: every system runs
+	 * after the stages of the systems it conflicts with, and the systems of a stage run in
+	 * parallel.
+	 *
+	 * @code
+	 * scheduler.add<Position, const Velocity>("integrate",
+	 * 										   [movers = world.query<Position, const Velocity>()]
+	 * 										   (World&) mutable { movers.each(...); });
+	 * @endcode
+	 *
+	 * Systems must not make structural changes to the world (see `World`), except exclusive ones.
+	 */
+	export class SystemScheduler
+	{
+		struct System
+		{
+			std::string name;
+			const char* zoneName{}; ///< Interned, as captured zones outlive the scheduler.
+			ComponentMask reads;
+			ComponentMask writes;
+			bool exclusive{};
+			std::function<void(World&)> function;
+		};
+
+		std::vector<System> m_systems;
+		std::vector<size_t> m_systemStages;
+		std::vector<std::vector<size_t>> m_stages;
+
+	public:
+		/**
+		 * @brief Adds a system accessing the given components: `const` types are read, the
+		 * others written, as in `Query`.
+		 */
+		template <typename... Ts>
+		void add(std::string name, std::function<void(World&)> function)
+		{
+			ComponentMask reads;
+			ComponentMask writes;
+			((std::is_const_v<Ts> ? reads : writes).set(ComponentRegistry::id<Ts>()), ...);
+			add({std::move(name), {}, reads, writes, false, std::move(function)});
+		}
+
+		/**
+		 * @brief Adds a system that runs alone, after every system added before it and before
+		 * every system added after it. It may make structural changes to the world.
+		 */
+		void addExclusive(std::string name, std::function<void(World&)> function)
+		{
+			add({std::move(name), {}, {}, {}, true, std::move(function)});
+		}
+
+		/**
+		 * @brief Runs every system once.
+		 *
+		 * @param jobs Job system running the systems of a stage in parallel; nullptr to run them
+		 * on the calling thread.
+		 */
+		void run(World& world, JobSystem* jobs = nullptr);
+
+		/**
+		 * @brief Gets the names of the systems of each stage, in execution order.
+		 */
+		[[nodiscard]] std::vector<std::vector<std::string>> stages() const;
+
+		[[nodiscard]] size_t systemCount() const noexcept
+		{
+			return m_systems.size();
+		}
+
+	private:
+		void add(System system);
+
+		[[nodiscard]] static bool conflicts(const System& first, const System& second) noexcept;
+	};
+} // namespace lune
@@ -0,0 +1,235 @@
+module;
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+module lune;
+
+namespace lune
+{
+	namespace
+	{
+		size_t alignUp(const size_t value, const size_t alignment)
+		{
+			return (value + alignment - 1) / alignment * alignment;
+		}
+	} // namespace
+
+	ComponentId ComponentRegistry::add(const ComponentInfo& info)
+	{
+		const ComponentId id{m_count.fetch_add(1, std::memory_order_acq_rel)};
+		if (id >= MAX_COMPONENTS)
+			throw std::length_error("Too many component types");
+
+		m_infos[id] = info;
+		return id;
+	}
+
+	void Archetype::ChunkDeleter::operator()(std::byte* data) const noexcept
+	{
+		MemoryTracker::recordFree(MEMORY_TAG_SCENE, bytes);
+		::operator delete(data, std::align_val_t{ComponentRegistry::MAX_ALIGNMENT});
+	}
+
+	Archetype::Archetype(std::vector<ComponentId> components) : m_components(std::move(components))
+	{
+		std::ranges::sort(m_components);
+		for (const ComponentId component : m_components)
+			m_mask.set(component);
+
+		size_t rowBytes{sizeof(Entity)};
+		for (const ComponentId component : m_components)
+			rowBytes += ComponentRegistry::info(component).size;
+
+		// Every array may need padding up to its alignment; large rows get one per chunk
+		size_t padding{};
+		for (const ComponentId component : m_components)
+			padding += ComponentRegistry::info(component).alignment - 1;
+
+		m_chunkCapacity = static_cast<uint32_t>(
+				std::max<size_t>(1, CHUNK_SIZE > padding ? (CHUNK_SIZE - padding) / rowBytes : 1));
+
+		size_t offset{m_chunkCapacity * sizeof(Entity)};
+		for (const ComponentId component : m_components)
+		{
+			const ComponentInfo& info{ComponentRegistry::info(component)};
+			offset = alignUp(offset, info.alignment);
+			m_offsets.push_back(offset);
+			offset += m_chunkCapacity * info.size;
+		}
+		m_chunkBytes = alignUp(offset, ComponentRegistry::MAX_ALIGNMENT);
+	}
+
+	int Archetype::column(const ComponentId component) const noexcept
+	{
+		const auto it{std::ranges::lower_bound(m_components, component)};
+		return it != m_components.end() && *it == component
+					   ? static_cast<int>(it - m_components.begin())
+					   : -1;
+	}
+
+	uint32_t Archetype::pushRow(const Entity entity)
+	{
+		if (m_size == m_chunks.size() * m_chunkCapacity)
+		{
+			auto* data{static_cast<std::byte*>(::operator new(
+					m_chunkBytes, std::align_val_t{ComponentRegistry::MAX_ALIGNMENT}))};
+			m_chunks.emplace_back(data, ChunkDeleter{m_chunkBytes});
+			MemoryTracker::recordAllocation(MEMORY_TAG_SCENE, m_chunkBytes);
+		}
+
+		const uint32_t row{m_size++};
+		entities(row / m_chunkCapacity)[row % m_chunkCapacity] = entity;
+		return row;
+	}
+
+	Entity Archetype::eraseRow(const uint32_t row) noexcept
+	{
+		const uint32_t last{--m_size};
+
+		Entity moved{};
+		if (row != last)
+		{
+			for (size_t column = 0; column < m_components.size(); ++column)
+			{
+				ComponentRegistry::info(m_components[column])
+						.relocate(component(row, column), component(last, column));
+			}
+
+			moved = entities(last / m_chunkCapacity)[last % m_chunkCapacity];
+			entities(row / m_chunkCapacity)[row % m_chunkCapacity] = moved;
+		}
+
+		// Keep one empty chunk as a spare, so adding right after removing doesn't reallocate
+		if (m_chunks.size() > 1 && m_size <= (m_chunks.size() - 2) * m_chunkCapacity)
+			m_chunks.pop_back();
+
+		return moved;
+	}
+
+	World::World()
+	{
+		findArchetype({});
+	}
+
+	World::~World()
+	{
+		for (const auto& archetype : m_archetypes)
+		{
+			for (uint32_t row = 0; row < archetype->size(); ++row)
+			{
+				for (size_t column = 0; column < archetype->components().size(); ++column)
+				{
+					ComponentRegistry::info(archetype->components()[column])
+							.destroy(archetype->component(row, column));
+				}
+			}
+		}
+	}
+
+	void World::destroy(const Entity entity)
+	{
+		if (!isAlive(entity))
+			return;
+
+		Record& record{m_records[entity.index]};
+		Archetype& archetype{*record.archetype};
+		for (size_t column = 0; column < archetype.components().size(); ++column)
+		{
+			ComponentRegistry::info(archetype.components()[column])
+					.destroy(archetype.component(record.row, column));
+		}
+
+		const Entity moved{archetype.eraseRow(record.row)};
+		if (!moved.isNull())
+			m_records[moved.index].row = record.row;
+
+		record.archetype = nullptr;
+		++record.generation;
+		m_freeIndices.push_back(entity.index);
+		--m_entityCount;
+	}
+
+	Entity World::allocateEntity()
+	{
+		++m_entityCount;
+		if (!m_freeIndices.empty())
+		{
+			const uint32_t index{m_freeIndices.back()};
+			m_freeIndices.pop_back();
+			return {index, m_records[index].generation};
+		}
+
+		m_records.emplace_back();
+		return {static_cast<uint32_t>(m_records.size() - 1), 0};
+	}
+
+	Archetype& World::findArchetype(std::vector<ComponentId> components)
+	{
+		ComponentMask mask;
+		for (const ComponentId component : components)
+			mask.set(component);
+
+		if (const auto it{m_archetypeLookup.find(mask)}; it != m_archetypeLookup.end())
+			return *it->second;
+
+		Archetype& archetype{*m_archetypes.emplace_back(
+				std::make_unique<Archetype>(std::move(components)))};
+		m_archetypeLookup.emplace(mask, &archetype);
+		return archetype;
+	}
+
+	Archetype& World::archetypeWith(Archetype& archetype, const ComponentId component)
+	{
+		Archetype*& edge{archetype.m_addEdges[component]};
+		if (!edge)
+		{
+			std::vector<ComponentId> components{archetype.components()};
+			components.push_back(component);
+			edge = &findArchetype(std::move(components));
+		}
+		return *edge;
+	}
+
+	Archetype& World::archetypeWithout(Archetype& archetype, const ComponentId component)
+	{
+		Archetype*& edge{archetype.m_removeEdges[component]};
+		if (!edge)
+		{
+			std::vector<ComponentId> components{archetype.components()};
+			std::erase(components, component);
+			edge = &findArchetype(std::move(components));
+		}
+		return *edge;
+	}
+
+	void World::move(const Entity entity, Archetype& target)
+	{
+		Record& record{m_records[entity.index]};
+		Archetype& source{*record.archetype};
+		const uint32_t row{target.pushRow(entity)};
+
+		for (size_t column = 0; column < source.components().size(); ++column)
+		{
+			const ComponentId component{source.components()[column]};
+			const ComponentInfo& info{ComponentRegistry::info(component)};
+			const int targetColumn{target.column(component)};
+			void* value{source.component(record.row, column)};
+			if (targetColumn >= 0)
+				info.relocate(target.component(row, targetColumn), value);
+			else
+				info.destroy(value);
+		}
+
+		const Entity moved{source.eraseRow(record.row)};
+		if (!moved.isNull())
+			m_records[moved.index].row = record.row;
+
+		record.archetype = &target;
+		record.row = row;
+	}
+} // namespace lune
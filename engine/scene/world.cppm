@@ -0,0 +1,580 @@
+module;
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+export module lune:world;
+
+import lune.jobs;
+import lune.memory;
+
+namespace lune
+{
+	/**
+	 * @brief Handle of an entity of a `World`. The generation tells a destroyed entity apart from a
+	 * later one reusing its index.
+	 */
+	export struct Entity
+	{
+		static constexpr uint32_t NULL_INDEX{std::numeric_limits<uint32_t>::max()};
+
+		uint32_t index{NULL_INDEX};
+		uint32_t generation{};
+
+		[[nodiscard]] constexpr bool isNull() const noexcept
+		{
+			return index == NULL_INDEX;
+		}
+
+		constexpr bool operator==(const Entity&) const noexcept = default;
+	};
+
+
+	export using ComponentId = uint32_t;
+
+	export inline constexpr size_t MAX_COMPONENTS{128};
+
+	/// Set of component types, indexed by `ComponentId`.
+	export using ComponentMask = std::bitset<MAX_COMPONENTS>;
+
+
+	/**
+	 * @brief Size and lifetime operations of a component type, so archetypes can store components
+	 * without knowing their types.
+	 */
+	export struct ComponentInfo
+	{
+		size_t size{};
+		size_t alignment{};
+
+		/// Move-constructs the component at `destination` from `source` and destroys `source`.
+		void (*relocate)(void* destination, void* source){};
+		void (*destroy)(void* component){};
+	};
+
+
+	/**
+	 * @brief Assigns ids to component types on first use.
+	 *
+	 * Components are plain structs; any type that is nothrow move constructible qualifies. `const`
+	 * is ignored, so `const Position` and `Position` share an id.
+	 */
+	export class ComponentRegistry
+	{
+		static inline std::array<ComponentInfo, MAX_COMPONENTS> m_infos{};
+		static inline std::atomic<ComponentId> m_count{0};
+
+	public:
+		/// Largest supported component alignment, which is also the alignment of chunks.
+		static constexpr size_t MAX_ALIGNMENT{64};
+
+		template <typename T> [[nodiscard]] static ComponentId id()
+		{
+			using Component = std::remove_cvref_t<T>;
+			if constexpr (!std::is_same_v<T, Component>)
+			{
+				return id<Component>();
+			}
+			else
+			{
+				static_assert(std::is_nothrow_move_constructible_v<T>,
+							  "Components must be nothrow move constructible");
+				static_assert(alignof(T) <= MAX_ALIGNMENT, "Component alignment too large");
+
+				static const ComponentId id{
+						add({sizeof(T), alignof(T),
+							 [](void* destination, void* source)
+							 {
+								 new (destination) T(std::move(*static_cast<T*>(source)));
+								 static_cast<T*>(source)->~T();
+							 },
+							 [](void* component) { static_cast<T*>(component)->~T(); }})};
+				return id;
+			}
+		}
+
+		template <typename... Ts> [[nodiscard]] static ComponentMask mask()
+		{
+			ComponentMask mask;
+			(mask.set(id<Ts>()), ...);
+			return mask;
+		}
+
+		[[nodiscard]] static const ComponentInfo& info(const ComponentId id) noexcept
+		{
+			return m_infos[id];
+		}
+
+	private:
+		/**
+		 * @throws std::length_error if more than `MAX_COMPONENTS` types are registered.
+		 */
+		static ComponentId add(const ComponentInfo& info);
+	};
+
+
+	/**
+	 * @brief Storage of all entities that have exactly the same set of components.
+	 *
+	 * Entities are packed into fixed-size chunks. Each chunk stores every component type as a
+	 * contiguous array (structure of arrays), preceded by the entities of its rows, so a system
+	 * touching positions streams through positions only. Rows are kept dense: removing an entity
+	 * moves the last row into its place.
+	 */
+	export class Archetype
+	{
+		struct ChunkDeleter
+		{
+			size_t bytes;
+
+			void operator()(std::byte* data) const noexcept;
+		};
+
+		using ChunkPointer = std::unique_ptr<std::byte[], ChunkDeleter>;
+
+		ComponentMask m_mask;
+		std::vector<ComponentId> m_components; ///< Sorted.
+		std::vector<size_t> m_offsets; ///< Offset of each component array in a chunk.
+		std::vector<ChunkPointer> m_chunks;
+		uint32_t m_chunkCapacity{};
+		size_t m_chunkBytes{};
+		uint32_t m_size{};
+
+		/// Archetypes one component away, filled in as entities move between them.
+		std::unordered_map<ComponentId, Archetype*> m_addEdges;
+		std::unordered_map<ComponentId, Archetype*> m_removeEdges;
+
+		friend class World;
+
+	public:
+		/// Bytes of a chunk, unless a single row needs more.
+		static constexpr size_t CHUNK_SIZE{16 * 1024};
+
+		explicit Archetype(std::vector<ComponentId> components);
+
+		Archetype(const Archetype&) = delete;
+		Archetype& operator=(const Archetype&) = delete;
+
+		[[nodiscard]] const ComponentMask& mask() const noexcept
+		{
+			return m_mask;
+		}
+
+		[[nodiscard]] const std::vector<ComponentId>& components() const noexcept
+		{
+			return m_components;
+		}
+
+		/**
+		 * @brief Gets the column of a component type.
+		 *
+		 * @return Index in `components()`; -1 if entities of this archetype don't have it.
+		 */
+		[[nodiscard]] int column(ComponentId component) const noexcept;
+
+		[[nodiscard]] uint32_t size() const noexcept
+		{
+			return m_size;
+		}
+
+		[[nodiscard]] size_t chunkCount() const noexcept
+		{
+			return m_chunks.size();
+		}
+
+		[[nodiscard]] uint32_t chunkCapacity() const noexcept
+		{
+			return m_chunkCapacity;
+		}
+
+		/**
+		 * @brief Gets the number of rows of a chunk. Rows fill chunks in order, so only the last
+		 * non-empty chunk may be partially filled.
+		 */
+		[[nodiscard]] uint32_t chunkSize(const size_t chunk) const noexcept
+		{
+			const size_t begin{chunk * m_chunkCapacity};
+			return m_size > begin ? std::min(m_size - static_cast<uint32_t>(begin), m_chunkCapacity)
+								  : 0;
+		}
+
+		[[nodiscard]] Entity* entities(const size_t chunk) const noexcept
+		{
+			return reinterpret_cast<Entity*>(m_chunks[chunk].get());
+		}
+
+		/**
+		 * @brief Gets the component array of a column in a chunk.
+		 */
+		[[nodiscard]] void* data(const size_t chunk, const size_t column) const noexcept
+		{
+			return m_chunks[chunk].get() + m_offsets[column];
+		}
+
+		[[nodiscard]] void* component(const uint32_t row, const size_t column) const noexcept
+		{
+			const size_t size{ComponentRegistry::info(m_components[column]).size};
+			return static_cast<std::byte*>(data(row / m_chunkCapacity, column)) +
+				   row % m_chunkCapacity * size;
+		}
+
+	private:
+		/**
+		 * @brief Appends a row for an entity. Its components are left unconstructed.
+		 *
+		 * @return The row.
+		 */
+		uint32_t pushRow(Entity entity);
+
+		/**
+		 * @brief Removes a row whose components were already destroyed or moved out, by moving
+		 * the last row into its place.
+		 *
+		 * @return The entity moved into the row; a null entity if the row was the last.
+		 */
+		Entity eraseRow(uint32_t row) noexcept;
+	};
+
+
+	export template <typename... Ts> class Query;
+
+
+	/**
+	 * @brief Container of entities and their components, grouped into archetypes.
+	 *
+	 * Structural changes (creating or destroying entities, adding or removing components) move
+	 * components between archetypes and invalidate references to components; they must not
+	 * happen while systems or queries are iterating.
+	 */
+	export class World
+	{
+		struct Record
+		{
+			Archetype* archetype{};
+			uint32_t row{};
+			uint32_t generation{};
+		};
+
+		std::vector<std::unique_ptr<Archetype>> m_archetypes; ///< Append-only; 0 has no components.
+		std::unordered_map<ComponentMask, Archetype*> m_archetypeLookup;
+		std::vector<Record> m_records;
+		std::vector<uint32_t> m_freeIndices;
+		size_t m_entityCount{};
+
+	public:
+		World();
+		~World();
+
+		World(const World&) = delete;
+		World& operator=(const World&) = delete;
+
+		/**
+		 * @brief Creates an entity with the given components, which must be of distinct types.
+		 */
+		template <typename... Ts> Entity create(Ts&&... components)
+		{
+			const Entity entity{allocateEntity()};
+			Archetype& archetype{findArchetype({ComponentRegistry::id<Ts>()...})};
+			const uint32_t row{archetype.pushRow(entity)};
+			(construct<std::remove_cvref_t<Ts>>(archetype, row, std::forward<Ts>(components)), ...);
+
+			m_records[entity.index].archetype = &archetype;
+			m_records[entity.index].row = row;
+			return entity;
+		}
+
+		/**
+		 * @brief Destroys an entity and its components. Does nothing if it is already destroyed.
+		 */
+		void destroy(Entity entity);
+
+		[[nodiscard]] bool isAlive(Entity entity) const noexcept
+		{
+			return entity.index < m_records.size() &&
+				   m_records[entity.index].generation == entity.generation &&
+				   m_records[entity.index].archetype;
+		}
+
+		template <typename T> [[nodiscard]] bool has(const Entity entity) const
+		{
+			return isAlive(entity) &&
+				   m_records[entity.index].archetype->mask().test(ComponentRegistry::id<T>());
+		}
+
+		/**
+		 * @brief Gets a component of an entity.
+		 *
+		 * @return The component; nullptr if the entity is destroyed or doesn't have it.
+		 */
+		template <typename T> [[nodiscard]] T* get(const Entity entity) const
+		{
+			if (!isAlive(entity))
+				return nullptr;
+
+			const Record& record{m_records[entity.index]};
+			const int column{record.archetype->column(ComponentRegistry::id<T>())};
+			return column < 0 ? nullptr
+							  : static_cast<T*>(record.archetype->component(record.row, column));
+		}
+
+		/**
+		 * @brief Adds a component to an entity, moving it to the archetype with the component.
+		 * Replaces the component if the entity already has one.
+		 *
+		 * @return The component.
+		 *
+		 * @throws std::invalid_argument if the entity was destroyed; a stale handle must not
+		 * modify the entity that reused its index.
+		 */
+		template <typename T> T& add(const Entity entity, T component = {})
+		{
+			if (!isAlive(entity))
+				throw std::invalid_argument("Cannot add a component to a destroyed entity");
+
+			if (T* existing{get<T>(entity)})
+				return *existing = std::move(component);
+
+			const ComponentId id{ComponentRegistry::id<T>()};
+			Record& record{m_records[entity.index]};
+			Archetype& target{archetypeWith(*record.archetype, id)};
+			move(entity, target);
+			return construct<T>(target, record.row, std::move(component));
+		}
+
+		/**
+		 * @brief Removes a component from an entity, moving it to the archetype without the
+		 * component. Does nothing if the entity doesn't have one.
+		 */
+		template <typename T> void remove(const Entity entity)
+		{
+			if (!has<T>(entity))
+				return;
+
+			const Record& record{m_records[entity.index]};
+			move(entity, archetypeWithout(*record.archetype, ComponentRegistry::id<T>()));
+		}
+
+		/**
+		 * @brief Creates a query over the entities having all of the given components.
+		 *
+		 * Keep the query around: it caches the matching archetypes and only checks archetypes
+		 * created since its last use.
+		 */
+		template <typename... Ts> [[nodiscard]] Query<Ts...> query();
+
+		[[nodiscard]] size_t entityCount() const noexcept
+		{
+			return m_entityCount;
+		}
+
+		[[nodiscard]] const std::vector<std::unique_ptr<Archetype>>& archetypes() const noexcept
+		{
+			return m_archetypes;
+		}
+
+	private:
+		Entity allocateEntity();
+
+		/**
+		 * @brief Finds or creates the archetype of a set of components.
+		 */
+		Archetype& findArchetype(std::vector<ComponentId> components);
+
+		Archetype& archetypeWith(Archetype& archetype, ComponentId component);
+		Archetype& archetypeWithout(Archetype& archetype, ComponentId component);
+
+		/**
+		 * @brief Moves an entity to another archetype, keeping the components both have and
+		 * destroying the others. Components only the target has are left unconstructed.
+		 */
+		void move(Entity entity, Archetype& target);
+
+		template <typename T, typename U> static T& construct(Archetype& archetype, uint32_t row,
+															  U&& component)
+		{
+			const int column{archetype.column(ComponentRegistry::id<T>())};
+			return *new (archetype.component(row, column)) T(std::forward<U>(component));
+		}
+	};
+
+
+	/**
+	 * @brief Iterates the entities having all of a set of components.
+	 *
+	 * Components are named by type; a `const` type declares read-only access:
+	 *
+	 * @code
+	 * Query<Position, const Velocity> movers{world.query<Position, const Velocity>()};
+	 * movers.each([&](Position& position, const Velocity& velocity)
+	 * 			   { position.value += velocity.value * dt; });
+	 * @endcode
+	 *
+	 * `eachChunk` hands out the component arrays of whole chunks as spans, ready for batch
+	 * kernels; the `parallel` variants spread chunks across a `JobSystem`.
+	 */
+	export template <typename... Ts> class Query
+	{
+		struct Match
+		{
+			Archetype* archetype;
+			std::array<size_t, sizeof...(Ts)> columns;
+		};
+
+		World* m_world;
+		ComponentMask m_mask;
+		std::vector<Match> m_matches;
+		size_t m_checkedArchetypes{};
+
+	public:
+		explicit Query(World& world) :
+			m_world(&world), m_mask(ComponentRegistry::mask<Ts...>())
+		{
+		}
+
+		/**
+		 * @brief Calls `function(std::span<const Entity>, std::span<Ts>...)` for every non-empty
+		 * chunk.
+		 */
+		template <typename Function> void eachChunk(Function&& function)
+		{
+			refresh();
+			for (const Match& match : m_matches)
+			{
+				for (size_t chunk = 0; chunk < match.archetype->chunkCount(); ++chunk)
+					invokeChunk(function, match, chunk);
+			}
+		}
+
+		/**
+		 * @brief Calls `function(Ts&...)`, or `function(Entity, Ts&...)`, for every entity.
+		 */
+		template <typename Function> void each(Function&& function)
+		{
+			eachChunk(
+					[&](const std::span<const Entity> entities, const std::span<Ts>... components)
+					{
+						for (size_t i = 0; i < entities.size(); ++i)
+							invokeRow(function, entities[i], components[i]...);
+					});
+		}
+
+		/**
+		 * @brief Like `eachChunk`, with chunks processed in parallel. The function must only
+		 * write to the components of its chunk.
+		 */
+		template <typename Function> void parallelEachChunk(JobSystem& jobs, Function&& function)
+		{
+			refresh();
+
+			std::vector<std::pair<const Match*, size_t>> chunks;
+			for (const Match& match : m_matches)
+			{
+				for (size_t chunk = 0; chunk < match.archetype->chunkCount(); ++chunk)
+					chunks.emplace_back(&match, chunk);
+			}
+
+			jobs.parallelFor(chunks.size(), 1,
+							 [&](const size_t begin, const size_t end)
+							 {
+								 for (size_t i = begin; i < end; ++i)
+									 invokeChunk(function, *chunks[i].first, chunks[i].second);
+							 });
+		}
+
+		/**
+		 * @brief Like `each`, with chunks processed in parallel. The function must only write to
+		 * the components of its entity.
+		 */
+		template <typename Function> void parallelEach(JobSystem& jobs, Function&& function)
+		{
+			parallelEachChunk(jobs,
+							  [&](const std::span<const Entity> entities,
+								  const std::span<Ts>... components)
+							  {
+								  for (size_t i = 0; i < entities.size(); ++i)
+									  invokeRow(function, entities[i], components[i]...);
+							  });
+		}
+
+		/**
+		 * @brief Counts the matching entities.
+		 */
+		[[nodiscard]] size_t count()
+		{
+			refresh();
+
+			size_t count{};
+			for (const Match& match : m_matches)
+				count += match.archetype->size();
+			return count;
+		}
+
+	private:
+		/**
+		 * @brief Matches the archetypes created since the last call.
+		 */
+		void refresh()
+		{
+			const auto& archetypes{m_world->archetypes()};
+			for (; m_checkedArchetypes < archetypes.size(); ++m_checkedArchetypes)
+			{
+				Archetype& archetype{*archetypes[m_checkedArchetypes]};
+				if ((archetype.mask() & m_mask) != m_mask)
+					continue;
+
+				m_matches.push_back(
+						{&archetype,
+						 {static_cast<size_t>(archetype.column(ComponentRegistry::id<Ts>()))...}});
+			}
+		}
+
+		template <typename Function>
+		static void invokeChunk(Function& function, const Match& match, const size_t chunk)
+		{
+			const Archetype& archetype{*match.archetype};
+			const size_t size{archetype.chunkSize(chunk)};
+			if (size == 0)
+				return;
+
+			invokeColumns(function, archetype, chunk, size, match.columns,
+						  std::index_sequence_for<Ts...>{});
+		}
+
+		template <typename Function, size_t... Indices>
+		static void invokeColumns(Function& function, const Archetype& archetype,
+								  const size_t chunk, const size_t size,
+								  const std::array<size_t, sizeof...(Ts)>& columns,
+								  std::index_sequence<Indices...>)
+		{
+			function(std::span<const Entity>(archetype.entities(chunk), size),
+					 std::span<Ts>(static_cast<Ts*>(archetype.data(chunk, columns[Indices])),
+								   size)...);
+		}
+
+		template <typename Function>
+		static void invokeRow(Function& function, const Entity entity, Ts&... components)
+		{
+			if constexpr (std::is_invocable_v<Function&, Entity, Ts&...>)
+				function(entity, components...);
+			else
+				function(components...);
+		}
+	};
+
+
+	template <typename... Ts> Query<Ts...> World::query()
+	{
+		return Query<Ts...>(*this);
+	}
+} // namespace lune
@@ -0,0 +1,346 @@
+module;
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <lune/profiler.hpp>
+#include <optional>
+#include <span>
+#include <string_view>
+module lune;
+
+namespace lune
+{
+	namespace
+	{
+		/// Words a job steps at least, so small grids aren't split into jobs that cost more than
+		/// they save.
+		constexpr size_t WORDS_PER_JOB{4096};
+
+		struct Grid
+		{
+			const uint64_t* cells;
+			uint64_t* next;
+			uint32_t width;
+			uint32_t height;
+			size_t wordsPerRow;
+			uint64_t lastWordMask;
+		};
+
+		void fullAdd(const uint64_t a, const uint64_t b, const uint64_t c, uint64_t& sum,
+					 uint64_t& carry) noexcept
+		{
+			const uint64_t partial{a ^ b};
+			sum = partial ^ c;
+			carry = (a & b) | (partial & c);
+		}
+
+		/**
+		 * @brief Conway's B3/S23: born with three neighbours, alive with two or three.
+		 */
+		struct ConwayRule
+		{
+			uint64_t operator()(const uint64_t alive, const uint64_t ones, const uint64_t twos,
+								const uint64_t fours, const uint64_t eights) const noexcept
+			{
+				return twos & ~fours & ~eights & (ones | alive);
+			}
+		};
+
+		/**
+		 * @brief Any B/S rule, by matching the neighbour count against each count of the rule.
+		 */
+		struct TotalisticRule
+		{
+			CellularRule rule;
+
+			uint64_t operator()(const uint64_t alive, const uint64_t ones, const uint64_t twos,
+								const uint64_t fours, const uint64_t eights) const noexcept
+			{
+				uint64_t born{};
+				uint64_t survive{};
+				for (uint32_t count = 0; count <= 8; ++count)
+				{
+					const bool births{(rule.birth >> count & 1) != 0};
+					const bool survives{(rule.survival >> count & 1) != 0};
+					if (!births && !survives)
+						continue;
+
+					const uint64_t matches{(count & 1 ? ones : ~ones) & (count & 2 ? twos : ~twos) &
+										   (count & 4 ? fours : ~fours) &
+										   (count & 8 ? eights : ~eights)};
+					if (births)
+						born |= matches;
+					if (survives)
+						survive |= matches;
+				}
+
+				return (alive & survive) | (~alive & born);
+			}
+		};
+
+		/**
+		 * @brief Computes the next state of 64 cells from the words holding each of their eight
+		 * neighbours, lined up bit for bit with the cells.
+		 */
+		template <typename Rule>
+		uint64_t evolve(const uint64_t northWest, const uint64_t north, const uint64_t northEast,
+						const uint64_t west, const uint64_t centre, const uint64_t east,
+						const uint64_t southWest, const uint64_t south, const uint64_t southEast,
+						const Rule& rule) noexcept
+		{
+			// Sum the eight neighbour bits of every cell into a 4-bit count, one bit plane each
+			uint64_t topOnes, topTwos, bottomOnes, bottomTwos;
+			fullAdd(northWest, north, northEast, topOnes, topTwos);
+			fullAdd(southWest, south, southEast, bottomOnes, bottomTwos);
+			const uint64_t middleOnes{west ^ east};
+			const uint64_t middleTwos{west & east};
+
+			uint64_t ones, onesCarry, twos, twosCarry;
+			fullAdd(topOnes, bottomOnes, middleOnes, ones, onesCarry);
+			fullAdd(topTwos, bottomTwos, middleTwos, twos, twosCarry);
+
+			const uint64_t twosSum{twos ^ onesCarry};
+			const uint64_t foursCarry{twos & onesCarry};
+			return rule(centre, ones, twosSum, twosCarry ^ foursCarry, twosCarry & foursCarry);
+		}
+
+		/**
+		 * @brief Shifts a row one cell east, so every bit holds its western neighbour, wrapping
+		 * around the width.
+		 */
+		uint64_t westOf(const Grid& grid, const uint64_t* row, const size_t word) noexcept
+		{
+			const size_t last{grid.wordsPerRow - 1};
+			const uint64_t carry{word == 0 ? row[last] >> ((grid.width - 1) & 63) & 1
+										   : row[word - 1] >> 63};
+			return row[word] << 1 | carry;
+		}
+
+		uint64_t eastOf(const Grid& grid, const uint64_t* row, const size_t word) noexcept
+		{
+			const size_t last{grid.wordsPerRow - 1};
+			const uint64_t carry{word == last ? (row[0] & 1) << ((grid.width - 1) & 63)
+											  : row[word + 1] << 63};
+			return row[word] >> 1 | carry;
+		}
+
+		template <typename Rule>
+		void stepRows(const Grid& grid, const size_t begin, const size_t end, const Rule& rule)
+		{
+			const size_t words{grid.wordsPerRow};
+			for (size_t y = begin; y < end; ++y)
+			{
+				const uint64_t* above{grid.cells + (y == 0 ? grid.height - 1 : y - 1) * words};
+				const uint64_t* row{grid.cells + y * words};
+				const uint64_t* below{grid.cells + (y + 1 == grid.height ? 0 : y + 1) * words};
+				uint64_t* next{grid.next + y * words};
+
+				const auto edge{[&](const size_t word)
+								{
+									next[word] = evolve(westOf(grid, above, word), above[word],
+														eastOf(grid, above, word),
+														westOf(grid, row, word), row[word],
+														eastOf(grid, row, word),
+														westOf(grid, below, word), below[word],
+														eastOf(grid, below, word), rule);
+								}};
+
+				edge(0);
+
+				// Interior words have both neighbours in the row, so the loop has no branches
+				for (size_t word = 1; word + 1 < words; ++word)
+				{
+					next[word] = evolve(above[word] << 1 | above[word - 1] >> 63, above[word],
+										above[word] >> 1 | above[word + 1] << 63,
+										row[word] << 1 | row[word - 1] >> 63, row[word],
+										row[word] >> 1 | row[word + 1] << 63,
+										below[word] << 1 | below[word - 1] >> 63, below[word],
+										below[word] >> 1 | below[word + 1] << 63, rule);
+				}
+
+				if (words > 1)
+					edge(words - 1);
+
+				// Cells shifted past the width must not come back as live padding
+				next[words - 1] &= grid.lastWordMask;
+			}
+		}
+
+		uint32_t packColor(const CellularAutomaton::Color& color) noexcept
+		{
+			uint32_t pixel;
+			std::memcpy(&pixel, color.data(), sizeof(pixel));
+			return pixel;
+		}
+
+		uint64_t splitMix(uint64_t& state) noexcept
+		{
+			uint64_t z{state += 0x9E3779B97F4A7C15};
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+			return z ^ (z >> 31);
+		}
+	} // namespace
+
+	std::optional<CellularRule> CellularRule::parse(const std::string_view notation)
+	{
+		const size_t slash{notation.find('/')};
+		if (slash == std::string_view::npos)
+			return std::nullopt;
+
+		const auto counts{[](std::string_view part, const char prefix) -> std::optional<uint16_t>
+						  {
+							  if (part.empty() || (part[0] != prefix && part[0] != prefix + 32))
+								  return std::nullopt;
+
+							  uint16_t mask{};
+							  for (const char c : part.substr(1))
+							  {
+								  if (c < '0' || c > '8')
+									  return std::nullopt;
+								  mask |= static_cast<uint16_t>(1 << (c - '0'));
+							  }
+							  return mask;
+						  }};
+
+		const auto birth{counts(notation.substr(0, slash), 'B')};
+		const auto survival{counts(notation.substr(slash + 1), 'S')};
+		if (!birth || !survival)
+			return std::nullopt;
+
+		return CellularRule{*birth, *survival};
+	}
+
+	CellularAutomaton::CellularAutomaton(const uint32_t width, const uint32_t height,
+										 const CellularRule& rule) :
+		m_width(std::max(width, 1u)), m_height(std::max(height, 1u)),
+		m_wordsPerRow((m_width + 63) / 64),
+		m_lastWordMask(~uint64_t{} >> ((64 - m_width % 64) % 64)),
+		m_cells(m_wordsPerRow * m_height), m_next(m_cells.size()), m_rule(rule)
+	{
+	}
+
+	void CellularAutomaton::set(const uint32_t x, const uint32_t y, const bool alive) noexcept
+	{
+		const uint64_t bit{uint64_t{1} << (x & 63)};
+		uint64_t& word{m_cells[index(x, y)]};
+		word = alive ? word | bit : word & ~bit;
+	}
+
+	void CellularAutomaton::clear() noexcept
+	{
+		std::fill(m_cells.begin(), m_cells.end(), 0);
+	}
+
+	void CellularAutomaton::randomize(const float density, uint64_t seed)
+	{
+		const auto threshold{static_cast<uint64_t>(std::clamp(density, 0.0f, 1.0f) * 65536.0f)};
+		for (size_t y = 0; y < m_height; ++y)
+		{
+			for (size_t word = 0; word < m_wordsPerRow; ++word)
+			{
+				// Four cells per random number, 16 bits of probability each
+				uint64_t cells{};
+				for (uint32_t bit = 0; bit < 64; bit += 4)
+				{
+					const uint64_t random{splitMix(seed)};
+					for (uint32_t i = 0; i < 4; ++i)
+						cells |= static_cast<uint64_t>((random >> (i * 16) & 0xFFFF) < threshold)
+								 << (bit + i);
+				}
+
+				const bool last{word + 1 == m_wordsPerRow};
+				m_cells[y * m_wordsPerRow + word] = last ? cells & m_lastWordMask : cells;
+			}
+		}
+	}
+
+	void CellularAutomaton::step(const uint32_t generations, JobSystem* jobs)
+	{
+		LUNE_ZONE("CellularAutomaton::step");
+
+		const size_t grain{std::max<size_t>(WORDS_PER_JOB / m_wordsPerRow, 1)};
+		const bool conway{m_rule == CellularRule{}};
+
+		for (uint32_t generation = 0; generation < generations; ++generation)
+		{
+			const Grid grid{m_cells.data(), m_next.data(), m_width,
+							m_height,		m_wordsPerRow, m_lastWordMask};
+			const auto run{[&](const size_t begin, const size_t end)
+						   {
+							   if (conway)
+								   stepRows(grid, begin, end, ConwayRule{});
+							   else
+								   stepRows(grid, begin, end, TotalisticRule{m_rule});
+						   }};
+
+			if (jobs && m_height > grain)
+				jobs->parallelFor(m_height, grain, run);
+			else
+				run(0, m_height);
+
+			m_cells.swap(m_next);
+			++m_generation;
+		}
+	}
+
+	size_t CellularAutomaton::population() const noexcept
+	{
+		size_t count{};
+		for (const uint64_t word : m_cells)
+			count += static_cast<size_t>(std::popcount(word));
+		return count;
+	}
+
+	void CellularAutomaton::toPixels(const std::span<uint32_t> pixels, const Color& alive,
+									 const Color& dead, JobSystem* jobs) const
+	{
+		if (pixels.size() < static_cast<size_t>(m_width) * m_height)
+		{
+			std::cerr << "Pixel buffer too small for a " << m_width << "x" << m_height
+					  << " automaton\n";
+			return;
+		}
+
+		const uint32_t alivePixel{packColor(alive)};
+		const uint32_t deadPixel{packColor(dead)};
+		const auto run{[&](const size_t begin, const size_t end)
+					   {
+						   for (size_t y = begin; y < end; ++y)
+						   {
+							   const uint64_t* row{m_cells.data() + y * m_wordsPerRow};
+							   uint32_t* out{pixels.data() + y * m_width};
+							   for (uint32_t x = 0; x < m_width; ++x)
+								   out[x] = row[x / 64] >> (x & 63) & 1 ? alivePixel : deadPixel;
+						   }
+					   }};
+
+		const size_t grain{std::max<size_t>(64 * WORDS_PER_JOB / m_width, 1)};
+		if (jobs && m_height > grain)
+			jobs->parallelFor(m_height, grain, run);
+		else
+			run(0, m_height);
+	}
+
+	void CellularAutomaton::upload(const gfx::Texture& texture, const Color& alive,
+								   const Color& dead, JobSystem* jobs) const
+	{
+		LUNE_ZONE("CellularAutomaton::upload");
+
+		if (texture.width() != static_cast<int>(m_width) ||
+			texture.height() != static_cast<int>(m_height) ||
+			texture.pixelFormat() != gfx::RGBA8_UNorm)
+		{
+			std::cerr << "Automaton upload needs an RGBA8_UNorm texture of " << m_width << "x"
+					  << m_height << "\n";
+			return;
+		}
+
+		m_pixels.resize(static_cast<size_t>(m_width) * m_height);
+		toPixels(m_pixels, alive, dead, jobs);
+		texture.setData(m_pixels.data(), m_width * sizeof(uint32_t));
+	}
+} // namespace lune
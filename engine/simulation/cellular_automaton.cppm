@@ -0,0 +1,170 @@
+module;
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+export module lune:cellular_automaton;
+
+import lune.gfx;
+import lune.jobs;
+import lune.memory;
+
+namespace lune
+{
+	/**
+	 * @brief Rule of a Life-like automaton: whether a cell lives on is decided by its state and
+	 * the number of live cells among its eight neighbours.
+	 */
+	export struct CellularRule
+	{
+		uint16_t birth{1 << 3}; ///< Bit n set: a dead cell with n live neighbours comes alive.
+		uint16_t survival{1 << 2 | 1 << 3}; ///< Bit n set: a live cell with n neighbours lives on.
+
+		/**
+		 * @brief Parses a rule in B/S notation, e.g. "B3/S23" for Conway's Game of Life or
+		 * "B36/S23" for HighLife.
+		 *
+		 * @return The rule, or nullopt if the notation is malformed.
+		 */
+		[[nodiscard]] static std::optional<CellularRule> parse(std::string_view notation);
+
+		[[nodiscard]] bool operator==(const CellularRule&) const = default;
+	};
+
+
+	/**
+	 * @brief Two-state cellular automaton on a toroidal grid, such as the Game of Life.
+	 *
+	 * Cells are bit-packed, 64 to a word, and a generation is computed a word at a time: the
+	 * neighbour counts of 64 cells are summed at once by bit-sliced adders, with plain integer
+	 * operations the compiler vectorizes across words. Rows are spread across the job system
+	 * when one is given. Grids of any size wrap around at their edges.
+	 *
+	 * The cells only become pixels for display, in `upload()`:
+	 *
+	 * @code
+	 * CellularAutomaton life{1024, 1024};
+	 * life.randomize(0.5f);
+	 * life.step(1, &JobSystem::instance());
+	 * life.upload(texture, {255, 0, 0, 255}, {25, 25, 25, 255});
+	 * @endcode
+	 */
+	export class CellularAutomaton
+	{
+	public:
+		using Color = std::array<uint8_t, 4>; ///< RGBA8.
+
+	private:
+		template <typename T>
+		using CellVector = std::vector<T, TaggedAllocator<T, MEMORY_TAG_GENERAL>>;
+
+		uint32_t m_width;
+		uint32_t m_height;
+		size_t m_wordsPerRow;
+		uint64_t m_lastWordMask; ///< Bits of the last word of a row that are cells.
+
+		CellVector<uint64_t> m_cells;
+		CellVector<uint64_t> m_next;
+		mutable CellVector<uint32_t> m_pixels;
+
+		CellularRule m_rule;
+		uint64_t m_generation{};
+
+	public:
+		CellularAutomaton(uint32_t width, uint32_t height, const CellularRule& rule = {});
+
+		[[nodiscard]] bool get(uint32_t x, uint32_t y) const noexcept
+		{
+			return m_cells[index(x, y)] >> (x & 63) & 1;
+		}
+
+		void set(uint32_t x, uint32_t y, bool alive) noexcept;
+
+		/**
+		 * @brief Kills every cell.
+		 */
+		void clear() noexcept;
+
+		/**
+		 * @brief Brings cells to life at random.
+		 *
+		 * @param density Probability of each cell being alive.
+		 */
+		void randomize(float density, uint64_t seed = 0x9E3779B97F4A7C15);
+
+		/**
+		 * @brief Advances the automaton by a number of generations.
+		 *
+		 * @param jobs Job system to spread the rows across; nullptr to step on the calling thread.
+		 */
+		void step(uint32_t generations = 1, JobSystem* jobs = nullptr);
+
+		/**
+		 * @brief Counts the live cells.
+		 */
+		[[nodiscard]] size_t population() const noexcept;
+
+		/**
+		 * @brief Writes one RGBA8 pixel per cell, row by row from `y = 0`.
+		 *
+		 * @param pixels At least `width() * height()` pixels.
+		 */
+		void toPixels(std::span<uint32_t> pixels, const Color& alive, const Color& dead,
+					  JobSystem* jobs = nullptr) const;
+
+		/**
+		 * @brief Replaces the pixels of an RGBA8 texture of the grid's size with the cells.
+		 * Safe to call every frame: the frames in flight keep sampling the previous pixels.
+		 */
+		void upload(const gfx::Texture& texture, const Color& alive, const Color& dead,
+					JobSystem* jobs = nullptr) const;
+
+		[[nodiscard]] uint32_t width() const noexcept
+		{
+			return m_width;
+		}
+
+		[[nodiscard]] uint32_t height() const noexcept
+		{
+			return m_height;
+		}
+
+		[[nodiscard]] uint64_t generation() const noexcept
+		{
+			return m_generation;
+		}
+
+		[[nodiscard]] const CellularRule& rule() const noexcept
+		{
+			return m_rule;
+		}
+
+		void setRule(const CellularRule& rule) noexcept
+		{
+			m_rule = rule;
+		}
+
+		/**
+		 * @brief Gets the packed cells: `wordsPerRow()` words per row, cell `x` of a row in bit
+		 * `x % 64` of word `x / 64`. Bits past the width are always 0.
+		 */
+		[[nodiscard]] std::span<const uint64_t> words() const noexcept
+		{
+			return m_cells;
+		}
+
+		[[nodiscard]] size_t wordsPerRow() const noexcept
+		{
+			return m_wordsPerRow;
+		}
+
+	private:
+		[[nodiscard]] size_t index(const uint32_t x, const uint32_t y) const noexcept
+		{
+			return y * m_wordsPerRow + x / 64;
+		}
+	};
+} // namespace lune
@@ -0,0 +1,619 @@
+module;
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <lune/profiler.hpp>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#ifdef LUNE_USE_LZ4
+#include <lz4.h>
+#include <lz4hc.h>
+#endif
+#ifdef LUNE_USE_ZSTD
+#include <zstd.h>
+#endif
+module lune.vfs;
+
+import lune.jobs;
+import lune.profiler;
+
+namespace lune
+{
+	namespace
+	{
+		/// Offline builds favour ratio; decompression speed barely depends on the level.
+		constexpr int ZSTD_LEVEL{19};
+
+		[[nodiscard]] const char* compressionName(const uint32_t compression) noexcept
+		{
+			switch (compression)
+			{
+				case ARCHIVE_LZ4:
+					return "LZ4 (LUNE_USE_LZ4)";
+				case ARCHIVE_ZSTD:
+					return "Zstandard (LUNE_USE_ZSTD)";
+				default:
+					return "stored";
+			}
+		}
+
+		[[nodiscard]] bool isCompressionAvailable(const uint32_t compression) noexcept
+		{
+			switch (compression)
+			{
+				case ARCHIVE_STORED:
+					return true;
+#ifdef LUNE_USE_LZ4
+				case ARCHIVE_LZ4:
+					return true;
+#endif
+#ifdef LUNE_USE_ZSTD
+				case ARCHIVE_ZSTD:
+					return true;
+#endif
+				default:
+					return false;
+			}
+		}
+
+		/**
+		 * @brief Compresses a block.
+		 *
+		 * @return The compressed block; empty if compression is unavailable or doesn't shrink the
+		 * block, in which case it is stored.
+		 */
+		std::vector<std::byte> compressBlock(const ArchiveCompression compression,
+											 const std::span<const std::byte> block)
+		{
+			std::vector<std::byte> compressed;
+			[[maybe_unused]] const auto* source{reinterpret_cast<const char*>(block.data())};
+
+			switch (compression)
+			{
+#ifdef LUNE_USE_LZ4
+				case ARCHIVE_LZ4:
+				{
+					const int sourceSize{static_cast<int>(block.size())};
+					compressed.resize(static_cast<size_t>(LZ4_compressBound(sourceSize)));
+					auto* destination{reinterpret_cast<char*>(compressed.data())};
+					const int size{LZ4_compress_HC(source, destination, sourceSize,
+												   static_cast<int>(compressed.size()),
+												   LZ4HC_CLEVEL_DEFAULT)};
+					compressed.resize(size > 0 ? static_cast<size_t>(size) : 0);
+					break;
+				}
+#endif
+#ifdef LUNE_USE_ZSTD
+				case ARCHIVE_ZSTD:
+				{
+					compressed.resize(ZSTD_compressBound(block.size()));
+					const size_t size{ZSTD_compress(compressed.data(), compressed.size(), source,
+													block.size(), ZSTD_LEVEL)};
+					compressed.resize(ZSTD_isError(size) ? 0 : size);
+					break;
+				}
+#endif
+				default:
+					break;
+			}
+
+			if (compressed.size() >= block.size())
+				compressed.clear();
+			return compressed;
+		}
+
+		bool decompressBlock(const uint32_t compression, const std::span<const std::byte> source,
+							 const std::span<std::byte> destination)
+		{
+			switch (compression)
+			{
+				case ARCHIVE_STORED:
+					if (source.size() != destination.size())
+						return false;
+					std::memcpy(destination.data(), source.data(), source.size());
+					return true;
+#ifdef LUNE_USE_LZ4
+				case ARCHIVE_LZ4:
+				{
+					const int size{LZ4_decompress_safe(reinterpret_cast<const char*>(source.data()),
+													   reinterpret_cast<char*>(destination.data()),
+													   static_cast<int>(source.size()),
+													   static_cast<int>(destination.size()))};
+					return size >= 0 && static_cast<size_t>(size) == destination.size();
+				}
+#endif
+#ifdef LUNE_USE_ZSTD
+				case ARCHIVE_ZSTD:
+				{
+					const size_t size{ZSTD_decompress(destination.data(), destination.size(),
+													  source.data(), source.size())};
+					return !ZSTD_isError(size) && size == destination.size();
+				}
+#endif
+				default:
+					return false;
+			}
+		}
+
+		/**
+		 * @brief Checks that `count` elements of `elementSize` at `offset` lie within the file and
+		 * are aligned for in-place access.
+		 */
+		[[nodiscard]] bool isValidSection(const uint64_t offset, const uint64_t count,
+										  const size_t elementSize, const size_t fileSize) noexcept
+		{
+			if (offset % ARCHIVE_SECTION_ALIGNMENT != 0 || offset > fileSize)
+				return false;
+			return count <= (fileSize - offset) / elementSize;
+		}
+
+		[[nodiscard]] uint64_t alignUp(const uint64_t value, const uint64_t alignment) noexcept
+		{
+			return (value + alignment - 1) / alignment * alignment;
+		}
+
+		/**
+		 * @brief Writes `size` bytes at offset `at` of a sequentially written stream, zero-padding
+		 * the gap since the last write.
+		 */
+		void writeAt(std::ofstream& out, uint64_t& written, const void* data, const uint64_t at,
+					 const size_t size)
+		{
+			static constexpr char padding[ARCHIVE_PAGE_ALIGNMENT]{};
+			while (written < at)
+			{
+				const uint64_t count{std::min(at - written, uint64_t{sizeof(padding)})};
+				out.write(padding, static_cast<std::streamsize>(count));
+				written += count;
+			}
+
+			out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+			written += size;
+		}
+	} // namespace
+
+	std::optional<std::string> normalizeVirtualPath(const std::string_view path)
+	{
+		if (path.starts_with('/'))
+			return std::nullopt;
+
+		std::vector<std::string_view> components;
+		size_t begin{};
+		while (begin <= path.size())
+		{
+			const size_t end{std::min(path.find('/', begin), path.size())};
+			const std::string_view component{path.substr(begin, end - begin)};
+			begin = end + 1;
+
+			if (component.empty() || component == ".")
+				continue;
+
+			if (component == "..")
+			{
+				if (components.empty())
+					return std::nullopt;
+				components.pop_back();
+				continue;
+			}
+
+			components.push_back(component);
+		}
+
+		std::string normalized;
+		for (const std::string_view component : components)
+		{
+			if (!normalized.empty())
+				normalized += '/';
+			normalized += component;
+		}
+		return normalized;
+	}
+
+	std::optional<Archive> Archive::open(const std::string& path)
+	{
+		auto file{MappedFile::open(path)};
+		if (!file)
+			return std::nullopt;
+
+		const size_t fileSize{file->size()};
+		if (fileSize < sizeof(ArchiveHeader))
+		{
+			std::cerr << "Archive is too small: " << path << "\n";
+			return std::nullopt;
+		}
+
+		const auto& header{*reinterpret_cast<const ArchiveHeader*>(file->data())};
+		if (header.magic != ARCHIVE_MAGIC || header.version != ARCHIVE_VERSION)
+		{
+			std::cerr << "Unsupported archive (bad magic or version): " << path << "\n";
+			return std::nullopt;
+		}
+
+		if (header.blockSize == 0 ||
+			!isValidSection(header.entriesOffset, header.entryCount, sizeof(ArchiveEntry),
+							fileSize) ||
+			!isValidSection(header.blocksOffset, header.blockCount, sizeof(ArchiveBlock),
+							fileSize) ||
+			!isValidSection(header.nameTableOffset, header.nameTableSize, 1, fileSize))
+		{
+			std::cerr << "Archive has a table of contents out of bounds: " << path << "\n";
+			return std::nullopt;
+		}
+
+		Archive archive;
+		archive.m_entries = {reinterpret_cast<const ArchiveEntry*>(file->data() +
+																	header.entriesOffset),
+							 header.entryCount};
+		archive.m_blocks = {reinterpret_cast<const ArchiveBlock*>(file->data() +
+																   header.blocksOffset),
+							header.blockCount};
+		archive.m_names = {reinterpret_cast<const char*>(file->data() + header.nameTableOffset),
+						   header.nameTableSize};
+		archive.m_blockSize = header.blockSize;
+
+		// Validate every entry up front, so reads only need to look up and decompress
+		std::string_view previous;
+		for (const ArchiveEntry& entry : archive.m_entries)
+		{
+			const uint64_t blockCount{(entry.size + header.blockSize - 1) / header.blockSize};
+			const bool validName{entry.nameLength > 0 &&
+								 entry.nameOffset <= archive.m_names.size() &&
+								 entry.nameLength <= archive.m_names.size() - entry.nameOffset};
+			if (!validName || entry.blockCount != blockCount ||
+				uint64_t{entry.firstBlock} + entry.blockCount > header.blockCount)
+			{
+				std::cerr << "Archive has a malformed entry: " << path << "\n";
+				return std::nullopt;
+			}
+
+			const std::string_view name{archive.name(entry)};
+			if (!previous.empty() && name <= previous)
+			{
+				std::cerr << "Archive entries are not sorted: " << path << "\n";
+				return std::nullopt;
+			}
+			previous = name;
+
+			for (uint32_t i = 0; i < entry.blockCount; ++i)
+			{
+				const ArchiveBlock& block{archive.m_blocks[entry.firstBlock + i]};
+				const uint64_t offset{uint64_t{i} * header.blockSize};
+				const uint64_t size{std::min<uint64_t>(header.blockSize, entry.size - offset)};
+				const bool inBounds{block.offset <= fileSize &&
+									block.compressedSize <= fileSize - block.offset};
+				const bool validSize{block.compression != ARCHIVE_STORED ||
+									 block.compressedSize == size};
+				if (!inBounds || !validSize || block.compression > ARCHIVE_ZSTD)
+				{
+					std::cerr << "Archive has a malformed block in " << name << ": " << path
+							  << "\n";
+					return std::nullopt;
+				}
+			}
+		}
+
+		archive.m_file = std::move(*file);
+		return archive;
+	}
+
+	bool Archive::contains(const std::string_view path) const
+	{
+		return find(path) != nullptr;
+	}
+
+	std::optional<uint64_t> Archive::size(const std::string_view path) const
+	{
+		const ArchiveEntry* entry{find(path)};
+		if (!entry)
+			return std::nullopt;
+		return entry->size;
+	}
+
+	std::optional<std::span<const std::byte>> Archive::view(const std::string_view path) const
+	{
+		const ArchiveEntry* entry{find(path)};
+		if (!entry)
+			return std::nullopt;
+
+		if (entry->blockCount == 0)
+			return std::span<const std::byte>{};
+
+		// Stored blocks of a file are written back to back, so the file is one contiguous range
+		const uint64_t begin{m_blocks[entry->firstBlock].offset};
+		for (uint32_t i = 0; i < entry->blockCount; ++i)
+		{
+			const ArchiveBlock& block{m_blocks[entry->firstBlock + i]};
+			if (block.compression != ARCHIVE_STORED ||
+				block.offset != begin + uint64_t{i} * m_blockSize)
+				return std::nullopt;
+		}
+
+		return m_file.bytes().subspan(begin, entry->size);
+	}
+
+	std::optional<std::vector<std::byte>> Archive::read(const std::string_view path,
+														 JobSystem* jobs) const
+	{
+		const ArchiveEntry* entry{find(path)};
+		if (!entry)
+			return std::nullopt;
+
+		std::vector<std::byte> content(entry->size);
+		if (!readInto(path, content, jobs))
+			return std::nullopt;
+		return content;
+	}
+
+	bool Archive::readInto(const std::string_view path, const std::span<std::byte> output,
+						   JobSystem* jobs) const
+	{
+		LUNE_ZONE("Archive::readInto");
+
+		const ArchiveEntry* entry{find(path)};
+		if (!entry || output.size() != entry->size)
+			return false;
+
+		std::atomic<bool> failed{false};
+		const auto run{[&](const size_t begin, const size_t end)
+					   {
+						   for (size_t i = begin; i < end; ++i)
+						   {
+							   const ArchiveBlock& block{m_blocks[entry->firstBlock + i]};
+							   const size_t offset{i * m_blockSize};
+							   const size_t size{
+									   std::min<size_t>(m_blockSize, entry->size - offset)};
+							   if (!decompressBlock(block.compression,
+													m_file.bytes().subspan(block.offset,
+																		   block.compressedSize),
+													output.subspan(offset, size)))
+								   failed.store(true, std::memory_order_relaxed);
+						   }
+					   }};
+
+		if (jobs && entry->blockCount > 1)
+			jobs->parallelFor(entry->blockCount, 1, run);
+		else
+			run(0, entry->blockCount);
+
+		if (failed.load(std::memory_order_relaxed))
+		{
+			std::cerr << "Failed to decompress " << path << " from archive";
+			for (uint32_t i = 0; i < entry->blockCount; ++i)
+			{
+				const uint32_t compression{m_blocks[entry->firstBlock + i].compression};
+				if (!isCompressionAvailable(compression))
+				{
+					std::cerr << ": " << compressionName(compression) << " support not compiled in";
+					break;
+				}
+			}
+			std::cerr << "\n";
+			return false;
+		}
+
+		return true;
+	}
+
+	std::vector<std::string_view> Archive::list() const
+	{
+		std::vector<std::string_view> names;
+		names.reserve(m_entries.size());
+		for (const ArchiveEntry& entry : m_entries)
+			names.push_back(name(entry));
+		return names;
+	}
+
+	const ArchiveEntry* Archive::find(const std::string_view path) const
+	{
+		const auto it{std::lower_bound(m_entries.begin(), m_entries.end(), path,
+									   [this](const ArchiveEntry& entry, const std::string_view key)
+									   { return name(entry) < key; })};
+		if (it == m_entries.end() || name(*it) != path)
+			return nullptr;
+		return &*it;
+	}
+
+	ArchiveWriter::ArchiveWriter(const ArchiveCompression compression, const uint32_t blockSize) :
+		m_compression(compression), m_blockSize(std::max(blockSize, 1u))
+	{
+	}
+
+	bool ArchiveWriter::add(const std::string_view path, const std::span<const std::byte> content)
+	{
+		auto name{normalizeVirtualPath(path)};
+		if (!name || name->empty())
+		{
+			std::cerr << "Invalid archive path: " << path << "\n";
+			return false;
+		}
+
+		m_files.insert_or_assign(std::move(*name),
+								 std::vector<std::byte>(content.begin(), content.end()));
+		return true;
+	}
+
+	bool ArchiveWriter::addFile(const std::string_view path, const std::string& sourcePath)
+	{
+		std::ifstream file(sourcePath, std::ios::binary | std::ios::ate);
+		if (!file)
+		{
+			std::cerr << "Failed to open file: " << sourcePath << "\n";
+			return false;
+		}
+
+		std::vector<std::byte> content(static_cast<size_t>(file.tellg()));
+		file.seekg(0, std::ios::beg);
+		if (!file.read(reinterpret_cast<char*>(content.data()),
+					   static_cast<std::streamsize>(content.size())))
+		{
+			std::cerr << "Failed to read file: " << sourcePath << "\n";
+			return false;
+		}
+
+		return add(path, content);
+	}
+
+	size_t ArchiveWriter::addDirectory(const std::string& directory, const std::string_view prefix)
+	{
+		namespace fs = std::filesystem;
+
+		std::error_code error;
+		fs::recursive_directory_iterator it{directory, error};
+		if (error)
+		{
+			std::cerr << "Failed to open directory: " << directory << "\n";
+			return 0;
+		}
+
+		size_t count{};
+		for (const fs::directory_entry& entry : it)
+		{
+			if (!entry.is_regular_file(error))
+				continue;
+
+			std::string path{prefix};
+			if (!path.empty())
+				path += '/';
+			path += entry.path().lexically_relative(directory).generic_string();
+
+			if (addFile(path, entry.path().string()))
+				++count;
+		}
+		return count;
+	}
+
+	bool ArchiveWriter::write(const std::string& path, JobSystem* jobs) const
+	{
+		LUNE_ZONE("ArchiveWriter::write");
+
+		if (!isCompressionAvailable(m_compression))
+			std::cerr << "Archive " << path << ": " << compressionName(m_compression)
+					  << " support not compiled in, storing blocks uncompressed\n";
+
+		// Every block of every file, compressed independently
+		std::vector<std::span<const std::byte>> blocks;
+		for (const auto& [name, content] : m_files)
+		{
+			const std::span<const std::byte> bytes{content};
+			for (size_t offset = 0; offset < bytes.size(); offset += m_blockSize)
+				blocks.push_back(bytes.subspan(offset, std::min<size_t>(m_blockSize,
+																		  bytes.size() - offset)));
+		}
+
+		if (blocks.size() > UINT32_MAX)
+		{
+			std::cerr << "Archive has too many blocks: " << path << "\n";
+			return false;
+		}
+
+		std::vector<std::vector<std::byte>> compressed(blocks.size());
+		if (m_compression != ARCHIVE_STORED)
+		{
+			const auto run{[&](const size_t begin, const size_t end)
+						   {
+							   for (size_t i = begin; i < end; ++i)
+								   compressed[i] = compressBlock(m_compression, blocks[i]);
+						   }};
+
+			if (jobs && blocks.size() > 1)
+				jobs->parallelFor(blocks.size(), 1, run);
+			else
+				run(0, blocks.size());
+		}
+
+		// Lay out the data: a file with any compressed block only needs section alignment
+		ArchiveHeader header{};
+		header.blockSize = m_blockSize;
+		header.entryCount = static_cast<uint32_t>(m_files.size());
+		header.blockCount = static_cast<uint32_t>(blocks.size());
+
+		std::vector<ArchiveEntry> entries;
+		std::vector<ArchiveBlock> blockEntries;
+		std::string names;
+		entries.reserve(m_files.size());
+		blockEntries.reserve(blocks.size());
+
+		uint64_t offset{sizeof(ArchiveHeader)};
+		for (const auto& [name, content] : m_files)
+		{
+			ArchiveEntry entry{};
+			entry.nameOffset = static_cast<uint32_t>(names.size());
+			entry.nameLength = static_cast<uint32_t>(name.size());
+			entry.size = content.size();
+			entry.firstBlock = static_cast<uint32_t>(blockEntries.size());
+			entry.blockCount = static_cast<uint32_t>((content.size() + m_blockSize - 1) /
+													 m_blockSize);
+			names += name;
+
+			bool stored{true};
+			for (uint32_t i = 0; i < entry.blockCount; ++i)
+				stored = stored && compressed[entry.firstBlock + i].empty();
+			offset = alignUp(offset, stored ? ARCHIVE_PAGE_ALIGNMENT : ARCHIVE_SECTION_ALIGNMENT);
+
+			for (uint32_t i = 0; i < entry.blockCount; ++i)
+			{
+				const size_t index{entry.firstBlock + i};
+				const bool isCompressed{!compressed[index].empty()};
+				const size_t size{isCompressed ? compressed[index].size() : blocks[index].size()};
+				blockEntries.push_back({offset, static_cast<uint32_t>(size),
+										isCompressed ? m_compression : ARCHIVE_STORED});
+				offset += size;
+			}
+
+			entries.push_back(entry);
+		}
+
+		if (names.size() > UINT32_MAX)
+		{
+			std::cerr << "Archive name table is too large: " << path << "\n";
+			return false;
+		}
+
+		header.entriesOffset = alignUp(offset, ARCHIVE_SECTION_ALIGNMENT);
+		header.blocksOffset = alignUp(header.entriesOffset + entries.size() * sizeof(ArchiveEntry),
+									  ARCHIVE_SECTION_ALIGNMENT);
+		header.nameTableOffset =
+				alignUp(header.blocksOffset + blockEntries.size() * sizeof(ArchiveBlock),
+						ARCHIVE_SECTION_ALIGNMENT);
+		header.nameTableSize = static_cast<uint32_t>(names.size());
+
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		if (!out)
+		{
+			std::cerr << "Failed to open file for writing: " << path << "\n";
+			return false;
+		}
+
+		uint64_t written{};
+		const auto write{[&](const void* data, const uint64_t at, const size_t size)
+						 { writeAt(out, written, data, at, size); }};
+
+		write(&header, 0, sizeof(header));
+		for (size_t i = 0; i < blocks.size(); ++i)
+		{
+			const std::span<const std::byte> data{
+					compressed[i].empty() ? blocks[i] : std::span<const std::byte>{compressed[i]}};
+			write(data.data(), blockEntries[i].offset, data.size());
+		}
+		write(entries.data(), header.entriesOffset, entries.size() * sizeof(ArchiveEntry));
+		write(blockEntries.data(), header.blocksOffset,
+			  blockEntries.size() * sizeof(ArchiveBlock));
+		write(names.data(), header.nameTableOffset, names.size());
+
+		if (!out)
+		{
+			std::cerr << "Failed to write archive: " << path << "\n";
+			return false;
+		}
+		return true;
+	}
+} // namespace lune
@@ -0,0 +1,251 @@
+module;
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+export module lune.vfs:archive;
+
+import lune.jobs;
+import :mapped_file;
+
+namespace lune
+{
+	export inline constexpr uint32_t ARCHIVE_MAGIC{0x4B41504C}; ///< "LPAK" in little-endian.
+	export inline constexpr uint32_t ARCHIVE_VERSION{1};
+	export inline constexpr uint32_t ARCHIVE_DEFAULT_BLOCK_SIZE{256 * 1024};
+
+	/// Alignment of uncompressed files, so they can be used in place from the mapping (e.g. as
+	/// page-aligned GPU buffer contents).
+	export inline constexpr size_t ARCHIVE_PAGE_ALIGNMENT{4096};
+
+	/// Alignment of compressed files and of the table of contents.
+	export inline constexpr size_t ARCHIVE_SECTION_ALIGNMENT{16};
+
+	/**
+	 * @brief How a block of an archive is stored.
+	 */
+	export enum ArchiveCompression : uint32_t
+	{
+		ARCHIVE_STORED, ///< Uncompressed.
+		ARCHIVE_LZ4,	///< LZ4 (HC when writing): fastest to decompress.
+		ARCHIVE_ZSTD	///< Zstandard: smaller, slower to decompress.
+	};
+
+
+	/**
+	 * @brief A file of the archive: a run of consecutive blocks, every block but the last holding
+	 * `ArchiveHeader::blockSize` bytes once decompressed.
+	 */
+	export struct ArchiveEntry
+	{
+		uint32_t nameOffset{}; ///< Offset of the path in the name table.
+		uint32_t nameLength{};
+		uint64_t size{}; ///< Decompressed size.
+		uint32_t firstBlock{};
+		uint32_t blockCount{};
+	};
+
+
+	/**
+	 * @brief A block of a file, compressed on its own so blocks decompress in parallel.
+	 */
+	export struct ArchiveBlock
+	{
+		uint64_t offset{}; ///< Relative to the start of the archive.
+		uint32_t compressedSize{};
+		uint32_t compression{}; ///< `ArchiveCompression`.
+	};
+
+
+	/**
+	 * @brief Fixed-size header at the start of every archive.
+	 *
+	 * File data follows the header; the table of contents (entries sorted by path, blocks and the
+	 * name table) is written after the data, each part on a `ARCHIVE_SECTION_ALIGNMENT` boundary.
+	 */
+	export struct ArchiveHeader
+	{
+		uint32_t magic{ARCHIVE_MAGIC};
+		uint32_t version{ARCHIVE_VERSION};
+		uint32_t blockSize{ARCHIVE_DEFAULT_BLOCK_SIZE};
+		uint32_t entryCount{};
+		uint32_t blockCount{};
+		uint32_t nameTableSize{};
+		uint64_t entriesOffset{}; ///< `ArchiveEntry[entryCount]`.
+		uint64_t blocksOffset{};  ///< `ArchiveBlock[blockCount]`.
+		uint64_t nameTableOffset{};
+	};
+
+	static_assert(std::is_trivially_copyable_v<ArchiveHeader>);
+	static_assert(sizeof(ArchiveHeader) % ARCHIVE_SECTION_ALIGNMENT == 0);
+	static_assert(sizeof(ArchiveEntry) == 24 && sizeof(ArchiveBlock) == 16);
+
+
+	/**
+	 * @brief Normalizes a virtual path: '/' separators, no empty, "." or ".." components and no
+	 * leading or trailing separator.
+	 *
+	 * @return The normalized path; std::nullopt for absolute paths and paths leaving the root.
+	 */
+	std::optional<std::string> normalizeVirtualPath(std::string_view path);
+
+
+	/**
+	 * @brief Read-only, memory-mapped asset archive (`.lpak`) written by `ArchiveWriter`.
+	 *
+	 * Opening validates the table of contents; lookups are a binary search over the sorted
+	 * entries. Uncompressed files are views straight into the mapping, and compressed files are
+	 * decompressed block by block, in parallel when a job system is given. An archive is
+	 * immutable once open and can be read from any number of threads.
+	 */
+	export class Archive
+	{
+		MappedFile m_file;
+		std::span<const ArchiveEntry> m_entries;
+		std::span<const ArchiveBlock> m_blocks;
+		std::string_view m_names;
+		uint32_t m_blockSize{};
+
+	public:
+		Archive() = default;
+
+		/**
+		 * @brief Maps an archive and validates its table of contents.
+		 *
+		 * @param path Path to the archive on disk.
+		 *
+		 * @return The archive on success; std::nullopt if it is missing or malformed.
+		 */
+		static std::optional<Archive> open(const std::string& path);
+
+		[[nodiscard]] bool contains(std::string_view path) const;
+
+		/**
+		 * @brief Gets the decompressed size of a file.
+		 *
+		 * @return The size, or std::nullopt if the archive has no such file.
+		 */
+		[[nodiscard]] std::optional<uint64_t> size(std::string_view path) const;
+
+		/**
+		 * @brief Gets the contents of an uncompressed file without copying them.
+		 *
+		 * @return A view into the mapping, valid as long as the archive; std::nullopt if the file
+		 * is missing or has compressed blocks.
+		 */
+		[[nodiscard]] std::optional<std::span<const std::byte>> view(std::string_view path) const;
+
+		/**
+		 * @brief Reads and decompresses a file.
+		 *
+		 * @param jobs Job system to decompress the blocks on; nullptr to decompress them on the
+		 * calling thread.
+		 *
+		 * @return The contents; std::nullopt if the file is missing or fails to decompress.
+		 */
+		[[nodiscard]] std::optional<std::vector<std::byte>> read(std::string_view path,
+																 JobSystem* jobs = nullptr) const;
+
+		/**
+		 * @brief Decompresses a file into caller-provided memory.
+		 *
+		 * @param output Exactly `size(path)` bytes.
+		 *
+		 * @return true if every block was decompressed.
+		 */
+		bool readInto(std::string_view path, std::span<std::byte> output,
+					  JobSystem* jobs = nullptr) const;
+
+		/**
+		 * @brief Lists the paths of every file, in sorted order.
+		 */
+		[[nodiscard]] std::vector<std::string_view> list() const;
+
+		[[nodiscard]] size_t fileCount() const noexcept
+		{
+			return m_entries.size();
+		}
+
+		[[nodiscard]] bool isOpen() const noexcept
+		{
+			return m_file.isOpen();
+		}
+
+	private:
+		[[nodiscard]] const ArchiveEntry* find(std::string_view path) const;
+
+		[[nodiscard]] std::string_view name(const ArchiveEntry& entry) const noexcept
+		{
+			return m_names.substr(entry.nameOffset, entry.nameLength);
+		}
+	};
+
+
+	/**
+	 * @brief Builds an asset archive offline, e.g. from a directory of cooked assets.
+	 *
+	 * Files are split into blocks that are compressed independently, in parallel when a job
+	 * system is given. A block that does not shrink is stored as is, and files with no compressed
+	 * blocks are page aligned so they can be viewed in place.
+	 *
+	 * @code
+	 * ArchiveWriter writer{ARCHIVE_LZ4};
+	 * writer.addDirectory("assets");
+	 * writer.write("assets.lpak", &JobSystem::instance());
+	 * @endcode
+	 */
+	export class ArchiveWriter
+	{
+		ArchiveCompression m_compression;
+		uint32_t m_blockSize;
+		std::map<std::string, std::vector<std::byte>, std::less<>> m_files;
+
+	public:
+		explicit ArchiveWriter(ArchiveCompression compression = ARCHIVE_LZ4,
+							   uint32_t blockSize = ARCHIVE_DEFAULT_BLOCK_SIZE);
+
+		/**
+		 * @brief Adds a file, replacing any earlier file with the same path.
+		 *
+		 * @param path Virtual path of the file in the archive.
+		 *
+		 * @return false if the path is absolute or leaves the archive root.
+		 */
+		bool add(std::string_view path, std::span<const std::byte> content);
+
+		/**
+		 * @brief Adds a file from disk.
+		 *
+		 * @param path Virtual path of the file in the archive.
+		 * @param sourcePath Path of the file on disk.
+		 */
+		bool addFile(std::string_view path, const std::string& sourcePath);
+
+		/**
+		 * @brief Adds every regular file under a directory, recursively.
+		 *
+		 * @param prefix Virtual directory the files are added under; empty for the archive root.
+		 *
+		 * @return Number of files added.
+		 */
+		size_t addDirectory(const std::string& directory, std::string_view prefix = {});
+
+		/**
+		 * @brief Writes the archive.
+		 *
+		 * @return true if the whole archive was written.
+		 */
+		bool write(const std::string& path, JobSystem* jobs = nullptr) const;
+
+		[[nodiscard]] size_t fileCount() const noexcept
+		{
+			return m_files.size();
+		}
+	};
+} // namespace lune
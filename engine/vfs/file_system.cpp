@@ -0,0 +1,244 @@
+module;
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+module lune.vfs;
+
+import lune.jobs;
+
+namespace lune
+{
+	namespace
+	{
+		struct Mount
+		{
+			std::string source;
+			std::string point; ///< Normalized virtual directory; empty for the root.
+			std::filesystem::path directory;
+			std::shared_ptr<const Archive> archive; ///< Shared with the reads in flight.
+
+			/**
+			 * @brief Gets the path of a file relative to this mount.
+			 *
+			 * @return The relative path, or std::nullopt if the file is outside the mount point.
+			 */
+			[[nodiscard]] std::optional<std::string_view>
+			relative(const std::string_view path) const
+			{
+				if (point.empty())
+					return path;
+
+				if (path.size() <= point.size() || !path.starts_with(point) ||
+					path[point.size()] != '/')
+					return std::nullopt;
+
+				return path.substr(point.size() + 1);
+			}
+		};
+
+		struct MountTable
+		{
+			std::shared_mutex mutex;
+			std::vector<Mount> mounts; ///< In mount order; lookups walk it backwards.
+		};
+
+		MountTable& mountTable()
+		{
+			static MountTable table;
+			return table;
+		}
+
+		/**
+		 * @brief Reads a file from disk, silently failing if it doesn't exist.
+		 */
+		std::optional<std::vector<std::byte>> readDisk(const std::filesystem::path& path)
+		{
+			std::ifstream file(path, std::ios::binary | std::ios::ate);
+			if (!file)
+				return std::nullopt;
+
+			const std::streamsize size{file.tellg()};
+			if (size < 0)
+				return std::nullopt;
+			file.seekg(0, std::ios::beg);
+
+			std::vector<std::byte> bytes(static_cast<size_t>(size));
+			if (!file.read(reinterpret_cast<char*>(bytes.data()), size))
+			{
+				std::cerr << "Failed to read file: " << path.string() << "\n";
+				return std::nullopt;
+			}
+
+			return bytes;
+		}
+
+		[[nodiscard]] bool isFile(const std::filesystem::path& path)
+		{
+			std::error_code error;
+			return std::filesystem::is_regular_file(path, error);
+		}
+	} // namespace
+
+	bool Vfs::mount(const std::string& source, const std::string& mountPoint)
+	{
+		auto point{normalizeVirtualPath(mountPoint)};
+		if (!point)
+		{
+			std::cerr << "Invalid mount point: " << mountPoint << "\n";
+			return false;
+		}
+
+		Mount mount{source, std::move(*point), {}, nullptr};
+
+		std::error_code error;
+		if (std::filesystem::is_directory(source, error))
+		{
+			// Absolute, so a later change of working directory doesn't move the mount
+			mount.directory = std::filesystem::absolute(source, error);
+		}
+		else
+		{
+			auto archive{Archive::open(source)};
+			if (!archive)
+				return false;
+			mount.archive = std::make_shared<const Archive>(std::move(*archive));
+		}
+
+		MountTable& table{mountTable()};
+		const std::unique_lock lock{table.mutex};
+		table.mounts.push_back(std::move(mount));
+		return true;
+	}
+
+	bool Vfs::unmount(const std::string& source)
+	{
+		MountTable& table{mountTable()};
+		const std::unique_lock lock{table.mutex};
+		return std::erase_if(table.mounts,
+							 [&](const Mount& mount) { return mount.source == source; }) > 0;
+	}
+
+	void Vfs::unmountAll()
+	{
+		MountTable& table{mountTable()};
+		const std::unique_lock lock{table.mutex};
+		table.mounts.clear();
+	}
+
+	size_t Vfs::mountCount()
+	{
+		MountTable& table{mountTable()};
+		const std::shared_lock lock{table.mutex};
+		return table.mounts.size();
+	}
+
+	bool Vfs::exists(const std::string& path)
+	{
+		if (const auto virtualPath{normalizeVirtualPath(path)})
+		{
+			MountTable& table{mountTable()};
+			const std::shared_lock lock{table.mutex};
+			for (auto mount = table.mounts.rbegin(); mount != table.mounts.rend(); ++mount)
+			{
+				const auto relative{mount->relative(*virtualPath)};
+				if (!relative)
+					continue;
+
+				if (mount->archive ? mount->archive->contains(*relative)
+								   : isFile(mount->directory / *relative))
+					return true;
+			}
+		}
+
+		return isFile(path);
+	}
+
+	std::optional<std::vector<std::byte>> Vfs::readBinary(const std::string& path,
+														  JobSystem* jobs)
+	{
+		std::shared_ptr<const Archive> archive;
+		std::string archived;
+		std::filesystem::path file{path};
+
+		if (const auto virtualPath{normalizeVirtualPath(path)})
+		{
+			MountTable& table{mountTable()};
+			const std::shared_lock lock{table.mutex};
+			for (auto mount = table.mounts.rbegin(); mount != table.mounts.rend(); ++mount)
+			{
+				const auto relative{mount->relative(*virtualPath)};
+				if (!relative)
+					continue;
+
+				if (mount->archive)
+				{
+					if (mount->archive->contains(*relative))
+					{
+						archive = mount->archive;
+						archived = *relative;
+						break;
+					}
+				}
+				else if (std::filesystem::path candidate{mount->directory / *relative};
+						 isFile(candidate))
+				{
+					file = std::move(candidate);
+					break;
+				}
+			}
+		}
+
+		// Read without the mount table locked: decompressing waits on the job system, whose
+		// queued jobs may be reading files too. The archive stays open if it is unmounted.
+		if (archive)
+			return archive->read(archived, jobs);
+		return readDisk(file);
+	}
+
+	std::optional<std::string> Vfs::read(const std::string& path, JobSystem* jobs)
+	{
+		const auto bytes{readBinary(path, jobs)};
+		if (!bytes)
+			return std::nullopt;
+
+		return std::string(reinterpret_cast<const char*>(bytes->data()), bytes->size());
+	}
+
+	std::optional<std::string> Vfs::resolve(const std::string& path)
+	{
+		if (const auto virtualPath{normalizeVirtualPath(path)})
+		{
+			MountTable& table{mountTable()};
+			const std::shared_lock lock{table.mutex};
+			for (auto mount = table.mounts.rbegin(); mount != table.mounts.rend(); ++mount)
+			{
+				const auto relative{mount->relative(*virtualPath)};
+				if (!relative)
+					continue;
+
+				if (mount->archive)
+				{
+					if (mount->archive->contains(*relative))
+						return std::nullopt;
+				}
+				else if (const std::filesystem::path file{mount->directory / *relative};
+						 isFile(file))
+				{
+					return file.string();
+				}
+			}
+		}
+
+		return path;
+	}
+} // namespace lune
@@ -0,0 +1,90 @@
+module;
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+export module lune.vfs:file_system;
+
+import lune.jobs;
+
+namespace lune
+{
+	/**
+	 * @brief Virtual file system: resolves engine paths against mounted directories and archives.
+	 *
+	 * A mount makes a directory on disk or an `.lpak` archive visible under a virtual mount
+	 * point. Lookups try the most recent mount first, so a mounted patch archive or a loose
+	 * development directory overrides the files of earlier mounts. Paths that no mount provides
+	 * are read from disk as given, so absolute and working-directory relative paths keep working.
+	 *
+	 * `File`, the texture and shader loaders and shader reflection all read through the file
+	 * system, so mounting is all it takes for assets to be loaded from archives:
+	 *
+	 * @code
+	 * Vfs::mount(getWorkingDirectory() + "/assets.lpak");
+	 * Vfs::mount("assets", "shaders"); // Loose shaders override the archived ones
+	 *
+	 * const auto source{File::read("shaders/triangle.metal")};
+	 * @endcode
+	 *
+	 * Mounting and reading are thread-safe.
+	 */
+	export class Vfs
+	{
+	public:
+		/**
+		 * @brief Mounts a directory or an archive.
+		 *
+		 * @param source Path of a directory or an `.lpak` archive on disk.
+		 * @param mountPoint Virtual directory the contents appear under; empty for the root.
+		 *
+		 * @return false if the source is missing or not a valid archive.
+		 */
+		static bool mount(const std::string& source, const std::string& mountPoint = {});
+
+		/**
+		 * @brief Removes every mount of a source.
+		 *
+		 * @return true if the source was mounted.
+		 */
+		static bool unmount(const std::string& source);
+
+		static void unmountAll();
+
+		[[nodiscard]] static size_t mountCount();
+
+		/**
+		 * @brief Checks whether a file exists in a mount or on disk.
+		 */
+		[[nodiscard]] static bool exists(const std::string& path);
+
+		/**
+		 * @brief Reads a file from the most recent mount that has it, or from disk.
+		 *
+		 * Nothing is reported when the file doesn't exist, so callers can probe for optional
+		 * files; corrupt archives are reported to stderr.
+		 *
+		 * @param jobs Job system to decompress archived blocks on; nullptr to decompress them on
+		 * the calling thread.
+		 *
+		 * @return The contents; std::nullopt if the file doesn't exist or can't be read.
+		 */
+		[[nodiscard]] static std::optional<std::vector<std::byte>>
+		readBinary(const std::string& path, JobSystem* jobs = nullptr);
+
+		/**
+		 * @brief Reads a text file from the most recent mount that has it, or from disk.
+		 */
+		[[nodiscard]] static std::optional<std::string> read(const std::string& path,
+															  JobSystem* jobs = nullptr);
+
+		/**
+		 * @brief Resolves a path to a file on disk, for loaders that need one (e.g. to memory map
+		 * it or to watch it for changes).
+		 *
+		 * @return The path in the directory mount that has the file, the path itself if no mount
+		 * has it, or std::nullopt if the file only exists inside an archive.
+		 */
+		[[nodiscard]] static std::optional<std::string> resolve(const std::string& path);
+	};
+} // namespace lune
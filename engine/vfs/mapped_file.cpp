@@ -0,0 +1,79 @@
+module;
+#include <fcntl.h>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+module lune.vfs;
+
+namespace lune
+{
+	MappedFile::~MappedFile()
+	{
+		close();
+	}
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept :
+		m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0))
+	{
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+	{
+		if (this != &other)
+		{
+			close();
+			m_data = std::exchange(other.m_data, nullptr);
+			m_size = std::exchange(other.m_size, 0);
+		}
+		return *this;
+	}
+
+	std::optional<MappedFile> MappedFile::open(const std::string& path)
+	{
+		const int fd{::open(path.c_str(), O_RDONLY)};
+		if (fd < 0)
+		{
+			std::cerr << "Failed to open file: " << path << "\n";
+			return std::nullopt;
+		}
+
+		struct stat info{};
+		if (fstat(fd, &info) != 0 || info.st_size <= 0)
+		{
+			std::cerr << "Failed to map empty or unreadable file: " << path << "\n";
+			::close(fd);
+			return std::nullopt;
+		}
+
+		const auto size{static_cast<size_t>(info.st_size)};
+		void* data{mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0)};
+
+		// The mapping keeps its own reference to the file
+		::close(fd);
+
+		if (data == MAP_FAILED)
+		{
+			std::cerr << "Failed to map file: " << path << "\n";
+			return std::nullopt;
+		}
+
+		MappedFile file;
+		file.m_data = static_cast<std::byte*>(data);
+		file.m_size = size;
+		return file;
+	}
+
+	void MappedFile::close()
+	{
+		if (m_data)
+		{
+			munmap(m_data, m_size);
+			m_data = nullptr;
+			m_size = 0;
+		}
+	}
+} // namespace lune
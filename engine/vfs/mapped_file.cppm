@@ -0,0 +1,65 @@
+module;
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string>
+export module lune.vfs:mapped_file;
+
+namespace lune
+{
+	/**
+	 * @brief Read-only memory mapping of a file.
+	 *
+	 * The file contents are paged in lazily by the OS on first access, which makes this the
+	 * preferred way to load large precooked assets: no parsing and no intermediate copy.
+	 */
+	export class MappedFile
+	{
+		std::byte* m_data{};
+		size_t m_size{};
+
+	public:
+		MappedFile() = default;
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		/**
+		 * @brief Maps the whole file into memory.
+		 *
+		 * @param path Path to the file.
+		 *
+		 * @return The mapping on success; std::nullopt if the file could not be opened or mapped.
+		 */
+		static std::optional<MappedFile> open(const std::string& path);
+
+		/**
+		 * @brief Unmaps the file. Safe to call on an empty mapping.
+		 */
+		void close();
+
+		[[nodiscard]] const std::byte* data() const noexcept
+		{
+			return m_data;
+		}
+
+		[[nodiscard]] size_t size() const noexcept
+		{
+			return m_size;
+		}
+
+		[[nodiscard]] std::span<const std::byte> bytes() const noexcept
+		{
+			return {m_data, m_size};
+		}
+
+		[[nodiscard]] bool isOpen() const noexcept
+		{
+			return m_data != nullptr;
+		}
+	};
+} // namespace lune
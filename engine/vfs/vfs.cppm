@@ -0,0 +1,5 @@
+export module lune.vfs;
+
+export import :mapped_file;
+export import :archive;
+export import :file_system;
@@ -1,3 +1,4 @@
+#include <cstdlib>
 import lune;
 import sandbox;
 using namespace sandbox;
@@ -46,38 +47,32 @@ int main()
 			.setUniform("vertexColors", colors, sizeof(colors));
 
 
+	// LUNE_RENDER_THREAD encodes frames on a render thread while the next one is simulated
+	lune::gfx::RenderQueue queue{std::getenv("LUNE_RENDER_THREAD") != nullptr};
+
 	window.show();
 	timer.start();
 	while (!window.shouldClose())
 	{
 		if (lune::InputManager::isJustPressed(lune::KEY_ESCAPE))
 			window.setShouldClose(true);
-		material.setUniform("u", static_cast<float>(timer.peakDelta()));
 
-		if (lune::InputManager::isPressed(lune::KEY_W))
-		{
-			pass.begin()
-					.setFillMode(lune::gfx::Wireframe)
-					.bind(material)
-					.drawIndexed(lune::gfx::Triangle, 36, indexBuffer, 0) // Optimized indexed draw
-					.bind(materialA2)
-					.draw(lune::gfx::Triangle, 0, 3)
-					.bind(materialA)
-					.draw(lune::gfx::Triangle, 0, 6)
-					.end();
-		}
-		else
-		{
-			pass.begin()
-					.bind(material)
-					.drawIndexed(lune::gfx::Triangle, 36, indexBuffer, 0)
-					.bind(materialA2)
-					.draw(lune::gfx::Triangle, 0, 3)
-					.bind(materialA)
-					.draw(lune::gfx::Triangle, 0, 6)
-					.end();
-		}
+		lune::gfx::RenderCommandList& frame{queue.commands()};
+		frame.setUniform(material, "u", static_cast<float>(timer.peakDelta()));
 
+		auto recorder{frame.pass(pass)};
+		recorder.begin();
+		if (lune::InputManager::isPressed(lune::KEY_W))
+			recorder.setFillMode(lune::gfx::Wireframe);
+
+		recorder.bind(material)
+				.drawIndexed(lune::gfx::Triangle, 36, indexBuffer, 0) // Optimized indexed draw
+				.bind(materialA2)
+				.draw(lune::gfx::Triangle, 0, 3)
+				.bind(materialA)
+				.draw(lune::gfx::Triangle, 0, 6)
+				.end();
+		queue.submit();
 
 		lune::Window::pollEvents();
 	}
@@ -0,0 +1,186 @@
+#include <catch.hpp>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+import lune;
+
+using namespace lune;
+
+
+static MeshSource makeGrid(const uint32_t size)
+{
+	MeshSource source;
+
+	for (uint32_t y = 0; y <= size; ++y)
+	{
+		for (uint32_t x = 0; x <= size; ++x)
+		{
+			MeshVertex vertex{};
+			vertex.position[0] = static_cast<float>(x);
+			vertex.position[1] = static_cast<float>(y);
+			vertex.position[2] = std::sin(static_cast<float>(x) * 0.2f) * 0.3f;
+			vertex.normal[2] = 1.0f;
+			vertex.uv[0] = static_cast<float>(x) / static_cast<float>(size);
+			vertex.uv[1] = static_cast<float>(y) / static_cast<float>(size);
+			source.vertices.push_back(vertex);
+		}
+	}
+
+	for (uint32_t y = 0; y < size; ++y)
+	{
+		for (uint32_t x = 0; x < size; ++x)
+		{
+			const uint32_t a{y * (size + 1) + x};
+			const uint32_t b{a + 1};
+			const uint32_t c{a + size + 1};
+			const uint32_t d{c + 1};
+			source.indices.insert(source.indices.end(), {a, b, d, a, d, c});
+		}
+	}
+
+	return source;
+}
+
+static std::string tempPath(const std::string& name)
+{
+	return (std::filesystem::temp_directory_path() / name).string();
+}
+
+TEST_CASE("Cooked mesh round trips through MeshFile", "[Mesh]")
+{
+	const MeshSource source{makeGrid(16)};
+	const std::string path{tempPath("lune_test_grid.lmesh")};
+
+	for (const MeshLayout layout : {MESH_INTERLEAVED, MESH_SEPARATE_STREAMS})
+	{
+		REQUIRE(MeshCooker::cookToFile(source, path, {.layout = layout, .buildMeshlets = false}));
+
+		const auto mesh{MeshFile::open(path)};
+		REQUIRE(mesh.has_value());
+		REQUIRE(mesh->layout() == layout);
+		REQUIRE(mesh->vertexCount() == source.vertices.size());
+		REQUIRE(mesh->indexSize() == 2);
+		REQUIRE(mesh->lods().front().indexCount == source.indices.size());
+
+		for (size_t i = 0; i < source.indices.size(); ++i)
+			REQUIRE(mesh->index(i) == source.indices[i]);
+
+		if (layout == MESH_INTERLEAVED)
+		{
+			REQUIRE(mesh->vertices().size() == source.vertices.size());
+			REQUIRE(mesh->positions().empty());
+			REQUIRE(mesh->vertices()[20].position[0] == Catch::Approx(3.0f));
+		}
+		else
+		{
+			REQUIRE(mesh->vertices().empty());
+			REQUIRE(mesh->positions().size() == source.vertices.size() * 3);
+			REQUIRE(mesh->uvs()[40] == Catch::Approx(source.vertices[20].uv[0]));
+		}
+
+		REQUIRE(mesh->header().aabbMax[0] == Catch::Approx(16.0f));
+		REQUIRE(mesh->header().aabbMax[1] == Catch::Approx(16.0f));
+	}
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("Mesh LOD chain reduces triangle count", "[Mesh]")
+{
+	const MeshSource source{makeGrid(32)};
+	const std::vector<std::byte> bytes{MeshCooker::cook(source, {.maxLodCount = 4})};
+	const std::string path{tempPath("lune_test_lods.lmesh")};
+	REQUIRE(File::writeBinary(path, bytes));
+
+	const auto mesh{MeshFile::open(path)};
+	REQUIRE(mesh.has_value());
+	REQUIRE(mesh->lods().size() > 1);
+
+	for (size_t i = 1; i < mesh->lods().size(); ++i)
+	{
+		const MeshLod& previous{mesh->lods()[i - 1]};
+		const MeshLod& lod{mesh->lods()[i]};
+
+		REQUIRE(lod.indexCount < previous.indexCount);
+		REQUIRE(lod.indexOffset == previous.indexOffset + previous.indexCount);
+		REQUIRE(lod.error >= previous.error);
+	}
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("Meshlets respect limits and cover every triangle", "[Mesh]")
+{
+	const MeshSource source{makeGrid(32)};
+	std::vector<uint32_t> meshletVertices;
+	std::vector<uint8_t> meshletTriangles;
+
+	const std::vector<Meshlet> meshlets{MeshCooker::buildMeshlets(
+			source.vertices, source.indices, 64, 124, meshletVertices, meshletTriangles)};
+
+	size_t triangleCount{};
+	for (const Meshlet& meshlet : meshlets)
+	{
+		REQUIRE(meshlet.vertexCount <= 64);
+		REQUIRE(meshlet.triangleCount <= 124);
+		REQUIRE(meshlet.triangleOffset % 4 == 0);
+
+		for (uint32_t i = 0; i < meshlet.triangleCount * 3; ++i)
+			REQUIRE(meshletTriangles[meshlet.triangleOffset + i] < meshlet.vertexCount);
+
+		triangleCount += meshlet.triangleCount;
+	}
+
+	REQUIRE(triangleCount == source.indices.size() / 3);
+}
+
+TEST_CASE("MeshFile rejects malformed files", "[Mesh]")
+{
+	const std::string path{tempPath("lune_test_bad.lmesh")};
+	File::write(path, "definitely not a mesh");
+
+	REQUIRE_FALSE(MeshFile::open(path).has_value());
+	REQUIRE_FALSE(MeshFile::open(tempPath("lune_test_missing.lmesh")).has_value());
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("MeshFile rejects counts and ranges past their sections", "[Mesh]")
+{
+	const std::vector<std::byte> cooked{MeshCooker::cook(makeGrid(16))};
+	const std::string path{tempPath("lune_test_ranges.lmesh")};
+
+	MeshHeader header;
+	std::memcpy(&header, cooked.data(), sizeof(header));
+	REQUIRE(header.lodCount > 0);
+	REQUIRE(header.meshletCount > 0);
+
+	// Writes the cooked mesh with one of its header fields or table entries corrupted
+	const auto corrupt{[&](const size_t offset, const uint32_t value)
+					   {
+						   std::vector<std::byte> bytes{cooked};
+						   std::memcpy(bytes.data() + offset, &value, sizeof(value));
+						   REQUIRE(File::writeBinary(path, bytes));
+						   return MeshFile::open(path).has_value();
+					   }};
+
+	REQUIRE(corrupt(offsetof(MeshHeader, vertexCount), header.vertexCount));
+	REQUIRE_FALSE(corrupt(offsetof(MeshHeader, vertexCount), header.vertexCount + 1));
+	REQUIRE_FALSE(corrupt(offsetof(MeshHeader, indexCount), header.indexCount + 1));
+	REQUIRE_FALSE(corrupt(offsetof(MeshHeader, lodCount), 1'000'000));
+	REQUIRE_FALSE(corrupt(offsetof(MeshHeader, layout), 7));
+
+	const size_t lod{header.lods.offset};
+	REQUIRE_FALSE(corrupt(lod + offsetof(MeshLod, indexCount), header.indexCount + 1));
+	REQUIRE_FALSE(corrupt(lod + offsetof(MeshLod, indexOffset), 0xFFFFFFFF));
+
+	const size_t meshlet{header.meshlets.offset};
+	REQUIRE_FALSE(corrupt(meshlet + offsetof(Meshlet, vertexOffset), 0xFFFFFFFF));
+	REQUIRE_FALSE(corrupt(meshlet + offsetof(Meshlet, triangleCount), 0xFFFFFFFF));
+
+	std::filesystem::remove(path);
+}
@@ -0,0 +1,220 @@
+#include <catch.hpp>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+import lune;
+
+using namespace lune;
+
+
+namespace
+{
+	struct FakeAsset
+	{
+		std::string path;
+	};
+
+	std::unique_ptr<FakeAsset> makeAsset(const std::string& path)
+	{
+		return std::make_unique<FakeAsset>(FakeAsset{path});
+	}
+
+	/// Loads a `FakeAsset` of 100 GPU bytes per path, failing for paths starting with "missing".
+	struct FakeLoader
+	{
+		std::mutex mutex;
+		std::map<std::string, int> loads;
+		std::shared_future<void> gate; ///< Holds loads back until set, if valid.
+
+		ResourceLoader<FakeAsset> loader()
+		{
+			return [this](const std::string& path) -> std::optional<LoadedResource<FakeAsset>>
+			{
+				if (gate.valid())
+					gate.wait();
+
+				{
+					const std::lock_guard lock{mutex};
+					++loads[path];
+				}
+
+				if (path.starts_with("missing"))
+					return std::nullopt;
+				return LoadedResource<FakeAsset>{makeAsset(path), {0, 100}};
+			};
+		}
+
+		int loadCount(const std::string& path)
+		{
+			const std::lock_guard lock{mutex};
+			return loads[path];
+		}
+	};
+
+} // namespace
+
+
+TEST_CASE("ResourceManager shares resources by path", "[ResourceManager]")
+{
+	FakeLoader fake;
+	ResourceManager resources{nullptr};
+	resources.registerLoader(fake.loader(), makeAsset("placeholder"));
+
+	const ResourceHandle<FakeAsset> a{resources.load<FakeAsset>("textures/a.png")};
+	const ResourceHandle<FakeAsset> same{resources.load<FakeAsset>("./textures/x/../a.png")};
+	const ResourceHandle<FakeAsset> b{resources.load<FakeAsset>("textures/b.png")};
+
+	REQUIRE(a == same);
+	REQUIRE_FALSE(a == b);
+	REQUIRE(fake.loadCount("textures/a.png") == 1);
+	REQUIRE(resources.resourceCount() == 2);
+	REQUIRE(resources.usage() == ResourceMemory{0, 200});
+	REQUIRE(resources.state(a) == RESOURCE_READY);
+	REQUIRE(resources.get(a)->path == "textures/a.png");
+
+	SECTION("The last release destroys the resource")
+	{
+		resources.release(a);
+		REQUIRE(resources.state(a) == RESOURCE_READY);
+		resources.release(same);
+		REQUIRE(resources.state(a) == RESOURCE_INVALID);
+		REQUIRE(resources.get(a) == nullptr);
+		REQUIRE(resources.usage() == ResourceMemory{0, 100});
+
+		// The slot is reused, but the old handle stays invalid
+		const ResourceHandle<FakeAsset> reloaded{resources.load<FakeAsset>("textures/a.png")};
+		REQUIRE(reloaded.index == a.index);
+		REQUIRE_FALSE(reloaded == a);
+		REQUIRE(resources.get(a) == nullptr);
+		REQUIRE(resources.get(reloaded)->path == "textures/a.png");
+		REQUIRE(fake.loadCount("textures/a.png") == 2);
+
+		resources.release(a);
+		REQUIRE(resources.state(reloaded) == RESOURCE_READY);
+		resources.release(reloaded);
+	}
+
+	SECTION("Null handles are invalid")
+	{
+		const ResourceHandle<FakeAsset> null;
+		REQUIRE(null.isNull());
+		REQUIRE(resources.state(null) == RESOURCE_INVALID);
+		REQUIRE(resources.get(null) == nullptr);
+		resources.release(null);
+
+		resources.release(a);
+		resources.release(same);
+	}
+
+	resources.release(b);
+	REQUIRE(resources.resourceCount() == 0);
+	REQUIRE(resources.usage() == ResourceMemory{});
+}
+
+TEST_CASE("ResourceManager loads in the background behind placeholders", "[ResourceManager]")
+{
+	JobSystem jobs{2};
+	FakeLoader fake;
+	std::promise<void> open;
+	fake.gate = open.get_future().share();
+
+	ResourceManager resources{&jobs};
+	resources.registerLoader(fake.loader(), makeAsset("placeholder"));
+
+	SECTION("Loaded resources replace the placeholder")
+	{
+		const ResourceHandle<FakeAsset> a{resources.load<FakeAsset>("a")};
+		const ResourceHandle<FakeAsset> missing{resources.load<FakeAsset>("missing")};
+		REQUIRE(resources.state(a) == RESOURCE_LOADING);
+		REQUIRE(resources.get(a)->path == "placeholder");
+
+		open.set_value();
+		resources.waitIdle();
+		REQUIRE(resources.state(a) == RESOURCE_READY);
+		REQUIRE(resources.get(a)->path == "a");
+		REQUIRE(resources.state(missing) == RESOURCE_FAILED);
+		REQUIRE(resources.get(missing)->path == "placeholder");
+
+		resources.release(a);
+		resources.release(missing);
+	}
+
+	SECTION("Resources released while loading are dropped")
+	{
+		const ResourceHandle<FakeAsset> a{resources.load<FakeAsset>("a")};
+		resources.release(a);
+		REQUIRE(resources.state(a) == RESOURCE_INVALID);
+
+		open.set_value();
+		resources.waitIdle();
+		REQUIRE(fake.loadCount("a") == 1);
+		REQUIRE(resources.resourceCount() == 0);
+		REQUIRE(resources.usage() == ResourceMemory{});
+	}
+}
+
+TEST_CASE("ResourceManager evicts the least recently used resources", "[ResourceManager]")
+{
+	FakeLoader fake;
+	ResourceManager resources{nullptr, {.gpuBytes = 300}};
+	resources.registerLoader(fake.loader(), makeAsset("placeholder"));
+
+	const ResourceHandle<FakeAsset> a{resources.load<FakeAsset>("a")};
+	const ResourceHandle<FakeAsset> b{resources.load<FakeAsset>("b")};
+	const ResourceHandle<FakeAsset> c{resources.load<FakeAsset>("c")};
+	resources.update();
+
+	// Within budget, nothing is evicted however long it goes unused
+	resources.update();
+	REQUIRE(resources.evictionCount() == 0);
+
+	(void)resources.get(b);
+	(void)resources.get(c);
+	const ResourceHandle<FakeAsset> d{resources.load<FakeAsset>("d")};
+	REQUIRE(resources.usage() == ResourceMemory{0, 400});
+
+	resources.update();
+	REQUIRE(resources.usage() == ResourceMemory{0, 300});
+	REQUIRE(resources.evictionCount() == 1);
+	REQUIRE(resources.state(a) == RESOURCE_EVICTED);
+	REQUIRE(resources.state(b) == RESOURCE_READY);
+
+	// Evicted resources keep their handles and are reloaded when used
+	REQUIRE(resources.get(a)->path == "a");
+	REQUIRE(resources.state(a) == RESOURCE_READY);
+	REQUIRE(fake.loadCount("a") == 2);
+
+	// a was used during the last frame, so one of the others goes instead
+	resources.update();
+	REQUIRE(resources.usage() == ResourceMemory{0, 300});
+	REQUIRE(resources.evictionCount() == 2);
+	REQUIRE(resources.state(a) == RESOURCE_READY);
+
+	SECTION("Resources added from memory are never evicted")
+	{
+		const ResourceHandle<FakeAsset> added{
+				resources.add(makeAsset("added"), {0, 100}, "mesh#1")};
+		const ResourceHandle<FakeAsset> shared{
+				resources.add(makeAsset("duplicate"), {0, 100}, "mesh#1")};
+		REQUIRE(added == shared);
+		REQUIRE(resources.usage() == ResourceMemory{0, 400});
+
+		resources.setBudget({});
+		resources.update();
+		resources.update();
+		REQUIRE(resources.usage() == ResourceMemory{0, 100});
+		REQUIRE(resources.state(added) == RESOURCE_READY);
+		REQUIRE(resources.get(added)->path == "added");
+
+		resources.release(added);
+		resources.release(shared);
+		REQUIRE(resources.usage() == ResourceMemory{});
+	}
+
+	for (const ResourceHandle<FakeAsset> handle : {a, b, c, d})
+		resources.release(handle);
+	REQUIRE(resources.resourceCount() == 0);
+}
@@ -0,0 +1,63 @@
+#include <catch.hpp>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+import lune;
+
+using namespace lune;
+
+namespace
+{
+	bool waitFor(const std::atomic<int>& counter, const int value)
+	{
+		const auto deadline{std::chrono::steady_clock::now() + std::chrono::seconds(5)};
+		while (counter.load() < value && std::chrono::steady_clock::now() < deadline)
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+		return counter.load() >= value;
+	}
+} // namespace
+
+TEST_CASE("FileWatcher reports changed files", "[FileWatcher]")
+{
+	const auto directory{std::filesystem::temp_directory_path() / "lune_file_watcher"};
+	std::filesystem::create_directories(directory);
+	const std::string watched{(directory / "watched.metal").string()};
+	const std::string other{(directory / "other.metal").string()};
+	File::write(watched, "a");
+	File::write(other, "a");
+
+	std::mutex mutex;
+	std::vector<std::string> changes;
+	std::atomic<int> count{};
+
+	{
+		FileWatcher watcher{[&](const std::string& path)
+							{
+								std::lock_guard lock(mutex);
+								changes.push_back(path);
+								++count;
+							}};
+		REQUIRE(watcher.watch(watched));
+		REQUIRE_FALSE(watcher.watch((directory / "missing.metal").string()));
+
+		// Make sure the write lands on a later modification time when polling
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		File::write(other, "b");
+		File::write(watched, "b");
+		File::append(watched, "c");
+
+		REQUIRE(waitFor(count, 1));
+		std::this_thread::sleep_for(FileWatcher::POLL_INTERVAL * 3);
+	}
+
+	// Both writes are coalesced, and unwatched files are ignored
+	REQUIRE(changes.size() == 1);
+	REQUIRE(std::filesystem::equivalent(changes[0], watched));
+
+	std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,53 @@
+#include <catch.hpp>
+#include <limits>
+import lune;
+
+using namespace lune;
+
+
+TEST_CASE("GameLoop runs fixed steps and carries the remainder", "[GameLoop]")
+{
+	GameLoop loop{{.tickRate = 100.0}};
+	REQUIRE(loop.tickDelta() == Catch::Approx(0.01));
+
+	REQUIRE(loop.advance(0.004) == 0);
+	REQUIRE(loop.alpha() == Catch::Approx(0.4));
+
+	// The leftover 4 ms adds up with the next frame
+	REQUIRE(loop.advance(0.0265) == 3);
+	REQUIRE(loop.alpha() == Catch::Approx(0.05).margin(1e-6));
+	REQUIRE(loop.tickCount() == 3);
+
+	// Simulated time follows real time, whatever the frame rate
+	for (int i = 0; i < 1000; ++i)
+		loop.advance(1.0 / 144.0);
+	const double simulated{static_cast<double>(loop.tickCount()) * loop.tickDelta()};
+	REQUIRE(simulated == Catch::Approx(0.0305 + 1000.0 / 144.0).margin(0.01));
+	REQUIRE(loop.droppedTime() == 0.0);
+}
+
+TEST_CASE("GameLoop drops time it can't catch up on", "[GameLoop]")
+{
+	GameLoop loop{{.tickRate = 60.0, .maxTicksPerFrame = 4}};
+
+	// A one second hitch runs 4 steps instead of 60
+	REQUIRE(loop.advance(1.0) == 4);
+	REQUIRE(loop.droppedTime() == Catch::Approx(1.0 - 4.0 / 60.0).margin(1.0 / 60.0));
+	REQUIRE(loop.alpha() < 1.0);
+
+	// The next normal frame is not penalized by the hitch
+	REQUIRE(loop.advance(1.0 / 60.0) <= 2);
+	REQUIRE(loop.tickCount() <= 6);
+
+	REQUIRE(loop.advance(-1.0) == 0);
+}
+
+TEST_CASE("GameLoop falls back to the default rate for an invalid tick rate", "[GameLoop]")
+{
+	const double defaultDelta{1.0 / GameLoopDesc{}.tickRate};
+	for (const double tickRate : {0.0, -30.0, std::numeric_limits<double>::infinity()})
+		REQUIRE(GameLoop{{.tickRate = tickRate}}.tickDelta() == Catch::Approx(defaultDelta));
+
+	GameLoop loop{{.tickRate = 0.0}};
+	REQUIRE(loop.advance(0.04) == 2);
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+import lune;
+
+/// Backend fakes shared by the gfx tests, which run without a GPU.
+namespace lune::test
+{
+	/// Buffer in CPU memory. `Private` buffers have no `data()`, like GPU-only memory.
+	struct FakeBufferImpl : gfx::IBufferImpl
+	{
+		std::vector<std::byte> bytes;
+		bool cpuAccessible;
+
+		explicit FakeBufferImpl(const size_t size, const gfx::BufferUsage usage = gfx::Shared) :
+			bytes(size), cpuAccessible(usage != gfx::Private)
+		{
+		}
+
+		void setData(const void* data, const size_t size, const size_t offset) override
+		{
+			std::memcpy(bytes.data() + offset, data, size);
+		}
+
+		[[nodiscard]] size_t size() const override
+		{
+			return bytes.size();
+		}
+
+		[[nodiscard]] void* data() const override
+		{
+			return cpuAccessible ? const_cast<std::byte*>(bytes.data()) : nullptr;
+		}
+	};
+
+	/// Gets the bytes of a fake buffer, even a `Private` one.
+	inline std::byte* storage(const gfx::Buffer& buffer)
+	{
+		return static_cast<FakeBufferImpl*>(buffer.getImpl())->bytes.data();
+	}
+
+	/**
+	 * @brief Context creating fake buffers and empty objects of every other kind. Its transfer
+	 * queue and compute primitives are the CPU defaults. Tests override what they exercise.
+	 */
+	struct FakeContextImpl : gfx::IContextImpl
+	{
+		mutable size_t buffersCreated{};
+
+		[[nodiscard]] gfx::Buffer createBuffer(const size_t size,
+											   const gfx::BufferUsage usage) const override
+		{
+			++buffersCreated;
+			return gfx::Buffer{std::make_unique<FakeBufferImpl>(size, usage)};
+		}
+
+		[[nodiscard]] gfx::Texture
+		createTexture(const gfx::TextureContextCreateInfo&) const override
+		{
+			return gfx::Texture{nullptr};
+		}
+
+		[[nodiscard]] gfx::Shader createShader(gfx::ShaderDesc) const override
+		{
+			return gfx::Shader{nullptr};
+		}
+
+		[[nodiscard]] gfx::Pipeline createPipeline(const gfx::Shader&,
+												   gfx::PipelineDesc) const override
+		{
+			return gfx::Pipeline{nullptr};
+		}
+
+		[[nodiscard]] gfx::Material createMaterial(const gfx::Pipeline&) const override
+		{
+			return gfx::Material{nullptr};
+		}
+
+		[[nodiscard]] gfx::RenderPass createRenderPass(const gfx::RenderSurface&) const override
+		{
+			return gfx::RenderPass{nullptr};
+		}
+
+		[[nodiscard]] gfx::ComputeShader createComputeShader(const std::string&) const override
+		{
+			return gfx::ComputeShader{nullptr};
+		}
+	};
+} // namespace lune::test
@@ -0,0 +1,168 @@
+#include <catch.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <span>
+#include <vector>
+#include "fake_context.hpp"
+import lune;
+
+using namespace lune;
+
+namespace
+{
+	// Spans several chunks of the CPU primitives, with a partial one at the end
+	constexpr size_t COUNT{200'003};
+
+	template <typename T> std::vector<T> randomValues(const size_t count, const T max)
+	{
+		std::mt19937_64 random{42};
+		std::uniform_int_distribution<T> distribution{0, max};
+		std::vector<T> values(count);
+		for (T& value : values)
+			value = distribution(random);
+		return values;
+	}
+
+	template <typename T> std::span<T> contents(const gfx::Buffer& buffer, const size_t count)
+	{
+		return {static_cast<T*>(buffer.data()), count};
+	}
+} // namespace
+
+TEST_CASE("CpuPrimitives scans and reduces", "[CpuPrimitives]")
+{
+	JobSystem jobs{3};
+	const std::vector<uint32_t> input{randomValues<uint32_t>(COUNT, 1000)};
+
+	std::vector<uint32_t> expected(COUNT);
+	std::exclusive_scan(input.begin(), input.end(), expected.begin(), 0u);
+	std::vector<uint32_t> output(COUNT);
+	gfx::CpuPrimitives::exclusiveScan(input, output, &jobs);
+	REQUIRE(output == expected);
+
+	std::inclusive_scan(input.begin(), input.end(), expected.begin());
+	gfx::CpuPrimitives::inclusiveScan(input, output);
+	REQUIRE(output == expected);
+
+	// In place
+	output = input;
+	gfx::CpuPrimitives::inclusiveScan(output, output, &jobs);
+	REQUIRE(output == expected);
+
+	REQUIRE(gfx::CpuPrimitives::reduce(input, &jobs) == expected.back());
+	REQUIRE(gfx::CpuPrimitives::reduce({}) == 0);
+
+	// Sums wrap around like unsigned arithmetic
+	const std::vector<uint32_t> large{0xFFFFFFFFu, 2u};
+	REQUIRE(gfx::CpuPrimitives::reduce(large) == 1);
+}
+
+TEST_CASE("CpuPrimitives compacts and counts", "[CpuPrimitives]")
+{
+	JobSystem jobs{3};
+	const std::vector<uint32_t> input{randomValues<uint32_t>(COUNT, 1'000'000)};
+
+	std::vector<uint32_t> flags(COUNT);
+	std::vector<uint32_t> expected;
+	for (size_t i = 0; i < COUNT; ++i)
+	{
+		flags[i] = input[i] % 3 == 0;
+		if (flags[i])
+			expected.push_back(input[i]);
+	}
+
+	std::vector<uint32_t> output(COUNT);
+	const size_t kept{gfx::CpuPrimitives::compact(input, flags, output, &jobs)};
+	REQUIRE(kept == expected.size());
+	output.resize(kept);
+	REQUIRE(output == expected);
+
+	std::vector<uint32_t> bins(10);
+	gfx::CpuPrimitives::histogram(input, bins, 4, &jobs);
+	std::vector<uint32_t> expectedBins(10);
+	for (const uint32_t value : input)
+		++expectedBins[(value >> 4) % 10];
+	REQUIRE(bins == expectedBins);
+
+	std::vector<uint32_t> powerOfTwoBins(256, 7);
+	gfx::CpuPrimitives::histogram(input, powerOfTwoBins, 0, &jobs);
+	REQUIRE(std::accumulate(powerOfTwoBins.begin(), powerOfTwoBins.end(), size_t{}) == COUNT);
+	REQUIRE(powerOfTwoBins[input[0] & 255] > 0);
+}
+
+TEST_CASE("CpuPrimitives radix sorts key-value pairs stably", "[CpuPrimitives]")
+{
+	JobSystem jobs{3};
+
+	SECTION("32-bit keys")
+	{
+		// Few distinct keys, so the values show whether equal keys kept their order
+		std::vector<uint32_t> keys{randomValues<uint32_t>(COUNT, 0x3FF)};
+		for (uint32_t& key : keys)
+			key <<= 12;
+		std::vector<uint32_t> values(COUNT);
+		std::iota(values.begin(), values.end(), 0u);
+
+		std::vector<uint32_t> order(values);
+		std::stable_sort(order.begin(), order.end(),
+						 [&](const uint32_t a, const uint32_t b) { return keys[a] < keys[b]; });
+
+		const std::vector<uint32_t> unsorted{keys};
+		gfx::CpuPrimitives::sortPairs(keys, values, &jobs);
+		REQUIRE(values == order);
+		for (size_t i = 0; i < COUNT; ++i)
+			REQUIRE(keys[i] == unsorted[values[i]]);
+	}
+
+	SECTION("64-bit keys")
+	{
+		std::vector<uint64_t> keys{randomValues<uint64_t>(COUNT, ~uint64_t{})};
+		std::vector<uint64_t> expected{keys};
+		std::sort(expected.begin(), expected.end());
+
+		gfx::CpuPrimitives::sortPairs(keys, {}, &jobs);
+		REQUIRE(keys == expected);
+	}
+
+	SECTION("Small and already sorted inputs")
+	{
+		std::vector<uint32_t> keys{5, 3, 9, 3};
+		std::vector<uint32_t> values{0, 1, 2, 3};
+		gfx::CpuPrimitives::sortPairs(keys, values);
+		REQUIRE(keys == std::vector<uint32_t>{3, 3, 5, 9});
+		REQUIRE(values == std::vector<uint32_t>{1, 3, 0, 2});
+
+		gfx::CpuPrimitives::sortPairs(keys, values);
+		REQUIRE(values == std::vector<uint32_t>{1, 3, 0, 2});
+	}
+}
+
+TEST_CASE("ComputePrimitives fall back to the CPU on backends without kernels",
+		  "[ComputePrimitives]")
+{
+	// The fake context has no compute primitives of its own, so it gets the CPU ones
+	const gfx::Context context{std::make_unique<test::FakeContextImpl>()};
+	gfx::ComputePrimitives primitives{context.createComputePrimitives()};
+
+	const std::vector<uint32_t> input{randomValues<uint32_t>(COUNT, 100)};
+	const gfx::Buffer values{context.createBuffer(COUNT * sizeof(uint32_t))};
+	const gfx::Buffer result{context.createBuffer(COUNT * sizeof(uint32_t))};
+	const gfx::Buffer sum{context.createBuffer(sizeof(uint32_t))};
+	values.setData(input.data(), COUNT * sizeof(uint32_t));
+
+	primitives.exclusiveScan(values, result, COUNT).reduce(values, sum, COUNT).waitUntilComplete();
+	REQUIRE(contents<uint32_t>(result, COUNT)[1] == input[0]);
+	REQUIRE(contents<uint32_t>(sum, 1)[0] == std::accumulate(input.begin(), input.end(), 0u));
+
+	primitives.sortPairs(values, result, COUNT);
+	const auto sorted{contents<uint32_t>(values, COUNT)};
+	REQUIRE(std::is_sorted(sorted.begin(), sorted.end()));
+
+	// Too small a buffer is reported and skipped rather than overrun
+	const gfx::Buffer small{context.createBuffer(16)};
+	primitives.inclusiveScan(values, small, COUNT);
+	REQUIRE(contents<uint32_t>(small, 4)[0] == 0);
+}
@@ -0,0 +1,53 @@
+#include <catch.hpp>
+import lune;
+
+using namespace lune;
+
+TEST_CASE("GpuTimings collects samples in completion order", "[GpuTimings]")
+{
+	gfx::GpuTimings::reset();
+
+	gfx::GpuTimings::record("blur", 1.0, 1.5);
+	gfx::GpuTimings::record("RenderPass", 1.5, 1.75);
+
+	const auto samples{gfx::GpuTimings::collect()};
+	REQUIRE(samples.size() == 2);
+	REQUIRE(samples[0].label == "blur");
+	REQUIRE(samples[0].duration() == Catch::Approx(0.5));
+	REQUIRE(samples[1].label == "RenderPass");
+
+	// Collecting drains the pending samples
+	REQUIRE(gfx::GpuTimings::collect().empty());
+}
+
+TEST_CASE("GpuTimings accumulates stats per label", "[GpuTimings]")
+{
+	gfx::GpuTimings::reset();
+
+	gfx::GpuTimings::record("blur", 0.0, 0.002);
+	gfx::GpuTimings::record("blur", 1.0, 1.004);
+	gfx::GpuTimings::record("blur", 2.0, 2.003);
+
+	const auto stats{gfx::GpuTimings::getStats("blur")};
+	REQUIRE(stats.has_value());
+	REQUIRE(stats->count == 3);
+	REQUIRE(stats->last == Catch::Approx(0.003));
+	REQUIRE(stats->min == Catch::Approx(0.002));
+	REQUIRE(stats->max == Catch::Approx(0.004));
+	REQUIRE(stats->average() == Catch::Approx(0.003));
+
+	REQUIRE_FALSE(gfx::GpuTimings::getStats("missing").has_value());
+	REQUIRE(gfx::GpuTimings::getAllStats().size() == 1);
+}
+
+TEST_CASE("GpuTimings bounds uncollected samples", "[GpuTimings]")
+{
+	gfx::GpuTimings::reset();
+
+	for (size_t i = 0; i < gfx::GpuTimings::MAX_PENDING_SAMPLES + 10; ++i)
+		gfx::GpuTimings::record("dispatch", 0.0, 1.0);
+
+	REQUIRE(gfx::GpuTimings::collect().size() == gfx::GpuTimings::MAX_PENDING_SAMPLES);
+	REQUIRE(gfx::GpuTimings::getStats("dispatch")->count ==
+			gfx::GpuTimings::MAX_PENDING_SAMPLES + 10);
+}
@@ -0,0 +1,199 @@
+#include <catch.hpp>
+#include <string>
+#include <vector>
+import lune;
+
+using namespace lune;
+
+namespace
+{
+	struct FakeShader : gfx::IHotReloadable
+	{
+		std::vector<std::string>& log;
+		std::string name;
+		bool compiles{true};
+		int version{};
+		int prepared{};
+
+		FakeShader(std::vector<std::string>& log, std::string name) :
+			log(log), name(std::move(name))
+		{
+		}
+
+		bool prepareReload() override
+		{
+			log.push_back("prepare " + name);
+			prepared = version + 1;
+			return compiles;
+		}
+
+		void applyReload() override
+		{
+			log.push_back("apply " + name);
+			version = prepared;
+		}
+	};
+} // namespace
+
+TEST_CASE("HotReload prepares on reload and applies between frames", "[HotReload]")
+{
+	std::vector<std::string> log;
+	FakeShader shader{log, "shader"};
+	FakeShader pipeline{log, "pipeline"};
+	gfx::HotReload::add("shaders/hot_reload_a.metal", shader);
+	gfx::HotReload::add("shaders/hot_reload_a.metal", pipeline);
+
+	REQUIRE(gfx::HotReload::applyPending() == 0);
+
+	// Relative and normalized spellings refer to the same source
+	REQUIRE(gfx::HotReload::reload("shaders/../shaders/hot_reload_a.metal"));
+	REQUIRE(shader.version == 0);
+	REQUIRE(log == std::vector<std::string>{"prepare shader", "prepare pipeline"});
+
+	REQUIRE(gfx::HotReload::applyPending() == 1);
+	REQUIRE(shader.version == 1);
+	REQUIRE(pipeline.version == 1);
+	REQUIRE(log.back() == "apply pipeline");
+	REQUIRE(gfx::HotReload::applyPending() == 0);
+
+	gfx::HotReload::remove(shader);
+	gfx::HotReload::remove(pipeline);
+	REQUIRE_FALSE(gfx::HotReload::reload("shaders/hot_reload_a.metal"));
+}
+
+TEST_CASE("HotReload keeps the previous version when a reload fails", "[HotReload]")
+{
+	std::vector<std::string> log;
+	FakeShader shader{log, "shader"};
+	FakeShader pipeline{log, "pipeline"};
+	gfx::HotReload::add("shaders/hot_reload_b.metal", shader);
+	gfx::HotReload::add("shaders/hot_reload_b.metal", pipeline);
+
+	REQUIRE(gfx::HotReload::reload("shaders/hot_reload_b.metal"));
+
+	// A broken edit before the frame discards the prepared reload, and stops at the shader
+	shader.compiles = false;
+	log.clear();
+	REQUIRE_FALSE(gfx::HotReload::reload("shaders/hot_reload_b.metal"));
+	REQUIRE(log == std::vector<std::string>{"prepare shader"});
+	REQUIRE(gfx::HotReload::applyPending() == 0);
+	REQUIRE(shader.version == 0);
+	REQUIRE(pipeline.version == 0);
+
+	gfx::HotReload::remove(shader);
+	gfx::HotReload::remove(pipeline);
+}
+
+TEST_CASE("HotReload reports every source to the watch callback once", "[HotReload]")
+{
+	std::vector<std::string> log;
+	FakeShader first{log, "first"};
+	FakeShader second{log, "second"};
+	gfx::HotReload::add("shaders/hot_reload_c.metal", first);
+	gfx::HotReload::add("shaders/hot_reload_c.metal", second);
+
+	std::vector<std::string> watched;
+	gfx::HotReload::setWatchCallback([&](const std::string& path) { watched.push_back(path); });
+	REQUIRE(watched.size() == 1);
+
+	FakeShader third{log, "third"};
+	gfx::HotReload::add("shaders/hot_reload_d.metal", third);
+	REQUIRE(watched.size() == 2);
+	REQUIRE(watched[1].ends_with("hot_reload_d.metal"));
+
+	gfx::HotReload::setWatchCallback({});
+	gfx::HotReload::remove(first);
+	gfx::HotReload::remove(second);
+	gfx::HotReload::remove(third);
+}
+
+TEST_CASE("HotReload allows registering objects while a reload is prepared", "[HotReload]")
+{
+	// Backends wait on the job system while rebuilding, which may run jobs creating shaders
+	struct CreatingShader : FakeShader
+	{
+		FakeShader created;
+
+		CreatingShader(std::vector<std::string>& log) :
+			FakeShader(log, "creating"), created(log, "created")
+		{
+		}
+
+		bool prepareReload() override
+		{
+			gfx::HotReload::add("shaders/hot_reload_f.metal", created);
+			gfx::HotReload::remove(created);
+			return FakeShader::prepareReload();
+		}
+	};
+
+	std::vector<std::string> log;
+	CreatingShader shader{log};
+	gfx::HotReload::add("shaders/hot_reload_e.metal", shader);
+
+	REQUIRE(gfx::HotReload::reload("shaders/hot_reload_e.metal"));
+	REQUIRE(gfx::HotReload::applyPending() == 1);
+	REQUIRE(shader.version == 1);
+
+	gfx::HotReload::remove(shader);
+}
+
+TEST_CASE("HotReload applies only to objects prepared by the reload", "[HotReload]")
+{
+	// An object registered for the source after the reload took its snapshot was never rebuilt
+	struct RegisteringShader : FakeShader
+	{
+		FakeShader& late;
+
+		RegisteringShader(std::vector<std::string>& log, FakeShader& late) :
+			FakeShader(log, "registering"), late(late)
+		{
+		}
+
+		bool prepareReload() override
+		{
+			gfx::HotReload::add("shaders/hot_reload_h.metal", late);
+			return FakeShader::prepareReload();
+		}
+	};
+
+	std::vector<std::string> log;
+	FakeShader late{log, "late"};
+	RegisteringShader shader{log, late};
+	gfx::HotReload::add("shaders/hot_reload_h.metal", shader);
+
+	REQUIRE(gfx::HotReload::reload("shaders/hot_reload_h.metal"));
+	REQUIRE(gfx::HotReload::applyPending() == 1);
+	REQUIRE(shader.version == 1);
+	REQUIRE(late.version == 0);
+	REQUIRE(log == std::vector<std::string>{"prepare registering", "apply registering"});
+
+	gfx::HotReload::remove(shader);
+	gfx::HotReload::remove(late);
+}
+
+TEST_CASE("HotReload waits on frame barriers before applying", "[HotReload]")
+{
+	std::vector<std::string> log;
+	FakeShader shader{log, "shader"};
+	gfx::HotReload::add("shaders/hot_reload_g.metal", shader);
+
+	int owner{};
+	gfx::HotReload::addFrameBarrier(&owner, [&] { log.push_back("barrier"); });
+
+	// Nothing to apply, so the render thread isn't waited on
+	REQUIRE(gfx::HotReload::applyPending() == 0);
+	REQUIRE(log.empty());
+
+	REQUIRE(gfx::HotReload::reload("shaders/hot_reload_g.metal"));
+	REQUIRE(gfx::HotReload::applyPending() == 1);
+	REQUIRE(log == std::vector<std::string>{"prepare shader", "barrier", "apply shader"});
+
+	gfx::HotReload::removeFrameBarrier(&owner);
+	log.clear();
+	REQUIRE(gfx::HotReload::reload("shaders/hot_reload_g.metal"));
+	REQUIRE(gfx::HotReload::applyPending() == 1);
+	REQUIRE(log == std::vector<std::string>{"prepare shader", "apply shader"});
+
+	gfx::HotReload::remove(shader);
+}
@@ -0,0 +1,183 @@
+#include <catch.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+import lune;
+
+using namespace lune;
+
+namespace
+{
+	using Log = std::vector<std::string>;
+
+	struct FakeMaterialImpl : gfx::IMaterialImpl
+	{
+		Log& log;
+		float value{};
+
+		explicit FakeMaterialImpl(Log& log) : log(log)
+		{
+		}
+
+		void setUniform(const std::string& name, const gfx::Texture&) override
+		{
+			log.push_back("texture " + name);
+		}
+
+		void setUniform(const std::string& name, const gfx::Buffer&) override
+		{
+			log.push_back("buffer " + name);
+		}
+
+		void setUniform(const std::string& name, const void* data, const size_t size) override
+		{
+			// Runs on the render thread, where Catch assertions can't be used
+			std::memcpy(&value, data, std::min(size, sizeof(float)));
+			log.push_back("data " + name + " " + std::to_string(value));
+		}
+	};
+
+	struct FakeRenderPassImpl : gfx::IRenderPassImpl
+	{
+		Log& log;
+
+		explicit FakeRenderPassImpl(Log& log) : log(log)
+		{
+		}
+
+		void bind(const gfx::IMaterialImpl&) override
+		{
+			log.push_back("bind");
+		}
+
+		void begin() override
+		{
+			log.push_back("begin");
+		}
+
+		void end() override
+		{
+			log.push_back("end");
+		}
+
+		void draw(gfx::PrimitiveType, const uint32_t start, const uint32_t count) override
+		{
+			log.push_back("draw " + std::to_string(start) + " " + std::to_string(count));
+		}
+
+		void drawIndexed(gfx::PrimitiveType, const uint32_t indexCount, const gfx::Buffer&,
+						 const uint32_t indexOffset) override
+		{
+			log.push_back("drawIndexed " + std::to_string(indexCount) + " " +
+						  std::to_string(indexOffset));
+		}
+
+		void setViewport(const float, const float, const float w, const float h, const float,
+						 const float) override
+		{
+			log.push_back("viewport " + std::to_string(static_cast<int>(w)) + "x" +
+						  std::to_string(static_cast<int>(h)));
+		}
+
+		void setScissor(uint32_t, uint32_t, uint32_t, uint32_t) override
+		{
+			log.push_back("scissor");
+		}
+
+		void waitUntilComplete() override
+		{
+		}
+
+		void setFillMode(const gfx::FillMode fillMode) override
+		{
+			log.push_back(fillMode == gfx::Wireframe ? "wireframe" : "fill");
+		}
+	};
+
+	Log recordAndReplay(const bool threaded)
+	{
+		Log log;
+		gfx::RenderPass pass{std::make_unique<FakeRenderPassImpl>(log)};
+		gfx::Material material{std::make_unique<FakeMaterialImpl>(log)};
+		const gfx::Buffer indices{nullptr};
+
+		gfx::RenderQueue queue{threaded};
+		REQUIRE(queue.isThreaded() == threaded);
+
+		for (int frame = 0; frame < 3; ++frame)
+		{
+			float time{static_cast<float>(frame)};
+			gfx::RenderCommandList& commands{queue.commands()};
+			commands.setUniform(material, "time", time);
+			time = -1.0f; // Recorded uniforms are copies
+			commands.setUniform(material, "indices", indices);
+
+			commands.pass(pass)
+					.begin()
+					.setViewport(0, 0, 640, 480)
+					.setFillMode(gfx::Wireframe)
+					.bind(material)
+					.draw(gfx::Triangle, 0, 3)
+					.drawIndexed(gfx::Triangle, 36, indices, 4)
+					.end();
+			commands.execute([&log] { log.push_back("callback"); });
+			queue.submit();
+		}
+
+		queue.waitIdle();
+		return log;
+	}
+} // namespace
+
+TEST_CASE("RenderQueue replays commands in order", "[RenderQueue]")
+{
+	const Log expectedFrame{"buffer indices", "begin", "viewport 640x480", "wireframe", "bind",
+							"draw 0 3", "drawIndexed 36 4", "end", "callback"};
+
+	const Log inlineLog{recordAndReplay(false)};
+	REQUIRE(inlineLog.size() == 3 * (expectedFrame.size() + 1));
+	for (size_t frame = 0; frame < 3; ++frame)
+	{
+		const auto frameSize{static_cast<long>(expectedFrame.size())};
+		const auto begin{inlineLog.begin() + static_cast<long>(frame) * (frameSize + 1)};
+		REQUIRE(*begin == "data time " + std::to_string(static_cast<float>(frame)));
+		REQUIRE(Log(begin + 1, begin + 1 + frameSize) == expectedFrame);
+	}
+
+	REQUIRE(recordAndReplay(true) == inlineLog);
+}
+
+TEST_CASE("RenderQueue records the next frame while one is replayed", "[RenderQueue]")
+{
+	gfx::RenderQueue queue;
+	std::atomic<bool> started{false};
+	std::atomic<bool> release{false};
+	std::atomic<int> replayed{0};
+
+	queue.commands().execute(
+			[&]
+			{
+				started = true;
+				started.notify_one();
+				release.wait(false);
+				++replayed;
+			});
+	queue.submit();
+	started.wait(false);
+
+	// The render thread is stuck in frame 1, yet frame 2 can be recorded
+	REQUIRE(queue.commands().empty());
+	queue.commands().execute([&] { ++replayed; });
+	REQUIRE(queue.commands().size() == 1);
+	REQUIRE(replayed == 0);
+
+	release = true;
+	release.notify_one();
+	queue.submit();
+	queue.waitIdle();
+	REQUIRE(replayed == 2);
+	REQUIRE(queue.commands().empty());
+}
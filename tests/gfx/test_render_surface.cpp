@@ -0,0 +1,112 @@
+#include <catch.hpp>
+#include <atomic>
+#include <chrono>
+#include <thread>
+import lune;
+
+using namespace lune;
+
+namespace
+{
+	struct FakeSurfaceImpl : gfx::IRenderSurfaceImpl
+	{
+		int resizes{};
+
+		using IRenderSurfaceImpl::IRenderSurfaceImpl;
+
+		void* currentDrawable() override
+		{
+			return nullptr;
+		}
+
+		void* nextDrawable() override
+		{
+			return nullptr;
+		}
+
+	protected:
+		void onResize() override
+		{
+			++resizes;
+		}
+	};
+} // namespace
+
+TEST_CASE("RenderSurface applies resizes once they settle", "[RenderSurface]")
+{
+	using Clock = std::chrono::steady_clock;
+	constexpr auto debounce{gfx::IRenderSurfaceImpl::RESIZE_DEBOUNCE};
+
+	FakeSurfaceImpl surface{{.width = 800, .height = 600}};
+	REQUIRE_FALSE(surface.applyPendingResize());
+
+	// A live resize sends a burst of sizes; only the last one is applied
+	for (int width = 801; width <= 900; ++width)
+		surface.requestResize(width, 600 + width / 2);
+
+	const Clock::time_point requested{Clock::now()};
+	REQUIRE_FALSE(surface.applyPendingResize(requested));
+	REQUIRE(surface.info().width == 800);
+	REQUIRE(surface.generation() == 0);
+
+	REQUIRE(surface.applyPendingResize(requested + debounce * 2));
+	REQUIRE(surface.info().width == 900);
+	REQUIRE(surface.info().height == 1050);
+	REQUIRE(surface.resizes == 1);
+	REQUIRE(surface.generation() == 1);
+
+	REQUIRE_FALSE(surface.applyPendingResize(requested + debounce * 3));
+	REQUIRE(surface.resizes == 1);
+}
+
+TEST_CASE("RenderSurface ignores empty and unchanged sizes", "[RenderSurface]")
+{
+	using Clock = std::chrono::steady_clock;
+	const Clock::time_point later{Clock::now() + gfx::IRenderSurfaceImpl::RESIZE_DEBOUNCE * 2};
+
+	FakeSurfaceImpl surface{{.width = 640, .height = 480}};
+
+	// Minimizing reports a zero-sized framebuffer
+	surface.requestResize(0, 0);
+	REQUIRE_FALSE(surface.applyPendingResize(later));
+
+	// Resizing away and back before the debounce expires leaves the surface alone
+	surface.requestResize(1024, 768);
+	surface.requestResize(640, 480);
+	REQUIRE_FALSE(surface.applyPendingResize(later));
+	REQUIRE(surface.resizes == 0);
+	REQUIRE(surface.generation() == 0);
+}
+
+TEST_CASE("RenderSurface publishes sizes to other threads as a whole", "[RenderSurface]")
+{
+	using Clock = std::chrono::steady_clock;
+	const Clock::time_point later{Clock::now() + gfx::IRenderSurfaceImpl::RESIZE_DEBOUNCE * 2};
+
+	FakeSurfaceImpl surface{{.width = 100, .height = 200}};
+	std::atomic<bool> done{};
+	std::atomic<int> torn{};
+
+	// The game thread reads the size while the render thread applies resizes
+	std::thread reader{[&]
+					   {
+						   while (!done.load())
+						   {
+							   const gfx::RenderSurfaceInfo info{surface.info()};
+							   if (info.height != info.width * 2)
+								   torn.fetch_add(1);
+						   }
+					   }};
+
+	for (int width = 101; width <= 2000; ++width)
+	{
+		surface.requestResize(width, width * 2);
+		REQUIRE(surface.applyPendingResize(later));
+	}
+
+	done.store(true);
+	reader.join();
+	REQUIRE(torn.load() == 0);
+	REQUIRE(surface.info().width == 2000);
+	REQUIRE(surface.generation() == 1900);
+}
@@ -0,0 +1,54 @@
+#include <catch.hpp>
+#include <array>
+#include <cstdint>
+import lune;
+
+using namespace lune;
+
+TEST_CASE("ShaderReflection parses entry points and bindings", "[ShaderReflection]")
+{
+	const auto reflection{gfx::ShaderReflection::parse(R"(lune-reflection 1
+# Generated from life.slang.json
+entry computeMain compute 16 16 1
+buffer 0 cells
+texture 1 image
+sampler 0 linearSampler
+entry vertexMain vertex
+buffer 3 uniforms
+)")};
+	REQUIRE(reflection.has_value());
+	REQUIRE(reflection->entryPoints().size() == 2);
+
+	const gfx::ShaderEntryPoint* compute{reflection->find("computeMain")};
+	REQUIRE(compute != nullptr);
+	REQUIRE(compute->stage == gfx::ComputeStage);
+	REQUIRE(compute->threadGroupSize == std::array<uint32_t, 3>{16, 16, 1});
+	REQUIRE(compute->bindings.size() == 3);
+	REQUIRE(compute->bindings[1].name == "image");
+	REQUIRE(compute->bindings[1].index == 1);
+	REQUIRE(compute->bindings[1].type == gfx::TextureBinding);
+
+	const gfx::ShaderEntryPoint* vertex{reflection->find("vertexMain")};
+	REQUIRE(vertex != nullptr);
+	REQUIRE(vertex->stage == gfx::VertexStage);
+	REQUIRE(vertex->bindings.size() == 1);
+	REQUIRE(vertex->bindings[0].index == 3);
+
+	REQUIRE(reflection->find("fragmentMain") == nullptr);
+}
+
+TEST_CASE("ShaderReflection rejects malformed sidecars", "[ShaderReflection]")
+{
+	REQUIRE_FALSE(gfx::ShaderReflection::parse("").has_value());
+	REQUIRE_FALSE(gfx::ShaderReflection::parse("lune-reflection 2\n").has_value());
+	REQUIRE_FALSE(gfx::ShaderReflection::parse("lune-reflection 1\nbuffer 0 orphan\n").has_value());
+	REQUIRE_FALSE(
+			gfx::ShaderReflection::parse("lune-reflection 1\nentry main geometry\n").has_value());
+}
+
+TEST_CASE("ShaderReflection only looks for sidecars of precompiled shaders", "[ShaderReflection]")
+{
+	REQUIRE(gfx::ShaderReflection::sidecarPath("shaders/life.metallib") == "shaders/life.reflect");
+	REQUIRE_FALSE(gfx::ShaderReflection::loadSidecar("shaders/life.metal").has_value());
+	REQUIRE_FALSE(gfx::ShaderReflection::loadSidecar("missing/life.metallib").has_value());
+}
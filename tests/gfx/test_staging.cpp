@@ -0,0 +1,190 @@
+#include <catch.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+#include "fake_context.hpp"
+import lune;
+
+using namespace lune;
+
+namespace
+{
+	/// Holds submitted copies until `complete()`, like a GPU queue running behind the CPU.
+	struct DeferredTransferQueue : gfx::ITransferQueueImpl
+	{
+		struct Submission
+		{
+			std::vector<gfx::BufferCopy> copies;
+			std::function<void()> onComplete;
+		};
+
+		std::vector<Submission>& submissions;
+
+		explicit DeferredTransferQueue(std::vector<Submission>& submissions) :
+			submissions(submissions)
+		{
+		}
+
+		void submit(const std::span<const gfx::BufferCopy> copies,
+					const std::function<void()> onComplete) override
+		{
+			submissions.push_back({{copies.begin(), copies.end()}, onComplete});
+		}
+	};
+
+	/// Context whose transfer queue is deferred when given somewhere to keep the submissions.
+	struct StagingContextImpl : test::FakeContextImpl
+	{
+		std::vector<DeferredTransferQueue::Submission>* submissions{};
+
+		[[nodiscard]] std::unique_ptr<gfx::ITransferQueueImpl> createTransferQueue() const override
+		{
+			if (!submissions)
+				return IContextImpl::createTransferQueue();
+			return std::make_unique<DeferredTransferQueue>(*submissions);
+		}
+	};
+
+	/// Runs the copies of a submission on the "GPU", with its private buffers, from another thread.
+	void complete(const DeferredTransferQueue::Submission& submission)
+	{
+		std::thread gpu{[&]
+						{
+							for (const gfx::BufferCopy& copy : submission.copies)
+							{
+								std::byte* destination{test::storage(*copy.destination)};
+								const std::byte* source{test::storage(*copy.source)};
+								std::memcpy(destination + copy.destinationOffset,
+											source + copy.sourceOffset, copy.size);
+							}
+							submission.onComplete();
+						}};
+		gpu.join();
+	}
+
+	std::vector<int> sequence(const size_t count, const int first)
+	{
+		std::vector<int> values(count);
+		std::iota(values.begin(), values.end(), first);
+		return values;
+	}
+} // namespace
+
+TEST_CASE("StagingManager round-trips through the default transfer queue", "[StagingManager]")
+{
+	auto* impl{new StagingContextImpl};
+	const gfx::Context context{std::unique_ptr<gfx::IContextImpl>(impl)};
+	const gfx::Buffer buffer{context.createBuffer(1024)};
+
+	gfx::StagingManager staging{context, {.bufferSize = 256, .bufferCount = 2}};
+	const std::vector<int> values{sequence(32, 7)};
+	staging.upload(buffer, values.data(), values.size() * sizeof(int), 64);
+
+	std::vector<int> readback;
+	staging.readbackAsync(buffer, 64, values.size() * sizeof(int),
+						  [&](const std::span<const std::byte> bytes)
+						  {
+							  readback.resize(bytes.size() / sizeof(int));
+							  std::memcpy(readback.data(), bytes.data(), bytes.size());
+						  });
+	REQUIRE(readback.empty());
+
+	staging.flush();
+	REQUIRE(staging.poll() == 1);
+	REQUIRE(readback == values);
+	REQUIRE(staging.pendingBatches() == 0);
+}
+
+TEST_CASE("StagingManager delivers readbacks once the GPU completes them", "[StagingManager]")
+{
+	std::vector<DeferredTransferQueue::Submission> submissions;
+	auto* impl{new StagingContextImpl};
+	impl->submissions = &submissions;
+	const gfx::Context context{std::unique_ptr<gfx::IContextImpl>(impl)};
+
+	const gfx::Buffer gpuOnly{context.createBuffer(4096, gfx::Private)};
+	REQUIRE(gpuOnly.data() == nullptr);
+
+	gfx::StagingManager staging{context, {.bufferSize = 256, .bufferCount = 4}};
+	REQUIRE(impl->buffersCreated == 5);
+
+	// Each upload fills most of a staging buffer, so every one ends up in a batch of its own
+	for (int i = 0; i < 3; ++i)
+	{
+		const std::vector<int> values{sequence(50, i * 100)};
+		staging.upload(gpuOnly, values.data(), values.size() * sizeof(int),
+					   static_cast<size_t>(i) * 200);
+	}
+	REQUIRE(submissions.size() == 2);
+
+	std::vector<int> order;
+	for (int i = 0; i < 3; ++i)
+	{
+		staging.readbackAsync(gpuOnly, static_cast<size_t>(i) * 200, sizeof(int),
+							  [&](const std::span<const std::byte> bytes)
+							  {
+								  int value;
+								  std::memcpy(&value, bytes.data(), sizeof(int));
+								  order.push_back(value);
+							  });
+	}
+	staging.flush();
+	REQUIRE(submissions.size() == 3);
+
+	// Nothing is delivered before the GPU is done, and batches are delivered in order
+	REQUIRE(staging.poll() == 0);
+	complete(submissions[1]);
+	REQUIRE(staging.poll() == 0);
+	complete(submissions[0]);
+	complete(submissions[2]);
+	REQUIRE(staging.poll() == 3);
+	REQUIRE(order == std::vector<int>{0, 100, 200});
+	REQUIRE(staging.pendingBatches() == 0);
+
+	// Oversized transfers get a staging buffer of their own
+	const std::vector<int> large{sequence(1000, 0)};
+	staging.upload(gpuOnly, large.data(), large.size() * sizeof(int));
+	REQUIRE(impl->buffersCreated == 6);
+	staging.flush();
+	complete(submissions.back());
+	staging.poll();
+
+	std::vector<int> copied(large.size());
+	std::memcpy(copied.data(), test::storage(gpuOnly), copied.size() * sizeof(int));
+	REQUIRE(copied == large);
+}
+
+TEST_CASE("StagingManager reads back what a compute dispatch wrote", "[StagingManager]")
+{
+	const gfx::Context context{std::make_unique<StagingContextImpl>()};
+	const std::vector<uint32_t> values{1, 2, 3, 4, 5, 6, 7, 8};
+	const size_t size{values.size() * sizeof(uint32_t)};
+	const gfx::Buffer input{context.createBuffer(size)};
+	const gfx::Buffer output{context.createBuffer(size)};
+
+	// Transfers are ordered with the dispatches around them, without waiting in between
+	gfx::StagingManager staging{context};
+	staging.upload(input, values.data(), size);
+	staging.flush();
+
+	gfx::ComputePrimitives primitives{context.createComputePrimitives()};
+	primitives.inclusiveScan(input, output, values.size());
+
+	std::vector<uint32_t> sums;
+	staging.readbackAsync(output, 0, size,
+						  [&](const std::span<const std::byte> bytes)
+						  {
+							  sums.resize(bytes.size() / sizeof(uint32_t));
+							  std::memcpy(sums.data(), bytes.data(), bytes.size());
+						  });
+	staging.waitIdle();
+
+	REQUIRE(sums == std::vector<uint32_t>{1, 3, 6, 10, 15, 21, 28, 36});
+}
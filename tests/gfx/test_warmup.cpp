@@ -0,0 +1,219 @@
+#include <catch.hpp>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include "fake_context.hpp"
+import lune;
+
+using namespace lune;
+
+namespace
+{
+	struct FakeShaderImpl : gfx::IShaderImpl
+	{
+		std::string path;
+		bool valid;
+
+		explicit FakeShaderImpl(std::string path, const bool valid = true) :
+			path(std::move(path)), valid(valid)
+		{
+		}
+
+		void create() override
+		{
+		}
+
+		[[nodiscard]] bool isValid() const noexcept override
+		{
+			return valid;
+		}
+	};
+
+	struct FakePipelineImpl : gfx::IPipelineImpl
+	{
+		const FakeShaderImpl* shader;
+		bool valid;
+
+		explicit FakePipelineImpl(const FakeShaderImpl* shader, const bool valid = true) :
+			shader(shader), valid(valid)
+		{
+		}
+
+		[[nodiscard]] bool isValid() const noexcept override
+		{
+			return valid;
+		}
+
+	protected:
+		void createPipeline() override
+		{
+		}
+	};
+
+	struct FakeComputeShaderImpl : gfx::IComputeShaderImpl
+	{
+		using IComputeShaderImpl::IComputeShaderImpl;
+
+		[[nodiscard]] bool isValid() const noexcept override
+		{
+			return !m_path.starts_with("invalid");
+		}
+	};
+
+	/// Context whose shaders named "broken*" fail to compile by throwing, and those named
+	/// "invalid*" by returning invalid objects, like the Metal backend. Pipelines of shaders named
+	/// "unbuildable*" are invalid.
+	struct WarmupContextImpl : test::FakeContextImpl
+	{
+		mutable std::atomic<int> shadersCompiled{0};
+		mutable std::atomic<int> pipelinesBuilt{0};
+
+		[[nodiscard]] gfx::Shader createShader(const gfx::ShaderDesc desc) const override
+		{
+			if (desc.path.starts_with("broken"))
+				throw std::runtime_error("compilation failed");
+
+			++shadersCompiled;
+			return gfx::Shader{
+					std::make_unique<FakeShaderImpl>(desc.path, !desc.path.starts_with("invalid"))};
+		}
+
+		[[nodiscard]] gfx::Pipeline createPipeline(const gfx::Shader& shader,
+												   gfx::PipelineDesc) const override
+		{
+			++pipelinesBuilt;
+			const auto* impl{static_cast<const FakeShaderImpl*>(shader.getImpl())};
+			const bool valid{!impl->path.starts_with("unbuildable")};
+			return gfx::Pipeline{std::make_unique<FakePipelineImpl>(impl, valid)};
+		}
+
+		[[nodiscard]] gfx::ComputeShader createComputeShader(const std::string& path) const override
+		{
+			if (path.starts_with("broken"))
+				throw std::runtime_error("compilation failed");
+
+			return gfx::ComputeShader{std::make_unique<FakeComputeShaderImpl>(path)};
+		}
+	};
+
+	const FakeShaderImpl* shaderOf(const gfx::Pipeline* pipeline)
+	{
+		return static_cast<const FakePipelineImpl*>(pipeline->getImpl())->shader;
+	}
+} // namespace
+
+TEST_CASE("Context creates shaders and pipelines asynchronously", "[PipelineWarmup]")
+{
+	auto* impl{new WarmupContextImpl};
+	const gfx::Context context{std::unique_ptr<gfx::IContextImpl>(impl)};
+
+	auto shaderFuture{context.createShaderAsync({"shaders/basic.metal"})};
+	const std::unique_ptr<gfx::Shader> shader{shaderFuture.get()};
+	REQUIRE(shader);
+	REQUIRE(static_cast<const FakeShaderImpl*>(shader->getImpl())->path == "shaders/basic.metal");
+
+	auto pipelineFuture{context.createPipelineAsync(*shader, {})};
+	const std::unique_ptr<gfx::Pipeline> pipeline{pipelineFuture.get()};
+	REQUIRE(shaderOf(pipeline.get()) == shader->getImpl());
+
+	auto computeFuture{context.createComputeShaderAsync("shaders/life.metal")};
+	REQUIRE(computeFuture.get()->getImpl()->path() == "shaders/life.metal");
+
+	// Errors of the job are rethrown by the future
+	auto broken{context.createShaderAsync({"broken.metal"})};
+	REQUIRE_THROWS_AS(broken.get(), std::runtime_error);
+}
+
+TEST_CASE("PipelineWarmup compiles each shader once and builds its pipelines", "[PipelineWarmup]")
+{
+	auto* impl{new WarmupContextImpl};
+	const gfx::Context context{std::unique_ptr<gfx::IContextImpl>(impl)};
+
+	gfx::WarmupManifest manifest;
+	manifest.pipelines.push_back({.shader = {"shaders/basic.metal"}});
+	manifest.pipelines.push_back({.shader = {"shaders/unlit.metal"}});
+	manifest.pipelines.push_back(
+			{.shader = {"shaders/basic.metal"}, .pipeline = {.enableBlending = true}});
+	manifest.pipelines.push_back({.shader = {"shaders/basic.metal", "shadowMain", "emptyMain"}});
+	manifest.computeShaders = {"shaders/life.metal", "shaders/blur.metal"};
+
+	const gfx::PipelineWarmup warmup{context, manifest};
+	warmup.wait();
+
+	REQUIRE(warmup.isDone());
+	REQUIRE(warmup.progress() == 1.0f);
+	REQUIRE(impl->shadersCompiled == 3);
+	REQUIRE(impl->pipelinesBuilt == 4);
+
+	for (size_t i = 0; i < manifest.pipelines.size(); ++i)
+	{
+		REQUIRE(warmup.pipeline(i) != nullptr);
+		REQUIRE(shaderOf(warmup.pipeline(i)) == warmup.shader(i)->getImpl());
+		REQUIRE(shaderOf(warmup.pipeline(i))->path == manifest.pipelines[i].shader.path);
+	}
+
+	// Pipelines of the same shader and entry points share its compilation
+	REQUIRE(warmup.shader(0) == warmup.shader(2));
+	REQUIRE(warmup.shader(0) != warmup.shader(3));
+
+	REQUIRE(warmup.computeShader(0)->getImpl()->path() == "shaders/life.metal");
+	REQUIRE(warmup.computeShader(1)->getImpl()->path() == "shaders/blur.metal");
+}
+
+TEST_CASE("PipelineWarmup skips the pipelines of shaders that fail", "[PipelineWarmup]")
+{
+	auto* impl{new WarmupContextImpl};
+	const gfx::Context context{std::unique_ptr<gfx::IContextImpl>(impl)};
+
+	gfx::WarmupManifest manifest;
+	manifest.pipelines.push_back({.shader = {"broken.metal"}});
+	manifest.pipelines.push_back({.shader = {"shaders/basic.metal"}});
+	manifest.pipelines.push_back({.shader = {"broken.metal"}});
+	manifest.computeShaders = {"broken_kernel.metal"};
+
+	const gfx::PipelineWarmup warmup{context, manifest};
+	warmup.wait();
+
+	REQUIRE(warmup.progress() == 1.0f);
+	REQUIRE(warmup.pipeline(0) == nullptr);
+	REQUIRE(warmup.shader(0) == nullptr);
+	REQUIRE(warmup.pipeline(1) != nullptr);
+	REQUIRE(warmup.pipeline(2) == nullptr);
+	REQUIRE(warmup.computeShader(0) == nullptr);
+	REQUIRE(impl->pipelinesBuilt == 1);
+}
+
+TEST_CASE("PipelineWarmup drops objects the backend failed to build", "[PipelineWarmup]")
+{
+	auto* impl{new WarmupContextImpl};
+	const gfx::Context context{std::unique_ptr<gfx::IContextImpl>(impl)};
+
+	gfx::WarmupManifest manifest;
+	manifest.pipelines.push_back({.shader = {"invalid.metal"}});
+	manifest.pipelines.push_back({.shader = {"unbuildable.metal"}});
+	manifest.pipelines.push_back({.shader = {"shaders/basic.metal"}});
+	manifest.computeShaders = {"invalid_kernel.metal", "shaders/life.metal"};
+
+	const gfx::PipelineWarmup warmup{context, manifest};
+	warmup.wait();
+
+	REQUIRE(warmup.progress() == 1.0f);
+	REQUIRE(warmup.shader(0) == nullptr);
+	REQUIRE(warmup.pipeline(0) == nullptr);
+	REQUIRE(warmup.shader(1) != nullptr);
+	REQUIRE(warmup.pipeline(1) == nullptr);
+	REQUIRE(warmup.pipeline(2) != nullptr);
+	REQUIRE(warmup.computeShader(0) == nullptr);
+	REQUIRE(warmup.computeShader(1) != nullptr);
+	REQUIRE(impl->pipelinesBuilt == 2);
+}
+
+TEST_CASE("PipelineWarmup of an empty manifest is done immediately", "[PipelineWarmup]")
+{
+	const gfx::Context context{std::make_unique<WarmupContextImpl>()};
+	const gfx::PipelineWarmup warmup{context, {}};
+
+	REQUIRE(warmup.isDone());
+	REQUIRE(warmup.progress() == 1.0f);
+}
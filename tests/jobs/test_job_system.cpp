@@ -0,0 +1,55 @@
+#include <catch.hpp>
+#include <atomic>
+#include <stdexcept>
+import lune;
+
+using namespace lune;
+
+
+TEST_CASE("JobSystem rethrows job exceptions from wait", "[JobSystem]")
+{
+	JobSystem jobs{2};
+	JobCounter counter;
+	std::atomic<int> finished{};
+
+	for (int i = 0; i < 8; ++i)
+	{
+		jobs.submit(
+				[&, i]
+				{
+					if (i == 3)
+						throw std::runtime_error("job failed");
+					++finished;
+				},
+				&counter);
+	}
+
+	REQUIRE_THROWS_WITH(jobs.wait(counter), "job failed");
+	REQUIRE(counter.isDone());
+	REQUIRE(finished == 7);
+
+	// The exception is only rethrown once
+	REQUIRE_NOTHROW(jobs.wait(counter));
+
+	// Jobs without a counter report their exceptions instead of terminating the worker
+	jobs.submit([] { throw std::runtime_error("untracked job failed"); });
+	jobs.submit([&] { ++finished; }, &counter);
+	jobs.wait(counter);
+	REQUIRE(finished == 8);
+}
+
+TEST_CASE("JobSystem::parallelFor finishes every range before rethrowing", "[JobSystem]")
+{
+	JobSystem jobs{2};
+	std::atomic<int> ranges{};
+
+	const auto run{[&](const size_t begin, const size_t)
+				   {
+					   ++ranges;
+					   if (begin == 0 || begin == 50)
+						   throw std::runtime_error("range failed");
+				   }};
+
+	REQUIRE_THROWS_AS(jobs.parallelFor(100, 10, run), std::runtime_error);
+	REQUIRE(ranges == 10);
+}
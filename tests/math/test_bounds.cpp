@@ -0,0 +1,89 @@
+#include <catch.hpp>
+#include <cstdint>
+#include <numbers>
+#include <vector>
+import lune;
+
+using namespace lune;
+
+
+static Frustum makeCameraFrustum()
+{
+	const Mat4 projection = Mat4::perspective(std::numbers::pi_v<float> / 2.0f, 1.0f, 0.1f, 100.0f);
+	const Mat4 view = Mat4::lookAt({0.0f, 0.0f, 5.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f});
+	return Frustum::fromCamera(projection, view);
+}
+
+TEST_CASE("Aabb merge, center and extents", "[Aabb]")
+{
+	Aabb box{};
+	REQUIRE(box.isEmpty());
+
+	box.merge(Vec3{-1.0f, 2.0f, 0.0f}).merge(Vec3{3.0f, -2.0f, 4.0f});
+	REQUIRE_FALSE(box.isEmpty());
+	REQUIRE(box.center().x == Catch::Approx(1.0f));
+	REQUIRE(box.center().z == Catch::Approx(2.0f));
+	REQUIRE(box.extents().x == Catch::Approx(2.0f));
+	REQUIRE(box.extents().y == Catch::Approx(2.0f));
+	REQUIRE(box.surfaceArea() == Catch::Approx(2.0f * (16.0f + 16.0f + 16.0f)));
+
+	REQUIRE(box.contains(Vec3{0.0f, 0.0f, 1.0f}));
+	REQUIRE_FALSE(box.contains(Vec3{0.0f, 0.0f, 5.0f}));
+	REQUIRE(box.intersects(Aabb{{2.0f, 1.0f, 3.0f}, {5.0f, 5.0f, 5.0f}}));
+	REQUIRE_FALSE(box.intersects(Aabb{{4.0f, 1.0f, 3.0f}, {5.0f, 5.0f, 5.0f}}));
+}
+
+TEST_CASE("Aabb transformed by translation and scale", "[Aabb]")
+{
+	const Aabb box{{-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}};
+	const Aabb moved = box.transformed(Mat4::translate(10.0f, 0.0f, 0.0f));
+	REQUIRE(moved.min.x == Catch::Approx(9.0f));
+	REQUIRE(moved.max.x == Catch::Approx(11.0f));
+
+	const Aabb scaled = box.transformed(Mat4::scale(2.0f, 3.0f, 4.0f));
+	REQUIRE(scaled.max.y == Catch::Approx(3.0f));
+	REQUIRE(scaled.min.z == Catch::Approx(-4.0f));
+}
+
+TEST_CASE("Frustum from perspective and lookAt", "[Frustum]")
+{
+	const Frustum frustum = makeCameraFrustum();
+
+	REQUIRE(frustum.contains(Vec3{0.0f, 0.0f, 0.0f}));
+	REQUIRE_FALSE(frustum.contains(Vec3{0.0f, 0.0f, 10.0f}));	// Behind the camera
+	REQUIRE_FALSE(frustum.contains(Vec3{0.0f, 0.0f, -200.0f})); // Past the far plane
+	REQUIRE_FALSE(frustum.contains(Vec3{20.0f, 0.0f, 0.0f}));	// Outside the 90 degree fov
+
+	REQUIRE(frustum.intersects(Sphere{{6.0f, 0.0f, 0.0f}, 2.0f}));
+	REQUIRE_FALSE(frustum.intersects(Sphere{{20.0f, 0.0f, 0.0f}, 2.0f}));
+
+	REQUIRE(frustum.classify(Aabb{{-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}}) == CULL_INSIDE);
+	REQUIRE(frustum.classify(Aabb{{4.0f, -1.0f, -1.0f}, {6.0f, 1.0f, 1.0f}}) ==
+			CULL_INTERSECTING);
+	REQUIRE(frustum.classify(Aabb{{-1.0f, -1.0f, 6.0f}, {1.0f, 1.0f, 8.0f}}) == CULL_OUTSIDE);
+}
+
+TEST_CASE("Batched frustum culling matches per-box tests", "[Frustum]")
+{
+	const Frustum frustum = makeCameraFrustum();
+
+	// An odd count exercises both the 8-wide batches and the scalar remainder
+	AabbArray boxes;
+	std::vector<uint32_t> expected;
+	for (uint32_t i = 0; i < 101; ++i)
+	{
+		const float x{static_cast<float>(i % 11) * 4.0f - 20.0f};
+		const float z{static_cast<float>(i / 11) * -4.0f + 10.0f};
+		const Aabb box = Aabb::fromCenterExtents({x, 0.0f, z}, {0.5f, 0.5f, 0.5f});
+
+		boxes.add(box);
+		if (frustum.intersects(box))
+			expected.push_back(i);
+	}
+
+	std::vector<uint32_t> visible;
+	REQUIRE(frustum.cull(boxes, visible) == expected.size());
+	REQUIRE(visible == expected);
+	REQUIRE_FALSE(visible.empty());
+	REQUIRE(visible.size() < boxes.size());
+}
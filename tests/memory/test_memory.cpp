@@ -0,0 +1,150 @@
+#include <catch.hpp>
+#include <cstdint>
+#include <memory_resource>
+#include <thread>
+#include <vector>
+import lune;
+
+using namespace lune;
+
+TEST_CASE("MemoryTracker tracks live and peak bytes per tag", "[Memory]")
+{
+	const MemoryStats before{MemoryTracker::getStats(MEMORY_TAG_ASSETS)};
+
+	{
+		TrackedAllocation a{MEMORY_TAG_ASSETS, 1000};
+		TrackedAllocation b{MEMORY_TAG_ASSETS, 500};
+
+		const MemoryStats stats{MemoryTracker::getStats(MEMORY_TAG_ASSETS)};
+		REQUIRE(stats.liveBytes == before.liveBytes + 1500);
+		REQUIRE(stats.liveAllocations == before.liveAllocations + 2);
+		REQUIRE(stats.peakBytes >= before.liveBytes + 1500);
+
+		// Moving transfers the accounting instead of duplicating it
+		TrackedAllocation c{std::move(a)};
+		REQUIRE(MemoryTracker::getStats(MEMORY_TAG_ASSETS).liveBytes == before.liveBytes + 1500);
+	}
+
+	const MemoryStats after{MemoryTracker::getStats(MEMORY_TAG_ASSETS)};
+	REQUIRE(after.liveBytes == before.liveBytes);
+	REQUIRE(after.liveAllocations == before.liveAllocations);
+	REQUIRE(after.totalAllocations == before.totalAllocations + 2);
+	REQUIRE(after.peakBytes >= before.liveBytes + 1500);
+}
+
+TEST_CASE("TaggedAllocator accounts container storage", "[Memory]")
+{
+	const size_t before{MemoryTracker::getStats(MEMORY_TAG_GENERAL).liveBytes};
+
+	{
+		std::vector<uint64_t, TaggedAllocator<uint64_t, MEMORY_TAG_GENERAL>> values;
+		values.reserve(128);
+		REQUIRE(MemoryTracker::getStats(MEMORY_TAG_GENERAL).liveBytes ==
+				before + 128 * sizeof(uint64_t));
+	}
+
+	REQUIRE(MemoryTracker::getStats(MEMORY_TAG_GENERAL).liveBytes == before);
+}
+
+TEST_CASE("TaggedMemoryResource accounts pmr containers", "[Memory]")
+{
+	TaggedMemoryResource resource{MEMORY_TAG_JOBS};
+	const size_t before{MemoryTracker::getStats(MEMORY_TAG_JOBS).liveBytes};
+
+	{
+		std::pmr::vector<int> values{&resource};
+		values.reserve(64);
+		REQUIRE(MemoryTracker::getStats(MEMORY_TAG_JOBS).liveBytes == before + 64 * sizeof(int));
+	}
+
+	REQUIRE(MemoryTracker::getStats(MEMORY_TAG_JOBS).liveBytes == before);
+}
+
+TEST_CASE("MemoryArena bump allocates and rewinds", "[Memory]")
+{
+	const size_t before{MemoryTracker::getStats(MEMORY_TAG_SCENE).liveBytes};
+
+	{
+		MemoryArena arena{MEMORY_TAG_SCENE, 1024};
+
+		auto* first{arena.allocateArray<uint32_t>(16)};
+		auto* second{arena.allocateArray<double>(4)};
+		REQUIRE(reinterpret_cast<uintptr_t>(second) % alignof(double) == 0);
+		REQUIRE(reinterpret_cast<std::byte*>(second) >= reinterpret_cast<std::byte*>(first + 16));
+		REQUIRE(arena.capacity() == 1024);
+		REQUIRE(MemoryTracker::getStats(MEMORY_TAG_SCENE).liveBytes == before + 1024);
+
+		// Overflowing the block adds another one; a reset folds them into one
+		static_cast<void>(arena.allocate(2000, 16));
+		REQUIRE(arena.capacity() > 1024);
+		const size_t grown{arena.capacity()};
+
+		arena.reset();
+		REQUIRE(arena.used() == 0);
+		REQUIRE(arena.capacity() == grown);
+
+		auto* reused{arena.allocateArray<uint32_t>(16)};
+		REQUIRE(reused != nullptr);
+		REQUIRE(arena.capacity() == grown);
+
+		std::pmr::vector<int> values{&arena};
+		values.assign(100, 7);
+		REQUIRE(values[99] == 7);
+
+		// Freeing the last allocation unwinds the arena like a stack
+		const size_t used{arena.used()};
+		{
+			std::pmr::vector<int> scratch{&arena};
+			scratch.reserve(50);
+		}
+		REQUIRE(arena.used() == used);
+	}
+
+	REQUIRE(MemoryTracker::getStats(MEMORY_TAG_SCENE).liveBytes == before);
+}
+
+TEST_CASE("FrameArena rewinds on the next frame", "[Memory]")
+{
+	FrameArena::nextFrame();
+	auto* first{FrameArena::allocate<uint64_t>(32)};
+	REQUIRE(FrameArena::get().used() >= 32 * sizeof(uint64_t));
+
+	{
+		FrameVector<int> values{FrameArena::resource()};
+		values.assign(1000, 3);
+		REQUIRE(values[999] == 3);
+	}
+
+	// Once the arena has grown to the frame's peak, later frames reuse the same memory
+	const size_t capacity{FrameArena::get().capacity()};
+	FrameArena::nextFrame();
+	REQUIRE(FrameArena::get().used() == 0);
+	REQUIRE(FrameArena::allocate<uint64_t>(32) == first);
+
+	FrameVector<int> values{FrameArena::resource()};
+	values.assign(1000, 3);
+	REQUIRE(FrameArena::get().capacity() == capacity);
+}
+
+TEST_CASE("FrameArena gives each thread its own arena", "[Memory]")
+{
+	FrameArena::nextFrame();
+	MemoryArena* mainArena{&FrameArena::get()};
+	static_cast<void>(FrameArena::allocate<int>(4));
+
+	// The worker's arena is destroyed with the thread, so only inspect it from inside
+	bool distinct{};
+	size_t workerUsed{};
+	MemoryTag workerTag{};
+	std::thread worker([&] {
+		distinct = &FrameArena::get() != mainArena;
+		static_cast<void>(FrameArena::allocate<int>(8));
+		workerUsed = FrameArena::get().used();
+		workerTag = FrameArena::get().tag();
+	});
+	worker.join();
+
+	REQUIRE(distinct);
+	REQUIRE(workerUsed >= 8 * sizeof(int));
+	REQUIRE(workerTag == MEMORY_TAG_FRAME);
+}
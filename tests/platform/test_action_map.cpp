@@ -0,0 +1,109 @@
+#include <catch.hpp>
+#include <vector>
+import lune;
+
+using namespace lune;
+
+
+static InputEvent press(const Key key, const double time = 0.0)
+{
+	return InputEvent{key, JUST_PRESSED, time};
+}
+
+static InputEvent release(const Key key, const double time = 0.0)
+{
+	return InputEvent{key, JUST_RELEASED, time};
+}
+
+TEST_CASE("ActionMap single keys and chords", "[ActionMap]")
+{
+	ActionMap actions;
+	const ActionId jump{actions.addAction("jump")};
+	const ActionId save{actions.addAction("save")};
+	actions.bind(jump, {KEY_SPACE});
+	actions.bind(jump, {MOUSE_RIGHT});
+	actions.bind(save, {KEY_LEFT_CONTROL, KEY_S});
+
+	REQUIRE(actions.findAction("save") == save);
+	REQUIRE_FALSE(actions.findAction("crouch").has_value());
+
+	actions.update(std::vector{press(KEY_SPACE)});
+	REQUIRE(actions.isPressed(jump));
+	REQUIRE(actions.isJustPressed(jump));
+
+	// A second binding of a held action does not retrigger it
+	actions.update(std::vector{press(MOUSE_RIGHT), release(KEY_SPACE)});
+	REQUIRE(actions.isPressed(jump));
+	REQUIRE_FALSE(actions.isJustPressed(jump));
+	REQUIRE_FALSE(actions.isJustReleased(jump));
+
+	actions.update(std::vector{release(MOUSE_RIGHT)});
+	REQUIRE_FALSE(actions.isPressed(jump));
+	REQUIRE(actions.isJustReleased(jump));
+
+	// Chords accept any order
+	actions.update(std::vector{press(KEY_S), press(KEY_LEFT_CONTROL)});
+	REQUIRE(actions.isJustPressed(save));
+
+	actions.update({});
+	REQUIRE(actions.isPressed(save));
+	REQUIRE_FALSE(actions.isJustPressed(save));
+}
+
+TEST_CASE("ActionMap ordered chords", "[ActionMap]")
+{
+	ActionMap actions;
+	const ActionId dash{actions.addAction("dash")};
+	actions.bind(dash, {KEY_LEFT_SHIFT, KEY_D}, ACTION_ORDERED_CHORD);
+
+	actions.update(std::vector{press(KEY_D), press(KEY_LEFT_SHIFT)});
+	REQUIRE_FALSE(actions.isPressed(dash));
+
+	actions.update(std::vector{release(KEY_D), release(KEY_LEFT_SHIFT)});
+	actions.update(std::vector{press(KEY_LEFT_SHIFT), press(KEY_D)});
+	REQUIRE(actions.isJustPressed(dash));
+
+	actions.update(std::vector{release(KEY_D)});
+	REQUIRE(actions.isJustReleased(dash));
+}
+
+TEST_CASE("ActionMap chords ignore repeated keys", "[ActionMap]")
+{
+	ActionMap actions;
+	const ActionId save{actions.addAction("save")};
+	const ActionId dash{actions.addAction("dash")};
+	actions.bind(save, {KEY_LEFT_CONTROL, KEY_S, KEY_LEFT_CONTROL});
+	actions.bind(dash, {KEY_LEFT_SHIFT, KEY_LEFT_SHIFT, KEY_D}, ACTION_ORDERED_CHORD);
+
+	actions.update(std::vector{press(KEY_LEFT_CONTROL), press(KEY_S)});
+	REQUIRE(actions.isJustPressed(save));
+
+	actions.update(std::vector{press(KEY_LEFT_SHIFT), press(KEY_D)});
+	REQUIRE(actions.isJustPressed(dash));
+
+	actions.update(std::vector{release(KEY_LEFT_CONTROL), release(KEY_LEFT_SHIFT)});
+	REQUIRE(actions.isJustReleased(save));
+	REQUIRE(actions.isJustReleased(dash));
+}
+
+TEST_CASE("ActionMap sequences respect the time window", "[ActionMap]")
+{
+	ActionMap actions;
+	const ActionId roll{actions.addAction("roll")};
+	actions.bind(roll, {KEY_W, KEY_W}, ACTION_SEQUENCE, 0.25);
+
+	actions.update(std::vector{press(KEY_W, 0.0), release(KEY_W, 0.05)});
+	REQUIRE_FALSE(actions.isJustPressed(roll));
+
+	actions.update(std::vector{press(KEY_W, 0.2)});
+	REQUIRE(actions.isJustPressed(roll));
+	REQUIRE_FALSE(actions.isPressed(roll));
+
+	actions.update(std::vector{release(KEY_W, 0.3)});
+	REQUIRE_FALSE(actions.isJustPressed(roll));
+
+	// Too slow: the second press only starts a new attempt
+	actions.update(std::vector{press(KEY_W, 1.0), release(KEY_W, 1.1)});
+	actions.update(std::vector{press(KEY_W, 1.5)});
+	REQUIRE_FALSE(actions.isJustPressed(roll));
+}
@@ -0,0 +1,129 @@
+#include <catch.hpp>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+import lune;
+
+using namespace lune;
+
+
+static std::string tempPath(const std::string& name)
+{
+	return (std::filesystem::temp_directory_path() / name).string();
+}
+
+static bool loadRecords(const std::string& path, const std::vector<InputRecord>& records)
+{
+	std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+	const InputRecordingHeader header{};
+	stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	stream.write(reinterpret_cast<const char*>(records.data()),
+				 static_cast<std::streamsize>(records.size() * sizeof(InputRecord)));
+	stream.close();
+
+	return InputReplayer::load(path).has_value();
+}
+
+TEST_CASE("Input recording round trips through the replayer", "[InputRecorder]")
+{
+	const std::string path{tempPath("lune_test_input.linp")};
+
+	auto recorder{InputRecorder::create(path)};
+	REQUIRE(recorder.has_value());
+
+	const std::vector<InputEvent> frame0{InputEvent{KEY_W, JUST_PRESSED, 0.01}};
+	const std::vector<InputEvent> frame2{InputEvent::mouseMove(10.0, 20.0, 0.05),
+										 InputEvent{KEY_W, JUST_RELEASED, 0.06}};
+	recorder->write(0, frame0);
+	recorder->write(2, frame2);
+	recorder->finish(4);
+
+	auto replayer{InputReplayer::load(path)};
+	REQUIRE(replayer.has_value());
+	REQUIRE(replayer->frameCount() == 4);
+
+	REQUIRE(replayer->replay(0).size() == 1);
+	REQUIRE(replayer->replay(1).empty());
+
+	const auto records{replayer->replay(2)};
+	REQUIRE(records.size() == 2);
+	REQUIRE(records[0].toEvent().getType() == INPUT_EVENT_MOUSE_MOVE);
+	REQUIRE(records[0].toEvent().getY() == Catch::Approx(20.0));
+	REQUIRE(records[1].toEvent().getKey() == KEY_W);
+	REQUIRE(records[1].toEvent().isJustReleased());
+	REQUIRE(records[1].toEvent().getTimestamp() == Catch::Approx(0.06));
+
+	REQUIRE_FALSE(replayer->isFinished(3));
+	REQUIRE(replayer->isFinished(4));
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("Input replayer rejects malformed records", "[InputRecorder]")
+{
+	const std::string path{tempPath("lune_test_invalid.linp")};
+
+	const InputRecord key{.frame = 1, .type = INPUT_EVENT_KEY, .key = KEY_A, .state = PRESSED};
+	const InputRecord move{.frame = 1, .type = INPUT_EVENT_MOUSE_MOVE, .x = 1.0};
+	REQUIRE(loadRecords(path, {key, move}));
+
+	InputRecord unknownType{key};
+	unknownType.type = 7;
+	REQUIRE_FALSE(loadRecords(path, {unknownType}));
+
+	InputRecord negativeKey{key};
+	negativeKey.key = -1;
+	REQUIRE_FALSE(loadRecords(path, {negativeKey}));
+
+	InputRecord keyOutOfRange{key};
+	keyOutOfRange.key = static_cast<int32_t>(KEY_COUNT);
+	REQUIRE_FALSE(loadRecords(path, {keyOutOfRange}));
+
+	InputRecord unknownState{key};
+	unknownState.state = JUST_RELEASED + 1;
+	REQUIRE_FALSE(loadRecords(path, {unknownState}));
+
+	InputRecord earlierFrame{key};
+	earlierFrame.frame = 0;
+	REQUIRE_FALSE(loadRecords(path, {key, earlierFrame}));
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("InputManager replays a recording without a window", "[InputRecorder]")
+{
+	const std::string path{tempPath("lune_test_replay.linp")};
+
+	auto recorder{InputRecorder::create(path)};
+	REQUIRE(recorder.has_value());
+
+	const std::vector<InputEvent> frame0{InputEvent{KEY_A, JUST_PRESSED, 0.0},
+										 InputEvent::mouseMove(0.0, 0.0, 0.0)};
+	const std::vector<InputEvent> frame1{InputEvent::mouseMove(3.0, 1.0, 0.01),
+										 InputEvent::mouseMove(5.0, -2.0, 0.015)};
+	const std::vector<InputEvent> frame2{InputEvent{KEY_A, JUST_RELEASED, 0.03}};
+	recorder->write(0, frame0);
+	recorder->write(1, frame1);
+	recorder->write(2, frame2);
+	recorder->finish(3);
+
+	REQUIRE(InputManager::startReplay(path));
+	REQUIRE(InputManager::isReplaying());
+
+	InputManager::_process();
+	REQUIRE(InputManager::isJustPressed(KEY_A));
+	REQUIRE(InputManager::getFrameEvents().size() == 2);
+
+	InputManager::_process();
+	REQUIRE(InputManager::isPressed(KEY_A));
+	REQUIRE(InputManager::getMouseDelta().x == Catch::Approx(5.0f));
+	REQUIRE(InputManager::getMouseDelta().y == Catch::Approx(2.0f));
+
+	InputManager::_process();
+	REQUIRE(InputManager::isJustReleased(KEY_A));
+	REQUIRE(InputManager::isReplayFinished());
+	REQUIRE_FALSE(InputManager::isReplaying());
+
+	std::filesystem::remove(path);
+}
@@ -0,0 +1,127 @@
+#include <catch.hpp>
+#include <filesystem>
+#include <fstream>
+#include <string>
+import lune;
+
+using namespace lune;
+
+TEST_CASE("RollingHistogram percentiles follow the window", "[FrameStats]")
+{
+	RollingHistogram histogram{100, 0.001, 1000};
+
+	for (int i = 1; i <= 100; ++i)
+		histogram.add(i * 0.001);
+
+	REQUIRE(histogram.count() == 100);
+	REQUIRE(histogram.percentile(0.50) == Catch::Approx(0.050).margin(0.001));
+	REQUIRE(histogram.percentile(0.99) == Catch::Approx(0.099).margin(0.001));
+	REQUIRE(histogram.max() == Catch::Approx(0.100));
+	REQUIRE(histogram.average() == Catch::Approx(0.0505));
+
+	// Old values are evicted as new ones arrive
+	for (int i = 0; i < 100; ++i)
+		histogram.add(0.002);
+
+	REQUIRE(histogram.count() == 100);
+	REQUIRE(histogram.percentile(0.99) == Catch::Approx(0.002).margin(0.001));
+	REQUIRE(histogram.max() == Catch::Approx(0.002));
+}
+
+TEST_CASE("RollingHistogram reports overflowing values through max", "[FrameStats]")
+{
+	RollingHistogram histogram{10, 0.001, 10};
+
+	histogram.add(0.005);
+	histogram.add(5.0);
+
+	REQUIRE(histogram.percentile(1.0) == Catch::Approx(5.0));
+	REQUIRE(histogram.percentile(0.5) == Catch::Approx(0.006).margin(0.001));
+}
+
+TEST_CASE("FrameStats detects hitches against the budget", "[FrameStats]")
+{
+	FrameStats stats{1.0 / 60.0};
+
+	double time{};
+	stats.markFrame(time);
+	for (int i = 0; i < 100; ++i)
+	{
+		time += i == 50 ? 0.1 : 0.016;
+		stats.addCpuWait(0.002);
+		stats.markFrame(time);
+	}
+
+	REQUIRE(stats.frameCount() == 100);
+	REQUIRE(stats.hitchCount() == 1);
+
+	const auto hitches{stats.getHitches()};
+	REQUIRE(hitches.size() == 1);
+	REQUIRE(hitches[0].frame == 50);
+	REQUIRE(hitches[0].frameTime == Catch::Approx(0.1));
+
+	const FrameMetricSummary frameTime{stats.getSummary(FRAME_TIME)};
+	REQUIRE(frameTime.count == 100);
+	REQUIRE(frameTime.p50 == Catch::Approx(0.016).margin(0.0002));
+	REQUIRE(frameTime.max == Catch::Approx(0.1));
+
+	const FrameMetricSummary cpuWait{stats.getSummary(FRAME_CPU_WAIT)};
+	REQUIRE(cpuWait.p99 == Catch::Approx(0.002).margin(0.0002));
+}
+
+TEST_CASE("FrameStats keeps the most recent hitches in order", "[FrameStats]")
+{
+	FrameStats stats{0.01};
+
+	double time{};
+	stats.markFrame(time);
+	for (size_t i = 0; i < FrameStats::MAX_HITCHES + 5; ++i)
+	{
+		time += 0.02;
+		stats.markFrame(time);
+	}
+
+	const auto hitches{stats.getHitches()};
+	REQUIRE(hitches.size() == FrameStats::MAX_HITCHES);
+	REQUIRE(hitches.front().frame == 5);
+	REQUIRE(hitches.back().frame == FrameStats::MAX_HITCHES + 4);
+}
+
+TEST_CASE("FrameStats measures present intervals", "[FrameStats]")
+{
+	FrameStats stats;
+
+	stats.recordPresent(1.0);
+	stats.recordPresent(1.0 + 1.0 / 60.0);
+	stats.recordPresent(1.0 + 2.0 / 60.0);
+
+	const FrameMetricSummary present{stats.getSummary(FRAME_PRESENT_INTERVAL)};
+	REQUIRE(present.count == 2);
+	REQUIRE(present.average == Catch::Approx(1.0 / 60.0));
+}
+
+TEST_CASE("FrameStats writes the window as CSV", "[FrameStats]")
+{
+	const auto path{std::filesystem::temp_directory_path() / "lune_test_frame_stats.csv"};
+	FrameStats stats{0.02};
+
+	stats.markFrame(0.0);
+	stats.markFrame(0.01);
+	stats.recordPresent(1.0);
+	stats.recordPresent(1.025);
+	stats.markFrame(0.05);
+
+	REQUIRE(stats.writeCsv(path.string()));
+
+	std::ifstream stream(path);
+	std::string line;
+	std::getline(stream, line);
+	REQUIRE(line == "frame,frame_time_ms,cpu_wait_ms,present_interval_ms,hitch");
+	std::getline(stream, line);
+	REQUIRE(line == "0,10,0,,0");
+	std::getline(stream, line);
+	REQUIRE(line == "1,40,0,25,1");
+
+	stream.close();
+	std::filesystem::remove(path);
+}
@@ -0,0 +1,148 @@
+#include <catch.hpp>
+#include <filesystem>
+#include <fstream>
+#include <lune/profiler.hpp>
+#include <sstream>
+#include <string>
+#include <thread>
+import lune;
+
+using namespace lune;
+
+namespace
+{
+	std::string readFile(const std::filesystem::path& path)
+	{
+		std::ifstream stream(path);
+		std::stringstream contents;
+		contents << stream.rdbuf();
+		return contents.str();
+	}
+
+	size_t countOccurrences(const std::string& text, const std::string& pattern)
+	{
+		size_t count{};
+		for (size_t pos = text.find(pattern); pos != std::string::npos;
+			 pos = text.find(pattern, pos + pattern.size()))
+		{
+			++count;
+		}
+		return count;
+	}
+} // namespace
+
+TEST_CASE("Profiler records zones only while capturing", "[Profiler]")
+{
+	const auto path{std::filesystem::temp_directory_path() / "lune_test_trace.json"};
+
+	{
+		ProfileZone zone{"before"};
+	}
+
+	Profiler::beginCapture();
+	REQUIRE(Profiler::isCapturing());
+	{
+		ProfileZone outer{"outer"};
+		ProfileZone inner{"inner \"quoted\""};
+	}
+	Profiler::endCapture();
+
+	{
+		ProfileZone zone{"after"};
+	}
+
+	REQUIRE(Profiler::exportChromeTrace(path.string()));
+	const std::string trace{readFile(path)};
+
+	REQUIRE(trace.find("\"traceEvents\"") != std::string::npos);
+	REQUIRE(trace.find("\"outer\"") != std::string::npos);
+	REQUIRE(trace.find(R"("inner \"quoted\"")") != std::string::npos);
+	REQUIRE(trace.find("\"before\"") == std::string::npos);
+	REQUIRE(trace.find("\"after\"") == std::string::npos);
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("Profiler collects zones from every thread", "[Profiler]")
+{
+	const auto path{std::filesystem::temp_directory_path() / "lune_test_trace_threads.json"};
+
+	Profiler::beginCapture();
+	std::thread worker(
+			[]
+			{
+				Profiler::setThreadName("Test worker");
+				for (int i = 0; i < 100; ++i)
+				{
+					ProfileZone zone{"worker zone"};
+				}
+			});
+	for (int i = 0; i < 100; ++i)
+	{
+		ProfileZone zone{"main zone"};
+	}
+	worker.join();
+
+	Profiler::markFrame();
+	Profiler::markFrame();
+	Profiler::endCapture();
+
+	REQUIRE(Profiler::exportChromeTrace(path.string()));
+	const std::string trace{readFile(path)};
+
+	REQUIRE(countOccurrences(trace, "\"worker zone\"") == 100);
+	REQUIRE(countOccurrences(trace, "\"main zone\"") == 100);
+	REQUIRE(countOccurrences(trace, "\"Frame\"") == 1);
+	REQUIRE(trace.find("\"Test worker\"") != std::string::npos);
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("A new capture discards the previous one", "[Profiler]")
+{
+	const auto path{std::filesystem::temp_directory_path() / "lune_test_trace_reset.json"};
+
+	Profiler::beginCapture();
+	{
+		LUNE_ZONE("first capture");
+	}
+	Profiler::endCapture();
+
+	Profiler::beginCapture();
+	{
+		LUNE_ZONE("second capture");
+	}
+	Profiler::endCapture();
+
+	REQUIRE(Profiler::exportChromeTrace(path.string()));
+	const std::string trace{readFile(path)};
+
+	REQUIRE(trace.find("\"first capture\"") == std::string::npos);
+	REQUIRE(trace.find("\"second capture\"") != std::string::npos);
+	REQUIRE(Profiler::droppedZones() == 0);
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("Profiler interns runtime zone names", "[Profiler]")
+{
+	const auto path{std::filesystem::temp_directory_path() / "lune_test_trace_interned.json"};
+
+	std::string name{"system"};
+	const char* interned{Profiler::intern(name)};
+	REQUIRE(Profiler::intern(std::string{"system"}) == interned);
+	REQUIRE(Profiler::intern("other") != interned);
+
+	Profiler::beginCapture();
+	{
+		ProfileZone zone{interned};
+	}
+	Profiler::endCapture();
+
+	// The recorded name doesn't depend on the string it was interned from
+	name = "overwritten";
+	REQUIRE(Profiler::exportChromeTrace(path.string()));
+	REQUIRE(readFile(path).find("\"system\"") != std::string::npos);
+
+	std::filesystem::remove(path);
+}
@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <catch.hpp>
+#include <cstdint>
+#include <numbers>
+#include <vector>
+import lune;
+
+using namespace lune;
+
+
+static Aabb gridBox(const uint32_t i, const float offset = 0.0f)
+{
+	const float x{static_cast<float>(i % 100) * 2.0f + offset};
+	const float z{static_cast<float>(i / 100) * -2.0f};
+	return Aabb::fromCenterExtents({x, 0.0f, z}, {0.5f, 0.5f, 0.5f});
+}
+
+static std::vector<uint32_t> bruteForce(const Frustum& frustum, const std::vector<Aabb>& boxes)
+{
+	std::vector<uint32_t> result;
+	for (uint32_t i = 0; i < boxes.size(); ++i)
+	{
+		if (frustum.intersects(boxes[i]))
+			result.push_back(i);
+	}
+	return result;
+}
+
+TEST_CASE("Bvh frustum query matches brute force", "[Bvh]")
+{
+	const Mat4 projection = Mat4::perspective(std::numbers::pi_v<float> / 3.0f, 1.5f, 0.1f, 60.0f);
+	const Mat4 view = Mat4::lookAt({50.0f, 5.0f, 10.0f}, {50.0f, 0.0f, -20.0f}, {0.0f, 1.0f, 0.0f});
+	const Frustum frustum = Frustum::fromCamera(projection, view);
+
+	JobSystem jobs{3};
+	Bvh bvh;
+	std::vector<Aabb> boxes;
+	for (uint32_t i = 0; i < 10000; ++i)
+	{
+		boxes.push_back(gridBox(i));
+		bvh.insert(boxes.back(), i);
+	}
+	bvh.commit(&jobs);
+
+	std::vector<uint32_t> visible;
+	bvh.query(frustum, visible);
+	std::ranges::sort(visible);
+	REQUIRE(visible == bruteForce(frustum, boxes));
+	REQUIRE_FALSE(visible.empty());
+
+	// Moving every object only refits the tree
+	for (uint32_t i = 0; i < boxes.size(); ++i)
+	{
+		boxes[i] = gridBox(i, 1.0f);
+		bvh.update(i, boxes[i]);
+	}
+	bvh.commit(&jobs);
+
+	visible.clear();
+	bvh.query(frustum, visible);
+	std::ranges::sort(visible);
+	REQUIRE(visible == bruteForce(frustum, boxes));
+}
+
+TEST_CASE("Bvh insert and remove", "[Bvh]")
+{
+	Bvh bvh;
+	const uint32_t a{bvh.insert({{0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}}, 7)};
+	const uint32_t b{bvh.insert({{5.0f, 0.0f, 0.0f}, {6.0f, 1.0f, 1.0f}}, 9)};
+	bvh.commit();
+
+	std::vector<uint32_t> result;
+	bvh.query(Aabb{{-1.0f, -1.0f, -1.0f}, {10.0f, 2.0f, 2.0f}}, result);
+	REQUIRE(result.size() == 2);
+
+	bvh.remove(a);
+	bvh.commit();
+	REQUIRE(bvh.proxyCount() == 1);
+
+	result.clear();
+	bvh.query(Aabb{{-1.0f, -1.0f, -1.0f}, {10.0f, 2.0f, 2.0f}}, result);
+	REQUIRE(result == std::vector<uint32_t>{9});
+	REQUIRE(bvh.userData(b) == 9);
+}
+
+TEST_CASE("Bvh refits trees without area instead of rebuilding them", "[Bvh]")
+{
+	// Points on a line: no inner node has any surface area
+	Bvh bvh;
+	for (uint32_t i = 0; i < 16; ++i)
+	{
+		const Vec3 point{static_cast<float>(i), 0.0f, 0.0f};
+		bvh.insert({point, point}, i);
+	}
+	bvh.commit();
+	REQUIRE(bvh.rebuildCount() == 1);
+
+	// Jittering the points gives the tree a little area, which is no reason to rebuild it
+	for (int frame = 1; frame <= 10; ++frame)
+	{
+		for (uint32_t i = 0; i < 16; ++i)
+		{
+			const Vec3 point{static_cast<float>(i), 0.0001f * static_cast<float>(frame * (i % 3)),
+							 0.0f};
+			bvh.update(i, {point, point});
+		}
+		bvh.commit();
+	}
+	REQUIRE(bvh.rebuildCount() == 1);
+
+	// Scattering them does degrade the tree
+	for (uint32_t i = 0; i < 16; ++i)
+	{
+		const Vec3 point{static_cast<float>(i), static_cast<float>(i * 7 % 16) * 10.0f,
+						 static_cast<float>(i * 5 % 16) * 10.0f};
+		bvh.update(i, {point, point});
+	}
+	bvh.commit();
+	REQUIRE(bvh.rebuildCount() == 2);
+
+	std::vector<uint32_t> result;
+	bvh.query(Aabb{{-1.0f, -1.0f, -1.0f}, {20.0f, 200.0f, 200.0f}}, result);
+	REQUIRE(result.size() == 16);
+}
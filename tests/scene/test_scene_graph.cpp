@@ -0,0 +1,155 @@
+#include <catch.hpp>
+#include <cstdint>
+#include <numbers>
+#include <stdexcept>
+#include <vector>
+import lune;
+
+using namespace lune;
+
+
+static Vec3 origin(const Mat4& matrix)
+{
+	return {matrix.m[3][0], matrix.m[3][1], matrix.m[3][2]};
+}
+
+static Mat4 expectedWorld(const SceneGraph& graph, const uint32_t node)
+{
+	const Transform& local{graph.local(node)};
+	const Mat4 matrix{Mat4::transform(local.translation, local.rotation, local.scale)};
+	const uint32_t parent{graph.parent(node)};
+	return parent == SCENE_NULL_NODE ? matrix : matrix * expectedWorld(graph, parent);
+}
+
+static bool approxEqual(const Mat4& a, const Mat4& b)
+{
+	for (int i = 0; i < 4; ++i)
+	{
+		for (int j = 0; j < 4; ++j)
+		{
+			if (a.m[i][j] != Catch::Approx(b.m[i][j]).margin(1e-4))
+				return false;
+		}
+	}
+	return true;
+}
+
+TEST_CASE("SceneGraph composes world matrices down the hierarchy", "[SceneGraph]")
+{
+	SceneGraph graph;
+	const uint32_t root{graph.create(SCENE_NULL_NODE, {.translation = {10, 0, 0}})};
+	const uint32_t child{graph.create(root, {.translation = {0, 5, 0}})};
+	const uint32_t grandchild{graph.create(child, {.translation = {0, 0, 1}})};
+	graph.update();
+
+	REQUIRE(graph.updatedCount() == 3);
+	REQUIRE(origin(graph.world(grandchild)).x == Catch::Approx(10.0f));
+	REQUIRE(origin(graph.world(grandchild)).y == Catch::Approx(5.0f));
+	REQUIRE(origin(graph.world(grandchild)).z == Catch::Approx(1.0f));
+
+	graph.setRotation(root, {0, std::numbers::pi_v<float> / 2.0f, 0});
+	graph.update();
+	for (const uint32_t node : {root, child, grandchild})
+		REQUIRE(approxEqual(graph.world(node), expectedWorld(graph, node)));
+}
+
+TEST_CASE("SceneGraph only recomputes changed subtrees", "[SceneGraph]")
+{
+	SceneGraph graph;
+	std::vector<uint32_t> parents;
+	for (int i = 0; i < 100; ++i)
+	{
+		const float x{static_cast<float>(i)};
+		const uint32_t parent{graph.create(SCENE_NULL_NODE, {.translation = {x, 0, 0}})};
+		parents.push_back(parent);
+		for (int j = 0; j < 9; ++j)
+			graph.create(parent, {.translation = {0, static_cast<float>(j), 0}});
+	}
+	graph.update();
+	REQUIRE(graph.updatedCount() == 1000);
+
+	graph.update();
+	REQUIRE(graph.updatedCount() == 0);
+
+	// A moved parent recomputes its 10 nodes; a dirty child inside it is covered by the parent
+	graph.setTranslation(parents[42], {0, 0, 3});
+	graph.setScale(parents[42] + 1, {2, 2, 2});
+	graph.setTranslation(parents[7], {1, 1, 1});
+	graph.update();
+	REQUIRE(graph.updatedCount() == 20);
+	REQUIRE(origin(graph.world(parents[42] + 4)).z == Catch::Approx(3.0f));
+}
+
+TEST_CASE("SceneGraph reparents and destroys subtrees", "[SceneGraph]")
+{
+	SceneGraph graph;
+	const uint32_t a{graph.create(SCENE_NULL_NODE, {.translation = {1, 0, 0}})};
+	const uint32_t b{graph.create(SCENE_NULL_NODE, {.translation = {0, 2, 0}})};
+	const uint32_t child{graph.create(a, {.translation = {0, 0, 3}})};
+	const uint32_t leaf{graph.create(child)};
+	graph.update();
+	REQUIRE(origin(graph.world(leaf)).x == Catch::Approx(1.0f));
+
+	REQUIRE_FALSE(graph.setParent(a, leaf));
+	REQUIRE(graph.setParent(child, b));
+	graph.update();
+	REQUIRE(graph.updatedCount() == 2);
+	REQUIRE(origin(graph.world(leaf)).x == Catch::Approx(0.0f));
+	REQUIRE(origin(graph.world(leaf)).y == Catch::Approx(2.0f));
+	REQUIRE(origin(graph.world(leaf)).z == Catch::Approx(3.0f));
+
+	graph.destroy(b);
+	REQUIRE_FALSE(graph.isAlive(child));
+	REQUIRE_FALSE(graph.isAlive(leaf));
+	REQUIRE(graph.nodeCount() == 1);
+
+	REQUIRE_THROWS_AS(graph.create(b), std::invalid_argument);
+	REQUIRE_THROWS_AS(graph.create(100), std::invalid_argument);
+	REQUIRE(graph.nodeCount() == 1);
+
+	// Destroyed indices are reused
+	const uint32_t reused{graph.create(a, {.translation = {0, 7, 0}})};
+	graph.update();
+	REQUIRE(graph.isAlive(reused));
+	REQUIRE(origin(graph.world(reused)).y == Catch::Approx(7.0f));
+	REQUIRE(origin(graph.world(a)).x == Catch::Approx(1.0f));
+}
+
+TEST_CASE("SceneGraph parallel propagation matches serial", "[SceneGraph]")
+{
+	// A deep spine with wide fans, so large subtrees get split across jobs
+	SceneGraph serial;
+	std::vector<uint32_t> nodes;
+	uint32_t spine{SCENE_NULL_NODE};
+	for (int i = 0; i < 40; ++i)
+	{
+		const float angle{0.05f * static_cast<float>(i)};
+		spine = serial.create(spine, {.translation = {1, 0, 0}, .rotation = {0, angle, 0}});
+		nodes.push_back(spine);
+		for (int j = 0; j < 300; ++j)
+		{
+			const float y{0.01f * static_cast<float>(j)};
+			nodes.push_back(serial.create(spine, {.translation = {0, y, 0}}));
+		}
+	}
+
+	SceneGraph parallel;
+	for (const uint32_t node : nodes)
+		REQUIRE(parallel.create(serial.parent(node), serial.local(node)) == node);
+
+	JobSystem jobs{3};
+	serial.update();
+	parallel.update(&jobs);
+	REQUIRE(parallel.updatedCount() == nodes.size());
+
+	serial.setRotation(nodes[0], {0.3f, 0, 0});
+	parallel.setRotation(nodes[0], {0.3f, 0, 0});
+	serial.update();
+	parallel.update(&jobs);
+
+	for (const uint32_t node : nodes)
+	{
+		REQUIRE(approxEqual(parallel.world(node), serial.world(node)));
+		REQUIRE(approxEqual(parallel.world(node), expectedWorld(parallel, node)));
+	}
+}
@@ -0,0 +1,111 @@
+#include <atomic>
+#include <catch.hpp>
+#include <string>
+#include <vector>
+import lune;
+
+using namespace lune;
+
+namespace
+{
+	struct Position
+	{
+		Vec3 value;
+	};
+
+	struct Velocity
+	{
+		Vec3 value;
+	};
+
+	struct Gravity
+	{
+		float value{-9.8f};
+	};
+
+	using Stages = std::vector<std::vector<std::string>>;
+} // namespace
+
+TEST_CASE("SystemScheduler groups systems by conflicting accesses", "[SystemScheduler]")
+{
+	SystemScheduler scheduler;
+	scheduler.add<Velocity, const Gravity>("gravity", [](World&) {});
+	scheduler.add<Position, const Velocity>("integrate", [](World&) {});
+	scheduler.add<const Position>("render", [](World&) {});
+	scheduler.add<const Position>("audio", [](World&) {});
+	scheduler.add<const Gravity>("debug", [](World&) {});
+
+	// Readers run together; writers wait for what they conflict with
+	REQUIRE(scheduler.stages() ==
+			Stages{{"gravity", "debug"}, {"integrate"}, {"render", "audio"}});
+
+	scheduler.addExclusive("spawn", [](World&) {});
+	scheduler.add<const Gravity>("late", [](World&) {});
+	REQUIRE(scheduler.stages() == Stages{{"gravity", "debug"},
+										 {"integrate"},
+										 {"render", "audio"},
+										 {"spawn"},
+										 {"late"}});
+}
+
+TEST_CASE("SystemScheduler runs stages in order", "[SystemScheduler]")
+{
+	World world;
+	for (int i = 0; i < 1000; ++i)
+		world.create(Position{}, Velocity{}, Gravity{});
+
+	SystemScheduler scheduler;
+	scheduler.add<Velocity, const Gravity>(
+			"gravity",
+			[query = world.query<Velocity, const Gravity>()](World&) mutable
+			{
+				query.each([](Velocity& velocity, const Gravity& gravity)
+						   { velocity.value.y += gravity.value; });
+			});
+	scheduler.add<Position, const Velocity>(
+			"integrate",
+			[query = world.query<Position, const Velocity>()](World&) mutable
+			{
+				query.each([](Position& position, const Velocity& velocity)
+						   { position.value = position.value + velocity.value; });
+			});
+
+	std::atomic<int> readers{0};
+	for (const char* name : {"a", "b", "c", "d"})
+	{
+		scheduler.add<const Position>(name,
+									  [&, query = world.query<const Position>()](World&) mutable
+									  {
+										  query.each(
+												  [&](const Position& position)
+												  {
+													  if (position.value.y < -9.0f)
+														  ++readers;
+												  });
+									  });
+	}
+
+	JobSystem jobs{3};
+	scheduler.run(world, &jobs);
+	REQUIRE(readers == 4000);
+
+	scheduler.run(world);
+	const auto* position{world.get<Position>(Entity{0, 0})};
+	REQUIRE(position->value.y == Catch::Approx(-9.8f * 3.0f));
+}
+
+TEST_CASE("Exclusive systems may change the world", "[SystemScheduler]")
+{
+	World world;
+	SystemScheduler scheduler;
+	scheduler.addExclusive("spawn", [](World& w) { w.create(Position{}); });
+
+	size_t seen{};
+	scheduler.add<const Position>("count",
+								  [&, query = world.query<const Position>()](World&) mutable
+								  { seen = query.count(); });
+
+	scheduler.run(world);
+	scheduler.run(world);
+	REQUIRE(seen == 2);
+}
@@ -0,0 +1,233 @@
+#include <catch.hpp>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+import lune;
+
+using namespace lune;
+
+namespace
+{
+	struct Position
+	{
+		Vec3 value;
+	};
+
+	struct Velocity
+	{
+		Vec3 value;
+	};
+
+	struct Health
+	{
+		int value{100};
+	};
+
+	struct Name
+	{
+		std::unique_ptr<std::string> value;
+	};
+
+	/// Counts live instances to check that moves between archetypes don't leak or double-free.
+	struct Tracked
+	{
+		static inline int live{0};
+		int value{};
+
+		Tracked(const int value = 0) : value(value)
+		{
+			++live;
+		}
+
+		Tracked(Tracked&& other) noexcept : value(other.value)
+		{
+			++live;
+		}
+
+		Tracked& operator=(Tracked&&) noexcept = default;
+
+		~Tracked()
+		{
+			--live;
+		}
+	};
+} // namespace
+
+TEST_CASE("World creates entities and gets their components", "[World]")
+{
+	World world;
+	const Entity a{world.create(Position{{1, 2, 3}}, Velocity{{0, 1, 0}})};
+	const Entity b{world.create(Position{{4, 5, 6}})};
+
+	REQUIRE(world.entityCount() == 2);
+	REQUIRE(world.isAlive(a));
+	REQUIRE(world.has<Velocity>(a));
+	REQUIRE_FALSE(world.has<Velocity>(b));
+	REQUIRE(world.get<Position>(a)->value.y == 2.0f);
+	REQUIRE(world.get<Position>(b)->value.z == 6.0f);
+	REQUIRE(world.get<Velocity>(b) == nullptr);
+
+	// Same component sets share an archetype, regardless of order
+	const Entity c{world.create(Velocity{}, Position{})};
+	REQUIRE(world.archetypes().size() == 3);
+	REQUIRE(world.get<Position>(c) != nullptr);
+}
+
+TEST_CASE("World reuses destroyed entity indices with a new generation", "[World]")
+{
+	World world;
+	const Entity a{world.create(Health{1})};
+	const Entity b{world.create(Health{2})};
+	world.destroy(a);
+
+	REQUIRE_FALSE(world.isAlive(a));
+	REQUIRE(world.get<Health>(a) == nullptr);
+	REQUIRE(world.get<Health>(b)->value == 2);
+
+	const Entity c{world.create(Health{3})};
+	REQUIRE(c.index == a.index);
+	REQUIRE(c.generation != a.generation);
+	REQUIRE_FALSE(world.isAlive(a));
+	REQUIRE(world.get<Health>(c)->value == 3);
+
+	world.destroy(a);
+	REQUIRE(world.entityCount() == 2);
+
+	// A stale handle can't touch the entity that reused its index
+	REQUIRE_THROWS_AS(world.add(a, Position{}), std::invalid_argument);
+	world.remove<Health>(a);
+	REQUIRE_FALSE(world.has<Position>(c));
+	REQUIRE(world.get<Health>(c)->value == 3);
+}
+
+TEST_CASE("World moves entities between archetypes when components change", "[World]")
+{
+	World world;
+	std::vector<Entity> entities;
+	for (int i = 0; i < 10; ++i)
+		entities.push_back(world.create(Health{i}, Name{std::make_unique<std::string>("e")}));
+
+	world.add(entities[3], Position{{3, 0, 0}});
+	REQUIRE(world.has<Position>(entities[3]));
+	REQUIRE(world.get<Health>(entities[3])->value == 3);
+	REQUIRE(*world.get<Name>(entities[3])->value == "e");
+
+	// The last row filled the hole, so every other entity must still resolve correctly
+	for (int i = 0; i < 10; ++i)
+		REQUIRE(world.get<Health>(entities[i])->value == i);
+
+	world.add(entities[3], Position{{7, 0, 0}});
+	REQUIRE(world.get<Position>(entities[3])->value.x == 7.0f);
+
+	world.remove<Name>(entities[3]);
+	REQUIRE_FALSE(world.has<Name>(entities[3]));
+	REQUIRE(world.get<Health>(entities[3])->value == 3);
+	REQUIRE(world.get<Position>(entities[3])->value.x == 7.0f);
+
+	world.remove<Velocity>(entities[3]);
+	REQUIRE(world.has<Position>(entities[3]));
+}
+
+TEST_CASE("World destroys every component exactly once", "[World]")
+{
+	{
+		World world;
+		std::vector<Entity> entities;
+		for (int i = 0; i < 1000; ++i)
+			entities.push_back(world.create(Tracked{i}, Health{}));
+		REQUIRE(Tracked::live == 1000);
+
+		for (int i = 0; i < 1000; i += 3)
+			world.destroy(entities[i]);
+		for (int i = 1; i < 1000; i += 3)
+			world.remove<Health>(entities[i]);
+		for (int i = 2; i < 1000; i += 3)
+			world.add(entities[i], Position{});
+
+		REQUIRE(Tracked::live == 666);
+		for (int i = 1; i < 1000; i += 3)
+			REQUIRE(world.get<Tracked>(entities[i])->value == i);
+	}
+	REQUIRE(Tracked::live == 0);
+}
+
+TEST_CASE("Query iterates matching entities as contiguous arrays", "[World]")
+{
+	World world;
+	for (int i = 0; i < 5000; ++i)
+	{
+		const float x{static_cast<float>(i)};
+		if (i % 2 == 0)
+			world.create(Position{{x, 0, 0}}, Velocity{{1, 0, 0}});
+		else
+			world.create(Position{{x, 0, 0}}, Velocity{{1, 0, 0}}, Health{});
+	}
+	world.create(Position{});
+
+	Query<Position, const Velocity> movers{world.query<Position, const Velocity>()};
+	REQUIRE(movers.count() == 5000);
+
+	size_t chunks{};
+	movers.eachChunk(
+			[&](const std::span<const Entity> entities, const std::span<Position> positions,
+				const std::span<const Velocity> velocities)
+			{
+				REQUIRE(entities.size() == positions.size());
+				REQUIRE(positions.size() == velocities.size());
+				for (size_t i = 0; i < positions.size(); ++i)
+					positions[i].value = positions[i].value + velocities[i].value;
+				++chunks;
+			});
+	REQUIRE(chunks > 2);
+
+	std::set<float> xs;
+	movers.each([&](const Entity entity, const Position& position, const Velocity&)
+				{
+					REQUIRE(world.isAlive(entity));
+					xs.insert(position.value.x);
+				});
+	REQUIRE(xs.size() == 5000);
+	REQUIRE(*xs.begin() == 1.0f);
+	REQUIRE(*xs.rbegin() == 5000.0f);
+
+	// Archetypes created after the query was made are picked up
+	world.create(Position{}, Velocity{}, Name{});
+	REQUIRE(movers.count() == 5001);
+}
+
+TEST_CASE("Query processes chunks in parallel", "[World]")
+{
+	World world;
+	for (int i = 0; i < 20000; ++i)
+		world.create(Position{}, Velocity{{0, 2, 0}});
+
+	JobSystem jobs{3};
+	Query<Position, const Velocity> movers{world.query<Position, const Velocity>()};
+	movers.parallelEach(jobs, [](Position& position, const Velocity& velocity)
+						{ position.value = position.value + velocity.value; });
+
+	size_t moved{};
+	world.query<const Position>().each(
+			[&](const Position& position)
+			{
+				if (position.value.y == 2.0f)
+					++moved;
+			});
+	REQUIRE(moved == 20000);
+}
+
+TEST_CASE("Chunks are accounted to the scene", "[World]")
+{
+	const size_t before{MemoryTracker::getStats(MEMORY_TAG_SCENE).liveBytes};
+	{
+		World world;
+		for (int i = 0; i < 100; ++i)
+			world.create(Position{});
+		REQUIRE(MemoryTracker::getStats(MEMORY_TAG_SCENE).liveBytes > before);
+	}
+	REQUIRE(MemoryTracker::getStats(MEMORY_TAG_SCENE).liveBytes == before);
+}
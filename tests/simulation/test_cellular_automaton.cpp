@@ -0,0 +1,166 @@
+#include <catch.hpp>
+#include <cstdint>
+#include <utility>
+#include <vector>
+import lune;
+
+using namespace lune;
+
+namespace
+{
+	/// One byte per cell, stepped the obvious way, to check the packed implementation against.
+	struct ReferenceGrid
+	{
+		uint32_t width;
+		uint32_t height;
+		std::vector<uint8_t> cells;
+
+		explicit ReferenceGrid(const CellularAutomaton& automaton) :
+			width(automaton.width()), height(automaton.height()), cells(width * height)
+		{
+			for (uint32_t y = 0; y < height; ++y)
+			{
+				for (uint32_t x = 0; x < width; ++x)
+					cells[y * width + x] = automaton.get(x, y);
+			}
+		}
+
+		void step(const CellularRule& rule)
+		{
+			std::vector<uint8_t> next(cells.size());
+			for (uint32_t y = 0; y < height; ++y)
+			{
+				for (uint32_t x = 0; x < width; ++x)
+				{
+					uint32_t neighbours{};
+					for (uint32_t dy = height - 1; dy <= height + 1; ++dy)
+					{
+						for (uint32_t dx = width - 1; dx <= width + 1; ++dx)
+						{
+							if (dx != width || dy != height)
+								neighbours += cells[(y + dy) % height * width + (x + dx) % width];
+						}
+					}
+
+					const uint16_t mask{cells[y * width + x] ? rule.survival : rule.birth};
+					next[y * width + x] = mask >> neighbours & 1;
+				}
+			}
+			cells = std::move(next);
+		}
+
+		[[nodiscard]] bool matches(const CellularAutomaton& automaton) const
+		{
+			for (uint32_t y = 0; y < height; ++y)
+			{
+				for (uint32_t x = 0; x < width; ++x)
+				{
+					if (automaton.get(x, y) != (cells[y * width + x] != 0))
+						return false;
+				}
+			}
+			return true;
+		}
+	};
+} // namespace
+
+TEST_CASE("CellularAutomaton matches a per-cell reference on any grid size",
+		  "[CellularAutomaton]")
+{
+	const auto [width, height]{GENERATE(std::pair{1u, 1u}, std::pair{5u, 3u}, std::pair{64u, 8u},
+										std::pair{65u, 7u}, std::pair{130u, 40u},
+										std::pair{200u, 2u})};
+	const CellularRule rule{GENERATE(CellularRule{}, *CellularRule::parse("B36/S23"),
+									 *CellularRule::parse("B2/S"))};
+
+	JobSystem jobs{3};
+	CellularAutomaton automaton{width, height, rule};
+	automaton.randomize(0.4f, width * 31 + height);
+	ReferenceGrid reference{automaton};
+
+	for (int generation = 0; generation < 12; ++generation)
+	{
+		automaton.step(1, generation % 2 ? &jobs : nullptr);
+		reference.step(rule);
+		REQUIRE(reference.matches(automaton));
+	}
+	REQUIRE(automaton.generation() == 12);
+
+	// Padding bits past the width stay dead
+	const uint64_t padding{width % 64 ? ~uint64_t{} << (width % 64) : 0};
+	for (size_t word = automaton.wordsPerRow() - 1; word < automaton.words().size();
+		 word += automaton.wordsPerRow())
+		REQUIRE((automaton.words()[word] & padding) == 0);
+}
+
+TEST_CASE("CellularAutomaton gliders wrap around the torus", "[CellularAutomaton]")
+{
+	CellularAutomaton life{70, 33};
+	for (const auto [x, y] : {std::pair{1u, 0u}, {2u, 1u}, {0u, 2u}, {1u, 2u}, {2u, 2u}})
+		life.set(x, y, true);
+	REQUIRE(life.population() == 5);
+
+	// A glider moves one cell diagonally every four generations; after width * 4 generations it
+	// has crossed the grid horizontally and wrapped vertically by the same amount
+	life.step(70 * 4);
+	REQUIRE(life.population() == 5);
+	const uint32_t shift{70 % 33};
+	REQUIRE(life.get(1, shift));
+	REQUIRE(life.get(2, shift + 1));
+	REQUIRE(life.get(0, shift + 2));
+	REQUIRE(life.get(1, shift + 2));
+	REQUIRE(life.get(2, shift + 2));
+
+	life.clear();
+	REQUIRE(life.population() == 0);
+}
+
+TEST_CASE("CellularRule parses B/S notation", "[CellularAutomaton]")
+{
+	REQUIRE(CellularRule::parse("B3/S23") == CellularRule{});
+	REQUIRE(CellularRule::parse("b36/s23") == CellularRule{1 << 3 | 1 << 6, 1 << 2 | 1 << 3});
+	REQUIRE(CellularRule::parse("B2/S") == CellularRule{1 << 2, 0});
+	REQUIRE_FALSE(CellularRule::parse("B3S23"));
+	REQUIRE_FALSE(CellularRule::parse("B9/S23"));
+	REQUIRE_FALSE(CellularRule::parse("S23/B3"));
+}
+
+TEST_CASE("CellularAutomaton expands cells to pixels", "[CellularAutomaton]")
+{
+	CellularAutomaton life{3, 2};
+	life.set(0, 0, true);
+	life.set(2, 1, true);
+
+	std::vector<uint32_t> pixels(6);
+	life.toPixels(pixels, {255, 255, 255, 255}, {0, 0, 0, 255});
+	const uint32_t on{0xFFFFFFFF};
+	const uint32_t off{0xFF000000};
+	REQUIRE(pixels == std::vector<uint32_t>{on, off, off, off, off, on});
+}
+
+TEST_CASE("CellularAutomaton splits tall grids across jobs", "[CellularAutomaton]")
+{
+	// A job steps at least 4096 words, i.e. 1024 rows of this width, and expands 1310 rows to
+	// pixels, so both are split across jobs and rows on either side of a split are covered
+	constexpr uint32_t width{200};
+	constexpr uint32_t height{2100};
+	const CellularRule rule{GENERATE(CellularRule{}, *CellularRule::parse("B36/S23"))};
+
+	JobSystem jobs{3};
+	CellularAutomaton automaton{width, height, rule};
+	automaton.randomize(0.4f);
+	ReferenceGrid reference{automaton};
+
+	for (int generation = 0; generation < 4; ++generation)
+	{
+		automaton.step(1, &jobs);
+		reference.step(rule);
+		REQUIRE(reference.matches(automaton));
+	}
+
+	std::vector<uint32_t> serial(width * height);
+	std::vector<uint32_t> threaded(width * height);
+	automaton.toPixels(serial, {255, 255, 255, 255}, {0, 0, 0, 255});
+	automaton.toPixels(threaded, {255, 255, 255, 255}, {0, 0, 0, 255}, &jobs);
+	REQUIRE(threaded == serial);
+}
@@ -0,0 +1,233 @@
+#include <catch.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+import lune;
+
+using namespace lune;
+
+
+static std::string tempPath(const std::string& name)
+{
+	return (std::filesystem::temp_directory_path() / name).string();
+}
+
+static std::vector<std::byte> makeContent(const size_t size, const uint32_t seed)
+{
+	// Runs of repeated bytes with some noise, so compressors have something to find
+	std::vector<std::byte> content(size);
+	uint32_t state{seed};
+	for (size_t i = 0; i < size; ++i)
+	{
+		if (i % 64 == 0)
+			state = state * 1664525 + 1013904223;
+		content[i] = static_cast<std::byte>((state >> 24) + (i % 7 == 0 ? i : 0));
+	}
+	return content;
+}
+
+static std::span<const std::byte> asBytes(const std::string_view text)
+{
+	return std::as_bytes(std::span{text.data(), text.size()});
+}
+
+static void writeText(const std::filesystem::path& path, const std::string& text)
+{
+	std::filesystem::create_directories(path.parent_path());
+	File::write(path.string(), text);
+}
+
+
+TEST_CASE("Archive round-trips files across blocks", "[Vfs]")
+{
+	const ArchiveCompression compression{GENERATE(ARCHIVE_STORED, ARCHIVE_LZ4, ARCHIVE_ZSTD)};
+	const std::string path{tempPath("lune_test_roundtrip.lpak")};
+
+	const std::vector<std::byte> large{makeContent(50'000, 1)};
+	const std::vector<std::byte> exact{makeContent(8192, 2)};
+	const std::vector<std::byte> small{makeContent(100, 3)};
+
+	ArchiveWriter writer{compression, 4096};
+	REQUIRE(writer.add("textures/large.bin", large));
+	REQUIRE(writer.add("./textures/../exact.bin", exact));
+	REQUIRE(writer.add("small.bin", small));
+	REQUIRE(writer.add("empty.bin", {}));
+	REQUIRE_FALSE(writer.add("/absolute.bin", small));
+	REQUIRE_FALSE(writer.add("../outside.bin", small));
+	REQUIRE(writer.fileCount() == 4);
+	REQUIRE(writer.write(path));
+
+	const auto archive{Archive::open(path)};
+	REQUIRE(archive.has_value());
+	REQUIRE(archive->list() == std::vector<std::string_view>{"empty.bin", "exact.bin", "small.bin",
+															 "textures/large.bin"});
+	REQUIRE(archive->size("textures/large.bin") == large.size());
+	REQUIRE_FALSE(archive->contains("missing.bin"));
+	REQUIRE_FALSE(archive->read("missing.bin").has_value());
+
+	JobSystem jobs{3};
+	for (JobSystem* system : {static_cast<JobSystem*>(nullptr), &jobs})
+	{
+		REQUIRE(archive->read("textures/large.bin", system) == large);
+		REQUIRE(archive->read("exact.bin", system) == exact);
+		REQUIRE(archive->read("small.bin", system) == small);
+		REQUIRE(archive->read("empty.bin", system) == std::vector<std::byte>{});
+	}
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("Archive views uncompressed files in place", "[Vfs]")
+{
+	const std::string path{tempPath("lune_test_stored.lpak")};
+	const std::vector<std::byte> content{makeContent(20'000, 4)};
+
+	ArchiveWriter writer{ARCHIVE_STORED, 4096};
+	writer.add("a.bin", makeContent(10, 5));
+	writer.add("b.bin", content);
+	REQUIRE(writer.write(path));
+
+	const auto archive{Archive::open(path)};
+	REQUIRE(archive.has_value());
+
+	const auto view{archive->view("b.bin")};
+	REQUIRE(view.has_value());
+	REQUIRE(std::vector<std::byte>(view->begin(), view->end()) == content);
+	REQUIRE(reinterpret_cast<uintptr_t>(view->data()) % ARCHIVE_PAGE_ALIGNMENT == 0);
+	REQUIRE_FALSE(archive->view("missing.bin").has_value());
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("Archive rejects malformed files", "[Vfs]")
+{
+	const std::string path{tempPath("lune_test_bad.lpak")};
+
+	REQUIRE_FALSE(Archive::open(tempPath("lune_test_missing.lpak")).has_value());
+
+	File::write(path, "not an archive, but long enough to hold an archive header.......");
+	REQUIRE_FALSE(Archive::open(path).has_value());
+
+	// A valid header whose table of contents points past the end of the file
+	ArchiveHeader header{};
+	header.entryCount = 1;
+	header.entriesOffset = 4096;
+	File::writeBinary(path, std::as_bytes(std::span{&header, 1}));
+	REQUIRE_FALSE(Archive::open(path).has_value());
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("Vfs resolves paths against mounts, most recent first", "[Vfs]")
+{
+	const std::filesystem::path root{tempPath("lune_test_vfs")};
+	std::filesystem::remove_all(root);
+	writeText(root / "loose" / "shaders" / "a.metal", "loose a");
+	writeText(root / "loose" / "only_loose.txt", "only loose");
+	writeText(root / "disk.txt", "disk");
+
+	const std::string archivePath{(root / "assets.lpak").string()};
+	ArchiveWriter writer;
+	writer.add("shaders/a.metal", asBytes("archived a"));
+	writer.add("shaders/b.metal", asBytes("archived b"));
+	REQUIRE(writer.write(archivePath));
+
+	Vfs::unmountAll();
+	REQUIRE(Vfs::mount(archivePath));
+	REQUIRE_FALSE(Vfs::mount((root / "missing.lpak").string()));
+	REQUIRE_FALSE(Vfs::mount((root / "loose").string(), "../outside"));
+	REQUIRE(Vfs::mountCount() == 1);
+
+	SECTION("Archived files are read through File")
+	{
+		REQUIRE(File::read("shaders/a.metal") == "archived a");
+		REQUIRE(File::read("./shaders/x/../b.metal") == "archived b");
+		REQUIRE(Vfs::exists("shaders/b.metal"));
+		REQUIRE_FALSE(Vfs::resolve("shaders/b.metal").has_value());
+	}
+
+	SECTION("Later mounts override earlier ones")
+	{
+		REQUIRE(Vfs::mount((root / "loose").string()));
+		REQUIRE(File::read("shaders/a.metal") == "loose a");
+		REQUIRE(File::read("shaders/b.metal") == "archived b");
+		const std::string loose{(root / "loose" / "shaders" / "a.metal").string()};
+		REQUIRE(Vfs::resolve("shaders/a.metal") == loose);
+
+		REQUIRE(Vfs::unmount((root / "loose").string()));
+		REQUIRE(File::read("shaders/a.metal") == "archived a");
+	}
+
+	SECTION("Mount points prefix the mounted files")
+	{
+		REQUIRE(Vfs::mount((root / "loose").string(), "dev/"));
+		REQUIRE(Vfs::read("dev/only_loose.txt") == "only loose");
+		REQUIRE_FALSE(Vfs::exists("only_loose.txt"));
+		REQUIRE_FALSE(Vfs::exists("dev"));
+	}
+
+	SECTION("Paths no mount provides are read from disk")
+	{
+		const std::string disk{(root / "disk.txt").string()};
+		REQUIRE(File::read(disk) == "disk");
+		REQUIRE(Vfs::resolve(disk) == disk);
+		REQUIRE_FALSE(Vfs::exists("shaders/missing.metal"));
+		REQUIRE_FALSE(Vfs::readBinary("shaders/missing.metal").has_value());
+	}
+
+	Vfs::unmountAll();
+	REQUIRE(Vfs::mountCount() == 0);
+	std::filesystem::remove_all(root);
+}
+
+TEST_CASE("Vfs reads archives from jobs while mounts change", "[Vfs]")
+{
+	const std::filesystem::path root{tempPath("lune_test_vfs_jobs")};
+	std::filesystem::remove_all(root);
+	writeText(root / "loose" / "unrelated.txt", "loose");
+
+	const std::vector<std::byte> content{makeContent(200'000, 6)};
+	const std::string archivePath{(root / "assets.lpak").string()};
+	ArchiveWriter writer{ARCHIVE_LZ4, 4096};
+	writer.add("large.bin", content);
+	REQUIRE(writer.write(archivePath));
+
+	Vfs::unmountAll();
+	REQUIRE(Vfs::mount(archivePath));
+
+	// Reads wait on the job system for their blocks, running the other reads meanwhile
+	JobSystem jobs{3};
+	JobCounter counter;
+	std::atomic<int> matches{};
+	for (int i = 0; i < 16; ++i)
+	{
+		jobs.submit(
+				[&]
+				{
+					if (Vfs::readBinary("large.bin", &jobs) == content)
+						++matches;
+				},
+				&counter);
+	}
+
+	for (int i = 0; i < 16; ++i)
+	{
+		REQUIRE(Vfs::mount((root / "loose").string()));
+		REQUIRE(Vfs::unmount((root / "loose").string()));
+	}
+
+	jobs.wait(counter);
+	REQUIRE(matches == 16);
+
+	// An archive unmounted while it is being read stays open until the read is done
+	jobs.submit([&] { matches += Vfs::readBinary("large.bin", &jobs).has_value(); }, &counter);
+	Vfs::unmountAll();
+	jobs.wait(counter);
+
+	std::filesystem::remove_all(root);
+}
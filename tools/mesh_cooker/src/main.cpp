@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+import lune;
+
+
+namespace
+{
+	void printUsage()
+	{
+		std::cerr << "Usage: LuneMeshCooker <input.obj> <output.lmesh> [options]\n"
+				  << "  --separate          Store vertex attributes in separate streams\n"
+				  << "  --lods <count>      Maximum number of LODs, including LOD 0 (default 4)\n"
+				  << "  --lod-error <value> Maximum LOD error relative to the mesh extent\n"
+				  << "  --no-meshlets       Skip meshlet generation\n";
+	}
+} // namespace
+
+
+int main(const int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		printUsage();
+		return EXIT_FAILURE;
+	}
+
+	const std::string input{argv[1]};
+	const std::string output{argv[2]};
+	lune::MeshCookInfo info{};
+
+	for (int i = 3; i < argc; ++i)
+	{
+		const std::string_view arg{argv[i]};
+
+		if (arg == "--separate")
+		{
+			info.layout = lune::MESH_SEPARATE_STREAMS;
+		}
+		else if (arg == "--no-meshlets")
+		{
+			info.buildMeshlets = false;
+		}
+		else if (arg == "--lods" && i + 1 < argc)
+		{
+			info.maxLodCount = static_cast<uint32_t>(std::max(1, std::atoi(argv[++i])));
+		}
+		else if (arg == "--lod-error" && i + 1 < argc)
+		{
+			info.maxLodError = std::strtof(argv[++i], nullptr);
+		}
+		else
+		{
+			std::cerr << "Unknown option: " << arg << "\n";
+			printUsage();
+			return EXIT_FAILURE;
+		}
+	}
+
+	const auto source{lune::MeshCooker::loadObj(input)};
+	if (!source)
+	{
+		return EXIT_FAILURE;
+	}
+
+	if (!lune::MeshCooker::cookToFile(*source, output, info))
+	{
+		return EXIT_FAILURE;
+	}
+
+	// Report what was written by loading the result back through the runtime path
+	const auto mesh{lune::MeshFile::open(output)};
+	if (!mesh)
+	{
+		return EXIT_FAILURE;
+	}
+
+	std::cout << output << ": " << mesh->vertexCount() << " vertices, "
+			  << mesh->meshlets().size() << " meshlets\n";
+	for (size_t i = 0; i < mesh->lods().size(); ++i)
+	{
+		const lune::MeshLod& lod{mesh->lods()[i]};
+		std::cout << "  LOD " << i << ": " << lod.indexCount / 3 << " triangles, error "
+				  << lod.error << "\n";
+	}
+
+	return EXIT_SUCCESS;
+}
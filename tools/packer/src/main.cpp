@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+import lune;
+
+
+namespace
+{
+	void printUsage()
+	{
+		std::cerr << "Usage: LunePacker <input directory> <output.lpak> [options]\n"
+				  << "  --stored            Store files uncompressed\n"
+				  << "  --lz4               Compress blocks with LZ4 (default)\n"
+				  << "  --zstd              Compress blocks with Zstandard\n"
+				  << "  --block-size <KiB>  Decompressed size of a block (default 256)\n"
+				  << "  --prefix <path>     Virtual directory to add the files under\n";
+	}
+} // namespace
+
+
+int main(const int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		printUsage();
+		return EXIT_FAILURE;
+	}
+
+	const std::string input{argv[1]};
+	const std::string output{argv[2]};
+	lune::ArchiveCompression compression{lune::ARCHIVE_LZ4};
+	uint32_t blockSize{lune::ARCHIVE_DEFAULT_BLOCK_SIZE};
+	std::string prefix;
+
+	for (int i = 3; i < argc; ++i)
+	{
+		const std::string_view arg{argv[i]};
+
+		if (arg == "--stored")
+		{
+			compression = lune::ARCHIVE_STORED;
+		}
+		else if (arg == "--lz4")
+		{
+			compression = lune::ARCHIVE_LZ4;
+		}
+		else if (arg == "--zstd")
+		{
+			compression = lune::ARCHIVE_ZSTD;
+		}
+		else if (arg == "--block-size" && i + 1 < argc)
+		{
+			blockSize = static_cast<uint32_t>(std::max(1, std::atoi(argv[++i]))) * 1024;
+		}
+		else if (arg == "--prefix" && i + 1 < argc)
+		{
+			prefix = argv[++i];
+		}
+		else
+		{
+			std::cerr << "Unknown option: " << arg << "\n";
+			printUsage();
+			return EXIT_FAILURE;
+		}
+	}
+
+	lune::ArchiveWriter writer{compression, blockSize};
+	if (writer.addDirectory(input, prefix) == 0)
+	{
+		std::cerr << "No files found in " << input << "\n";
+		return EXIT_FAILURE;
+	}
+
+	if (!writer.write(output, &lune::JobSystem::instance()))
+	{
+		return EXIT_FAILURE;
+	}
+
+	// Report what was written by opening the result through the runtime path
+	const auto archive{lune::Archive::open(output)};
+	if (!archive)
+	{
+		return EXIT_FAILURE;
+	}
+
+	std::cout << output << ": " << archive->fileCount() << " files\n";
+	for (const std::string_view path : archive->list())
+	{
+		std::cout << "  " << path << ": " << *archive->size(path) << " bytes\n";
+	}
+
+	return EXIT_SUCCESS;
+}